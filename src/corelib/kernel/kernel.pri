@@ -5,6 +5,7 @@ HEADERS += \
         kernel/qabstractnativeeventfilter.h \
         kernel/qbasictimer.h \
         kernel/qeventloop.h\
+        kernel/qeventloopinstrumentation_p.h \
         kernel/qpointer.h \
         kernel/qcorecmdlineargs_p.h \
         kernel/qcoreapplication.h \
@@ -46,6 +47,7 @@ SOURCES += \
         kernel/qabstractnativeeventfilter.cpp \
         kernel/qbasictimer.cpp \
         kernel/qeventloop.cpp \
+        kernel/qeventloopinstrumentation.cpp \
         kernel/qcoreapplication.cpp \
         kernel/qcoreevent.cpp \
         kernel/qmetaobject.cpp \
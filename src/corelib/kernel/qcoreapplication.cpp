@@ -61,6 +61,7 @@
 #include <qthreadpool.h>
 #include <qthreadstorage.h>
 #include <private/qthread_p.h>
+#include <private/qeventloopinstrumentation_p.h>
 #endif
 #include <qelapsedtimer.h>
 #include <qlibraryinfo.h>
@@ -794,6 +795,8 @@ void QCoreApplicationPrivate::init()
 
     threadData->eventDispatcher = eventDispatcher;
     eventDispatcherReady();
+
+    QEventLoopInstrumentation::initialize();
 #endif
 
 #ifdef QT_EVAL
@@ -983,6 +986,7 @@ bool QCoreApplication::notifyInternal2(QObject *receiver, QEvent *event)
     QObjectPrivate *d = receiver->d_func();
     QThreadData *threadData = d->threadData;
     QScopedScopeLevelCounter scopeLevelCounter(threadData);
+    QEventLoopInstrumentation::HandlerScope instrumentation(threadData, receiver, event);
     if (!selfRequired)
         return doNotify(receiver, event);
     return self->notify(receiver, event);
@@ -1412,6 +1416,8 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     // properly owned in the postEventList
     QScopedPointer<QEvent> eventDeleter(event);
     data->postEventList.addEvent(QPostEvent(receiver, event, priority));
+    if (Q_UNLIKELY(QEventLoopInstrumentation::isEnabled()))
+        QEventLoopInstrumentation::postedEventQueued(data);
     eventDeleter.take();
     event->posted = true;
     ++receiver->d_func()->postedEvents;
@@ -50,6 +50,7 @@
 #include <private/qthread_p.h>
 #include <private/qcoreapplication_p.h>
 #include <private/qcore_unix_p.h>
+#include <private/qeventloopinstrumentation_p.h>
 
 #include <errno.h>
 #include <stdio.h>
@@ -455,10 +456,12 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
 {
     Q_D(QEventDispatcherUNIX);
     d->interrupt.store(0);
+    QEventLoopInstrumentation::LoopIteration instrumentation(d->threadData);
 
     // we are awake, broadcast it
     emit awake();
     QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+    instrumentation.phaseDone(QEventLoopInstrumentation::PostedEvents);
 
     const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
     const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
@@ -492,7 +495,11 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
 
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+    instrumentation.aboutToWait();
+    const int pollResult = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm);
+    instrumentation.phaseDone(QEventLoopInstrumentation::Poll);
+
+    switch (pollResult) {
     case -1:
         perror("qt_safe_poll");
         break;
@@ -500,13 +507,17 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         break;
     default:
         nevents += d->threadPipe.check(d->pollfds.takeLast());
-        if (include_notifiers)
+        if (include_notifiers) {
             nevents += d->activateSocketNotifiers();
+            instrumentation.phaseDone(QEventLoopInstrumentation::SocketNotifiers);
+        }
         break;
     }
 
-    if (include_timers)
+    if (include_timers) {
         nevents += d->activateTimers();
+        instrumentation.phaseDone(QEventLoopInstrumentation::Timers);
+    }
 
     // return true if we handled events, false otherwise
     return (nevents > 0);
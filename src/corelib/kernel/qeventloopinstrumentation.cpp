@@ -0,0 +1,604 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qeventloopinstrumentation_p.h"
+
+#include "qcoreapplication.h"
+#include "qcoreevent.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qloggingcategory.h"
+#include "qmetaobject.h"
+#include "qmutex.h"
+#include "qpair.h"
+#include "qthread.h"
+#include "qwaitcondition.h"
+
+#include <private/qthread_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcEventLoop, "qt.core.eventloop")
+
+/*
+    QEventLoopInstrumentation records, per thread, how long each phase of
+    the event dispatcher's loop takes, how deep the posted event queue
+    gets and how long event handlers run, as log2 histograms per event
+    type and receiver class. A watchdog thread can additionally report
+    threads whose event loop did not get back to waiting for events
+    within a threshold.
+
+    It is disabled by default; the hooks then cost one relaxed atomic
+    load each. It is enabled through setEnabled() or by setting
+    QT_EVENT_LOOP_INSTRUMENTATION, in which case the statistics of the
+    main thread are logged when the application exits. Setting
+    QT_EVENT_LOOP_WATCHDOG to a number of milliseconds also enables it
+    and starts the watchdog with that threshold.
+
+    Only QEventDispatcherUNIX, and the dispatchers based on it, report
+    loop phases. With other dispatchers, such as QEventDispatcherGlib,
+    a thread counts as busy while its outermost event handler runs, so
+    the watchdog still reports stalled handlers; time a handler spends
+    in a nested event loop counts as busy then. Handler durations and
+    queue depths are recorded for every thread.
+*/
+
+QBasicAtomicInt QEventLoopInstrumentation::enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+class QEventLoopThreadStatistics
+{
+public:
+    QEventLoopThreadStatistics(QThreadData *data)
+        : data(data), threadId(data->threadId), named(false),
+          busySince(0), reportedBusySince(0), loopDepth(0),
+          handlerDepth(0), currentEventType(QEvent::None), currentMetaObject(0)
+    { }
+
+    QMutex mutex;   // protects everything but data
+    QThreadData *data;
+    Qt::HANDLE threadId;
+    QByteArray threadName;
+    bool named;
+
+    QEventLoopInstrumentation::ThreadStatistics stats;
+    QHash<QPair<int, const QMetaObject *>, int> handlerIndex;
+
+    // when the loop last stopped waiting for events, 0 while it waits
+    qint64 busySince;
+    qint64 reportedBusySince;
+    // the number of LoopIteration scopes currently running
+    int loopDepth;
+
+    // the outermost event being handled
+    int handlerDepth;
+    int currentEventType;
+    const QMetaObject *currentMetaObject;
+};
+
+#ifndef QT_NO_THREAD
+class QEventLoopWatchdog : public QThread
+{
+public:
+    QEventLoopWatchdog() : stopping(false)
+    { setObjectName(QStringLiteral("Qt event loop watchdog")); }
+
+    void stop()
+    {
+        {
+            QMutexLocker locker(&mutex);
+            stopping = true;
+            condition.wakeAll();
+        }
+        wait();
+    }
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QMutex mutex;
+    QWaitCondition condition;
+    bool stopping;
+};
+#endif
+
+struct QEventLoopInstrumentationData
+{
+    QEventLoopInstrumentationData()
+        : watchdog(0), threshold(0), stallHandler(0)
+    {
+        clock.start();
+    }
+
+    ~QEventLoopInstrumentationData()
+    {
+        QEventLoopInstrumentation::setEnabled(false);
+#ifndef QT_NO_THREAD
+        if (watchdog) {
+            watchdog->stop();
+            delete watchdog;
+        }
+#endif
+        for (QEventLoopThreadStatistics *stats : qAsConst(threads)) {
+            stats->data->loopStatistics.store(0);
+            delete stats;
+        }
+    }
+
+    QElapsedTimer clock;
+
+    // protects the members below and QThreadData::loopStatistics
+    QMutex mutex;
+    QVector<QEventLoopThreadStatistics *> threads;
+#ifndef QT_NO_THREAD
+    QEventLoopWatchdog *watchdog;
+#else
+    void *watchdog;
+#endif
+    int threshold;
+    QEventLoopInstrumentation::StallHandler stallHandler;
+};
+
+Q_GLOBAL_STATIC(QEventLoopInstrumentationData, instrumentationData)
+
+static inline qint64 currentTime()
+{
+    const QEventLoopInstrumentationData *d = instrumentationData();
+    return d ? d->clock.nsecsElapsed() : 0;
+}
+
+static QEventLoopThreadStatistics *threadStatistics(QThreadData *data)
+{
+    QEventLoopThreadStatistics *stats = data->loopStatistics.loadAcquire();
+    if (Q_LIKELY(stats))
+        return stats;
+
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return 0;
+    QMutexLocker locker(&d->mutex);
+    stats = data->loopStatistics.load();
+    if (!stats) {
+        stats = new QEventLoopThreadStatistics(data);
+        d->threads.append(stats);
+        data->loopStatistics.storeRelease(stats);
+    }
+    return stats;
+}
+
+// only called from the thread the statistics belong to
+static void nameThread(QEventLoopThreadStatistics *stats)
+{
+    QMutexLocker locker(&stats->mutex);
+    stats->threadId = QThread::currentThreadId();
+    if (QThread *thread = stats->data->thread.load())
+        stats->threadName = thread->objectName().toLocal8Bit();
+    stats->named = true;
+}
+
+static QByteArray eventTypeName(int type)
+{
+    if (const char *key = QMetaEnum::fromType<QEvent::Type>().valueToKey(type))
+        return key;
+    return QByteArray::number(type);
+}
+
+static QByteArray threadDescription(const QByteArray &name, Qt::HANDLE id)
+{
+    if (!name.isEmpty())
+        return name;
+    return "0x" + QByteArray::number(quintptr(id), 16);
+}
+
+void QEventLoopInstrumentation::Histogram::add(qint64 nsecs)
+{
+    const quint64 usecs = quint64(qMax(nsecs, qint64(0))) / 1000;
+    const int bucket = usecs ? 64 - int(qCountLeadingZeroBits(usecs)) : 0;
+    ++buckets[qMin(bucket, int(BucketCount) - 1)];
+    ++count;
+    total += nsecs;
+    max = qMax(max, nsecs);
+}
+
+// Returns an upper bound in microseconds for the given fraction of the durations.
+static qint64 percentile(const QEventLoopInstrumentation::Histogram &histogram, double fraction)
+{
+    const quint64 wanted = quint64(histogram.count * fraction + 0.5);
+    quint64 seen = 0;
+    for (int i = 0; i < QEventLoopInstrumentation::BucketCount - 1; ++i) {
+        seen += histogram.buckets[i];
+        if (seen >= wanted)
+            return qMin(qint64(1) << i, histogram.max / 1000 + 1);
+    }
+    return histogram.max / 1000 + 1;
+}
+
+void QEventLoopInstrumentation::setEnabled(bool enable)
+{
+    if (enable)
+        instrumentationData(); // start the clock
+    enabled.store(enable ? 1 : 0);
+}
+
+static void logMainThreadStatistics()
+{
+    QEventLoopInstrumentation::logStatistics(QCoreApplication::instance()->thread());
+    QEventLoopInstrumentation::setWatchdogThreshold(0);
+}
+
+/*
+    Applies the QT_EVENT_LOOP_INSTRUMENTATION and QT_EVENT_LOOP_WATCHDOG
+    environment variables; called when QCoreApplication is created.
+*/
+void QEventLoopInstrumentation::initialize()
+{
+    const int threshold = qEnvironmentVariableIntValue("QT_EVENT_LOOP_WATCHDOG");
+    if (qEnvironmentVariableIsEmpty("QT_EVENT_LOOP_INSTRUMENTATION") && threshold <= 0)
+        return;
+
+    setEnabled(true);
+    if (threshold > 0)
+        setWatchdogThreshold(threshold);
+    if (!qEnvironmentVariableIsEmpty("QT_EVENT_LOOP_INSTRUMENTATION"))
+        qAddPostRoutine(logMainThreadStatistics);
+}
+
+/*
+    Returns a snapshot of the statistics recorded for \a thread.
+*/
+QEventLoopInstrumentation::ThreadStatistics QEventLoopInstrumentation::statistics(QThread *thread)
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d || !thread)
+        return ThreadStatistics();
+
+    QMutexLocker locker(&d->mutex);
+    QEventLoopThreadStatistics *stats = QThreadData::get2(thread)->loopStatistics.load();
+    if (!stats)
+        return ThreadStatistics();
+    QMutexLocker statsLocker(&stats->mutex);
+    ThreadStatistics result = stats->stats;
+    result.threadId = stats->threadId;
+    result.threadName = stats->threadName;
+    return result;
+}
+
+void QEventLoopInstrumentation::resetStatistics(QThread *thread)
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d || !thread)
+        return;
+
+    QMutexLocker locker(&d->mutex);
+    QEventLoopThreadStatistics *stats = QThreadData::get2(thread)->loopStatistics.load();
+    if (!stats)
+        return;
+    QMutexLocker statsLocker(&stats->mutex);
+    stats->stats = ThreadStatistics();
+    stats->handlerIndex.clear();
+}
+
+/*
+    Logs a summary of the statistics of \a thread to the qt.core.eventloop
+    category: the loop phases, then the ten handlers that took the most
+    time overall.
+*/
+void QEventLoopInstrumentation::logStatistics(QThread *thread)
+{
+    const ThreadStatistics stats = statistics(thread);
+    static const char *const phaseNames[PhaseCount] = {
+        "posted events", "poll", "socket notifiers", "timers"
+    };
+
+    qCInfo(lcEventLoop, "Event loop of thread %s: %llu iterations, posted event queue depth up to %d",
+           threadDescription(stats.threadName, stats.threadId).constData(),
+           stats.iterations, stats.maxPostedEventQueueDepth);
+    for (int i = 0; i < PhaseCount; ++i) {
+        const Histogram &h = stats.phases[i];
+        if (!h.count)
+            continue;
+        qCInfo(lcEventLoop, "  %s: %llu times, %.3f ms total, p99 < %lld us, max %.3f ms",
+               phaseNames[i], h.count, h.total / 1e6, percentile(h, 0.99), h.max / 1e6);
+    }
+
+    QVector<HandlerStatistics> handlers = stats.handlers;
+    std::sort(handlers.begin(), handlers.end(),
+              [](const HandlerStatistics &a, const HandlerStatistics &b) {
+        return a.durations.total > b.durations.total;
+    });
+    for (int i = 0; i < qMin(handlers.size(), 10); ++i) {
+        const HandlerStatistics &handler = handlers.at(i);
+        const Histogram &h = handler.durations;
+        qCInfo(lcEventLoop, "  %s to %s: %llu times, %.3f ms total, p99 < %lld us, max %.3f ms",
+               eventTypeName(handler.eventType).constData(), handler.receiverClass.constData(),
+               h.count, h.total / 1e6, percentile(h, 0.99), h.max / 1e6);
+    }
+}
+
+#ifndef QT_NO_THREAD
+static void checkForStalls()
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return;
+
+    QVector<QEventLoopInstrumentation::StallReport> reports;
+    QEventLoopInstrumentation::StallHandler handler;
+    {
+        QMutexLocker locker(&d->mutex);
+        handler = d->stallHandler;
+        const qint64 threshold = qint64(d->threshold) * 1000000;
+        const qint64 now = d->clock.nsecsElapsed();
+        for (QEventLoopThreadStatistics *stats : qAsConst(d->threads)) {
+            QMutexLocker statsLocker(&stats->mutex);
+            if (!stats->busySince || stats->busySince == stats->reportedBusySince
+                || now - stats->busySince < threshold) {
+                continue;
+            }
+            // report each stall once
+            stats->reportedBusySince = stats->busySince;
+
+            QEventLoopInstrumentation::StallReport report;
+            report.threadId = stats->threadId;
+            report.threadName = stats->threadName;
+            report.stalledFor = (now - stats->busySince) / 1000000;
+            report.eventType = stats->currentEventType;
+            if (stats->currentMetaObject)
+                report.receiverClass = stats->currentMetaObject->className();
+            reports.append(report);
+        }
+    }
+
+    for (const QEventLoopInstrumentation::StallReport &report : qAsConst(reports)) {
+        if (handler) {
+            handler(report);
+        } else if (report.eventType != QEvent::None) {
+            qCWarning(lcEventLoop, "Event loop of thread %s stalled for %lld ms handling %s event for %s",
+                      threadDescription(report.threadName, report.threadId).constData(), report.stalledFor,
+                      eventTypeName(report.eventType).constData(), report.receiverClass.constData());
+        } else {
+            qCWarning(lcEventLoop, "Event loop of thread %s stalled for %lld ms",
+                      threadDescription(report.threadName, report.threadId).constData(), report.stalledFor);
+        }
+    }
+}
+
+void QEventLoopWatchdog::run()
+{
+    QMutexLocker locker(&mutex);
+    while (!stopping) {
+        // look a few times per threshold, so stalls are reported soon after they cross it
+        condition.wait(&mutex, qMax(QEventLoopInstrumentation::watchdogThreshold() / 4, 1));
+        if (stopping)
+            break;
+        locker.unlock();
+        checkForStalls();
+        locker.relock();
+    }
+}
+
+static void stopWatchdog()
+{
+    QEventLoopInstrumentation::setWatchdogThreshold(0);
+}
+#endif
+
+/*
+    Starts a watchdog thread reporting event loops that are busy for
+    longer than \a msecs milliseconds, or stops it if \a msecs is 0.
+    Stalls are reported to the stall handler, or logged as warnings to
+    the qt.core.eventloop category. The watchdog is stopped when the
+    QCoreApplication is destroyed.
+*/
+void QEventLoopInstrumentation::setWatchdogThreshold(int msecs)
+{
+#ifndef QT_NO_THREAD
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return;
+
+    QEventLoopWatchdog *stopped = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->threshold = qMax(msecs, 0);
+        if (d->threshold && !d->watchdog) {
+            d->watchdog = new QEventLoopWatchdog;
+            d->watchdog->start(QThread::LowPriority);
+            qAddPostRoutine(stopWatchdog);
+        } else if (!d->threshold && d->watchdog) {
+            stopped = d->watchdog;
+            d->watchdog = 0;
+            qRemovePostRoutine(stopWatchdog);
+        }
+    }
+    if (stopped) {
+        stopped->stop();
+        delete stopped;
+    }
+#else
+    Q_UNUSED(msecs);
+#endif
+}
+
+int QEventLoopInstrumentation::watchdogThreshold()
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return 0;
+    QMutexLocker locker(&d->mutex);
+    return d->threshold;
+}
+
+/*
+    Sets the function the watchdog calls for each stalled event loop
+    instead of logging a warning. It is called from the watchdog thread.
+*/
+void QEventLoopInstrumentation::setStallHandler(StallHandler handler)
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return;
+    QMutexLocker locker(&d->mutex);
+    d->stallHandler = handler;
+}
+
+void QEventLoopInstrumentation::postedEventQueued(QThreadData *data)
+{
+    QEventLoopThreadStatistics *stats = threadStatistics(data);
+    if (!stats)
+        return;
+    const int depth = data->postEventList.size() - data->postEventList.startOffset;
+    QMutexLocker locker(&stats->mutex);
+    stats->stats.postedEventQueueDepth = depth;
+    stats->stats.maxPostedEventQueueDepth = qMax(stats->stats.maxPostedEventQueueDepth, depth);
+}
+
+void QEventLoopInstrumentation::threadDataDestroyed(QThreadData *data)
+{
+    QEventLoopInstrumentationData *d = instrumentationData();
+    if (!d)
+        return;
+    QMutexLocker locker(&d->mutex);
+    QEventLoopThreadStatistics *stats = data->loopStatistics.load();
+    if (!stats)
+        return;
+    d->threads.removeOne(stats);
+    data->loopStatistics.store(0);
+    delete stats;
+}
+
+void QEventLoopInstrumentation::HandlerScope::begin(QThreadData *data, QObject *receiver, QEvent *event)
+{
+    stats = threadStatistics(data);
+    if (!stats)
+        return;
+    if (Q_UNLIKELY(!stats->named))
+        nameThread(stats);
+
+    metaObject = receiver->metaObject();
+    eventType = event->type();
+
+    QMutexLocker locker(&stats->mutex);
+    start = currentTime();
+    // without a dispatcher reporting its iterations, the thread is
+    // busy for as long as its outermost handler runs
+    tracksBusy = stats->handlerDepth++ == 0 && stats->loopDepth == 0;
+    if (stats->handlerDepth == 1) {
+        stats->currentEventType = eventType;
+        stats->currentMetaObject = metaObject;
+    }
+    if (tracksBusy)
+        stats->busySince = start;
+}
+
+void QEventLoopInstrumentation::HandlerScope::end()
+{
+    const qint64 duration = currentTime() - start;
+
+    QMutexLocker locker(&stats->mutex);
+    if (--stats->handlerDepth == 0) {
+        stats->currentEventType = QEvent::None;
+        stats->currentMetaObject = 0;
+    }
+    if (tracksBusy)
+        stats->busySince = 0;
+
+    const QPair<int, const QMetaObject *> key(eventType, metaObject);
+    QHash<QPair<int, const QMetaObject *>, int>::const_iterator it = stats->handlerIndex.constFind(key);
+    int index;
+    if (it == stats->handlerIndex.constEnd()) {
+        index = stats->stats.handlers.size();
+        stats->handlerIndex.insert(key, index);
+        HandlerStatistics handler;
+        handler.eventType = eventType;
+        handler.receiverClass = metaObject->className();
+        stats->stats.handlers.append(handler);
+    } else {
+        index = it.value();
+    }
+    stats->stats.handlers[index].durations.add(duration);
+}
+
+void QEventLoopInstrumentation::LoopIteration::begin(QThreadData *data)
+{
+    stats = threadStatistics(data);
+    if (!stats)
+        return;
+    if (Q_UNLIKELY(!stats->named))
+        nameThread(stats);
+
+    phaseStart = currentTime();
+    QMutexLocker locker(&stats->mutex);
+    ++stats->stats.iterations;
+    ++stats->loopDepth;
+    savedBusySince = stats->busySince;
+    if (!stats->busySince)
+        stats->busySince = phaseStart;
+}
+
+void QEventLoopInstrumentation::LoopIteration::end()
+{
+    const qint64 now = currentTime();
+    QMutexLocker locker(&stats->mutex);
+    --stats->loopDepth;
+    // a nested loop returns to a handler of the outer one, which is busy
+    // again from now on
+    stats->busySince = savedBusySince ? now : 0;
+}
+
+void QEventLoopInstrumentation::LoopIteration::wait()
+{
+    phaseStart = currentTime();
+    QMutexLocker locker(&stats->mutex);
+    stats->busySince = 0;
+}
+
+void QEventLoopInstrumentation::LoopIteration::record(Phase phase)
+{
+    const qint64 now = currentTime();
+    QMutexLocker locker(&stats->mutex);
+    stats->stats.phases[phase].add(now - phaseStart);
+    if (phase == Poll)
+        stats->busySince = now;
+    phaseStart = now;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,198 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEVENTLOOPINSTRUMENTATION_P_H
+#define QEVENTLOOPINSTRUMENTATION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QEvent;
+struct QMetaObject;
+class QObject;
+class QThread;
+class QThreadData;
+class QEventLoopThreadStatistics;
+
+class Q_CORE_EXPORT QEventLoopInstrumentation
+{
+public:
+    enum Phase {
+        PostedEvents,       // sending posted events
+        Poll,               // waiting in poll()
+        SocketNotifiers,    // activating socket notifiers
+        Timers,             // activating timers
+        PhaseCount
+    };
+
+    enum { BucketCount = 24 };
+
+    struct Histogram
+    {
+        // bucket 0 counts durations below 1 us, bucket i those below 2^i us;
+        // the last bucket counts everything longer
+        quint64 buckets[BucketCount];
+        quint64 count;
+        qint64 total;       // nanoseconds
+        qint64 max;         // nanoseconds
+
+        Histogram() : count(0), total(0), max(0)
+        { std::fill_n(buckets, int(BucketCount), quint64(0)); }
+        void add(qint64 nsecs);
+    };
+
+    struct HandlerStatistics
+    {
+        int eventType;
+        QByteArray receiverClass;
+        Histogram durations;
+    };
+
+    struct ThreadStatistics
+    {
+        ThreadStatistics()
+            : threadId(0), iterations(0), postedEventQueueDepth(0), maxPostedEventQueueDepth(0) {}
+
+        Qt::HANDLE threadId;
+        QByteArray threadName;
+        quint64 iterations;
+        Histogram phases[PhaseCount];
+        int postedEventQueueDepth;      // after the most recent postEvent()
+        int maxPostedEventQueueDepth;
+        QVector<HandlerStatistics> handlers;
+    };
+
+    struct StallReport
+    {
+        Qt::HANDLE threadId;
+        QByteArray threadName;
+        qint64 stalledFor;          // milliseconds
+        int eventType;              // QEvent::None if no event is being handled
+        QByteArray receiverClass;
+    };
+    typedef void (*StallHandler)(const StallReport &report);
+
+    static inline bool isEnabled()
+    { return Q_UNLIKELY(enabled.load() != 0); }
+    static void setEnabled(bool enable);
+    static void initialize();
+
+    static ThreadStatistics statistics(QThread *thread);
+    static void resetStatistics(QThread *thread);
+    static void logStatistics(QThread *thread);
+
+    static void setWatchdogThreshold(int msecs);
+    static int watchdogThreshold();
+    static void setStallHandler(StallHandler handler);
+
+    // called with the post event list of data locked
+    static void postedEventQueued(QThreadData *data);
+    static void threadDataDestroyed(QThreadData *data);
+
+    // times one event handler, wrapped around QCoreApplication::notify()
+    class HandlerScope
+    {
+    public:
+        inline HandlerScope(QThreadData *data, QObject *receiver, QEvent *event)
+            : stats(0)
+        { if (isEnabled()) begin(data, receiver, event); }
+        inline ~HandlerScope()
+        { if (Q_UNLIKELY(stats)) end(); }
+
+    private:
+        Q_DISABLE_COPY(HandlerScope)
+        void begin(QThreadData *data, QObject *receiver, QEvent *event);
+        void end();
+
+        QEventLoopThreadStatistics *stats;
+        const QMetaObject *metaObject;
+        int eventType;
+        qint64 start;
+        bool tracksBusy;    // outermost handler outside a timed loop iteration
+    };
+
+    // times the phases of one event dispatcher iteration
+    class LoopIteration
+    {
+    public:
+        inline explicit LoopIteration(QThreadData *data)
+            : stats(0)
+        { if (isEnabled()) begin(data); }
+        inline ~LoopIteration()
+        { if (Q_UNLIKELY(stats)) end(); }
+
+        inline void aboutToWait()
+        { if (Q_UNLIKELY(stats)) wait(); }
+        inline void phaseDone(Phase phase)
+        { if (Q_UNLIKELY(stats)) record(phase); }
+
+    private:
+        Q_DISABLE_COPY(LoopIteration)
+        void begin(QThreadData *data);
+        void end();
+        void wait();
+        void record(Phase phase);
+
+        QEventLoopThreadStatistics *stats;
+        qint64 phaseStart;
+        qint64 savedBusySince;
+    };
+
+private:
+    static QBasicAtomicInt enabled;
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTLOOPINSTRUMENTATION_P_H
@@ -48,6 +48,7 @@
 
 #include "qthread_p.h"
 #include "private/qcoreapplication_p.h"
+#include "private/qeventloopinstrumentation_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -57,7 +58,7 @@ QT_BEGIN_NAMESPACE
 
 QThreadData::QThreadData(int initialRefCount)
     : _ref(initialRefCount), loopLevel(0), scopeLevel(0), thread(0), threadId(0),
-      eventDispatcher(0),
+      eventDispatcher(0), loopStatistics(0),
       quitNow(false), canWait(true), isAdopted(false), requiresCoreApplication(true)
 {
     // fprintf(stderr, "QThreadData %p created\n", this);
@@ -82,6 +83,9 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    if (loopStatistics.load())
+        QEventLoopInstrumentation::threadDataDestroyed(this);
+
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -231,6 +231,8 @@ public:
 
 #endif // QT_NO_THREAD
 
+class QEventLoopThreadStatistics;
+
 class QThreadData
 {
 public:
@@ -288,6 +290,7 @@ public:
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
     QVector<void *> tls;
     FlaggedDebugSignatures flaggedSignatures;
+    QAtomicPointer<QEventLoopThreadStatistics> loopStatistics;
 
     bool quitNow;
     bool canWait;
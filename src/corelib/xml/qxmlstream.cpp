@@ -42,6 +42,7 @@
 #ifndef QT_NO_XMLSTREAM
 
 #include "qxmlutils_p.h"
+#include <private/qsimd_p.h>
 #include <qdebug.h>
 #include <qfile.h>
 #include <stdio.h>
@@ -827,6 +828,7 @@ void QXmlStreamReaderPrivate::init()
     lineNumber = lastLineStart = characterOffset = 0;
     readBufferPos = 0;
     nbytesread = 0;
+    rawReadBufferPos = 0;
 #ifndef QT_NO_TEXTCODEC
     codec = QTextCodec::codecForMib(106); // utf8
     delete decoder;
@@ -952,6 +954,62 @@ inline uint QXmlStreamReaderPrivate::peekChar()
     return c;
 }
 
+/*!
+  \internal
+
+  Copies the run of characters at the current read position that need no
+  further attention from the fast scanners to textBuffer in one go, and
+  returns its length. The run ends before a control character (which
+  includes the line breaks), before the noncharacters U+FFFE and U+FFFF,
+  and before any of \a stop1, \a stop2, \a stop3 and \a stop4.
+
+  Characters that were put back with putChar() are left to getChar().
+  */
+int QXmlStreamReaderPrivate::fastScanPlainText(ushort stop1, ushort stop2, ushort stop3, ushort stop4)
+{
+    if (putStack.size())
+        return 0;
+
+    const ushort *begin = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBufferPos;
+    const ushort *end = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBuffer.size();
+    const ushort *p = begin;
+#ifdef __SSE2__
+    const __m128i controls = _mm_set1_epi16(0x1f);
+    const __m128i nonCharacters = _mm_set1_epi16(short(0xffff));
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i s1 = _mm_set1_epi16(short(stop1));
+    const __m128i s2 = _mm_set1_epi16(short(stop2));
+    const __m128i s3 = _mm_set1_epi16(short(stop3));
+    const __m128i s4 = _mm_set1_epi16(short(stop4));
+    for ( ; end - p >= 8; p += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // c <= 0x1f, or c is 0xfffe or 0xffff
+        __m128i stop = _mm_cmpeq_epi16(_mm_subs_epu16(data, controls), _mm_setzero_si128());
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi16(_mm_or_si128(data, one), nonCharacters));
+        stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(data, s1), _mm_cmpeq_epi16(data, s2)));
+        stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(data, s3), _mm_cmpeq_epi16(data, s4)));
+        const uint mask = _mm_movemask_epi8(stop);
+        if (mask) {
+            p += qCountTrailingZeroBits(mask) / 2;
+            break;
+        }
+    }
+    if (end - p < 8)
+#endif
+    for ( ; p != end; ++p) {
+        const ushort c = *p;
+        if (c < 0x20 || c >= 0xfffe || c == stop1 || c == stop2 || c == stop3 || c == stop4)
+            break;
+    }
+
+    const int n = int(p - begin);
+    if (n) {
+        textBuffer.append(readBuffer.constData() + readBufferPos, n);
+        readBufferPos += n;
+    }
+    return n;
+}
+
 /*!
   \internal
 
@@ -1146,7 +1204,10 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanPlainText('&', '<', '\"', '\'');
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1225,7 +1286,21 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (const int plain = fastScanPlainText('&', '<', ']', '<')) {
+            if (isWhitespace) {
+                const QChar *text = textBuffer.constData() + textBuffer.size() - plain;
+                for (int i = 0; i < plain; ++i) {
+                    if (text[i] != QLatin1Char(' ')) {
+                        isWhitespace = false;
+                        break;
+                    }
+                }
+            }
+            n += plain;
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1470,18 +1545,29 @@ uint QXmlStreamReaderPrivate::getChar_helper()
 #ifndef QT_NO_TEXTCODEC
     if (decoder)
 #endif
+    {
+        rawReadBufferPos += nbytesread;
         nbytesread = 0;
+    }
     if (device) {
+        rawReadBufferPos = 0;
         rawReadBuffer.resize(BUFFER_SIZE);
         int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, 0);
     } else {
-        if (nbytesread)
+        // Data added in one go is decoded BUFFER_SIZE bytes at a time, so
+        // that the parser works on text that is still in the cache, and
+        // large documents are never held twice in memory.
+        if (nbytesread) {
+            // too few bytes to determine the encoding so far
             rawReadBuffer += dataBuffer;
-        else
+            dataBuffer.clear();
+        } else if (rawReadBufferPos >= rawReadBuffer.size()) {
             rawReadBuffer = dataBuffer;
-        nbytesread = rawReadBuffer.size();
-        dataBuffer.clear();
+            rawReadBufferPos = 0;
+            dataBuffer.clear();
+        }
+        nbytesread = qMin(rawReadBuffer.size() - rawReadBufferPos, BUFFER_SIZE);
     }
     if (!nbytesread) {
         atEnd = true;
@@ -1521,7 +1607,7 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         decoder = codec->makeDecoder();
     }
 
-    decoder->toUnicode(&readBuffer, rawReadBuffer.constData(), nbytesread);
+    decoder->toUnicode(&readBuffer, rawReadBuffer.constData() + rawReadBufferPos, nbytesread);
 
     if(lockEncoding && decoder->hasFailure()) {
         raiseWellFormedError(QXmlStream::tr("Encountered incorrectly encoded content."));
@@ -1529,7 +1615,7 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         return StreamEOF;
     }
 #else
-    readBuffer = QString::fromLatin1(rawReadBuffer.data(), nbytesread);
+    readBuffer = QString::fromLatin1(rawReadBuffer.constData() + rawReadBufferPos, nbytesread);
 #endif // QT_NO_TEXTCODEC
 
     readBuffer.reserve(1); // keep capacity when calling resize() next time
@@ -1803,7 +1889,7 @@ void QXmlStreamReaderPrivate::startDocument()
                 err = QXmlStream::tr("%1 is an invalid encoding name.").arg(name);
             else {
 #ifdef QT_NO_TEXTCODEC
-                readBuffer = QString::fromLatin1(rawReadBuffer.data(), nbytesread);
+                readBuffer = QString::fromLatin1(rawReadBuffer.constData() + rawReadBufferPos, nbytesread);
 #else
                 QTextCodec *const newCodec = QTextCodec::codecForName(name.toLatin1());
                 if (!newCodec)
@@ -1812,7 +1898,7 @@ void QXmlStreamReaderPrivate::startDocument()
                     codec = newCodec;
                     delete decoder;
                     decoder = codec->makeDecoder();
-                    decoder->toUnicode(&readBuffer, rawReadBuffer.data(), nbytesread);
+                    decoder->toUnicode(&readBuffer, rawReadBuffer.constData() + rawReadBufferPos, nbytesread);
                 }
 #endif // QT_NO_TEXTCODEC
             }
@@ -255,6 +255,7 @@ public:
     QByteArray dataBuffer;
     uchar firstByte;
     qint64 nbytesread;
+    int rawReadBufferPos;
     QString readBuffer;
     int readBufferPos;
     QXmlStreamSimpleStack<uint> putStack;
@@ -487,6 +488,7 @@ public:
 
     // scan optimization functions. Not strictly necessary but LALR is
     // not very well suited for scanning fast
+    int fastScanPlainText(ushort stop1, ushort stop2, ushort stop3, ushort stop4);
     int fastScanLiteralContent();
     int fastScanSpace();
     int fastScanContentCharList();
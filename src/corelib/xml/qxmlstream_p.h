@@ -750,6 +750,7 @@ public:
     QByteArray dataBuffer;
     uchar firstByte;
     qint64 nbytesread;
+    int rawReadBufferPos;
     QString readBuffer;
     int readBufferPos;
     QXmlStreamSimpleStack<uint> putStack;
@@ -982,6 +983,7 @@ public:
 
     // scan optimization functions. Not strictly necessary but LALR is
     // not very well suited for scanning fast
+    int fastScanPlainText(ushort stop1, ushort stop2, ushort stop3, ushort stop4);
     int fastScanLiteralContent();
     int fastScanSpace();
     int fastScanContentCharList();
@@ -48,6 +48,7 @@
 #include <QtCore/qthread.h>
 
 #include "qdbusconnection.h"
+#include "qdbusmetatype.h"
 
 #include "qdbusconnection_p.h"  // for qDBusParametersForMethod
 #include "qdbusmetatype_p.h"
@@ -58,6 +59,18 @@
 
 QT_BEGIN_NAMESPACE
 
+// Only the meta object of this class is used: it describes the
+// org.freedesktop.DBus.Properties.PropertiesChanged signal, which is relayed
+// like any other adaptor signal when property changes are coalesced.
+class QDBusPropertiesChangedRelay: public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.DBus.Properties")
+Q_SIGNALS:
+    void PropertiesChanged(const QString &interface_name, const QVariantMap &changed_properties,
+                           const QStringList &invalidated_properties);
+};
+
 static int cachedRelaySlotMethodIndex = -1;
 
 int QDBusAdaptorConnector::relaySlotMethodIndex()
@@ -204,6 +217,75 @@ bool QDBusAbstractAdaptor::autoRelaySignals() const
     return d_func()->autoRelaySignals;
 }
 
+/*!
+    \since 5.9
+
+    Enables coalescing of property change notifications for this adaptor.
+
+    If \a msec is zero or greater, the notify signals of the adaptor's
+    properties are no longer relayed to D-Bus one by one. Instead, the
+    adaptor collects the properties whose notify signal was emitted and,
+    \a msec milliseconds after the first change (or when control returns to
+    the event loop, if \a msec is 0), emits a single
+    \c{org.freedesktop.DBus.Properties.PropertiesChanged} signal carrying the
+    current value of each of them. A property that changes many times within
+    the interval is sent only once, with its latest value.
+
+    This is useful for properties that change rapidly, such as the progress
+    of an operation, where relaying every change would flood the bus.
+
+    Only readable properties with a \c NOTIFY signal and a type that can be
+    sent over D-Bus take part. Notify signals must be emitted in the thread
+    of the object the adaptor is attached to, as for all relayed signals.
+
+    If \a msec is negative (the default), coalescing is disabled and any
+    pending changes are sent immediately.
+
+    \sa propertyChangeInterval(), setAutoRelaySignals()
+*/
+void QDBusAbstractAdaptor::setPropertyChangeInterval(int msec)
+{
+    Q_D(QDBusAbstractAdaptor);
+    if (msec < 0)
+        msec = -1;
+    if (d->propertyChangeInterval == msec)
+        return;
+
+    d->propertyChangeInterval = msec;
+    if (msec < 0) {
+        delete d->propertyChangeTimer;
+        d->propertyChangeTimer = 0;
+        if (QDBusAdaptorConnector *connector = qDBusFindAdaptorConnector(parent()))
+            connector->relayPropertiesChanged(this);
+        d->changedProperties.clear();
+        return;
+    }
+
+    if (!d->propertyChangeTimer) {
+        d->propertyChangeTimer = new QTimer(this);
+        d->propertyChangeTimer->setSingleShot(true);
+        connect(d->propertyChangeTimer, &QTimer::timeout, this, [this]() {
+            if (QDBusAdaptorConnector *connector = qDBusFindAdaptorConnector(parent()))
+                connector->relayPropertiesChanged(this);
+        });
+    }
+    d->propertyChangeTimer->setInterval(msec);
+}
+
+/*!
+    \since 5.9
+
+    Returns the interval in milliseconds over which property changes are
+    coalesced into one \c{PropertiesChanged} signal, or -1 if every notify
+    signal is relayed on its own.
+
+    \sa setPropertyChangeInterval()
+*/
+int QDBusAbstractAdaptor::propertyChangeInterval() const
+{
+    return d_func()->propertyChangeInterval;
+}
+
 QDBusAdaptorConnector::QDBusAdaptorConnector(QObject *obj)
     : QObject(obj), waitingForPolish(false)
 {
@@ -300,9 +382,14 @@ void QDBusAdaptorConnector::relay(QObject *senderObj, int lastSignalIdx, void **
     QMetaMethod mm = senderMetaObject->method(lastSignalIdx);
 
     QObject *realObject = senderObj;
-    if (qobject_cast<QDBusAbstractAdaptor *>(senderObj))
+    if (QDBusAbstractAdaptor *adaptor = qobject_cast<QDBusAbstractAdaptor *>(senderObj)) {
+        // a notify signal of a coalesced property is sent later, as part of PropertiesChanged
+        if (queuePropertyChange(adaptor, lastSignalIdx))
+            return;
+
         // it's an adaptor, so the real object is in fact its parent
         realObject = realObject->parent();
+    }
 
     // break down the parameter list
     QVector<int> types;
@@ -333,6 +420,52 @@ void QDBusAdaptorConnector::relay(QObject *senderObj, int lastSignalIdx, void **
     emit relaySignal(realObject, senderMetaObject, lastSignalIdx, args);
 }
 
+bool QDBusAdaptorConnector::queuePropertyChange(QDBusAbstractAdaptor *adaptor, int signalIdx)
+{
+    QDBusAbstractAdaptorPrivate *d = static_cast<QDBusAbstractAdaptorPrivate *>(QObjectPrivate::get(adaptor));
+    if (d->propertyChangeInterval < 0)
+        return false;
+
+    const QMetaObject *mo = adaptor->metaObject();
+    bool found = false;
+    for (int idx = QDBusAbstractAdaptor::staticMetaObject.propertyCount(); idx < mo->propertyCount(); ++idx) {
+        const QMetaProperty mp = mo->property(idx);
+        if (mp.notifySignalIndex() != signalIdx || !mp.isReadable()
+                || !QDBusMetaType::typeToSignature(mp.userType()))
+            continue;
+        found = true;
+        if (!d->changedProperties.contains(idx))
+            d->changedProperties.append(idx);
+    }
+
+    if (found && !d->propertyChangeTimer->isActive())
+        d->propertyChangeTimer->start();
+    return found;
+}
+
+void QDBusAdaptorConnector::relayPropertiesChanged(QDBusAbstractAdaptor *adaptor)
+{
+    QDBusAbstractAdaptorPrivate *d = static_cast<QDBusAbstractAdaptorPrivate *>(QObjectPrivate::get(adaptor));
+    if (d->changedProperties.isEmpty())
+        return;
+
+    const QMetaObject *mo = adaptor->metaObject();
+    QVariantMap changed;
+    for (int idx : qAsConst(d->changedProperties)) {
+        const QMetaProperty mp = mo->property(idx);
+        changed.insert(QLatin1String(mp.name()), mp.read(adaptor));
+    }
+    d->changedProperties.clear();
+
+    const QMetaObject *relayMetaObject = &QDBusPropertiesChangedRelay::staticMetaObject;
+    static const int signalIdx = relayMetaObject->indexOfSignal(
+                "PropertiesChanged(QString,QVariantMap,QStringList)");
+
+    QVariantList args;
+    args << qDBusInterfaceFromMetaObject(mo) << changed << QStringList();
+    emit relaySignal(adaptor->parent(), relayMetaObject, signalIdx, args);
+}
+
 // our Meta Object
 // modify carefully: this has been hand-edited!
 // the relaySlot slot gets called with the void** array
@@ -449,4 +582,6 @@ void QDBusAdaptorConnector::relaySignal(QObject * _t1, const QMetaObject * _t2,
 
 QT_END_NAMESPACE
 
+#include "qdbusabstractadaptor.moc"
+
 #endif // QT_NO_DBUS
@@ -62,6 +62,9 @@ protected:
     void setAutoRelaySignals(bool enable);
     bool autoRelaySignals() const;
 
+    void setPropertyChangeInterval(int msec);
+    int propertyChangeInterval() const;
+
 private:
     Q_DECLARE_PRIVATE(QDBusAbstractAdaptor)
 };
@@ -72,15 +72,22 @@ class QDBusAbstractAdaptor;
 class QDBusAdaptorConnector;
 class QDBusAdaptorManager;
 class QDBusConnectionPrivate;
+class QTimer;
 
 class QDBusAbstractAdaptorPrivate: public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QDBusAbstractAdaptor)
 public:
-    QDBusAbstractAdaptorPrivate() : autoRelaySignals(false) {}
+    QDBusAbstractAdaptorPrivate() : autoRelaySignals(false), propertyChangeInterval(-1), propertyChangeTimer(0) {}
     QString xml;
     bool autoRelaySignals;
 
+    // properties whose notify signals are being coalesced into one
+    // PropertiesChanged emission, see setPropertyChangeInterval()
+    int propertyChangeInterval;
+    QVector<int> changedProperties;
+    QTimer *propertyChangeTimer;
+
     static QString retrieveIntrospectionXml(QDBusAbstractAdaptor *adaptor);
     static void saveIntrospectionXml(QDBusAbstractAdaptor *adaptor, const QString &xml);
 };
@@ -116,6 +123,8 @@ public: // methods
     void connectAllSignals(QObject *object);
     void disconnectAllSignals(QObject *object);
     void relay(QObject *sender, int id, void **);
+    bool queuePropertyChange(QDBusAbstractAdaptor *adaptor, int signalIdx);
+    void relayPropertiesChanged(QDBusAbstractAdaptor *adaptor);
 
 //public slots:
     void relaySlot(void **);
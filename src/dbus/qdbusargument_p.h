@@ -66,6 +66,29 @@ QT_BEGIN_NAMESPACE
 
 class QDBusMarshaller;
 class QDBusDemarshaller;
+
+// Returns the D-Bus element type of the QList types that are registered for
+// the fixed-size D-Bus types and can be transferred as one block, or
+// DBUS_TYPE_INVALID. QList<bool> is not one of them: dbus_bool_t is 32 bits wide.
+inline int qDBusFixedListElementType(int id)
+{
+    if (id == qMetaTypeId<QList<short> >())
+        return DBUS_TYPE_INT16;
+    if (id == qMetaTypeId<QList<ushort> >())
+        return DBUS_TYPE_UINT16;
+    if (id == qMetaTypeId<QList<int> >())
+        return DBUS_TYPE_INT32;
+    if (id == qMetaTypeId<QList<uint> >())
+        return DBUS_TYPE_UINT32;
+    if (id == qMetaTypeId<QList<qlonglong> >())
+        return DBUS_TYPE_INT64;
+    if (id == qMetaTypeId<QList<qulonglong> >())
+        return DBUS_TYPE_UINT64;
+    if (id == qMetaTypeId<QList<double> >())
+        return DBUS_TYPE_DOUBLE;
+    return DBUS_TYPE_INVALID;
+}
+
 class QDBusArgumentPrivate
 {
 public:
@@ -142,6 +165,7 @@ public:
 
     bool appendVariantInternal(const QVariant &arg);
     bool appendRegisteredType(const QVariant &arg);
+    bool appendFixedList(int id, const void *data);
     bool appendCrossMarshalling(QDBusDemarshaller *arg);
 
 public:
@@ -199,6 +223,7 @@ public:
     bool atEnd();
 
     QVariant toVariantInternal();
+    bool toFixedList(int id, void *data);
     QDBusArgument::ElementType currentType();
     bool isCurrentTypeStringLike();
 
@@ -356,6 +356,56 @@ QByteArray QDBusDemarshaller::toByteArray()
     return QByteArray();
 }
 
+template <typename T>
+static void qIterGetFixedList(DBusMessageIter *it, QList<T> *list)
+{
+    DBusMessageIter sub;
+    q_dbus_message_iter_recurse(it, &sub);
+    q_dbus_message_iter_next(it);
+    int len;
+    T *data;
+    q_dbus_message_iter_get_fixed_array(&sub, &data, &len);
+
+    list->clear();
+    list->reserve(len);
+    for (int i = 0; i < len; ++i)
+        list->append(data[i]);
+}
+
+bool QDBusDemarshaller::toFixedList(int id, void *data)
+{
+    const int type = qDBusFixedListElementType(id);
+    if (type == DBUS_TYPE_INVALID
+            || q_dbus_message_iter_get_arg_type(&iterator) != DBUS_TYPE_ARRAY
+            || q_dbus_message_iter_get_element_type(&iterator) != type)
+        return false;
+
+    switch (type) {
+    case DBUS_TYPE_INT16:
+        qIterGetFixedList(&iterator, static_cast<QList<short> *>(data));
+        break;
+    case DBUS_TYPE_UINT16:
+        qIterGetFixedList(&iterator, static_cast<QList<ushort> *>(data));
+        break;
+    case DBUS_TYPE_INT32:
+        qIterGetFixedList(&iterator, static_cast<QList<int> *>(data));
+        break;
+    case DBUS_TYPE_UINT32:
+        qIterGetFixedList(&iterator, static_cast<QList<uint> *>(data));
+        break;
+    case DBUS_TYPE_INT64:
+        qIterGetFixedList(&iterator, static_cast<QList<qlonglong> *>(data));
+        break;
+    case DBUS_TYPE_UINT64:
+        qIterGetFixedList(&iterator, static_cast<QList<qulonglong> *>(data));
+        break;
+    case DBUS_TYPE_DOUBLE:
+        qIterGetFixedList(&iterator, static_cast<QList<double> *>(data));
+        break;
+    }
+    return true;
+}
+
 bool QDBusDemarshaller::atEnd()
 {
     // dbus_message_iter_has_next is broken if the list has one single element
@@ -524,8 +524,70 @@ bool QDBusMarshaller::appendVariantInternal(const QVariant &arg)
     return true;
 }
 
+template <typename T>
+static void qIterAppendFixedList(DBusMessageIter *it, int type, const QList<T> &list)
+{
+    const char signature[2] = { char(type), 0 };
+    DBusMessageIter sub;
+    q_dbus_message_iter_open_container(it, DBUS_TYPE_ARRAY, signature, &sub);
+    if (sizeof(T) == sizeof(void *)) {
+        // QList stores these in place, so the elements are already contiguous
+        const T *data = list.isEmpty() ? 0 : &list.at(0);
+        q_dbus_message_iter_append_fixed_array(&sub, type, &data, list.size());
+    } else {
+        const QVector<T> copy = list.toVector();
+        const T *data = copy.constData();
+        q_dbus_message_iter_append_fixed_array(&sub, type, &data, copy.size());
+    }
+    q_dbus_message_iter_close_container(it, &sub);
+}
+
+bool QDBusMarshaller::appendFixedList(int id, const void *data)
+{
+    const int type = qDBusFixedListElementType(id);
+    if (type == DBUS_TYPE_INVALID)
+        return false;
+
+    if (ba) {
+        if (!skipSignature) {
+            *ba += DBUS_TYPE_ARRAY_AS_STRING;
+            *ba += char(type);
+        }
+        return true;
+    }
+
+    switch (type) {
+    case DBUS_TYPE_INT16:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<short> *>(data));
+        break;
+    case DBUS_TYPE_UINT16:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<ushort> *>(data));
+        break;
+    case DBUS_TYPE_INT32:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<int> *>(data));
+        break;
+    case DBUS_TYPE_UINT32:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<uint> *>(data));
+        break;
+    case DBUS_TYPE_INT64:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<qlonglong> *>(data));
+        break;
+    case DBUS_TYPE_UINT64:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<qulonglong> *>(data));
+        break;
+    case DBUS_TYPE_DOUBLE:
+        qIterAppendFixedList(&iterator, type, *static_cast<const QList<double> *>(data));
+        break;
+    }
+    return true;
+}
+
 bool QDBusMarshaller::appendRegisteredType(const QVariant &arg)
 {
+    // arrays of fixed-size types are written in one go
+    if (appendFixedList(arg.userType(), arg.constData()))
+        return true;
+
     ref.ref();                  // reference up
     QDBusArgument self(QDBusArgumentPrivate::create(this));
     return QDBusMetaType::marshall(self, arg.userType(), arg.constData());
@@ -276,6 +276,17 @@ bool QDBusMetaType::demarshall(const QDBusArgument &arg, int id, void *data)
     }
 #ifndef QT_BOOTSTRAPPED
     QDBusArgument copy = arg;
+    QDBusArgumentPrivate *d = QDBusArgumentPrivate::d(copy);
+    if (qDBusFixedListElementType(id) != DBUS_TYPE_INVALID
+            && d && d->direction == QDBusArgumentPrivate::Demarshalling && d->message) {
+        // arrays of fixed-size types are read in one go; work on a copy of
+        // the iterator, as the user function would after detaching
+        QDBusDemarshaller fixed(d->capabilities);
+        fixed.message = q_dbus_message_ref(d->message);
+        fixed.iterator = d->demarshaller()->iterator;
+        if (fixed.toFixedList(id, data))
+            return true;
+    }
     df(copy, data);
 #else
     Q_UNUSED(arg);
@@ -40,8 +40,23 @@
 
 #include "qdbusunixfiledescriptor.h"
 
+#include <qdir.h>
+#include <qfile.h>
+
 #ifdef Q_OS_UNIX
 # include <private/qcore_unix_p.h>
+# include <sys/mman.h>
+# include <limits.h>
+# include <stdlib.h>
+# if defined(Q_OS_LINUX)
+#  include <sys/syscall.h>
+#  ifndef MFD_CLOEXEC
+#   define MFD_CLOEXEC          0x0001U
+#  endif
+#  ifndef MFD_ALLOW_SEALING
+#   define MFD_ALLOW_SEALING    0x0002U
+#  endif
+# endif
 #endif
 
 QT_BEGIN_NAMESPACE
@@ -99,6 +114,15 @@ QT_BEGIN_NAMESPACE
     invalid state and QDBusUnixFileDescriptor::isSupported() will return
     false.
 
+    \section2 Passing Large Payloads
+
+    Large blocks of data, such as images or file contents, can be passed
+    without copying them through the D-Bus message. fromData() stores the
+    data in an anonymous memory file and returns a descriptor for it; the
+    receiver calls mappedData() to map that file into its address space.
+    Only the descriptor itself travels over the connection, so the cost of
+    the call no longer depends on the size of the payload.
+
     \sa QDBusConnection::ConnectionCapabilities, QDBusConnection::connectionCapabilities()
 */
 
@@ -112,15 +136,26 @@ QT_BEGIN_NAMESPACE
     \internal
 */
 
+struct QDBusUnixFileDescriptorMapping
+{
+    void *address;
+    size_t size;
+    QByteArray copy; // the contents of files that may change, instead of a mapping
+};
+
 class QDBusUnixFileDescriptorPrivate : public QSharedData {
 public:
-    QDBusUnixFileDescriptorPrivate() : fd(-1) { }
+    QDBusUnixFileDescriptorPrivate() : fd(-1), mapping(0) { }
     QDBusUnixFileDescriptorPrivate(const QDBusUnixFileDescriptorPrivate &other)
-        : QSharedData(other), fd(-1)
+        : QSharedData(other), fd(-1), mapping(0)
     {  }
     ~QDBusUnixFileDescriptorPrivate();
 
+    void unmap();
+    static void release(QDBusUnixFileDescriptorMapping *m);
+
     QAtomicInt fd;
+    QAtomicPointer<QDBusUnixFileDescriptorMapping> mapping;
 };
 
 template<> inline
@@ -286,6 +321,7 @@ void QDBusUnixFileDescriptor::giveFileDescriptor(int fileDescriptor)
     const int fdl = d->fd.load();
     if (fdl != -1)
         qt_safe_close(fdl);
+    d->unmap();
 
     if (fileDescriptor != -1)
         d->fd.store(fileDescriptor);
@@ -307,11 +343,181 @@ int QDBusUnixFileDescriptor::takeFileDescriptor()
     return d->fd.fetchAndStoreRelaxed(-1);
 }
 
+static int createAnonymousFile()
+{
+#if defined(Q_OS_LINUX) && defined(SYS_memfd_create)
+    const int fd = int(syscall(SYS_memfd_create, "qt_dbus_data", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd != -1)
+        return fd;
+#endif
+
+    // no memfd support: fall back to an unlinked temporary file
+    QByteArray path = QFile::encodeName(QDir::tempPath()) + "/qt_dbus_data-XXXXXX";
+    const int tmpfd = ::mkstemp(path.data());
+    if (tmpfd == -1)
+        return -1;
+    ::unlink(path.constData());
+    ::fcntl(tmpfd, F_SETFD, FD_CLOEXEC);
+    return tmpfd;
+}
+
+/*!
+    \since 5.9
+
+    Creates an anonymous memory file containing a copy of \a data and
+    returns a QDBusUnixFileDescriptor holding it. Sending the returned
+    object over D-Bus transfers only the file descriptor; the receiver can
+    access the contents with mappedData() without another copy being made.
+
+    On Linux the file is created with \c memfd_create(2) and sealed against
+    further modification, so a receiver can rely on its size and contents
+    staying the same. On other Unix systems an unlinked temporary file is
+    used instead.
+
+    Returns an invalid QDBusUnixFileDescriptor if the file could not be
+    created.
+
+    \sa mappedData(), isSupported()
+*/
+QDBusUnixFileDescriptor QDBusUnixFileDescriptor::fromData(const QByteArray &data)
+{
+    const int fd = createAnonymousFile();
+    if (fd == -1)
+        return QDBusUnixFileDescriptor();
+
+    const char *ptr = data.constData();
+    qint64 left = data.size();
+    while (left > 0) {
+        const qint64 written = qt_safe_write(fd, ptr, left);
+        if (written <= 0) {
+            qt_safe_close(fd);
+            return QDBusUnixFileDescriptor();
+        }
+        ptr += written;
+        left -= written;
+    }
+
+#ifdef F_ADD_SEALS
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+
+    QDBusUnixFileDescriptor result;
+    result.giveFileDescriptor(fd);
+    return result;
+}
+
+// Returns true if the contents of the file can neither shrink nor change,
+// so that it is safe to map it.
+static bool isSealedAgainstChanges(int fd)
+{
+#ifdef F_GET_SEALS
+    const int seals = ::fcntl(fd, F_GET_SEALS);
+    return seals != -1 && (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) == (F_SEAL_SHRINK | F_SEAL_WRITE);
+#else
+    Q_UNUSED(fd);
+    return false;
+#endif
+}
+
+// Reads up to size bytes from the start of the file, without moving its
+// offset, which is shared with the sender.
+static QByteArray readContents(int fd, int size)
+{
+    QByteArray contents(size, Qt::Uninitialized);
+    int done = 0;
+    while (done < size) {
+        ssize_t r;
+        EINTR_LOOP(r, ::pread(fd, contents.data() + done, size - done, done));
+        if (r <= 0)
+            break;
+        done += int(r);
+    }
+    contents.resize(done);
+    return contents;
+}
+
+/*!
+    \since 5.9
+
+    Maps the file referred to by this object into memory and returns its
+    contents. No data is copied: the returned QByteArray refers directly to
+    the mapped pages, which remain valid for as long as this object or a
+    copy of it sharing the same file descriptor exists, and no other file
+    descriptor is set on it. Detach the array (for example by modifying it)
+    if you need to keep the data for longer.
+
+    The file is only mapped if it is sealed against being shrunk and
+    written to, as descriptors created with fromData() on Linux are, since
+    accessing a mapping of a file that its sender truncates would crash the
+    process. The contents of other files are read into memory once
+    instead. Either way, the data is shared between copies of this object.
+
+    Returns an empty QByteArray if the descriptor is invalid, the file is
+    empty or larger than a QByteArray can hold, or it cannot be mapped.
+
+    \sa fromData()
+*/
+QByteArray QDBusUnixFileDescriptor::mappedData() const
+{
+    if (!isValid())
+        return QByteArray();
+
+    QDBusUnixFileDescriptorMapping *mapping = d->mapping.loadAcquire();
+    if (!mapping) {
+        QT_STATBUF st;
+        if (QT_FSTAT(d->fd.load(), &st) == -1 || st.st_size <= 0 || st.st_size > INT_MAX)
+            return QByteArray();
+
+        QDBusUnixFileDescriptorMapping *created = new QDBusUnixFileDescriptorMapping;
+        if (isSealedAgainstChanges(d->fd.load())) {
+            created->size = size_t(st.st_size);
+            // a private mapping, since kernels before 6.7 refuse shared mappings
+            // of files sealed with F_SEAL_WRITE, even read-only ones
+            created->address = ::mmap(0, created->size, PROT_READ, MAP_PRIVATE, d->fd.load(), 0);
+            if (created->address == MAP_FAILED) {
+                delete created;
+                return QByteArray();
+            }
+        } else {
+            created->copy = readContents(d->fd.load(), int(st.st_size));
+            if (created->copy.isEmpty()) {
+                delete created;
+                return QByteArray();
+            }
+            created->address = created->copy.data();
+            created->size = size_t(created->copy.size());
+        }
+
+        if (d->mapping.testAndSetOrdered(0, created, mapping)) {
+            mapping = created;
+        } else {
+            // another copy mapped it at the same time
+            QDBusUnixFileDescriptorPrivate::release(created);
+        }
+    }
+
+    return QByteArray::fromRawData(static_cast<const char *>(mapping->address), int(mapping->size));
+}
+
+void QDBusUnixFileDescriptorPrivate::release(QDBusUnixFileDescriptorMapping *m)
+{
+    if (m->copy.isNull())
+        ::munmap(m->address, m->size);
+    delete m;
+}
+
+void QDBusUnixFileDescriptorPrivate::unmap()
+{
+    if (QDBusUnixFileDescriptorMapping *m = mapping.fetchAndStoreAcquire(0))
+        release(m);
+}
+
 QDBusUnixFileDescriptorPrivate::~QDBusUnixFileDescriptorPrivate()
 {
     const int fdl = fd.load();
     if (fdl != -1)
         qt_safe_close(fdl);
+    unmap();
 }
 
 #else
@@ -333,6 +539,20 @@ int QDBusUnixFileDescriptor::takeFileDescriptor()
     return -1;
 }
 
+QDBusUnixFileDescriptor QDBusUnixFileDescriptor::fromData(const QByteArray &)
+{
+    return QDBusUnixFileDescriptor();
+}
+
+QByteArray QDBusUnixFileDescriptor::mappedData() const
+{
+    return QByteArray();
+}
+
+void QDBusUnixFileDescriptorPrivate::unmap()
+{
+}
+
 QDBusUnixFileDescriptorPrivate::~QDBusUnixFileDescriptorPrivate()
 {
 }
@@ -41,6 +41,7 @@
 #ifndef QDBUSUNIXFILEDESCRIPTOR_H
 #define QDBUSUNIXFILEDESCRIPTOR_H
 
+#include <QtCore/qbytearray.h>
 #include <QtCore/qshareddata.h>
 #include <QtDBus/qdbusmacros.h>
 
@@ -80,6 +81,9 @@ public:
 
     static bool isSupported();
 
+    static QDBusUnixFileDescriptor fromData(const QByteArray &data);
+    QByteArray mappedData() const;
+
 protected:
     typedef QExplicitlySharedDataPointer<QDBusUnixFileDescriptorPrivate>  Data;
     Data d;
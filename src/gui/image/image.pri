@@ -21,6 +21,7 @@ HEADERS += \
         image/qpixmap_blitter_p.h \
         image/qpixmapcache.h \
         image/qpixmapcache_p.h \
+        image/qsharedimagecache_p.h \
         image/qplatformpixmap.h \
         image/qimagepixmapcleanuphooks_p.h \
         image/qicon.h \
@@ -41,6 +42,7 @@ SOURCES += \
         image/qpictureformatplugin.cpp \
         image/qpixmap.cpp \
         image/qpixmapcache.cpp \
+        image/qsharedimagecache.cpp \
         image/qplatformpixmap.cpp \
         image/qmovie.cpp \
         image/qpixmap_raster.cpp \
@@ -114,6 +114,7 @@ bool QPicturePaintEngine::begin(QPaintDevice *pd)
              << (qint32) r.height();
     }
     d->pic_d->trecs = 0;
+    d->pic_d->recordBounds.clear();
     d->s << (quint32)d->pic_d->trecs; // total number of records
     d->pic_d->formatOk = false;
     setActive(true);
@@ -369,6 +370,44 @@ void QPicturePaintEngine::writeCmdLength(int pos, const QRectF &r, bool corr)
             }
         }
     }
+
+    if (corr || r.width() > 0.0 || r.height() > 0.0)
+        setRecordBounds(r, corr);
+}
+
+/*!
+    \internal
+
+    Stores conservative device bounds of the command recorded last, derived
+    from \a r in logical coordinates. If \a stroked is true, the bounds are
+    grown by the extent of the current pen. \a margin grows them by a fixed
+    amount in logical coordinates.
+
+    Commands without bounds are assumed to possibly touch any pixel.
+*/
+void QPicturePaintEngine::setRecordBounds(const QRectF &r, bool stroked, qreal margin)
+{
+    Q_D(QPicturePaintEngine);
+    const QPen &pen = painter()->pen();
+    qreal deviceMargin = 2; // antialiasing and rounding to whole pixels
+    if (stroked && pen.style() != Qt::NoPen) {
+        qreal extent = qMax(pen.widthF(), qreal(1)) / 2;
+        if (pen.joinStyle() == Qt::MiterJoin || pen.joinStyle() == Qt::SvgMiterJoin)
+            extent *= qMax(pen.miterLimit(), qreal(M_SQRT2));
+        else
+            extent *= M_SQRT2; // square caps
+        if (pen.isCosmetic())
+            deviceMargin += extent;
+        else
+            margin += extent;
+    }
+
+    QRectF br = painter()->transform().mapRect(r.adjusted(-margin, -margin, margin, margin));
+    br.adjust(-deviceMargin, -deviceMargin, deviceMargin, deviceMargin);
+
+    QVector<QRect> &bounds = d->pic_d->recordBounds;
+    bounds.resize(d->pic_d->trecs);
+    bounds.last() = br.toAlignedRect();
 }
 
 void QPicturePaintEngine::drawEllipse(const QRectF &rect)
@@ -383,6 +422,47 @@ void QPicturePaintEngine::drawEllipse(const QRectF &rect)
     writeCmdLength(pos, rect, true);
 }
 
+void QPicturePaintEngine::drawLines(const QLineF *lines, int lineCount)
+{
+    Q_D(QPicturePaintEngine);
+#ifdef QT_PICTURE_DEBUG
+    qDebug() << " -> drawLines(): count=" << lineCount;
+#endif
+    // older formats store lines with integer coordinates
+    if (d->pic_d->formatMajor <= 5) {
+        QPaintEngine::drawLines(lines, lineCount);
+        return;
+    }
+
+    // Recording lines as lines rather than as polylines lets the replaying
+    // engine draw them exactly as it would have drawn them directly.
+    for (int i = 0; i < lineCount; ++i) {
+        int pos;
+        SERIALIZE_CMD(QPicturePrivate::PdcDrawLine);
+        d->s << lines[i].p1() << lines[i].p2();
+        writeCmdLength(pos, QRectF(lines[i].p1(), lines[i].p2()).normalized(), true);
+    }
+}
+
+void QPicturePaintEngine::drawPoints(const QPointF *points, int pointCount)
+{
+    Q_D(QPicturePaintEngine);
+#ifdef QT_PICTURE_DEBUG
+    qDebug() << " -> drawPoints(): count=" << pointCount;
+#endif
+    if (d->pic_d->formatMajor <= 5) {
+        QPaintEngine::drawPoints(points, pointCount);
+        return;
+    }
+
+    for (int i = 0; i < pointCount; ++i) {
+        int pos;
+        SERIALIZE_CMD(QPicturePrivate::PdcDrawPoint);
+        d->s << points[i];
+        writeCmdLength(pos, QRectF(points[i], QSizeF()), true);
+    }
+}
+
 void QPicturePaintEngine::drawPath(const QPainterPath &path)
 {
     Q_D(QPicturePaintEngine);
@@ -501,6 +581,11 @@ void QPicturePaintEngine::drawTextItem(const QPointF &p , const QTextItem &ti)
 
         d->s << p << ti.text() << fnt << ti.renderFlags() << double(fnt.d->dpi)/qt_defaultDpi() << justificationWidth;
         writeCmdLength(pos, /*brect=*/QRectF(), /*corr=*/false);
+        // The text is laid out again on playback, so allow a line height
+        // around it for overhangs and decorations.
+        const qreal lineHeight = ti.ascent() + ti.descent();
+        setRecordBounds(QRectF(p.x(), p.y() - ti.ascent(), ti.width(), lineHeight),
+                        /*stroked=*/false, /*margin=*/lineHeight);
     } else if (d->pic_d->formatMajor >= 8) {
         // old old (buggy) format
         int pos;
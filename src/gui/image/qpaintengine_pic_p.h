@@ -87,6 +87,10 @@ public:
     void updateOpacity(qreal opacity);
 
     void drawEllipse(const QRectF &rect) Q_DECL_OVERRIDE;
+    void drawLines(const QLineF *lines, int lineCount) Q_DECL_OVERRIDE;
+    using QPaintEngine::drawLines;
+    void drawPoints(const QPointF *points, int pointCount) Q_DECL_OVERRIDE;
+    using QPaintEngine::drawPoints;
     void drawPath(const QPainterPath &path) Q_DECL_OVERRIDE;
     void drawPolygon(const QPointF *points, int numPoints, PolygonDrawMode mode) Q_DECL_OVERRIDE;
     using QPaintEngine::drawPolygon;
@@ -106,6 +110,7 @@ private:
     Q_DISABLE_COPY(QPicturePaintEngine)
 
     void writeCmdLength(int pos, const QRectF &r, bool corr);
+    void setRecordBounds(const QRectF &r, bool stroked, qreal margin = 0);
 };
 
 QT_END_NAMESPACE
@@ -248,6 +248,7 @@ void QPicture::setData(const char* data, uint size)
 {
     detach();
     d_func()->pictb.setData(data, size);
+    d_func()->recordBounds.clear();
     d_func()->resetFormat();                                // we'll have to check
 }
 
@@ -297,6 +298,7 @@ bool QPicture::load(QIODevice *dev, const char *format)
     QByteArray a = dev->readAll();
 
     d_func()->pictb.setData(a);                        // set byte array in buffer
+    d_func()->recordBounds.clear();
     return d_func()->checkFormat();
 }
 
@@ -1031,6 +1033,7 @@ QPicturePrivate::QPicturePrivate(const QPicturePrivate &other)
       formatMinor(other.formatMinor),
       brect(other.brect),
       override_rect(other.override_rect),
+      recordBounds(other.recordBounds),
       in_memory_only(false)
 {
     pictb.setData(other.pictb.data(), other.pictb.size());
@@ -1181,6 +1184,7 @@ QDataStream &operator>>(QDataStream &s, QPicture &r)
     }
 
     r.d_func()->pictb.setData(data);
+    r.d_func()->recordBounds.clear();
     r.d_func()->resetFormat();
     return s;
 }
@@ -155,6 +155,7 @@ public:
     int formatMinor;
     QRect brect;
     QRect override_rect;
+    QVector<QRect> recordBounds; // device bounds of recorded draw commands, by record
     QScopedPointer<QPaintEngine> paintEngine;
     bool in_memory_only;
     QVector<QImage> image_list;
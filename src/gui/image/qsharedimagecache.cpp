@@ -0,0 +1,666 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsharedimagecache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qthreadpool.h>
+
+#include <private/qimage_p.h>
+
+#include <algorithm>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QSharedImageCache
+    \internal
+    \inmodule QtGui
+
+    \brief The QSharedImageCache class is a thread-safe cache for QImage.
+
+    Unlike QPixmapCache, which may only be used from the GUI thread, this
+    cache can be shared by threads that render into QImage. The cache is
+    split into a number of shards, each protected by its own mutex and
+    holding its own least-recently-used QCache, so that lookups of different
+    keys rarely contend. The cache limit applies to all shards together:
+    any shard can hold an image up to the whole limit, and when an insertion
+    takes the cache over its limit, the least recently used images of the
+    other shards are evicted first. Like QPixmapCache, the cost of an image
+    and the cache limit are measured in kilobytes.
+
+    When a disk cache directory is set, inserted images are also written to
+    that directory as raw pixel data. On a miss in memory the file is mapped
+    and used as the image data directly, which lets later processes start
+    with a warm cache. Images with a color table are only kept in memory.
+
+    Files are written, and evicted once the disk cache grows beyond
+    diskCacheLimit(), by a single background thread, so insert() does not
+    wait for the disk. Until the write has finished, the image is only
+    available from memory.
+*/
+
+class QSharedImageCacheShard
+{
+public:
+    QSharedImageCacheShard() : hits(0), misses(0), diskHits(0), insertions(0) {}
+
+    QMutex mutex;
+    QCache<QString, QImage> images;
+    qint64 hits;
+    qint64 misses;
+    qint64 diskHits;
+    qint64 insertions;
+};
+
+struct QSharedImageCacheFileHeader
+{
+    char magic[4];
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 format;
+    qint32 dotsPerMeterX;
+    qint32 dotsPerMeterY;
+    double devicePixelRatio;
+};
+
+// Keeps the pixel data that follows the header 32-bit aligned in the mapping.
+Q_STATIC_ASSERT(sizeof(QSharedImageCacheFileHeader) % 8 == 0);
+
+static const char diskCacheMagic[4] = { 'Q', 'S', 'I', 'C' };
+static const quint32 diskCacheVersion = 1;
+
+static inline int imageCost(const QImage &image)
+{
+    return qMax(1, image.byteCount() / 1024);
+}
+
+static bool writeDiskImage(const QString &path, const QImage &image)
+{
+    if (image.colorCount() > 0)
+        return false;
+
+    QSharedImageCacheFileHeader header;
+    memcpy(header.magic, diskCacheMagic, sizeof(header.magic));
+    header.version = diskCacheVersion;
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = image.bytesPerLine();
+    header.format = image.format();
+    header.dotsPerMeterX = image.dotsPerMeterX();
+    header.dotsPerMeterY = image.dotsPerMeterY();
+    header.devicePixelRatio = image.devicePixelRatio();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(image.constBits()), image.byteCount());
+    return file.commit();
+}
+
+static void unmapDiskImage(void *info)
+{
+    delete static_cast<QFile *>(info);
+}
+
+static QImage readDiskImage(const QString &path)
+{
+    QFile *file = new QFile(path);
+    const qint64 size = file->open(QIODevice::ReadOnly) ? file->size() : 0;
+    uchar *data = size > qint64(sizeof(QSharedImageCacheFileHeader)) ? file->map(0, size) : 0;
+    if (!data) {
+        delete file;
+        return QImage();
+    }
+
+    const QSharedImageCacheFileHeader *header = reinterpret_cast<const QSharedImageCacheFileHeader *>(data);
+    if (memcmp(header->magic, diskCacheMagic, sizeof(header->magic)) != 0
+        || header->version != diskCacheVersion
+        || header->format <= QImage::Format_Invalid || header->format >= QImage::NImageFormats
+        || header->width <= 0 || header->height <= 0 || header->bytesPerLine <= 0
+        || size < qint64(sizeof(QSharedImageCacheFileHeader)) + qint64(header->bytesPerLine) * header->height) {
+        delete file;
+        return QImage();
+    }
+
+    // The image uses the mapping read-only, painting on it detaches.
+    const uchar *bits = data + sizeof(QSharedImageCacheFileHeader);
+    QImage image(bits, header->width, header->height, header->bytesPerLine,
+                 QImage::Format(header->format), unmapDiskImage, file);
+    if (image.isNull()) {
+        delete file;
+        return QImage();
+    }
+
+    // Set the metadata without detaching from the mapping.
+    QImageData *d = image.data_ptr();
+    d->dpmx = header->dotsPerMeterX;
+    d->dpmy = header->dotsPerMeterY;
+    d->devicePixelRatio = header->devicePixelRatio;
+    return image;
+}
+
+class QSharedImageCacheDisk
+{
+public:
+    enum Operation { Scan, Write, Remove, Trim };
+
+    struct Entry
+    {
+        qint64 size;
+        quint64 lastUse;
+    };
+
+    QSharedImageCacheDisk() : limit(102400), totalSize(0), clock(0)
+    {
+        // One thread keeps the operations on the directory in order.
+        pool.setMaxThreadCount(1);
+    }
+
+    void enqueue(Operation operation, const QString &path = QString(), const QImage &image = QImage());
+    void run(Operation operation, const QString &directory, const QString &path, const QImage &image);
+    void touch(const QString &path);
+
+    QThreadPool pool;
+
+    // The members below are protected by the mutex.
+    mutable QMutex mutex;
+    QString directory;
+    int limit;
+    qint64 totalSize;
+    quint64 clock;
+    QHash<QString, Entry> entries;
+    QMap<quint64, QString> leastRecentlyUsed;
+
+private:
+    void insertEntry(const QString &path, qint64 size, quint64 lastUse);
+    void removeEntry(const QString &path);
+    void trim();
+};
+
+class QSharedImageCacheDiskTask : public QRunnable
+{
+public:
+    QSharedImageCacheDiskTask(QSharedImageCacheDisk *disk, QSharedImageCacheDisk::Operation operation,
+                              const QString &directory, const QString &path, const QImage &image)
+        : m_disk(disk), m_operation(operation), m_directory(directory), m_path(path), m_image(image)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_disk->run(m_operation, m_directory, m_path, m_image);
+    }
+
+private:
+    QSharedImageCacheDisk *m_disk;
+    QSharedImageCacheDisk::Operation m_operation;
+    QString m_directory;
+    QString m_path;
+    QImage m_image;
+};
+
+void QSharedImageCacheDisk::enqueue(Operation operation, const QString &path, const QImage &image)
+{
+    QString dir;
+    {
+        QMutexLocker locker(&mutex);
+        dir = directory;
+    }
+    if (dir.isEmpty())
+        return;
+    // The task holds a shallow copy of the image, so the caller does not wait for the write.
+    pool.start(new QSharedImageCacheDiskTask(this, operation, dir, path, image));
+}
+
+void QSharedImageCacheDisk::run(Operation operation, const QString &dir, const QString &path, const QImage &image)
+{
+    qint64 size = 0;
+    switch (operation) {
+    case Scan: {
+        // Files left by earlier processes are evicted oldest first.
+        QVector<QPair<QDateTime, QPair<QString, qint64> > > files;
+        QDirIterator it(dir, QStringList(QStringLiteral("*.qsic")), QDir::Files);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            files.append(qMakePair(info.lastModified(), qMakePair(info.filePath(), info.size())));
+        }
+        std::sort(files.begin(), files.end());
+
+        QMutexLocker locker(&mutex);
+        if (directory != dir)
+            return;
+        entries.clear();
+        leastRecentlyUsed.clear();
+        totalSize = 0;
+        for (const auto &file : qAsConst(files))
+            insertEntry(file.second.first, file.second.second, ++clock);
+        break;
+    }
+    case Write: {
+        QMutexLocker locker(&mutex);
+        const bool fits = qint64(image.byteCount()) <= qint64(limit) * 1024;
+        locker.unlock();
+        if (fits && writeDiskImage(path, image)) {
+            size = QFileInfo(path).size();
+            locker.relock();
+            if (directory != dir)
+                return;
+            insertEntry(path, size, ++clock);
+            break;
+        }
+        // Do not leave an older image for the same key behind.
+        QFile::remove(path);
+        locker.relock();
+        removeEntry(path);
+        return;
+    }
+    case Remove:
+        QFile::remove(path);
+        {
+            QMutexLocker locker(&mutex);
+            removeEntry(path);
+        }
+        return;
+    case Trim:
+        break;
+    }
+    trim();
+}
+
+void QSharedImageCacheDisk::touch(const QString &path)
+{
+    QMutexLocker locker(&mutex);
+    const auto it = entries.find(path);
+    if (it == entries.end())
+        return;
+    leastRecentlyUsed.remove(it->lastUse);
+    it->lastUse = ++clock;
+    leastRecentlyUsed.insert(it->lastUse, path);
+}
+
+void QSharedImageCacheDisk::insertEntry(const QString &path, qint64 size, quint64 lastUse)
+{
+    removeEntry(path);
+    const Entry entry = { size, lastUse };
+    entries.insert(path, entry);
+    leastRecentlyUsed.insert(lastUse, path);
+    totalSize += size;
+}
+
+void QSharedImageCacheDisk::removeEntry(const QString &path)
+{
+    const auto it = entries.find(path);
+    if (it == entries.end())
+        return;
+    leastRecentlyUsed.remove(it->lastUse);
+    totalSize -= it->size;
+    entries.erase(it);
+}
+
+// Called on the disk thread only. Files are removed without holding the mutex.
+void QSharedImageCacheDisk::trim()
+{
+    QStringList victims;
+    {
+        QMutexLocker locker(&mutex);
+        while (totalSize > qint64(limit) * 1024 && !leastRecentlyUsed.isEmpty()) {
+            const QString path = leastRecentlyUsed.first();
+            removeEntry(path);
+            victims.append(path);
+        }
+    }
+    for (const QString &path : qAsConst(victims))
+        QFile::remove(path);
+}
+
+Q_GLOBAL_STATIC(QSharedImageCache, globalSharedImageCache)
+
+/*!
+    Constructs a cache holding up to \a cacheLimit kilobytes of images,
+    split into \a shardCount independently locked shards.
+*/
+QSharedImageCache::QSharedImageCache(int cacheLimit, int shardCount)
+    : m_cacheLimit(cacheLimit),
+      m_totalCost(0),
+      m_disk(new QSharedImageCacheDisk)
+{
+    m_shards.resize(qMax(1, shardCount));
+    for (int i = 0; i < m_shards.size(); ++i)
+        m_shards[i] = new QSharedImageCacheShard;
+    setCacheLimit(cacheLimit);
+}
+
+QSharedImageCache::~QSharedImageCache()
+{
+    m_disk->pool.waitForDone();
+    delete m_disk;
+    qDeleteAll(m_shards);
+}
+
+/*!
+    Returns the application-wide image cache.
+*/
+QSharedImageCache *QSharedImageCache::instance()
+{
+    return globalSharedImageCache();
+}
+
+/*!
+    Sets the in-memory cache limit to \a kbytes kilobytes, shared by all
+    shards. Least recently used images are evicted first.
+*/
+void QSharedImageCache::setCacheLimit(int kbytes)
+{
+    m_cacheLimit.store(kbytes);
+    const int limit = qMax(1, kbytes);
+    for (QSharedImageCacheShard *shard : qAsConst(m_shards)) {
+        QMutexLocker locker(&shard->mutex);
+        const int before = shard->images.totalCost();
+        shard->images.setMaxCost(limit);
+        m_totalCost.fetchAndAddRelaxed(shard->images.totalCost() - before);
+    }
+    trimToLimit(0);
+}
+
+/*!
+    Returns the in-memory cache limit in kilobytes.
+*/
+int QSharedImageCache::cacheLimit() const
+{
+    return m_cacheLimit.load();
+}
+
+/*!
+    Sets the directory used as the second cache level to \a path. An empty
+    path, the default, disables the disk cache. The directory is created if
+    it does not exist. Files already in the directory count towards
+    diskCacheLimit().
+*/
+void QSharedImageCache::setDiskCacheDirectory(const QString &path)
+{
+    if (!path.isEmpty())
+        QDir().mkpath(path);
+    {
+        QMutexLocker locker(&m_disk->mutex);
+        m_disk->directory = path;
+    }
+    m_disk->enqueue(QSharedImageCacheDisk::Scan);
+}
+
+/*!
+    Returns the directory used as the second cache level.
+*/
+QString QSharedImageCache::diskCacheDirectory() const
+{
+    QMutexLocker locker(&m_disk->mutex);
+    return m_disk->directory;
+}
+
+/*!
+    Sets the disk cache limit to \a kbytes kilobytes. The default is
+    100 MB. Least recently used files are removed first when the limit is
+    exceeded.
+*/
+void QSharedImageCache::setDiskCacheLimit(int kbytes)
+{
+    {
+        QMutexLocker locker(&m_disk->mutex);
+        m_disk->limit = kbytes;
+    }
+    m_disk->enqueue(QSharedImageCacheDisk::Trim);
+}
+
+/*!
+    Returns the disk cache limit in kilobytes.
+*/
+int QSharedImageCache::diskCacheLimit() const
+{
+    QMutexLocker locker(&m_disk->mutex);
+    return m_disk->limit;
+}
+
+/*!
+    Blocks until all pending writes to and removals from the disk cache
+    have finished.
+*/
+void QSharedImageCache::waitForDiskWrites()
+{
+    m_disk->pool.waitForDone();
+}
+
+/*!
+    Inserts a copy of \a image associated with \a key into the cache,
+    replacing any image already associated with \a key. Returns \c false if
+    the image is null or larger than the cache limit.
+*/
+bool QSharedImageCache::insert(const QString &key, const QImage &image)
+{
+    if (image.isNull())
+        return false;
+
+    QSharedImageCacheShard *shard = shardFor(key);
+    bool inserted;
+    {
+        QMutexLocker locker(&shard->mutex);
+        ++shard->insertions;
+        const int before = shard->images.totalCost();
+        inserted = shard->images.insert(key, new QImage(image), imageCost(image));
+        m_totalCost.fetchAndAddRelaxed(shard->images.totalCost() - before);
+    }
+    if (inserted)
+        trimToLimit(shard);
+
+    const QString path = diskCachePath(key);
+    if (!path.isEmpty() && image.colorCount() == 0)
+        m_disk->enqueue(QSharedImageCacheDisk::Write, path, image);
+    return inserted;
+}
+
+/*!
+    Looks up the image associated with \a key and, if found, assigns it to
+    \a image. Returns \c true if the image was found in memory or in the
+    disk cache.
+*/
+bool QSharedImageCache::find(const QString &key, QImage *image)
+{
+    QSharedImageCacheShard *shard = shardFor(key);
+    {
+        QMutexLocker locker(&shard->mutex);
+        if (const QImage *cached = shard->images.object(key)) {
+            ++shard->hits;
+            if (image)
+                *image = *cached;
+            return true;
+        }
+    }
+
+    // Map the image from disk without holding the shard lock.
+    const QString path = diskCachePath(key);
+    const QImage mapped = path.isEmpty() ? QImage() : readDiskImage(path);
+
+    QMutexLocker locker(&shard->mutex);
+    // Another thread may have inserted a newer image in the meantime.
+    if (const QImage *cached = shard->images.object(key)) {
+        ++shard->hits;
+        if (image)
+            *image = *cached;
+        return true;
+    }
+    if (mapped.isNull()) {
+        ++shard->misses;
+        return false;
+    }
+    ++shard->diskHits;
+    const int before = shard->images.totalCost();
+    const bool inserted = shard->images.insert(key, new QImage(mapped), imageCost(mapped));
+    m_totalCost.fetchAndAddRelaxed(shard->images.totalCost() - before);
+    locker.unlock();
+
+    if (inserted)
+        trimToLimit(shard);
+    m_disk->touch(path);
+    if (image)
+        *image = mapped;
+    return true;
+}
+
+/*!
+    Removes the image associated with \a key from memory and from the disk
+    cache.
+*/
+void QSharedImageCache::remove(const QString &key)
+{
+    QSharedImageCacheShard *shard = shardFor(key);
+    {
+        QMutexLocker locker(&shard->mutex);
+        const int before = shard->images.totalCost();
+        shard->images.remove(key);
+        m_totalCost.fetchAndAddRelaxed(shard->images.totalCost() - before);
+    }
+
+    // Remove the file right away so that find() misses, and again after
+    // any write of the same key that is still queued.
+    const QString path = diskCachePath(key);
+    if (!path.isEmpty()) {
+        QFile::remove(path);
+        m_disk->enqueue(QSharedImageCacheDisk::Remove, path);
+    }
+}
+
+/*!
+    Removes all images from memory. The disk cache is left untouched.
+*/
+void QSharedImageCache::clear()
+{
+    for (QSharedImageCacheShard *shard : qAsConst(m_shards)) {
+        QMutexLocker locker(&shard->mutex);
+        m_totalCost.fetchAndAddRelaxed(-shard->images.totalCost());
+        shard->images.clear();
+    }
+}
+
+/*!
+    Returns the hit and miss counters and the current memory usage, summed
+    over all shards, and the number and size in kilobytes of the files in
+    the disk cache.
+*/
+QSharedImageCache::Statistics QSharedImageCache::statistics() const
+{
+    Statistics stats;
+    for (QSharedImageCacheShard *shard : m_shards) {
+        QMutexLocker locker(&shard->mutex);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.diskHits += shard->diskHits;
+        stats.insertions += shard->insertions;
+        stats.count += shard->images.count();
+        stats.totalCost += shard->images.totalCost();
+    }
+    QMutexLocker locker(&m_disk->mutex);
+    stats.diskCount = m_disk->entries.size();
+    stats.diskCost = int(m_disk->totalSize / 1024);
+    return stats;
+}
+
+/*!
+    Resets the hit, miss and insertion counters to zero.
+*/
+void QSharedImageCache::resetStatistics()
+{
+    for (QSharedImageCacheShard *shard : qAsConst(m_shards)) {
+        QMutexLocker locker(&shard->mutex);
+        shard->hits = shard->misses = shard->diskHits = shard->insertions = 0;
+    }
+}
+
+QSharedImageCacheShard *QSharedImageCache::shardFor(const QString &key) const
+{
+    return m_shards.at(qHash(key) % uint(m_shards.size()));
+}
+
+// Evicts least recently used images until the shards together fit into the
+// cache limit, starting with the shard after the one an image was just
+// inserted into, so that shard, where the new image is the most recently
+// used one, comes last. Only one shard is locked at a time.
+void QSharedImageCache::trimToLimit(QSharedImageCacheShard *inserted)
+{
+    const int limit = m_cacheLimit.load();
+    const int count = m_shards.size();
+    const int first = inserted ? m_shards.indexOf(inserted) + 1 : 0;
+    for (int i = 0; i < count && m_totalCost.load() > limit; ++i) {
+        QSharedImageCacheShard *shard = m_shards.at((first + i) % count);
+        QMutexLocker locker(&shard->mutex);
+        const int before = shard->images.totalCost();
+        const int excess = m_totalCost.load() - limit;
+        if (excess <= 0 || before == 0)
+            continue;
+        // QCache evicts its least recently used objects to fit a lower maximum.
+        shard->images.setMaxCost(qMax(0, before - excess));
+        shard->images.setMaxCost(qMax(1, limit));
+        m_totalCost.fetchAndAddRelaxed(shard->images.totalCost() - before);
+    }
+}
+
+QString QSharedImageCache::diskCachePath(const QString &key) const
+{
+    const QString directory = diskCacheDirectory();
+    if (directory.isEmpty())
+        return QString();
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return directory + QLatin1Char('/') + QLatin1String(hash) + QLatin1String(".qsic");
+}
+
+QT_END_NAMESPACE
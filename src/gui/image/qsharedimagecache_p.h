@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSHAREDIMAGECACHE_P_H
+#define QSHAREDIMAGECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/qimage.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSharedImageCacheShard;
+class QSharedImageCacheDisk;
+
+class Q_GUI_EXPORT QSharedImageCache
+{
+public:
+    struct Statistics
+    {
+        Statistics()
+            : hits(0), misses(0), diskHits(0), insertions(0), count(0), totalCost(0),
+              diskCount(0), diskCost(0)
+        {}
+
+        qint64 hits;
+        qint64 misses;
+        qint64 diskHits;
+        qint64 insertions;
+        int count;
+        int totalCost;
+        int diskCount;
+        int diskCost;
+    };
+
+    explicit QSharedImageCache(int cacheLimit = 10240, int shardCount = 16);
+    ~QSharedImageCache();
+
+    static QSharedImageCache *instance();
+
+    void setCacheLimit(int kbytes);
+    int cacheLimit() const;
+    int shardCount() const { return m_shards.size(); }
+
+    void setDiskCacheDirectory(const QString &path);
+    QString diskCacheDirectory() const;
+    void setDiskCacheLimit(int kbytes);
+    int diskCacheLimit() const;
+    void waitForDiskWrites();
+
+    bool insert(const QString &key, const QImage &image);
+    bool find(const QString &key, QImage *image);
+    void remove(const QString &key);
+    void clear();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    Q_DISABLE_COPY(QSharedImageCache)
+
+    QSharedImageCacheShard *shardFor(const QString &key) const;
+    QString diskCachePath(const QString &key) const;
+    void trimToLimit(QSharedImageCacheShard *inserted);
+
+    QVector<QSharedImageCacheShard *> m_shards;
+    QAtomicInt m_cacheLimit;
+    QAtomicInt m_totalCost; // the sum of the total costs of the shards
+    QSharedImageCacheDisk *m_disk;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSHAREDIMAGECACHE_P_H
@@ -237,6 +237,10 @@ QPlatformServices *QPlatformIntegration::services() const
     is required to have this capability.
 
     \value ApplicationIcon The platform supports setting the application icon. (since 5.5)
+
+    \value ThreadedFontRendering The platform's font database and font engines can be
+    used to lay out and rasterize text outside the GUI thread, for instance when painting
+    onto a QImage. The default implementation returns \c true. (since 5.8)
  */
 
 /*!
@@ -260,7 +264,8 @@ QPlatformServices *QPlatformIntegration::services() const
 
 bool QPlatformIntegration::hasCapability(Capability cap) const
 {
-    return cap == NonFullScreenWindows || cap == NativeWidgets || cap == WindowManagement;
+    return cap == NonFullScreenWindows || cap == NativeWidgets || cap == WindowManagement
+        || cap == ThreadedFontRendering;
 }
 
 QPlatformPixmap *QPlatformIntegration::createPlatformPixmap(QPlatformPixmap::PixelType type) const
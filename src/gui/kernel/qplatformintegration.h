@@ -98,7 +98,8 @@ public:
         RasterGLSurface,
         AllGLFunctionsQueryable,
         ApplicationIcon,
-        SwitchableWidgetComposition
+        SwitchableWidgetComposition,
+        ThreadedFontRendering
     };
 
     virtual ~QPlatformIntegration() { }
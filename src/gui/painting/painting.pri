@@ -42,7 +42,9 @@ HEADERS += \
         painting/qpolygonclipper_p.h \
         painting/qrasterdefs_p.h \
         painting/qrasterizer_p.h \
+        painting/qrastertilerenderer_p.h \
         painting/qregion.h \
+        painting/qregion_p.h \
         painting/qrgb.h \
         painting/qrgba64.h \
         painting/qrgba64_p.h \
@@ -88,6 +90,7 @@ SOURCES += \
         painting/qpen.cpp \
         painting/qpolygon.cpp \
         painting/qrasterizer.cpp \
+        painting/qrastertilerenderer.cpp \
         painting/qregion.cpp \
         painting/qstroker.cpp \
         painting/qtextureglyphcache.cpp \
@@ -232,9 +232,12 @@ static StrokeLine strokeLine(int strokeSelection)
 
 void QCosmeticStroker::setup()
 {
+    // A rectangular clip, including the one of the device itself, is applied
+    // per pixel, so that lines come out the same with and without a clip.
     blend = state->penData.blend;
-    if (state->clip && state->clip->enabled && state->clip->hasRectClip && !state->clip->clipRect.isEmpty()) {
-        clip &= state->clip->clipRect;
+    const QClipData *clipData = state->penData.clip;
+    if (clipData && clipData->enabled && clipData->hasRectClip && !clipData->clipRect.isEmpty()) {
+        clip &= clipData->clipRect;
         blend = state->penData.unclipped_blend;
     }
 
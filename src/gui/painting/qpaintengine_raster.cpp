@@ -3470,6 +3470,7 @@ void QRasterPaintEnginePrivate::initializeRasterizer(QSpanData *data)
     }
 
     rasterizer->setClipRect(clipRect);
+    rasterizer->setDeviceRect(deviceRect);
     rasterizer->initialize(blend, data);
 }
 
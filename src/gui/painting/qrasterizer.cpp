@@ -201,6 +201,7 @@ public:
     ProcessSpans blend;
     void *data;
     QRect clipRect;
+    QRect deviceRect;
 
     QScanConverter scanConverter;
 };
@@ -667,6 +668,11 @@ void QRasterizer::setClipRect(const QRect &clipRect)
     d->clipRect = clipRect;
 }
 
+void QRasterizer::setDeviceRect(const QRect &deviceRect)
+{
+    d->deviceRect = deviceRect;
+}
+
 void QRasterizer::setLegacyRoundingEnabled(bool legacyRoundingEnabled)
 {
     d->legacyRounding = legacyRoundingEnabled;
@@ -769,8 +775,12 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
         pb += (0.5f * width) * delta;
     }
 
+    // The line is clipped against the device rather than the clip, so that
+    // clipping only drops pixels and never shifts the remaining ones.
+    const QRect bounds = d->deviceRect.isEmpty() ? d->clipRect : d->deviceRect;
+
     QPointF offs = QPointF(qAbs(b.y() - a.y()), qAbs(b.x() - a.x())) * width * 0.5;
-    const QRectF clip(d->clipRect.topLeft() - offs, d->clipRect.bottomRight() + QPoint(1, 1) + offs);
+    const QRectF clip(bounds.topLeft() - offs, bounds.bottomRight() + QPoint(1, 1) + offs);
 
     if (!clip.contains(pa) || !clip.contains(pb)) {
         qreal t1 = 0;
@@ -957,7 +967,10 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
         left = snapTo26Dot6Grid(left);
         right = snapTo26Dot6Grid(right);
 
-        const qreal topBound = qBound(qreal(d->clipRect.top()), top.y(), qreal(d->clipRect.bottom()));
+        if (bottom.y() < d->clipRect.top() || top.y() >= d->clipRect.bottom() + 1)
+            return;
+
+        const qreal topBound = qBound(qreal(bounds.top()), top.y(), qreal(d->clipRect.bottom()));
         const qreal bottomBound = qBound(qreal(d->clipRect.top()), bottom.y(), qreal(d->clipRect.bottom()));
 
         const QPointF topLeftEdge = left - top;
@@ -1017,6 +1030,7 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
             topRightIntersectAf = rightIntersectAf +
                                   Q16Dot16Multiply(topRightSlopeFP, rowTop - iTopFP);
 
+            const Q16Dot16 clipTopFP = IntToQ16Dot16(d->clipRect.top());
             Q16Dot16 yFP = iTopFP;
             while (yFP <= iBottomFP) {
                 rowBottomLeft = qMin(yFP + Q16Dot16Factor, yLeftFP);
@@ -1053,6 +1067,20 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
                     bottomRightIntersectBf = rightIntersectBf + bottomRightSlopeFP;
                 }
 
+                if (yFP < clipTopFP) {
+                    // rows above the clip only advance the edges
+                    leftIntersectAf += topLeftSlopeFP;
+                    leftIntersectBf += bottomLeftSlopeFP;
+                    rightIntersectAf += topRightSlopeFP;
+                    rightIntersectBf += bottomRightSlopeFP;
+                    topLeftIntersectAf = leftIntersectAf;
+                    topRightIntersectAf = rightIntersectAf;
+
+                    yFP += Q16Dot16Factor;
+                    rowTop = yFP;
+                    continue;
+                }
+
                 if (yFP < iLeftFP) {
                     leftMin = Q16Dot16ToInt(bottomLeftIntersectAf);
                     leftMax = Q16Dot16ToInt(topLeftIntersectAf);
@@ -72,6 +72,7 @@ public:
 
     void setAntialiased(bool antialiased);
     void setClipRect(const QRect &clipRect);
+    void setDeviceRect(const QRect &deviceRect);
     void setLegacyRoundingEnabled(bool legacyRoundingEnabled);
 
     void initialize(ProcessSpans blend, void *data);
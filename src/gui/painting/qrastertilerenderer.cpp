@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qrastertilerenderer_p.h"
+
+#ifndef QT_NO_PICTURE
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qpainter.h>
+
+#include <qpa/qplatformintegration.h>
+
+#include <private/qguiapplication_p.h>
+#include <private/qpicture_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QRasterTileRenderer
+    \internal
+    \inmodule QtGui
+
+    \brief The QRasterTileRenderer class replays recorded painter commands
+    into a QImage using several threads.
+
+    Painting done on device() is recorded into a QPicture. When flush() is
+    called, the target image is split into horizontal bands and the recorded
+    commands are replayed once per band, each clipped to its band, on the
+    global QThreadPool. Each band replays the state changes in their original
+    order, but only those drawing commands whose recorded bounds intersect
+    it. Since the raster engine clips per pixel without otherwise changing
+    how primitives are rasterized, the result is identical to replaying the
+    picture on a single thread.
+
+    Recordings that modify the clip themselves, recordings that draw text
+    when the platform does not support threaded font rendering, images with a
+    device pixel ratio other than 1 and images that are too small to benefit
+    are replayed immediately on the calling thread instead.
+*/
+
+// Tiling is not worth the cost of decoding the command stream several times
+// for small images.
+static const int minimumTiledArea = 256 * 256;
+static const int minimumBandHeight = 32;
+
+// Scans the records of a picture. If \a bands is not empty, the recording is
+// also split into one picture per band, each holding the state changing
+// records and only those drawing records whose bounds intersect the band.
+//
+// The renderer installs its own clip for each band. Any recorded command that
+// replaces or disables the clip would let a band paint outside of its rows,
+// so such pictures are always replayed immediately.
+enum PictureScanResult {
+    PictureCanBeTiled,
+    PictureModifiesClip,
+    PictureIsInvalid
+};
+
+static PictureScanResult scanPicture(const QPicture &picture, bool *drawsText,
+                                     const QVector<QRect> &bands = QVector<QRect>(),
+                                     QVector<QByteArray> *bandData = Q_NULLPTR)
+{
+    const QByteArray data = QByteArray::fromRawData(picture.data(), picture.size());
+    QDataStream s(data);
+
+    char tag[4];
+    if (s.readRawData(tag, 4) != 4 || memcmp(tag, "QPIC", 4) != 0)
+        return PictureIsInvalid;
+
+    quint16 checksum, major, minor;
+    s >> checksum >> major >> minor;
+    s.setVersion(major != 4 ? major : 3);
+
+    quint8 c, clen;
+    s >> c >> clen;
+    if (c != QPicturePrivate::PdcBegin)
+        return PictureIsInvalid;
+    if (!(major >= 1 && major <= 3)) {
+        qint32 dummy;
+        s >> dummy >> dummy >> dummy >> dummy;
+    }
+
+    quint32 nrecords;
+    s >> nrecords;
+    const int headerSize = int(s.device()->pos());
+    if (bandData)
+        bandData->fill(data.left(headerSize), bands.size());
+    QVector<quint32> bandRecords(bands.size());
+
+    const QVector<QRect> &recordBounds = const_cast<QPicture &>(picture).data_ptr()->recordBounds;
+    *drawsText = false;
+    for (int i = 0; quint32(i) < nrecords && !s.atEnd(); ++i) {
+        const int recordStart = int(s.device()->pos());
+        quint8 tinyLength;
+        qint32 length;
+        s >> c >> tinyLength;
+        if (tinyLength == 255)
+            s >> length;
+        else
+            length = tinyLength;
+
+        switch (c) {
+        case QPicturePrivate::PdcSetClip:
+        case QPicturePrivate::PdcSetClipRegion:
+        case QPicturePrivate::PdcSetClipPath:
+        case QPicturePrivate::PdcSetClipEnabled:
+            return PictureModifiesClip;
+        case QPicturePrivate::PdcDrawText:
+        case QPicturePrivate::PdcDrawTextFormatted:
+        case QPicturePrivate::PdcDrawText2:
+        case QPicturePrivate::PdcDrawText2Formatted:
+        case QPicturePrivate::PdcDrawTextItem:
+            *drawsText = true;
+            break;
+        default:
+            break;
+        }
+
+        if (length < 0 || s.skipRawData(length) != length)
+            return PictureIsInvalid;
+
+        if (!bandData)
+            continue;
+        const int recordEnd = int(s.device()->pos());
+        const QRect bounds = i < recordBounds.size() ? recordBounds.at(i) : QRect();
+        for (int b = 0; b < bands.size(); ++b) {
+            if (bounds.isNull() || bounds.intersects(bands.at(b))) {
+                (*bandData)[b].append(data.constData() + recordStart, recordEnd - recordStart);
+                ++bandRecords[b];
+            }
+        }
+    }
+    if (s.status() != QDataStream::Ok)
+        return PictureIsInvalid;
+
+    if (bandData) {
+        // patch the record count and the checksum of every band
+        const int recordCountPos = headerSize - int(sizeof(quint32));
+        const int checksumPos = 4;
+        const int dataStart = checksumPos + int(sizeof(quint16));
+        for (int b = 0; b < bands.size(); ++b) {
+            QByteArray &band = (*bandData)[b];
+            QDataStream out(&band, QIODevice::WriteOnly);
+            out.device()->seek(recordCountPos);
+            out << bandRecords.at(b);
+            out.device()->seek(checksumPos);
+            out << quint16(qChecksum(band.constData() + dataStart, band.size() - dataStart));
+        }
+    }
+    return PictureCanBeTiled;
+}
+
+static bool playPicture(const QPicture &picture, QImage *image, const QRect &clip = QRect())
+{
+    QPicture copy(picture);
+    QPainter painter(image);
+    if (!clip.isNull())
+        painter.setClipRect(clip);
+    return copy.play(&painter);
+}
+
+#ifndef QT_NO_THREAD
+
+class QRasterTileRenderTask : public QRunnable
+{
+public:
+    QRasterTileRenderTask(const QByteArray &data, const QImage &image, const QRect &band,
+                          QSemaphore *done, QAtomicInt *failures)
+        : m_data(data), m_image(image), m_band(band), m_done(done), m_failures(failures)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        // QPicture::play() is not reentrant on a shared picture, so every
+        // band decodes its own stream, holding only the commands it needs.
+        QPicture picture;
+        picture.setData(m_data.constData(), m_data.size());
+        if (!playPicture(picture, &m_image, m_band))
+            m_failures->ref();
+        m_done->release();
+    }
+
+private:
+    QByteArray m_data;
+    QImage m_image;
+    QRect m_band;
+    QSemaphore *m_done;
+    QAtomicInt *m_failures;
+};
+
+// Text is laid out and rasterized on the threads replaying it, which is only
+// safe when the platform's font engines allow it.
+static bool supportsThreadedFontRendering()
+{
+    const QPlatformIntegration *integration = QGuiApplicationPrivate::platformIntegration();
+    return integration && integration->hasCapability(QPlatformIntegration::ThreadedFontRendering);
+}
+
+// Returns an image that paints directly into the pixels of \a image without
+// sharing its data, so that each band can own a separate paint engine.
+static QImage bandDevice(const QImage &image, uchar *bits)
+{
+    QImage device(bits, image.width(), image.height(), image.bytesPerLine(), image.format());
+    if (image.colorCount())
+        device.setColorTable(image.colorTable());
+    device.setDotsPerMeterX(image.dotsPerMeterX());
+    device.setDotsPerMeterY(image.dotsPerMeterY());
+    return device;
+}
+
+#endif // QT_NO_THREAD
+
+/*!
+    Constructs a renderer that replays into \a target when flushed.
+*/
+QRasterTileRenderer::QRasterTileRenderer(QImage *target)
+    : m_target(target),
+      m_bandCount(0),
+      m_lastFlushWasTiled(false)
+{
+}
+
+/*!
+    Flushes any pending commands and destroys the renderer.
+*/
+QRasterTileRenderer::~QRasterTileRenderer()
+{
+    if (!m_picture.isNull() && !m_picture.paintingActive())
+        flush();
+}
+
+/*!
+    \fn QPaintDevice *QRasterTileRenderer::device()
+
+    Returns the paint device recording the commands to be replayed on the
+    next flush().
+*/
+
+/*!
+    \fn void QRasterTileRenderer::setBandCount(int count)
+
+    Sets the number of bands the target is split into to \a count. A value of
+    0, the default, picks a band count based on the image size and the
+    maximum thread count of the global thread pool.
+*/
+
+/*!
+    Replays the commands recorded since the last flush into the target image
+    and clears the recording. Returns \c false if the recording could not be
+    replayed.
+
+    The painter operating on device() must have been ended.
+*/
+bool QRasterTileRenderer::flush()
+{
+    m_lastFlushWasTiled = false;
+    if (m_picture.paintingActive()) {
+        qWarning("QRasterTileRenderer::flush: Painter on the recording device is still active");
+        return false;
+    }
+    if (m_picture.isNull())
+        return true;
+
+    const bool ok = render(m_picture, m_target, m_bandCount, &m_lastFlushWasTiled);
+    m_picture = QPicture();
+    return ok;
+}
+
+/*!
+    Returns \c true if \a picture can be replayed into \a image band by band
+    with the same result as replaying it in one go.
+*/
+bool QRasterTileRenderer::canRenderTiled(const QPicture &picture, const QImage &image)
+{
+    if (image.isNull() || image.paintingActive() || image.devicePixelRatio() != 1.0)
+        return false;
+    if (picture.isNull() || picture.paintingActive())
+        return false;
+    bool drawsText;
+    return scanPicture(picture, &drawsText) == PictureCanBeTiled;
+}
+
+/*!
+    Returns the number of bands \a image would be split into by default.
+*/
+int QRasterTileRenderer::autoBandCount(const QImage &image)
+{
+#ifndef QT_NO_THREAD
+    if (qint64(image.width()) * image.height() < minimumTiledArea)
+        return 1;
+    const int count = qMin(QThreadPool::globalInstance()->maxThreadCount(),
+                           image.height() / minimumBandHeight);
+    return qMax(1, count);
+#else
+    Q_UNUSED(image);
+    return 1;
+#endif
+}
+
+/*!
+    Replays \a picture into \a image, splitting the image into \a bandCount
+    horizontal bands that are rendered in parallel. If \a bandCount is 0 the
+    count is chosen by autoBandCount().
+
+    If \a tiled is not null, it is set to whether the picture was actually
+    rendered in bands rather than immediately on the calling thread.
+*/
+bool QRasterTileRenderer::render(const QPicture &picture, QImage *image, int bandCount, bool *tiled)
+{
+    if (tiled)
+        *tiled = false;
+    if (!image || image->isNull())
+        return false;
+    if (picture.isNull())
+        return true;
+
+#ifndef QT_NO_THREAD
+    if (bandCount <= 0)
+        bandCount = autoBandCount(*image);
+    bandCount = qMin(bandCount, image->height());
+
+    const bool canTile = bandCount > 1 && !image->paintingActive() && image->devicePixelRatio() == 1.0
+            && !picture.paintingActive();
+
+    QVector<QRect> bands;
+    if (canTile) {
+        int y = 0;
+        for (int i = 0; i < bandCount; ++i) {
+            const int bandHeight = (image->height() - y) / (bandCount - i);
+            bands.append(QRect(0, y, image->width(), bandHeight));
+            y += bandHeight;
+        }
+    }
+
+    bool drawsText = false;
+    QVector<QByteArray> bandData;
+    if (canTile && scanPicture(picture, &drawsText, bands, &bandData) == PictureCanBeTiled
+        && (!drawsText || supportsThreadedFontRendering())) {
+        if (tiled)
+            *tiled = true;
+
+        uchar *bits = image->bits(); // detach before handing out the pixels
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore done;
+        QAtomicInt failures;
+
+        for (int i = 0; i < bandCount; ++i) {
+            QRasterTileRenderTask *task =
+                    new QRasterTileRenderTask(bandData.at(i), bandDevice(*image, bits), bands.at(i),
+                                              &done, &failures);
+            // The last band is rendered by the calling thread. Running bands
+            // inline when the pool is busy also avoids deadlocking when
+            // called from a pool thread.
+            if (i == bandCount - 1 || !pool->tryStart(task)) {
+                task->run();
+                delete task;
+            }
+        }
+        done.acquire(bandCount);
+        return failures.load() == 0;
+    }
+#else
+    Q_UNUSED(bandCount);
+#endif
+
+    return playPicture(picture, image);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_PICTURE
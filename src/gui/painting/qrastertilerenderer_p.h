@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QRASTERTILERENDERER_P_H
+#define QRASTERTILERENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/qimage.h>
+#include <QtGui/qpicture.h>
+
+#ifndef QT_NO_PICTURE
+
+QT_BEGIN_NAMESPACE
+
+class Q_GUI_EXPORT QRasterTileRenderer
+{
+public:
+    explicit QRasterTileRenderer(QImage *target);
+    ~QRasterTileRenderer();
+
+    QPaintDevice *device() { return &m_picture; }
+
+    void setBandCount(int count) { m_bandCount = count; }
+    int bandCount() const { return m_bandCount; }
+
+    bool flush();
+    bool lastFlushWasTiled() const { return m_lastFlushWasTiled; }
+
+    static bool canRenderTiled(const QPicture &picture, const QImage &image);
+    static int autoBandCount(const QImage &image);
+    static bool render(const QPicture &picture, QImage *image, int bandCount = 0,
+                       bool *tiled = Q_NULLPTR);
+
+private:
+    Q_DISABLE_COPY(QRasterTileRenderer)
+
+    QImage *m_target;
+    QPicture m_picture;
+    int m_bandCount;
+    bool m_lastFlushWasTiled;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_PICTURE
+
+#endif // QRASTERTILERENDERER_P_H
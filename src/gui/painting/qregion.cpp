@@ -47,7 +47,12 @@
 #include "qimage.h"
 #include "qbitmap.h"
 
+#include "qregion_p.h"
+
 #include <private/qdebug_p.h>
+#include <private/qsimd_p.h>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
@@ -4340,6 +4345,151 @@ bool qt_region_strictContains(const QRegion &region, const QRect &rect)
             && rect.top() >= r1.top() && rect.bottom() <= r1.bottom());
 }
 
+/*!
+    \class QRegionAccumulator
+    \inmodule QtGui
+    \internal
+
+    \brief The QRegionAccumulator class collects rectangles and unites them
+    into a QRegion in a single pass.
+
+    Uniting rectangles into a QRegion one at a time rebuilds the region's
+    bands for every rectangle, which gets quadratic when a widget receives
+    many small updates before it is repainted. The accumulator only appends
+    rectangles, dropping those that one of the most recently added
+    rectangles already covers, and region() sorts them by band before
+    uniting them all at once.
+
+    When many rectangles are pending and they cover most of their bounding
+    rectangle, region() returns the bounding rectangle instead: painting a
+    few extra pixels is cheaper than clipping to, and flushing, each
+    rectangle separately.
+*/
+
+// Number of recently added rectangles checked for containment by add().
+static const int QRegionAccumulatorLookBehind = 8;
+// Minimum number of rectangles before region() considers the bounding rect.
+static const int QRegionAccumulatorMinimumFallbackCount = 16;
+// Per-rectangle overhead of a region, expressed in pixels painted.
+static const int QRegionAccumulatorRectCost = 32 * 32;
+// Maximum number of append-only regions region() builds before merging.
+static const int QRegionAccumulatorMaximumRuns = 32;
+
+static inline bool qt_rect_contains(const QRect &outer, const QRect &inner)
+{
+#ifdef __SSE2__
+    // QRect stores x1, y1, x2, y2: compare the four coordinates at once.
+    Q_STATIC_ASSERT(sizeof(QRect) == sizeof(__m128i));
+    const __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&outer));
+    const __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&inner));
+    // x1 and y1 must not be smaller, x2 and y2 must not be larger.
+    const __m128i outside = _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(_mm_cmpgt_epi32(i, o)),
+                                                         _mm_castsi128_pd(_mm_cmplt_epi32(i, o))));
+    return _mm_movemask_epi8(outside) == 0;
+#else
+    return inner.left() >= outer.left() && inner.top() >= outer.top()
+        && inner.right() <= outer.right() && inner.bottom() <= outer.bottom();
+#endif
+}
+
+/*!
+    \internal
+
+    Adds \a rect to the accumulated area. Empty rectangles are ignored.
+*/
+void QRegionAccumulator::add(const QRect &rect)
+{
+    if (rect.isEmpty())
+        return;
+
+    // The same widget area is often updated repeatedly.
+    const QRect *end = rects.constEnd();
+    for (const QRect *it = end - qMin(rects.size(), QRegionAccumulatorLookBehind); it != end; ++it) {
+        if (qt_rect_contains(*it, rect))
+            return;
+    }
+
+    rects.append(rect);
+    bounds |= rect;
+    area += qint64(rect.width()) * rect.height();
+}
+
+/*!
+    \internal
+
+    Adds the rectangles of \a region to the accumulated area.
+*/
+void QRegionAccumulator::add(const QRegion &region)
+{
+    for (const QRect &rect : region)
+        add(rect);
+}
+
+/*!
+    \internal
+
+    Returns the union of the accumulated rectangles, or their bounding
+    rectangle if that is estimated to be cheaper to paint.
+*/
+QRegion QRegionAccumulator::region() const
+{
+    const int n = rects.size();
+    if (n == 0)
+        return QRegion();
+    if (n == 1)
+        return QRegion(rects.first());
+
+    // The summed area overestimates the covered area when rectangles
+    // overlap, which only makes the fallback more likely.
+    if (n >= QRegionAccumulatorMinimumFallbackCount
+        && qint64(bounds.width()) * bounds.height() <= area + qint64(n) * QRegionAccumulatorRectCost) {
+        return QRegion(bounds);
+    }
+
+    const auto byBand = [](const QRect &a, const QRect &b) {
+        return a.top() < b.top() || (a.top() == b.top() && a.left() < b.left());
+    };
+    QVector<QRect> sorted = rects;
+    if (!std::is_sorted(sorted.constBegin(), sorted.constEnd(), byBand))
+        std::sort(sorted.begin(), sorted.end(), byBand);
+
+    // Distribute the sorted rectangles over a few regions that are only
+    // ever appended to, which QRegion does in constant time, and then merge
+    // those regions pairwise.
+    QVarLengthArray<QRegion, QRegionAccumulatorMaximumRuns> level;
+    QVarLengthArray<QRect, QRegionAccumulatorMaximumRuns> lastRects;
+    for (const QRect &rect : qAsConst(sorted)) {
+        int i = 0;
+        while (i < level.size()) {
+            const QRect &last = lastRects.at(i);
+            if (rect.top() > level.at(i).boundingRect().bottom()
+                || (rect.top() == last.top() && rect.height() == last.height()
+                    && rect.left() > last.right())) {
+                break;
+            }
+            ++i;
+        }
+        if (i == level.size()) {
+            if (level.size() < QRegionAccumulatorMaximumRuns) {
+                level.append(QRegion(rect));
+                lastRects.append(rect);
+                continue;
+            }
+            --i; // a regular union
+        }
+        level[i] += rect;
+        lastRects[i] = rect;
+    }
+
+    while (level.size() > 1) {
+        int j = 0;
+        for (int i = 0; i < level.size(); i += 2)
+            level[j++] = i + 1 < level.size() ? level.at(i).united(level.at(i + 1)) : level.at(i);
+        level.resize(j);
+    }
+    return level.first();
+}
+
 QVector<QRect> QRegion::rects() const
 {
     if (d->qt_rgn) {
@@ -1778,6 +1778,22 @@ quint64 Selector::pseudoClass(quint64 *negated) const
 
 ///////////////////////////////////////////////////////////////////////////////
 // StyleSheet
+// Returns the first ".class" style attribute selector of \a sel, if any.
+// Such a selector can only match nodes whose space separated "class"
+// attribute contains the selector value, so the rule can be looked up
+// by that value instead of being tried against every node.
+static const AttributeSelector *indexableClassSelector(const BasicSelector &sel)
+{
+    for (int i = 0; i < sel.attributeSelectors.count(); ++i) {
+        const AttributeSelector &a = sel.attributeSelectors.at(i);
+        if (a.valueMatchCriterium == AttributeSelector::MatchContains
+            && a.name == QLatin1String("class")
+            && !a.value.isEmpty() && !a.value.contains(QLatin1Char(' ')))
+            return &a;
+    }
+    return 0;
+}
+
 void StyleSheet::buildIndexes(Qt::CaseSensitivity nameCaseSensitivity)
 {
     QVector<StyleRule> universals;
@@ -1814,6 +1830,12 @@ void StyleSheet::buildIndexes(Qt::CaseSensitivity nameCaseSensitivity)
                 if (nameCaseSensitivity == Qt::CaseInsensitive)
                     name=name.toLower();
                 nameIndex.insert(name, nr);
+            } else if (const AttributeSelector *classSel = indexableClassSelector(sel)) {
+                StyleRule nr;
+                nr.selectors += selector;
+                nr.declarations = rule.declarations;
+                nr.order = i;
+                classIndex.insert(classSel->value, nr);
             } else {
                 universalsSelectors += selector;
             }
@@ -2001,6 +2023,18 @@ QVector<StyleRule> StyleSelector::styleRulesForNode(NodePtr node)
                 }
             }
         }
+        if (!styleSheet.classIndex.isEmpty() && hasAttributes(node)) {
+            QStringList classes = attribute(node, QLatin1String("class")).split(QLatin1Char(' '), QString::SkipEmptyParts);
+            classes.removeDuplicates();
+            for (int i = 0; i < classes.count(); i++) {
+                const QString &key = classes.at(i);
+                QMultiHash<QString, StyleRule>::const_iterator it = styleSheet.classIndex.constFind(key);
+                while (it != styleSheet.classIndex.constEnd() && it.key() == key) {
+                    matchRule(node, it.value(), styleSheet.origin, styleSheet.depth, &weightedRules);
+                    ++it;
+                }
+            }
+        }
         if (!medium.isEmpty()) {
             for (int i = 0; i < styleSheet.mediaRules.count(); ++i) {
                 if (styleSheet.mediaRules.at(i).media.contains(medium, Qt::CaseInsensitive)) {
@@ -43,6 +43,7 @@
 #include "qvariant.h"
 #include "qfontengine_ft_p.h"
 #include "private/qimage_p.h"
+#include "private/qsharedglyphcache_p.h"
 #include <private/qstringiterator_p.h>
 
 #ifndef QT_NO_FREETYPE
@@ -923,6 +924,39 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
     if (transform || (format != Format_Mono && !isScalableBitmap()))
         load_flags |= FT_LOAD_NO_BITMAP;
 
+    // Other engines for the same face, possibly in other threads, may have
+    // rendered this glyph already. The cache is gone during static destruction.
+    QSharedGlyphCache *sharedCache = QSharedGlyphCache::instance();
+    QByteArray sharedKey;
+    if (sharedCache && sharedCache->isEnabled() && !fetchMetricsOnly && !(set && set->outline_drawing))
+        sharedKey = sharedGlyphCacheKey(glyph, subPixelPosition, format, load_flags, matrix);
+    if (!sharedKey.isEmpty()) {
+        QSharedGlyphCache::Glyph cached;
+        if (sharedCache->find(sharedKey, &cached)) {
+            if (!g) {
+                g = new Glyph;
+                g->data = 0;
+            }
+            g->linearAdvance = cached.linearAdvance;
+            g->width = cached.width;
+            g->height = cached.height;
+            g->x = cached.x;
+            g->y = cached.y;
+            g->advance = cached.advance;
+            g->format = cached.format;
+            delete [] g->data;
+            g->data = 0;
+            if (!cached.data.isEmpty()) {
+                g->data = new uchar[cached.data.size()];
+                memcpy(g->data, cached.data.constData(), cached.data.size());
+            }
+
+            if (set)
+                set->setGlyph(glyph, subPixelPosition, g);
+            return g;
+        }
+    }
+
     FT_Error err = FT_Load_Glyph(face, glyph, load_flags);
     if (err && (load_flags & FT_LOAD_NO_BITMAP)) {
         load_flags &= ~FT_LOAD_NO_BITMAP;
@@ -1245,12 +1279,60 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
     delete [] g->data;
     g->data = glyph_buffer.take();
 
+    if (!sharedKey.isEmpty()) {
+        QSharedGlyphCache::Glyph shared;
+        shared.linearAdvance = g->linearAdvance;
+        shared.width = g->width;
+        shared.height = g->height;
+        shared.x = g->x;
+        shared.y = g->y;
+        shared.advance = g->advance;
+        shared.format = g->format;
+        if (g->data)
+            shared.data = QByteArray(reinterpret_cast<const char *>(g->data), glyph_buffer_size);
+        sharedCache->insert(sharedKey, shared);
+    }
+
     if (set)
         set->setGlyph(glyph, subPixelPosition, g);
 
     return g;
 }
 
+QByteArray QFontEngineFT::sharedGlyphCacheKey(uint glyph, QFixed subPixelPosition, GlyphFormat format,
+                                              int loadFlags, const FT_Matrix &matrix) const
+{
+    // Fonts that cannot be identified across engines are not shared.
+    if (face_id.filename.isEmpty() && face_id.uuid.isEmpty())
+        return QByteArray();
+
+    const qint32 fields[] = {
+        qint32(face_id.index),
+        qint32(xsize),
+        qint32(ysize),
+        qint32(glyph),
+        qint32(subPixelPosition.value()),
+        qint32(format),
+        qint32(loadFlags),
+        qint32(matrix.xx),
+        qint32(matrix.xy),
+        qint32(matrix.yx),
+        qint32(matrix.yy),
+        qint32(embolden) | qint32(obliquen) << 1 | qint32(antialias) << 2,
+        qint32(subpixelType),
+        qint32(lcdFilterType)
+    };
+
+    QByteArray key;
+    key.reserve(face_id.filename.size() + face_id.uuid.size() + 2 + int(sizeof(fields)));
+    key += face_id.filename;
+    key += '\0';
+    key += face_id.uuid;
+    key += '\0';
+    key.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+    return key;
+}
+
 QFontEngine::FaceId QFontEngineFT::faceId() const
 {
     return face_id;
@@ -320,6 +320,8 @@ private:
     friend class QFontEngineMultiFontConfig;
 
     int loadFlags(QGlyphSet *set, GlyphFormat format, int flags, bool &hsubpixel, int &vfactor) const;
+    QByteArray sharedGlyphCacheKey(uint glyph, QFixed subPixelPosition, GlyphFormat format,
+                                   int loadFlags, const FT_Matrix &matrix) const;
     bool shouldUseDesignMetrics(ShaperFlags flags) const;
     QFixed scaledBitmapMetrics(QFixed m) const;
     glyph_metrics_t scaledBitmapMetrics(const glyph_metrics_t &m) const;
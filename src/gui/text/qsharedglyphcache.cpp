@@ -0,0 +1,211 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsharedglyphcache_p.h"
+
+#include <QtCore/qcache.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QSharedGlyphCache
+    \internal
+    \inmodule QtGui
+
+    \brief The QSharedGlyphCache class is a process-wide, thread-safe cache
+    of rasterized glyphs.
+
+    Font engines keep their rasterized glyphs per engine instance, and the
+    font cache creates separate engine instances for every thread. Threads
+    rendering the same fonts therefore rasterize the same glyphs over and
+    over. A font engine can consult this cache before rasterizing a glyph,
+    using a key that identifies the font file, size, rendering options,
+    transformation, subpixel position and glyph index.
+
+    Entries are spread over a number of shards that each have their own
+    mutex and least-recently-used QCache, costed in bytes. The limit is
+    given in kilobytes.
+
+    Consulting the cache costs a key computation and a mutex per glyph
+    that the engine's own cache misses, which only pays off when several
+    threads render the same fonts. The shared instance is therefore
+    disabled unless the \c QT_SHARED_GLYPH_CACHE_LIMIT environment
+    variable sets a limit, or setCacheLimit() is called on it.
+*/
+
+class QSharedGlyphCacheShard
+{
+public:
+    QSharedGlyphCacheShard() : hits(0), misses(0) {}
+
+    QMutex mutex;
+    QCache<QByteArray, QSharedGlyphCache::Glyph> glyphs;
+    qint64 hits;
+    qint64 misses;
+};
+
+Q_GLOBAL_STATIC(QSharedGlyphCache, globalSharedGlyphCache)
+
+/*!
+    Constructs a cache holding up to \a cacheLimit kilobytes of glyph data,
+    split into \a shardCount independently locked shards.
+*/
+QSharedGlyphCache::QSharedGlyphCache(int cacheLimit, int shardCount)
+    : m_cacheLimit(0)
+{
+    m_shards.resize(qMax(1, shardCount));
+    for (int i = 0; i < m_shards.size(); ++i)
+        m_shards[i] = new QSharedGlyphCacheShard;
+    setCacheLimit(cacheLimit);
+}
+
+QSharedGlyphCache::~QSharedGlyphCache()
+{
+    qDeleteAll(m_shards);
+}
+
+/*!
+    Returns the cache shared by all font engines in the process, or
+    0 once it has been destroyed at exit.
+*/
+QSharedGlyphCache *QSharedGlyphCache::instance()
+{
+    return globalSharedGlyphCache();
+}
+
+/*!
+    Returns the cache limit in kilobytes used for the shared instance, 0
+    unless \c QT_SHARED_GLYPH_CACHE_LIMIT is set.
+*/
+int QSharedGlyphCache::defaultCacheLimit()
+{
+    bool ok = false;
+    const int limit = qEnvironmentVariableIntValue("QT_SHARED_GLYPH_CACHE_LIMIT", &ok);
+    return ok ? qMax(0, limit) : 0;
+}
+
+/*!
+    Sets the cache limit to \a kbytes kilobytes, divided evenly between the
+    shards. A limit of 0 disables the cache.
+*/
+void QSharedGlyphCache::setCacheLimit(int kbytes)
+{
+    const int limit = qMax(0, kbytes);
+    m_cacheLimit.store(limit);
+    // QCache costs are ints, so account in bytes up to a shard size of 2 GB
+    const qint64 shardLimit = qint64(limit) * 1024 / m_shards.size();
+    for (QSharedGlyphCacheShard *shard : qAsConst(m_shards)) {
+        QMutexLocker locker(&shard->mutex);
+        shard->glyphs.setMaxCost(int(qMin<qint64>(shardLimit, INT_MAX)));
+    }
+}
+
+/*!
+    Looks up the glyph stored for \a key and copies it to \a glyph. Returns
+    \c true if the glyph was found.
+*/
+bool QSharedGlyphCache::find(const QByteArray &key, Glyph *glyph)
+{
+    if (!isEnabled())
+        return false;
+
+    QSharedGlyphCacheShard *shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+    const Glyph *cached = shard->glyphs.object(key);
+    if (!cached) {
+        ++shard->misses;
+        return false;
+    }
+    ++shard->hits;
+    *glyph = *cached;
+    return true;
+}
+
+/*!
+    Stores a copy of \a glyph for \a key.
+*/
+void QSharedGlyphCache::insert(const QByteArray &key, const Glyph &glyph)
+{
+    if (!isEnabled())
+        return;
+
+    QSharedGlyphCacheShard *shard = shardFor(key);
+    const int cost = qMax(1, glyph.data.size() + key.size() + int(sizeof(Glyph)));
+    QMutexLocker locker(&shard->mutex);
+    shard->glyphs.insert(key, new Glyph(glyph), cost);
+}
+
+/*!
+    Removes all glyphs from the cache.
+*/
+void QSharedGlyphCache::clear()
+{
+    for (QSharedGlyphCacheShard *shard : qAsConst(m_shards)) {
+        QMutexLocker locker(&shard->mutex);
+        shard->glyphs.clear();
+    }
+}
+
+/*!
+    Returns the hit and miss counters and the current memory usage in
+    bytes, summed over all shards.
+*/
+QSharedGlyphCache::Statistics QSharedGlyphCache::statistics() const
+{
+    Statistics stats;
+    for (QSharedGlyphCacheShard *shard : m_shards) {
+        QMutexLocker locker(&shard->mutex);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.count += shard->glyphs.count();
+        stats.totalCost += shard->glyphs.totalCost();
+    }
+    return stats;
+}
+
+QSharedGlyphCacheShard *QSharedGlyphCache::shardFor(const QByteArray &key) const
+{
+    return m_shards.at(qHash(key) % uint(m_shards.size()));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSHAREDGLYPHCACHE_P_H
+#define QSHAREDGLYPHCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSharedGlyphCacheShard;
+
+class Q_GUI_EXPORT QSharedGlyphCache
+{
+public:
+    struct Glyph
+    {
+        Glyph() : linearAdvance(0), width(0), height(0), x(0), y(0), advance(0), format(0) {}
+
+        short linearAdvance;
+        unsigned short width;
+        unsigned short height;
+        short x;
+        short y;
+        short advance;
+        signed char format;
+        QByteArray data;
+    };
+
+    struct Statistics
+    {
+        Statistics() : hits(0), misses(0), count(0), totalCost(0) {}
+
+        qint64 hits;
+        qint64 misses;
+        int count;
+        int totalCost;
+    };
+
+    explicit QSharedGlyphCache(int cacheLimit = defaultCacheLimit(), int shardCount = 8);
+    ~QSharedGlyphCache();
+
+    static QSharedGlyphCache *instance();
+    static int defaultCacheLimit();
+
+    void setCacheLimit(int kbytes);
+    int cacheLimit() const { return m_cacheLimit.load(); }
+    bool isEnabled() const { return m_cacheLimit.load() > 0; }
+
+    bool find(const QByteArray &key, Glyph *glyph);
+    void insert(const QByteArray &key, const Glyph &glyph);
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    Q_DISABLE_COPY(QSharedGlyphCache)
+
+    QSharedGlyphCacheShard *shardFor(const QByteArray &key) const;
+
+    QVector<QSharedGlyphCacheShard *> m_shards;
+    QAtomicInt m_cacheLimit; // read without locking by find() and insert()
+};
+
+QT_END_NAMESPACE
+
+#endif // QSHAREDGLYPHCACHE_P_H
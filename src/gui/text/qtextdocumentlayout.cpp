@@ -461,6 +461,7 @@ public:
     mutable QBasicTimer sizeChangedTimer;
     uint showLayoutProgress : 1;
     uint insideDocumentChange : 1;
+    uint viewportDrivenLayout : 1;
 
     int lastPageCount;
     qreal idealWidth;
@@ -540,6 +541,7 @@ QTextDocumentLayoutPrivate::QTextDocumentLayoutPrivate()
 {
     showLayoutProgress = true;
     insideDocumentChange = false;
+    viewportDrivenLayout = false;
     idealWidth = 0;
     contentHasAlignment = false;
 }
@@ -2962,7 +2964,7 @@ void QTextDocumentLayout::documentChanged(int from, int oldLength, int length)
         updateRect = doLayout(from, oldLength, length);
     }
 
-    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1)
+    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1 && !d->viewportDrivenLayout)
         d->layoutTimer.start(10, this);
 
     d->insideDocumentChange = false;
@@ -3178,7 +3180,9 @@ void QTextDocumentLayoutPrivate::ensureLayoutedByPosition(int position) const
 void QTextDocumentLayoutPrivate::layoutStep() const
 {
     ensureLayoutedByPosition(currentLazyLayoutPosition + lazyLayoutStepSize);
-    lazyLayoutStepSize = qMin(200000, lazyLayoutStepSize * 2);
+    // when laying out on demand only, keep the steps small so that we don't
+    // lay out much more than what was asked for
+    lazyLayoutStepSize = qMin(viewportDrivenLayout ? 20000 : 200000, lazyLayoutStepSize * 2);
 }
 
 void QTextDocumentLayout::setCursorWidth(int width)
@@ -3357,6 +3361,40 @@ bool QTextDocumentLayout::contentHasAlignment() const
     return d->contentHasAlignment;
 }
 
+/*!
+    \internal
+
+    When \a enable is true, the layout stops completing itself in the
+    background after a document change. Only the parts that are drawn, hit
+    tested or otherwise queried get laid out, so that loading a large
+    document only pays for what is shown. documentSize() and pageCount()
+    still finish the layout.
+
+    QPlainTextDocumentLayout always works this way: it lays out a block
+    when the block is drawn or its bounding rect is asked for, and reports
+    its size in lines, so it has no equivalent setting.
+*/
+void QTextDocumentLayout::setViewportDrivenLayout(bool enable)
+{
+    Q_D(QTextDocumentLayout);
+    if (bool(d->viewportDrivenLayout) == enable)
+        return;
+    d->viewportDrivenLayout = enable;
+    if (enable) {
+        d->layoutTimer.stop();
+    } else {
+        d->lazyLayoutStepSize = 1000;
+        if (d->currentLazyLayoutPosition != -1)
+            d->layoutTimer.start(10, this);
+    }
+}
+
+bool QTextDocumentLayout::viewportDrivenLayout() const
+{
+    Q_D(const QTextDocumentLayout);
+    return d->viewportDrivenLayout;
+}
+
 qreal QTextDocumentLayoutPrivate::scaleToDevice(qreal value) const
 {
     if (!paintDevice)
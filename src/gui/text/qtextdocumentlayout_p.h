@@ -68,6 +68,7 @@ class Q_GUI_EXPORT QTextDocumentLayout : public QAbstractTextDocumentLayout
     Q_PROPERTY(int cursorWidth READ cursorWidth WRITE setCursorWidth)
     Q_PROPERTY(qreal idealWidth READ idealWidth)
     Q_PROPERTY(bool contentHasAlignment READ contentHasAlignment)
+    Q_PROPERTY(bool viewportDrivenLayout READ viewportDrivenLayout WRITE setViewportDrivenLayout)
 public:
     explicit QTextDocumentLayout(QTextDocument *doc);
 
@@ -102,6 +103,9 @@ public:
 
     bool contentHasAlignment() const;
 
+    void setViewportDrivenLayout(bool enable);
+    bool viewportDrivenLayout() const;
+
 protected:
     void documentChanged(int from, int oldLength, int length) Q_DECL_OVERRIDE;
     void resizeInlineObject(QTextInlineObject item, int posInDocument, const QTextFormat &format) Q_DECL_OVERRIDE;
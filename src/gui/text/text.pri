@@ -5,6 +5,7 @@ HEADERS += \
     text/qfontdatabase.h \
     text/qfontengine_p.h \
     text/qfontengineglyphcache_p.h \
+    text/qsharedglyphcache_p.h \
     text/qfontinfo.h \
     text/qfontmetrics.h \
     text/qfont_p.h \
@@ -49,6 +50,7 @@ SOURCES += \
     text/qfont.cpp \
     text/qfontengine.cpp \
     text/qfontengineglyphcache.cpp \
+    text/qsharedglyphcache.cpp \
     text/qfontsubset.cpp \
     text/qfontmetrics.cpp \
     text/qfontdatabase.cpp \
@@ -51,7 +51,10 @@
 
 QT_BEGIN_NAMESPACE
 
-QFbScreen::QFbScreen() : mUpdatePending(false), mCursor(0), mGeometry(), mDepth(16), mFormat(QImage::Format_RGB16), mScreenImage(0), mCompositePainter(0), mIsUpToDate(false)
+Q_LOGGING_CATEGORY(qLcFbScreen, "qt.qpa.fb")
+
+QFbScreen::QFbScreen() : mUpdatePending(false), mCursor(0), mGeometry(), mDepth(16), mFormat(QImage::Format_RGB16), mScreenImage(0), mBytesCopied(0), mCompositePainter(0), mIsUpToDate(false),
+    mLastFrameBytesCopied(0), mTotalBytesCopied(0), mFrameCount(0)
 {
 }
 
@@ -70,8 +73,16 @@ void QFbScreen::initializeCompositor()
 bool QFbScreen::event(QEvent *event)
 {
     if (event->type() == QEvent::UpdateRequest) {
-        doRedraw();
+        mBytesCopied = 0;
+        const QRegion touched = doRedraw();
         mUpdatePending = false;
+        if (!touched.isEmpty()) {
+            ++mFrameCount;
+            mLastFrameBytesCopied = mBytesCopied;
+            mTotalBytesCopied += mBytesCopied;
+            qCDebug(qLcFbScreen) << "frame" << mFrameCount << "copied" << mBytesCopied
+                                 << "bytes for" << touched.rectCount() << "rects" << touched.boundingRect();
+        }
         return true;
     }
     return QObject::event(event);
@@ -161,6 +172,16 @@ void QFbScreen::setDirty(const QRect &rect)
     scheduleUpdate();
 }
 
+void QFbScreen::setDirty(const QRegion &region)
+{
+    QRegion intersection = region.intersected(mGeometry);
+    if (intersection.isEmpty())
+        return;
+    QPoint screenOffset = mGeometry.topLeft();
+    mRepaintRegion += intersection.translated(-screenOffset);    // global to local translation
+    scheduleUpdate();
+}
+
 void QFbScreen::scheduleUpdate()
 {
     if (!mUpdatePending) {
@@ -217,10 +238,67 @@ void QFbScreen::generateRects()
     mIsUpToDate = true;
 }
 
-QRegion QFbScreen::doRedraw()
+// Composes the window stack from \a layer upwards into \a rect of the
+// screen image. Windows below the topmost opaque window covering the whole
+// rect are skipped, as is the background fill, and every window only
+// contributes the part of \a rect it actually overlaps.
+void QFbScreen::composeRect(const QRect &rect, int layer)
 {
-    QPoint screenOffset = mGeometry.topLeft();
+    const QPoint screenOffset = mGeometry.topLeft();
+    const int topLayer = layer == -1 ? mWindowStack.size() - 1 : layer;
+
+    int bottomLayer = -1;
+    for (int layerIndex = 0; layerIndex <= topLayer; ++layerIndex) {
+        QFbWindow *window = mWindowStack[layerIndex];
+        if (!window->window()->isVisible())
+            continue;
+        QFbBackingStore *backingStore = window->backingStore();
+        if (!backingStore)
+            continue;
+        const QImage image = backingStore->image();
+        const QRect windowRect = window->geometry().translated(-screenOffset);
+        if (!image.hasAlphaChannel()
+            && (windowRect & QRect(windowRect.topLeft(), image.size())).contains(rect)) {
+            bottomLayer = layerIndex;
+            break;
+        }
+    }
+
+    if (bottomLayer == -1) {
+        if (layer == -1) {
+            mCompositePainter->fillRect(rect, Qt::black);
+            mBytesCopied += qint64(rect.width()) * rect.height() * mScreenImage->depth() / 8;
+        }
+        bottomLayer = topLayer;
+    }
+
+    for (int layerIndex = bottomLayer; layerIndex != -1; layerIndex--) {
+        if (!mWindowStack[layerIndex]->window()->isVisible())
+            continue;
+        // if (mWindowStack[layerIndex]->isMinimized())
+        //     continue;
+
+        QRect windowRect = mWindowStack[layerIndex]->geometry().translated(-screenOffset);
+        QRect targetRect = rect & windowRect;
+        if (targetRect.isEmpty())
+            continue;
+        QRect windowIntersect = targetRect.translated(-windowRect.left(),
+                                                      -windowRect.top());
 
+        QFbBackingStore *backingStore = mWindowStack[layerIndex]->backingStore();
+
+        if (backingStore) {
+            backingStore->lock();
+            const QImage &image = backingStore->image();
+            mCompositePainter->drawImage(targetRect, image, windowIntersect);
+            mBytesCopied += qint64(targetRect.width()) * targetRect.height() * image.depth() / 8;
+            backingStore->unlock();
+        }
+    }
+}
+
+QRegion QFbScreen::doRedraw()
+{
     QRegion touchedRegion;
     if (mCursor && mCursor->isDirty() && mCursor->isOnScreen()) {
         QRect lastCursor = mCursor->dirtyRect();
@@ -251,43 +329,15 @@ QRegion QFbScreen::doRedraw()
             rectRegion -= intersect;
 
             // we only expect one rectangle, but defensive coding...
-            for (const QRect &rect : intersect) {
-                bool firstLayer = true;
-                if (layer == -1) {
-                    mCompositePainter->fillRect(rect, Qt::black);
-                    firstLayer = false;
-                    layer = mWindowStack.size() - 1;
-                }
-
-                for (int layerIndex = layer; layerIndex != -1; layerIndex--) {
-                    if (!mWindowStack[layerIndex]->window()->isVisible())
-                        continue;
-                    // if (mWindowStack[layerIndex]->isMinimized())
-                    //     continue;
-
-                    QRect windowRect = mWindowStack[layerIndex]->geometry().translated(-screenOffset);
-                    QRect windowIntersect = rect.translated(-windowRect.left(),
-                                                            -windowRect.top());
-
-
-                    QFbBackingStore *backingStore = mWindowStack[layerIndex]->backingStore();
-
-                    if (backingStore) {
-                        backingStore->lock();
-                        mCompositePainter->drawImage(rect, backingStore->image(), windowIntersect);
-                        backingStore->unlock();
-                    }
-                    if (firstLayer) {
-                        firstLayer = false;
-                    }
-                }
-            }
+            for (const QRect &rect : intersect)
+                composeRect(rect, layer);
         }
     }
 
     QRect cursorRect;
     if (mCursor && (mCursor->isDirty() || mRepaintRegion.intersects(mCursor->lastPainted()))) {
         cursorRect = mCursor->drawCursor(*mCompositePainter);
+        mBytesCopied += qint64(cursorRect.width()) * cursorRect.height() * mScreenImage->depth() / 8;
         touchedRegion += cursorRect;
     }
     touchedRegion += mRepaintRegion;
@@ -54,10 +54,13 @@
 #include <qpa/qplatformscreen.h>
 #include <QtCore/QTimer>
 #include <QtCore/QSize>
+#include <QtCore/QLoggingCategory>
 #include "qfbcursor_p.h"
 
 QT_BEGIN_NAMESPACE
 
+Q_DECLARE_LOGGING_CATEGORY(qLcFbScreen)
+
 class QFbWindow;
 class QFbCursor;
 class QPainter;
@@ -90,8 +93,13 @@ public:
 
     void scheduleUpdate();
 
+    qint64 bytesCopiedLastFrame() const { return mLastFrameBytesCopied; }
+    qint64 bytesCopiedTotal() const { return mTotalBytesCopied; }
+    int frameCount() const { return mFrameCount; }
+
 public slots:
     virtual void setDirty(const QRect &rect);
+    void setDirty(const QRegion &region);
     void setPhysicalSize(const QSize &size);
     void setGeometry(const QRect &rect);
 
@@ -114,9 +122,14 @@ protected:
     QSizeF mPhysicalSize;
     QImage *mScreenImage;
 
+    // pixel bytes copied while redrawing the current frame; subclasses add
+    // the bytes they blit from mScreenImage to the hardware
+    qint64 mBytesCopied;
+
 private:
     void invalidateRectCache() { mIsUpToDate = false; }
     void generateRects();
+    void composeRect(const QRect &rect, int layer);
 
     QPainter *mCompositePainter;
     QVector<QPair<QRect, int> > mCachedRects;
@@ -124,6 +137,10 @@ private:
 
     friend class QFbWindow;
     bool mIsUpToDate;
+
+    qint64 mLastFrameBytesCopied;
+    qint64 mTotalBytesCopied;
+    int mFrameCount;
 };
 
 QT_END_NAMESPACE
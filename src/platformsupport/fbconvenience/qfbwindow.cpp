@@ -122,11 +122,9 @@ void QFbWindow::repaint(const QRegion &region)
 {
     QRect currentGeometry = geometry();
 
-    QRect dirtyClient = region.boundingRect();
-    QRect dirtyRegion(currentGeometry.left() + dirtyClient.left(),
-                      currentGeometry.top() + dirtyClient.top(),
-                      dirtyClient.width(),
-                      dirtyClient.height());
+    // Only the flushed rects need to be composited, not their bounding rect
+    QRegion dirtyRegion = region.intersected(QRect(QPoint(), currentGeometry.size()));
+    dirtyRegion.translate(currentGeometry.topLeft());
     QRect mOldGeometryLocal = mOldGeometry;
     mOldGeometry = currentGeometry;
     // If this is a move, redraw the previous location
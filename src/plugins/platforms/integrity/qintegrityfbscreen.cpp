@@ -207,6 +207,7 @@ QRegion QIntegrityFbScreen::doRedraw()
             (uint32_t)rects[i].height()
         };
         mBlitter->drawImage(rects[i], *mScreenImage, rects[i]);
+        mBytesCopied += qint64(rects[i].width()) * rects[i].height() * mFbScreenImage.depth() / 8;
         gh_FB_expose(mFbh, &fbrect, NULL);
     }
     return touched;
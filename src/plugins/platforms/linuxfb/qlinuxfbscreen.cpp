@@ -412,8 +412,10 @@ QRegion QLinuxFbScreen::doRedraw()
     if (!mBlitter)
         mBlitter = new QPainter(&mFbScreenImage);
 
-    for (const QRect &rect : touched)
+    for (const QRect &rect : touched) {
         mBlitter->drawImage(rect, *mScreenImage, rect);
+        mBytesCopied += qint64(rect.width()) * rect.height() * mFbScreenImage.depth() / 8;
+    }
     return touched;
 }
 
@@ -128,6 +128,9 @@ QPixmap QOffscreenScreen::grabWindow(WId id, int x, int y, int width, int height
 
 QOffscreenBackingStore::QOffscreenBackingStore(QWindow *window)
     : QPlatformBackingStore(window)
+    , m_lastFlushedBytes(0)
+    , m_flushedBytesTotal(0)
+    , m_flushCount(0)
 {
 }
 
@@ -143,8 +146,6 @@ QPaintDevice *QOffscreenBackingStore::paintDevice()
 
 void QOffscreenBackingStore::flush(QWindow *window, const QRegion &region, const QPoint &offset)
 {
-    Q_UNUSED(region);
-
     if (m_image.size().isEmpty())
         return;
 
@@ -162,6 +163,16 @@ void QOffscreenBackingStore::flush(QWindow *window, const QRegion &region, const
 
     m_windowAreaHash[id] = bounds;
     m_backingStoreForWinIdHash[id] = this;
+
+    // The window contents live in m_image already, so a flush only has to
+    // present the damaged part of it. Account for exactly that part.
+    m_lastFlushedRegion = region & clipped;
+    m_lastFlushedBytes = 0;
+    const int bytesPerPixel = m_image.depth() / 8;
+    for (const QRect &rect : m_lastFlushedRegion)
+        m_lastFlushedBytes += qint64(rect.width()) * rect.height() * bytesPerPixel;
+    m_flushedBytesTotal += m_lastFlushedBytes;
+    ++m_flushCount;
 }
 
 void QOffscreenBackingStore::resize(const QSize &size, const QRegion &)
@@ -223,4 +234,27 @@ void QOffscreenBackingStore::clearHash()
 
 QHash<WId, QOffscreenBackingStore *> QOffscreenBackingStore::m_backingStoreForWinIdHash;
 
+QVariant QOffscreenPlatformNativeInterface::windowProperty(QPlatformWindow *window, const QString &name) const
+{
+    const QOffscreenBackingStore *store = window ? QOffscreenBackingStore::backingStoreForWinId(window->winId()) : 0;
+    if (!store)
+        return QVariant();
+
+    if (name == QLatin1String("lastFlushedRegion"))
+        return store->lastFlushedRegion();
+    if (name == QLatin1String("lastFlushedBytes"))
+        return store->lastFlushedBytes();
+    if (name == QLatin1String("flushedBytesTotal"))
+        return store->flushedBytesTotal();
+    if (name == QLatin1String("flushCount"))
+        return store->flushCount();
+    return QVariant();
+}
+
+QVariant QOffscreenPlatformNativeInterface::windowProperty(QPlatformWindow *window, const QString &name, const QVariant &defaultValue) const
+{
+    const QVariant value = windowProperty(window, name);
+    return value.isValid() ? value : defaultValue;
+}
+
 QT_END_NAMESPACE
@@ -43,6 +43,7 @@
 #include <qpa/qplatformbackingstore.h>
 #include <qpa/qplatformdrag.h>
 #include <qpa/qplatformintegration.h>
+#include <qpa/qplatformnativeinterface.h>
 #include <qpa/qplatformscreen.h>
 #include <qpa/qplatformwindow.h>
 
@@ -95,15 +96,32 @@ public:
 
     static QOffscreenBackingStore *backingStoreForWinId(WId id);
 
+    QRegion lastFlushedRegion() const { return m_lastFlushedRegion; }
+    qint64 lastFlushedBytes() const { return m_lastFlushedBytes; }
+    qint64 flushedBytesTotal() const { return m_flushedBytesTotal; }
+    int flushCount() const { return m_flushCount; }
+
 private:
     void clearHash();
 
     QImage m_image;
     QHash<WId, QRect> m_windowAreaHash;
 
+    QRegion m_lastFlushedRegion;
+    qint64 m_lastFlushedBytes;
+    qint64 m_flushedBytesTotal;
+    int m_flushCount;
+
     static QHash<WId, QOffscreenBackingStore *> m_backingStoreForWinIdHash;
 };
 
+class QOffscreenPlatformNativeInterface : public QPlatformNativeInterface
+{
+public:
+    QVariant windowProperty(QPlatformWindow *window, const QString &name) const Q_DECL_OVERRIDE;
+    QVariant windowProperty(QPlatformWindow *window, const QString &name, const QVariant &defaultValue) const Q_DECL_OVERRIDE;
+};
+
 QT_END_NAMESPACE
 
 #endif
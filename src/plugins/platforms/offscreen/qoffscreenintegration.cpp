@@ -110,6 +110,7 @@ QOffscreenIntegration::QOffscreenIntegration()
     m_drag.reset(new QOffscreenDrag);
 #endif
     m_services.reset(new QPlatformServices);
+    m_nativeInterface.reset(new QOffscreenPlatformNativeInterface);
 
     screenAdded(new QOffscreenScreen);
 }
@@ -172,4 +173,9 @@ QPlatformServices *QOffscreenIntegration::services() const
     return m_services.data();
 }
 
+QPlatformNativeInterface *QOffscreenIntegration::nativeInterface() const
+{
+    return m_nativeInterface.data();
+}
+
 QT_END_NAMESPACE
@@ -62,6 +62,7 @@ public:
     QPlatformDrag *drag() const Q_DECL_OVERRIDE;
 #endif
     QPlatformServices *services() const Q_DECL_OVERRIDE;
+    QPlatformNativeInterface *nativeInterface() const Q_DECL_OVERRIDE;
 
     QPlatformFontDatabase *fontDatabase() const Q_DECL_OVERRIDE;
     QAbstractEventDispatcher *createEventDispatcher() const Q_DECL_OVERRIDE;
@@ -74,6 +75,7 @@ private:
     QScopedPointer<QPlatformDrag> m_drag;
 #endif
     QScopedPointer<QPlatformServices> m_services;
+    QScopedPointer<QPlatformNativeInterface> m_nativeInterface;
 };
 
 QT_END_NAMESPACE
@@ -45,6 +45,7 @@
 
 #include <xcb/shm.h>
 #include <xcb/xcb_image.h>
+#include <xcb/xcbext.h>
 
 #include <sys/ipc.h>
 #include <sys/shm.h>
@@ -81,14 +82,37 @@ public:
 
     void put(xcb_drawable_t dst, const QRegion &region, const QPoint &offset);
     void preparePaint(const QRegion &region);
+    void finishPaint(const QRegion &region);
 
 private:
+    // A shared memory segment the image can be painted into. Once the server
+    // may be reading a part of the current segment, painting over that part
+    // switches to another segment instead of waiting for the server.
+    struct ShmSegment
+    {
+        ShmSegment() : fence(0) { memset(&info, 0, sizeof(info)); }
+
+        xcb_shm_segment_info_t info;
+        // region the server may still be reading, fenced by the reply to request 'fence'
+        QRegion busy;
+        unsigned int fence;
+        // region in which this segment's contents are older than the current segment's
+        QRegion stale;
+    };
+
+    bool createShmSegment(ShmSegment *segment);
+    void destroyShmSegment(ShmSegment *segment);
+    void updateFences();
+    int idleShmSegment(const QRegion &region);
+    void switchToShmSegment(int index);
+
     void destroy();
 
     void ensureGC(xcb_drawable_t dst);
     void flushPixmap(const QRegion &region);
     void setClip(const QRegion &region);
 
+    // The segment currently painted into and put to the server
     xcb_shm_segment_info_t m_shm_info;
 
     xcb_image_t *m_xcb_image;
@@ -99,8 +123,9 @@ private:
     xcb_gcontext_t m_gc;
     xcb_drawable_t m_gc_drawable;
 
-    // When using shared memory this is the region currently shared with the server
-    QRegion m_dirtyShm;
+    // When using shared memory, segments are added on demand up to MaxShmSegments
+    QVector<ShmSegment> m_segments;
+    int m_currentSegment;
 
     // When not using shared memory, we maintain a server-side pixmap with the backing
     // store as well as repainted content not yet flushed to the pixmap. We only flush
@@ -110,9 +135,12 @@ private:
     QRegion m_pendingFlush;
     QByteArray m_flushBuffer;
 
+    QImage::Format m_format;
     bool m_hasAlpha;
 };
 
+static const int MaxShmSegments = 3;
+
 class QXcbShmGraphicsBuffer : public QPlatformGraphicsBuffer
 {
 public:
@@ -148,10 +176,13 @@ QXcbShmImage::QXcbShmImage(QXcbScreen *screen, const QSize &size, uint depth, QI
     , m_graphics_buffer(Q_NULLPTR)
     , m_gc(0)
     , m_gc_drawable(0)
+    , m_currentSegment(0)
     , m_xcb_pixmap(0)
 {
     Q_XCB_NOOP(connection());
 
+    memset(&m_shm_info, 0, sizeof(m_shm_info));
+
     const xcb_format_t *fmt = connection()->formatForDepth(depth);
     Q_ASSERT(fmt);
 
@@ -167,37 +198,21 @@ QXcbShmImage::QXcbShmImage(QXcbScreen *screen, const QSize &size, uint depth, QI
     if (!segmentSize)
         return;
 
-    int id = shmget(IPC_PRIVATE, segmentSize, IPC_CREAT | 0600);
-    if (id == -1)
-        qWarning("QXcbShmImage: shmget() failed (%d: %s) for size %d (%dx%d)",
-                 errno, strerror(errno), segmentSize, size.width(), size.height());
-    else
-        m_shm_info.shmid = id;
-    m_shm_info.shmaddr = m_xcb_image->data = (quint8 *)shmat (m_shm_info.shmid, 0, 0);
-    m_shm_info.shmseg = xcb_generate_id(xcb_connection());
-
     const xcb_query_extension_reply_t *shm_reply = xcb_get_extension_data(xcb_connection(), &xcb_shm_id);
     bool shm_present = shm_reply != NULL && shm_reply->present;
-    xcb_generic_error_t *error = NULL;
-    if (shm_present)
-        error = xcb_request_check(xcb_connection(), xcb_shm_attach_checked(xcb_connection(), m_shm_info.shmseg, m_shm_info.shmid, false));
-    if (!shm_present || error || id == -1) {
-        free(error);
-
-        shmdt(m_shm_info.shmaddr);
-        shmctl(m_shm_info.shmid, IPC_RMID, 0);
-
-        m_shm_info.shmaddr = 0;
-
-        m_xcb_image->data = (uint8_t *)malloc(segmentSize);
+    ShmSegment segment;
+    if (shm_present && createShmSegment(&segment)) {
+        m_segments.append(segment);
+        m_shm_info = segment.info;
+        m_xcb_image->data = m_shm_info.shmaddr;
     } else {
-        if (shmctl(m_shm_info.shmid, IPC_RMID, 0) == -1)
-            qWarning("QXcbBackingStore: Error while marking the shared memory segment to be destroyed");
+        m_xcb_image->data = (uint8_t *)malloc(segmentSize);
     }
 
     m_hasAlpha = QImage::toPixelFormat(format).alphaUsage() == QPixelFormat::UsesAlpha;
     if (!m_hasAlpha)
         format = qt_maybeAlphaVersionWithSameDepth(format);
+    m_format = format;
 
     m_qimage = QImage( (uchar*) m_xcb_image->data, m_xcb_image->width, m_xcb_image->height, m_xcb_image->stride, format);
     m_graphics_buffer = new QXcbShmGraphicsBuffer(&m_qimage);
@@ -212,6 +227,125 @@ QXcbShmImage::QXcbShmImage(QXcbScreen *screen, const QSize &size, uint depth, QI
     }
 }
 
+bool QXcbShmImage::createShmSegment(ShmSegment *segment)
+{
+    const int segmentSize = m_xcb_image->stride * m_xcb_image->height;
+
+    int id = shmget(IPC_PRIVATE, segmentSize, IPC_CREAT | 0600);
+    if (id == -1) {
+        qWarning("QXcbShmImage: shmget() failed (%d: %s) for size %d (%dx%d)",
+                 errno, strerror(errno), segmentSize, m_xcb_image->width, m_xcb_image->height);
+        return false;
+    }
+
+    void *addr = shmat(id, 0, 0);
+    if (addr == reinterpret_cast<void *>(-1)) {
+        qWarning("QXcbShmImage: shmat() failed (%d: %s) for id %d", errno, strerror(errno), id);
+        shmctl(id, IPC_RMID, 0);
+        return false;
+    }
+
+    segment->info.shmid = id;
+    segment->info.shmaddr = static_cast<quint8 *>(addr);
+    segment->info.shmseg = xcb_generate_id(xcb_connection());
+
+    xcb_generic_error_t *error = xcb_request_check(xcb_connection(),
+                                                   xcb_shm_attach_checked(xcb_connection(), segment->info.shmseg, id, false));
+    if (error) {
+        free(error);
+
+        shmdt(addr);
+        shmctl(id, IPC_RMID, 0);
+
+        segment->info.shmaddr = 0;
+        return false;
+    }
+
+    if (shmctl(id, IPC_RMID, 0) == -1)
+        qWarning("QXcbBackingStore: Error while marking the shared memory segment to be destroyed");
+
+    return true;
+}
+
+void QXcbShmImage::destroyShmSegment(ShmSegment *segment)
+{
+    if (segment->fence)
+        xcb_discard_reply(xcb_connection(), segment->fence);
+    Q_XCB_CALL(xcb_shm_detach(xcb_connection(), segment->info.shmseg));
+    shmdt(segment->info.shmaddr);
+    shmctl(segment->info.shmid, IPC_RMID, 0);
+}
+
+// Retires the segments whose puts the server has processed: ShmPutImage
+// reads the segment while the request executes, so once the reply to a
+// request sent after it arrives, the server is done with the segment.
+void QXcbShmImage::updateFences()
+{
+    for (ShmSegment &segment : m_segments) {
+        if (!segment.fence)
+            continue;
+        void *reply = 0;
+        xcb_generic_error_t *error = 0;
+        if (xcb_poll_for_reply(xcb_connection(), segment.fence, &reply, &error)) {
+            free(reply);
+            free(error);
+            segment.fence = 0;
+            segment.busy = QRegion();
+        }
+    }
+}
+
+// Returns a segment that can be brought up to date and painted in
+// \a region without touching anything the server may still read, or -1.
+int QXcbShmImage::idleShmSegment(const QRegion &region)
+{
+    for (int i = 0; i < m_segments.size(); ++i) {
+        if (i == m_currentSegment)
+            continue;
+        const ShmSegment &segment = m_segments.at(i);
+        if (segment.busy.isEmpty() || !segment.busy.intersects(region | segment.stale))
+            return i;
+    }
+
+    if (m_segments.size() < MaxShmSegments) {
+        ShmSegment segment;
+        if (createShmSegment(&segment)) {
+            segment.stale = QRect(QPoint(), size());
+            m_segments.append(segment);
+            return m_segments.size() - 1;
+        }
+    }
+
+    return -1;
+}
+
+void QXcbShmImage::switchToShmSegment(int index)
+{
+    ShmSegment &target = m_segments[index];
+    const ShmSegment &current = m_segments.at(m_currentSegment);
+
+    // copy over what changed since the target was last painted into
+    const int bytesPerLine = m_xcb_image->stride;
+    const int bytesPerPixel = m_qimage.depth() >> 3;
+    for (const QRect &rect : target.stale) {
+        const int offset = rect.y() * bytesPerLine + rect.x() * bytesPerPixel;
+        const int length = rect.width() * bytesPerPixel;
+        const uchar *src = current.info.shmaddr + offset;
+        uchar *dst = target.info.shmaddr + offset;
+        for (int y = 0; y < rect.height(); ++y) {
+            memcpy(dst, src, length);
+            src += bytesPerLine;
+            dst += bytesPerLine;
+        }
+    }
+    target.stale = QRegion();
+
+    m_currentSegment = index;
+    m_shm_info = target.info;
+    m_xcb_image->data = m_shm_info.shmaddr;
+    m_qimage = QImage(m_xcb_image->data, m_xcb_image->width, m_xcb_image->height, m_xcb_image->stride, m_format);
+}
+
 extern void qt_scrollRectInImage(QImage &img, const QRect &rect, const QPoint &offset);
 
 bool QXcbShmImage::scroll(const QRegion &area, int dx, int dy)
@@ -219,10 +353,10 @@ bool QXcbShmImage::scroll(const QRegion &area, int dx, int dy)
     if (image()->isNull())
         return false;
 
+    const QPoint delta(dx, dy);
     if (hasShm())
-        preparePaint(area);
+        preparePaint(area | area.translated(delta));
 
-    const QPoint delta(dx, dy);
     for (const QRect &rect : area)
         qt_scrollRectInImage(*image(), rect, delta);
 
@@ -248,13 +382,11 @@ bool QXcbShmImage::scroll(const QRegion &area, int dx, int dy)
 void QXcbShmImage::destroy()
 {
     const int segmentSize = m_xcb_image ? (m_xcb_image->stride * m_xcb_image->height) : 0;
-    if (segmentSize && m_shm_info.shmaddr)
-        Q_XCB_CALL(xcb_shm_detach(xcb_connection(), m_shm_info.shmseg));
-
     if (segmentSize) {
-        if (m_shm_info.shmaddr) {
-            shmdt(m_shm_info.shmaddr);
-            shmctl(m_shm_info.shmid, IPC_RMID, 0);
+        if (hasShm()) {
+            for (ShmSegment &segment : m_segments)
+                destroyShmSegment(&segment);
+            m_segments.clear();
         } else {
             free(m_xcb_image->data);
         }
@@ -353,9 +485,45 @@ static inline quint32 round_up_scanline(quint32 base, quint32 pad)
     return (base + pad - 1) & -pad;
 }
 
+// Merges the rects of \a region into fewer, larger rects, as long as that
+// does not upload much more than needed: each merge may add at most as many
+// pixels as the merged rects contain, or a few thousand for nearby small rects.
+static QVector<QRect> coalescedRects(const QRegion &region)
+{
+    static const int LookBehind = 4;
+    static const qint64 MinimumSlack = 4096;
+
+    QVector<QRect> merged;
+    QVector<qint64> used;
+    merged.reserve(region.rectCount());
+    used.reserve(region.rectCount());
+
+    for (const QRect &rect : region) {
+        const qint64 area = qint64(rect.width()) * rect.height();
+        bool done = false;
+        for (int i = merged.size() - 1; i >= 0 && i >= merged.size() - LookBehind; --i) {
+            const QRect united = merged.at(i) | rect;
+            const qint64 unitedArea = qint64(united.width()) * united.height();
+            const qint64 wasted = unitedArea - used.at(i) - area;
+            if (wasted <= qMax(used.at(i) + area, MinimumSlack)) {
+                merged[i] = united;
+                used[i] += area;
+                done = true;
+                break;
+            }
+        }
+        if (!done) {
+            merged.append(rect);
+            used.append(area);
+        }
+    }
+
+    return merged;
+}
+
 void QXcbShmImage::flushPixmap(const QRegion &region)
 {
-    const QVector<QRect> rects = m_pendingFlush.intersected(region).rects();
+    const QVector<QRect> rects = coalescedRects(m_pendingFlush.intersected(region));
     m_pendingFlush -= region;
 
     xcb_image_t xcb_subimage;
@@ -471,7 +639,14 @@ void QXcbShmImage::put(xcb_drawable_t dst, const QRegion &region, const QPoint &
                                      0, // send event?
                                      m_shm_info.shmseg,
                                      m_xcb_image->data - m_shm_info.shmaddr));
-        m_dirtyShm |= region.translated(offset);
+
+        // Fence the put with a request whose reply tells when the server is
+        // done reading, so that painting need not wait for it right away.
+        ShmSegment &segment = m_segments[m_currentSegment];
+        if (segment.fence)
+            xcb_discard_reply(xcb_connection(), segment.fence);
+        segment.fence = Q_XCB_CALL(xcb_get_input_focus(xcb_connection())).sequence;
+        segment.busy |= region.translated(offset);
     } else {
         flushPixmap(region);
         Q_XCB_CALL(xcb_copy_area(xcb_connection(),
@@ -491,15 +666,32 @@ void QXcbShmImage::preparePaint(const QRegion &region)
 {
     if (hasShm()) {
         // to prevent X from reading from the image region while we're writing to it
-        if (m_dirtyShm.intersects(region)) {
-            connection()->sync();
-            m_dirtyShm = QRegion();
+        updateFences();
+        if (m_segments.at(m_currentSegment).busy.intersects(region)) {
+            const int index = idleShmSegment(region);
+            if (index != -1) {
+                switchToShmSegment(index);
+            } else {
+                // every segment is in use, wait for the server to catch up
+                connection()->sync();
+                updateFences();
+            }
+        }
+        for (int i = 0; i < m_segments.size(); ++i) {
+            if (i != m_currentSegment)
+                m_segments[i].stale |= region;
         }
     } else {
         m_pendingFlush |= region;
     }
 }
 
+void QXcbShmImage::finishPaint(const QRegion &region)
+{
+    if (!hasShm())
+        m_pendingFlush |= region;
+}
+
 QXcbBackingStore::QXcbBackingStore(QWindow *window)
     : QPlatformBackingStore(window)
     , m_image(0)
@@ -545,7 +737,7 @@ void QXcbBackingStore::endPaint()
     }
 
     const QRegion region = m_paintRegions.pop();
-    m_image->preparePaint(region);
+    m_image->finishPaint(region);
 
     QXcbWindow *platformWindow = static_cast<QXcbWindow *>(window()->handle());
     if (!platformWindow || !platformWindow->imageNeedsRgbSwap())
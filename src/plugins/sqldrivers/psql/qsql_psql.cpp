@@ -51,6 +51,10 @@
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
 #include <qmutex.h>
+#include <qendian.h>
+#include <qthread.h>
+#include <private/qlocale_tools_p.h>
+#include <QtSql/private/qsqlcolumnblock_p.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 
@@ -58,7 +62,9 @@
 #include <pg_config.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <limits>
 // below code taken from an example at http://www.gnu.org/software/hello/manual/autoconf/Function-Portability.html
 #ifndef isnan
     # define isnan(x) \
@@ -83,9 +89,14 @@
 
 // workaround for postgres defining their OIDs in a private header file
 #define QBOOLOID 16
+#define QCHAROID 18
+#define QNAMEOID 19
 #define QINT8OID 20
 #define QINT2OID 21
 #define QINT4OID 23
+#define QTEXTOID 25
+#define QBPCHAROID 1042
+#define QVARCHAROID 1043
 #define QNUMERICOID 1700
 #define QFLOAT4OID 700
 #define QFLOAT8OID 701
@@ -107,6 +118,11 @@
 
 #define VARHDRSZ 4
 
+// single-row mode was introduced in libpq 9.2
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 90200
+#define QPSQL_SINGLE_ROW_MODE
+#endif
+
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
 template <typename T>
@@ -143,6 +159,7 @@ protected:
     bool fetch(int i) Q_DECL_OVERRIDE;
     bool fetchFirst() Q_DECL_OVERRIDE;
     bool fetchLast() Q_DECL_OVERRIDE;
+    bool fetchNext() Q_DECL_OVERRIDE;
     QVariant data(int i) Q_DECL_OVERRIDE;
     bool isNull(int field) Q_DECL_OVERRIDE;
     bool reset (const QString &query) Q_DECL_OVERRIDE;
@@ -152,8 +169,11 @@ protected:
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
 };
 
+class QPSQLResultPrivate;
+
 class QPSQLDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLDriver)
@@ -164,24 +184,52 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        binaryResults(false),
+        copyBatches(false),
+        integerDateTimes(false),
+        currentStmtId(InvalidStatementId),
+        stmtCount(0),
+        asyncResult(0)
     { dbmsType = QSqlDriver::PostgreSQL; }
 
+    enum { InvalidStatementId = 0 };
+
     PGconn *connection;
     bool isUtf8;
     QPSQLDriver::Protocol pro;
-    QSocketNotifier *sn;
+    // only exists while notifications are subscribed or a query runs
+    // asynchronously, see disableSocketNotifier()
+    mutable QSocketNotifier *sn;
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    bool binaryResults;
+    bool copyBatches;
+    bool integerDateTimes;
+    // statement whose results are still being read from the connection
+    mutable int currentStmtId;
+    mutable int stmtCount;
+    // result whose statement was started by QSqlQuery::execAsync()
+    mutable QPSQLResultPrivate *asyncResult;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    PGresult * execBinary(const QString & stmt) const;
+    int sendQuery(const QString &stmt, bool binary, bool singleRow) const;
+    PGresult *getResult(int stmtId) const;
+    void finishQuery(int stmtId) const;
+    void discardResults() const;
+    void checkPendingNotifications() const;
+    bool enableSocketNotifier();
+    void disableSocketNotifier() const;
+    void finishAsyncQuery() const;
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
     void detectBackslashEscape();
+    void detectIntegerDateTimes();
 };
 
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
@@ -208,14 +256,20 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
     }
 }
 
-PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+void QPSQLDriverPrivate::checkPendingNotifications() const
 {
     Q_Q(const QPSQLDriver);
-    PGresult *result = PQexec(connection, stmt);
     if (seid.size() && !pendingNotifyCheck) {
         pendingNotifyCheck = true;
         QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
     }
+}
+
+PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+{
+    discardResults();
+    PGresult *result = PQexec(connection, stmt);
+    checkPendingNotifications();
     return result;
 }
 
@@ -224,6 +278,74 @@ PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
     return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
 }
 
+// Executes stmt and requests all columns of the result in binary format.
+PGresult * QPSQLDriverPrivate::execBinary(const QString & stmt) const
+{
+    discardResults();
+    PGresult *result = PQexecParams(connection, isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData(),
+                                    0, 0, 0, 0, 0, 1);
+    checkPendingNotifications();
+    return result;
+}
+
+// Sends stmt without waiting for the result. With singleRow, the connection
+// is switched to single-row mode, so that the rows are retrieved one at a
+// time with getResult() instead of being buffered by libpq. Returns the id
+// of the statement, or InvalidStatementId on failure.
+int QPSQLDriverPrivate::sendQuery(const QString &stmt, bool binary, bool singleRow) const
+{
+    discardResults();
+    const QByteArray query = isUtf8 ? stmt.toUtf8() : stmt.toLocal8Bit();
+    const int sent = binary ? PQsendQueryParams(connection, query.constData(), 0, 0, 0, 0, 0, 1)
+                            : PQsendQuery(connection, query.constData());
+    checkPendingNotifications();
+    if (!sent)
+        return InvalidStatementId;
+#ifdef QPSQL_SINGLE_ROW_MODE
+    if (singleRow)
+        PQsetSingleRowMode(connection);
+#else
+    Q_UNUSED(singleRow);
+#endif
+    if (++stmtCount == InvalidStatementId)
+        ++stmtCount;
+    currentStmtId = stmtCount;
+    return currentStmtId;
+}
+
+// Returns the next result of the statement stmtId, or 0 if it has no more
+// results or if its results were discarded because another statement
+// was executed on the connection in the meantime.
+PGresult *QPSQLDriverPrivate::getResult(int stmtId) const
+{
+    if (stmtId == InvalidStatementId || stmtId != currentStmtId)
+        return 0;
+    PGresult *result = PQgetResult(connection);
+    if (!result)
+        currentStmtId = InvalidStatementId;
+    return result;
+}
+
+void QPSQLDriverPrivate::finishQuery(int stmtId) const
+{
+    if (stmtId != InvalidStatementId && stmtId == currentStmtId)
+        discardResults();
+}
+
+// The connection can only process one statement at a time, so the
+// remaining results of a statement sent with sendQuery() have to be
+// consumed before anything else is executed.
+void QPSQLDriverPrivate::discardResults() const
+{
+    if (asyncResult)
+        finishAsyncQuery();
+    if (currentStmtId == InvalidStatementId)
+        return;
+    while (PGresult *result = PQgetResult(connection))
+        PQclear(result);
+    currentStmtId = InvalidStatementId;
+}
+
 class QPSQLResultPrivate : public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLResult)
@@ -233,18 +355,33 @@ public:
       : QSqlResultPrivate(q, drv),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        stmtId(QPSQLDriverPrivate::InvalidStatementId),
+        preparedQueriesEnabled(false),
+        singleRowMode(false),
+        canFetchMoreRows(false),
+        binaryResults(false)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
     void deallocatePreparedStmt();
+    bool executeAsync(const QString &query, const QFutureInterface<bool> &future);
+    int currentRow() const { return singleRowMode ? 0 : q_func()->at(); }
 
     PGresult *result;
     int currentSize;
+    int stmtId;
     bool preparedQueriesEnabled;
+    bool singleRowMode;
+    bool canFetchMoreRows;
+    bool binaryResults;
     QString preparedStmtId;
+    QFutureInterface<bool> asyncExec;
 
+    bool execute(const QString &stmt);
     bool processResults();
+    bool hasBinaryDecodableColumns() const;
+    void appendColumnValue(QSqlColumnBlockPrivate *block, int i);
+    void fetchBlock(QSqlColumnBlockPrivate *block, int maxRows);
 };
 
 static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
@@ -260,29 +397,104 @@ static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
     return QSqlError(QLatin1String("QPSQL: ") + err, msg, type, errorCode);
 }
 
+// Forward-only queries are executed in single-row mode, so that rows are
+// retrieved from the server as they are iterated instead of being
+// buffered all at once.
+bool QPSQLResultPrivate::execute(const QString &stmt)
+{
+    Q_Q(QPSQLResult);
+#ifdef QPSQL_SINGLE_ROW_MODE
+    if (q->isForwardOnly()) {
+        stmtId = drv_d_func()->sendQuery(stmt, binaryResults, true);
+        result = drv_d_func()->getResult(stmtId);
+        singleRowMode = true;
+        return processResults();
+    }
+#endif
+    result = binaryResults ? drv_d_func()->execBinary(stmt) : drv_d_func()->exec(stmt);
+    return processResults();
+}
+
 bool QPSQLResultPrivate::processResults()
 {
     Q_Q(QPSQLResult);
-    if (!result)
+    canFetchMoreRows = false;
+    if (!result) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to create query"), QSqlError::StatementError, drv_d_func()));
         return false;
+    }
 
     int status = PQresultStatus(result);
     if (status == PGRES_TUPLES_OK) {
         q->setSelect(true);
         q->setActive(true);
-        currentSize = PQntuples(result);
+        currentSize = singleRowMode ? -1 : PQntuples(result);
+        drv_d_func()->finishQuery(stmtId);
         return true;
     } else if (status == PGRES_COMMAND_OK) {
         q->setSelect(false);
         q->setActive(true);
         currentSize = -1;
+        drv_d_func()->finishQuery(stmtId);
+        return true;
+#ifdef QPSQL_SINGLE_ROW_MODE
+    } else if (status == PGRES_SINGLE_TUPLE) {
+        q->setSelect(true);
+        q->setActive(true);
+        currentSize = -1;
+        canFetchMoreRows = true;
         return true;
+#endif
     }
     q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
                     "Unable to create query"), QSqlError::StatementError, drv_d_func(), result));
+    drv_d_func()->finishQuery(stmtId);
     return false;
 }
 
+bool QPSQLDriverPrivate::enableSocketNotifier()
+{
+    Q_Q(QPSQLDriver);
+    if (sn)
+        return true;
+    const int socket = PQsocket(connection);
+    if (socket < 0)
+        return false;
+    // A child of the driver, so that it follows the driver to another thread.
+    sn = new QSocketNotifier(socket, QSocketNotifier::Read, q);
+    QObject::connect(sn, SIGNAL(activated(int)), q, SLOT(_q_handleNotification(int)));
+    return true;
+}
+
+// Drops the notifier once it is no longer needed. A connection without a
+// notifier can be used from, and moved to, any thread, which connection
+// pools rely on. This may be called while the notifier is being activated.
+void QPSQLDriverPrivate::disableSocketNotifier() const
+{
+    Q_Q(const QPSQLDriver);
+    if (!sn)
+        return;
+    sn->setEnabled(false);
+    QObject::disconnect(sn, SIGNAL(activated(int)), q, SLOT(_q_handleNotification(int)));
+    sn->deleteLater();
+    sn = 0;
+}
+
+void QPSQLDriverPrivate::finishAsyncQuery() const
+{
+    QPSQLResultPrivate *r = asyncResult;
+    asyncResult = 0;
+    r->result = getResult(r->stmtId);
+    const bool ok = r->processResults();
+    if (seid.isEmpty())
+        disableSocketNotifier();
+    QFutureInterface<bool> future = r->asyncExec;
+    r->asyncExec = QFutureInterface<bool>();
+    future.reportResult(ok);
+    future.reportFinished();
+}
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -329,6 +541,224 @@ static QVariant::Type qDecodePSQLType(int t)
     return type;
 }
 
+// Returns whether values of type ptype can be requested in binary format.
+// The binary representation of the date and time types depends on the
+// server's integer_datetimes setting; only the 64-bit integer one is decoded.
+static bool qIsBinaryDecodable(int ptype, bool integerDateTimes)
+{
+    switch (ptype) {
+    case QBOOLOID:
+    case QCHAROID:
+    case QNAMEOID:
+    case QINT8OID:
+    case QINT2OID:
+    case QINT4OID:
+    case QTEXTOID:
+    case QBPCHAROID:
+    case QVARCHAROID:
+    case QFLOAT8OID:
+    case QDATEOID:
+    case QBYTEAOID:
+        return true;
+    case QTIMEOID:
+    case QTIMESTAMPOID:
+    case QTIMESTAMPTZOID:
+        return integerDateTimes;
+    default:
+        return false;
+    }
+}
+
+// Splits a PostgreSQL time value in microseconds into milliseconds since
+// the start of the day (or the epoch) the same way QTime::fromString()
+// rounds fractional seconds.
+static qint64 qPSQLMicrosecondsToMSecs(qint64 usecs)
+{
+    qint64 secs = usecs / 1000000;
+    qint64 fraction = usecs % 1000000;
+    if (fraction < 0) {
+        fraction += 1000000;
+        --secs;
+    }
+    return secs * 1000 + qMin<qint64>((fraction + 500) / 1000, 999);
+}
+
+static QVariant qDecodeBinaryPSQLValue(const char *val, int len, int ptype, QVariant::Type type, bool isUtf8)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(val);
+    // date and time values count from 2000-01-01
+    static const qint64 postgresEpochMSecs = Q_INT64_C(946684800000);
+    static const qint64 msecsPerDay = Q_INT64_C(86400000);
+
+    switch (type) {
+    case QVariant::Bool:
+        return QVariant(bool(len > 0 && data[0]));
+    case QVariant::String:
+        return isUtf8 ? QString::fromUtf8(val, len) : QString::fromLatin1(val, len);
+    case QVariant::LongLong: {
+        // keep the types returned for the text format
+        const qint64 v = qFromBigEndian<qint64>(data);
+        if (v < 0)
+            return QVariant(qlonglong(v));
+        return QVariant(qulonglong(v));
+    }
+    case QVariant::Int:
+        if (ptype == QINT2OID)
+            return QVariant(int(qFromBigEndian<qint16>(data)));
+        return QVariant(int(qFromBigEndian<qint32>(data)));
+    case QVariant::Double: {
+        const quint64 bits = qFromBigEndian<quint64>(data);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return QVariant(d);
+    }
+    case QVariant::Date: {
+        const qint32 days = qFromBigEndian<qint32>(data);
+        if (days == std::numeric_limits<qint32>::max() || days == std::numeric_limits<qint32>::min())
+            return QVariant(QDate()); // infinity
+        return QVariant(QDate(2000, 1, 1).addDays(days));
+    }
+    case QVariant::Time:
+        return QVariant(QTime::fromMSecsSinceStartOfDay(int(qPSQLMicrosecondsToMSecs(qFromBigEndian<qint64>(data)))));
+    case QVariant::DateTime: {
+        const qint64 usecs = qFromBigEndian<qint64>(data);
+        if (usecs == std::numeric_limits<qint64>::max() || usecs == std::numeric_limits<qint64>::min())
+            return QVariant(QDateTime()); // infinity
+        const qint64 msecs = qPSQLMicrosecondsToMSecs(usecs);
+        if (ptype == QTIMESTAMPTZOID)
+            return QVariant(QDateTime::fromMSecsSinceEpoch(msecs + postgresEpochMSecs, Qt::UTC).toLocalTime());
+        qint64 days = msecs / msecsPerDay;
+        qint64 msecsOfDay = msecs % msecsPerDay;
+        if (msecsOfDay < 0) {
+            msecsOfDay += msecsPerDay;
+            --days;
+        }
+        return QVariant(QDateTime(QDate(2000, 1, 1).addDays(days), QTime::fromMSecsSinceStartOfDay(int(msecsOfDay))));
+    }
+    case QVariant::ByteArray:
+        return QVariant(QByteArray(val, len));
+    default:
+        qWarning("QPSQLResult::data: unknown data type");
+    }
+    return QVariant();
+}
+
+// Binary results are only requested for prepared statements, whose result
+// columns are known before they are executed.
+bool QPSQLResultPrivate::hasBinaryDecodableColumns() const
+{
+    bool decodable = false;
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 80200
+    drv_d_func()->discardResults();
+    PGresult *description = PQdescribePrepared(drv_d_func()->connection, preparedStmtId.toLatin1().constData());
+    if (PQresultStatus(description) == PGRES_COMMAND_OK) {
+        const int count = PQnfields(description);
+        decodable = count > 0;
+        for (int i = 0; decodable && i < count; ++i)
+            decodable = qIsBinaryDecodable(PQftype(description, i), drv_d_func()->integerDateTimes);
+    }
+    PQclear(description);
+#endif
+    return decodable;
+}
+
+// Parses a double in the text format, which spells the special values
+// out in full.
+static double qParsePSQLDouble(const char *val, int len)
+{
+    if (qstrcmp(val, "NaN") == 0)
+        return qQNaN();
+    if (qstrcmp(val, "Infinity") == 0)
+        return qInf();
+    if (qstrcmp(val, "-Infinity") == 0)
+        return -qInf();
+    return qstrntod(val, len, 0, 0);
+}
+
+// Decodes the value in column i of the current row straight into block.
+// Values that have no direct representation in the column's buffer go
+// through data().
+void QPSQLResultPrivate::appendColumnValue(QSqlColumnBlockPrivate *block, int i)
+{
+    Q_Q(QPSQLResult);
+    const int row = currentRow();
+    if (PQgetisnull(result, row, i)) {
+        block->appendNull(i);
+        return;
+    }
+    const char *val = PQgetvalue(result, row, i);
+    const int len = PQgetlength(result, row, i);
+    const int ptype = PQftype(result, i);
+    const bool binary = PQfformat(result, i) == 1;
+    const uchar *data = reinterpret_cast<const uchar *>(val);
+
+    switch (block->columns.at(i).type) {
+    case QSqlColumnBlock::IntegerColumn:
+        // floating point and NUMERIC values are converted as the precision
+        // policy makes data() convert them
+        if (block->columns.at(i).fieldType == QVariant::Double)
+            break;
+        if (ptype == QBOOLOID) {
+            block->appendInteger(i, binary ? len > 0 && data[0] : val[0] == 't');
+            return;
+        }
+        if (!binary) {
+            block->appendInteger(i, strtoll(val, 0, 10));
+            return;
+        }
+        switch (ptype) {
+        case QINT2OID:
+            block->appendInteger(i, qFromBigEndian<qint16>(data));
+            return;
+        case QINT4OID:
+            block->appendInteger(i, qFromBigEndian<qint32>(data));
+            return;
+        case QINT8OID:
+            block->appendInteger(i, qFromBigEndian<qint64>(data));
+            return;
+        }
+        break;
+    case QSqlColumnBlock::RealColumn:
+        if (!binary) {
+            block->appendReal(i, qParsePSQLDouble(val, len));
+            return;
+        }
+        if (ptype == QFLOAT8OID) {
+            const quint64 bits = qFromBigEndian<quint64>(data);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            block->appendReal(i, d);
+            return;
+        }
+        break;
+    case QSqlColumnBlock::StringColumn:
+        // text is sent as is in both formats
+        if (drv_d_func()->isUtf8)
+            block->appendUtf8(i, val, len);
+        else
+            block->appendLatin1(i, val, len);
+        return;
+    case QSqlColumnBlock::VariantColumn:
+        break;
+    }
+    block->appendValue(i, q->data(i));
+}
+
+void QPSQLResultPrivate::fetchBlock(QSqlColumnBlockPrivate *block, int maxRows)
+{
+    Q_Q(QPSQLResult);
+    const int columns = block->columns.count();
+    while (block->rowCount < maxRows) {
+        if (!q->fetch(q->at() + 1)) {
+            q->setAt(QSql::AfterLastRow);
+            return;
+        }
+        for (int i = 0; i < columns; ++i)
+            appendColumnValue(block, i);
+        block->endRow();
+    }
+}
+
 void QPSQLResultPrivate::deallocatePreparedStmt()
 {
     const QString stmt = QLatin1String("DEALLOCATE ") + preparedStmtId;
@@ -365,9 +795,16 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+    if (d->drv_d_func() && d->drv_d_func()->asyncResult == d)
+        d->drv_d_func()->finishAsyncQuery();
     if (d->result)
         PQclear(d->result);
     d->result = 0;
+    if (d->stmtId != QPSQLDriverPrivate::InvalidStatementId && d->drv_d_func())
+        d->drv_d_func()->finishQuery(d->stmtId);
+    d->stmtId = QPSQLDriverPrivate::InvalidStatementId;
+    d->singleRowMode = false;
+    d->canFetchMoreRows = false;
     setAt(QSql::BeforeFirstRow);
     d->currentSize = -1;
     setActive(false);
@@ -380,25 +817,102 @@ bool QPSQLResult::fetch(int i)
         return false;
     if (i < 0)
         return false;
-    if (i >= d->currentSize)
-        return false;
     if (at() == i)
         return true;
+    if (d->singleRowMode) {
+        if (i < at())
+            return false;
+        if (at() == QSql::BeforeFirstRow && !fetchFirst())
+            return false;
+        while (at() < i) {
+            if (!fetchNext())
+                return false;
+        }
+        return true;
+    }
+    if (i >= d->currentSize)
+        return false;
     setAt(i);
     return true;
 }
 
 bool QPSQLResult::fetchFirst()
 {
+    Q_D(const QPSQLResult);
+    if (d->singleRowMode) {
+        if (!isActive())
+            return false;
+        if (at() == 0)
+            return true;
+        // the first row was already retrieved by exec()
+        if (at() == QSql::BeforeFirstRow && d->result && PQntuples(d->result) > 0) {
+            setAt(0);
+            return true;
+        }
+        return false;
+    }
     return fetch(0);
 }
 
 bool QPSQLResult::fetchLast()
 {
     Q_D(const QPSQLResult);
+    if (d->singleRowMode) {
+        if (!isActive() || at() == QSql::AfterLastRow)
+            return false;
+        if (at() == QSql::BeforeFirstRow && !fetchFirst())
+            return false;
+        while (fetchNext()) { }
+        return true;
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
+bool QPSQLResult::fetchNext()
+{
+    Q_D(QPSQLResult);
+    if (!d->singleRowMode)
+        return QSqlResult::fetchNext();
+    if (!isActive())
+        return false;
+    if (at() == QSql::BeforeFirstRow)
+        return fetchFirst();
+    if (!d->canFetchMoreRows)
+        return false;
+
+    PGresult *next = d->drv_d_func()->getResult(d->stmtId);
+    if (!next) {
+        d->canFetchMoreRows = false;
+        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                "Query results lost - probably discarded on executing another SQL query."),
+                                QSqlError::StatementError, d->drv_d_func()));
+        return false;
+    }
+
+    switch (PQresultStatus(next)) {
+#ifdef QPSQL_SINGLE_ROW_MODE
+    case PGRES_SINGLE_TUPLE:
+        PQclear(d->result);
+        d->result = next;
+        setAt(at() + 1);
+        return true;
+#endif
+    case PGRES_TUPLES_OK:
+        // end of the result set; keep the last row accessible
+        PQclear(next);
+        d->canFetchMoreRows = false;
+        d->drv_d_func()->finishQuery(d->stmtId);
+        return false;
+    default:
+        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                "Unable to get result"), QSqlError::StatementError, d->drv_d_func(), next));
+        PQclear(next);
+        d->canFetchMoreRows = false;
+        d->drv_d_func()->finishQuery(d->stmtId);
+        return false;
+    }
+}
+
 QVariant QPSQLResult::data(int i)
 {
     Q_D(const QPSQLResult);
@@ -406,11 +920,15 @@ QVariant QPSQLResult::data(int i)
         qWarning("QPSQLResult::data: column %d out of range", i);
         return QVariant();
     }
+    const int currentRow = d->currentRow();
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const char *val = PQgetvalue(d->result, currentRow, i);
+    if (PQgetisnull(d->result, currentRow, i))
         return QVariant(type);
+    if (PQfformat(d->result, i) == 1)
+        return qDecodeBinaryPSQLValue(val, PQgetlength(d->result, currentRow, i), ptype, type,
+                                      d->drv_d_func()->isUtf8);
     switch (type) {
     case QVariant::Bool:
         return QVariant((bool)(val[0] == 't'));
@@ -494,8 +1012,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int currentRow = d->currentRow();
+    PQgetvalue(d->result, currentRow, field);
+    return PQgetisnull(d->result, currentRow, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -506,8 +1025,8 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
-    d->result = d->drv_d_func()->exec(query);
-    return d->processResults();
+    d->binaryResults = false;
+    return d->execute(query);
 }
 
 int QPSQLResult::size()
@@ -593,6 +1112,18 @@ void QPSQLResult::virtual_hook(int id, void *data)
 {
     Q_ASSERT(data);
 
+    Q_D(QPSQLResult);
+    if (id == QSqlResultPrivate::AsyncExecOperation) {
+        QSqlAsyncExecRequest *request = static_cast<QSqlAsyncExecRequest *>(data);
+        request->started = d->executeAsync(request->query, request->future);
+        return;
+    }
+    if (id == QSqlResultPrivate::FetchBlockOperation) {
+        QSqlFetchBlockRequest *request = static_cast<QSqlFetchBlockRequest *>(data);
+        d->fetchBlock(request->block, request->maxRows);
+        request->handled = true;
+        return;
+    }
     QSqlResult::virtual_hook(id, data);
 }
 
@@ -618,6 +1149,47 @@ static QString qCreateParamString(const QVector<QVariant> &boundValues, const QS
     return params;
 }
 
+// Starts the statement without waiting for the server. The connection's
+// socket notifier calls finishAsyncQuery() once the result has arrived,
+// any other use of the connection completes it first.
+bool QPSQLResultPrivate::executeAsync(const QString &query, const QFutureInterface<bool> &future)
+{
+    Q_Q(QPSQLResult);
+    QPSQLDriverPrivate *drv = drv_d_func();
+    if (!drv || !drv->connection || QThread::currentThread() != sqldriver->thread())
+        return false;
+    if (query.isNull() && !preparedQueriesEnabled)
+        return false;
+    if (!drv->enableSocketNotifier())
+        return false;
+
+    q->cleanup();
+    QString stmt = query;
+    if (query.isNull()) {
+        const QString params = qCreateParamString(q->boundValues(), q->driver());
+        if (params.isEmpty())
+            stmt = QString::fromLatin1("EXECUTE %1").arg(preparedStmtId);
+        else
+            stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(preparedStmtId).arg(params);
+    } else {
+        binaryResults = false;
+    }
+
+#ifdef QPSQL_SINGLE_ROW_MODE
+    singleRowMode = q->isForwardOnly();
+#endif
+    stmtId = drv->sendQuery(stmt, binaryResults, singleRowMode);
+    if (stmtId == QPSQLDriverPrivate::InvalidStatementId) {
+        QFutureInterface<bool> failed(future);
+        failed.reportResult(processResults());
+        failed.reportFinished();
+        return true;
+    }
+    asyncExec = future;
+    drv->asyncResult = this;
+    return true;
+}
+
 Q_GLOBAL_STATIC(QMutex, qMutex)
 QString qMakePreparedStmtId()
 {
@@ -654,6 +1226,7 @@ bool QPSQLResult::prepare(const QString &query)
 
     PQclear(result);
     d->preparedStmtId = stmtId;
+    d->binaryResults = d->drv_d_func()->binaryResults && d->hasBinaryDecodableColumns();
     return true;
 }
 
@@ -672,8 +1245,229 @@ bool QPSQLResult::exec()
     else
         stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId).arg(params);
 
-    d->result = d->drv_d_func()->exec(stmt);
+    return d->execute(stmt);
+}
 
+// Turns "INSERT INTO table (columns) VALUES (?, ...)" with nothing but one
+// placeholder per bound value into the equivalent COPY statement.
+static bool qMakeCopyStatement(const QString &query, int placeholderCount, QString *copyStmt)
+{
+    QRegExp rx(QLatin1String("^\\s*INSERT\\s+INTO\\s+((?:\"[^\"]*\"|[^\\s(\"])+)\\s*(\\([^()]*\\))?"
+                             "\\s*VALUES\\s*\\(([^()]*)\\)\\s*;?\\s*$"), Qt::CaseInsensitive);
+    if (!rx.exactMatch(query))
+        return false;
+    const QStringList values = rx.cap(3).split(QLatin1Char(','));
+    if (values.count() != placeholderCount)
+        return false;
+    QRegExp placeholder(QLatin1String("\\?|:\\w+"));
+    for (int i = 0; i < values.count(); ++i) {
+        if (!placeholder.exactMatch(values.at(i).trimmed()))
+            return false;
+    }
+    *copyStmt = QLatin1String("COPY ") + rx.cap(1) + QLatin1Char(' ') + rx.cap(2) + QLatin1String(" FROM STDIN");
+    return true;
+}
+
+// Values that are sent in COPY text format exactly as formatValue() would
+// put them into an INSERT statement. Date-times are excluded, as they are
+// bound as timestamps with time zone, whose conversion depends on the
+// column type.
+static bool qCanCopyValue(const QVariant &value)
+{
+    if (value.isNull())
+        return true;
+    switch (int(value.type())) {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+    case QVariant::Double:
+    case QMetaType::Float:
+    case QVariant::String:
+    case QVariant::ByteArray:
+    case QVariant::Date:
+    case QVariant::Time:
+    case QVariant::Uuid:
+        return true;
+    default:
+        return false;
+    }
+}
+
+template <typename FloatType>
+static bool qAppendSpecialCopyFloat(QByteArray *row, FloatType val)
+{
+    if (isnan(val)) {
+        row->append("NaN");
+        return true;
+    }
+    switch (isinf(val)) {
+    case 1:
+        row->append("Infinity");
+        return true;
+    case -1:
+        row->append("-Infinity");
+        return true;
+    }
+    return false;
+}
+
+static void qAppendCopyValue(QByteArray *row, const QVariant &value, bool isUtf8)
+{
+    if (value.isNull()) {
+        row->append("\\N");
+        return;
+    }
+    switch (int(value.type())) {
+    case QVariant::Bool:
+        row->append(value.toBool() ? 't' : 'f');
+        return;
+    case QMetaType::Float:
+        if (!qAppendSpecialCopyFloat(row, value.toFloat()))
+            row->append(value.toString().toLatin1());
+        return;
+    case QVariant::Double:
+        if (!qAppendSpecialCopyFloat(row, value.toDouble()))
+            row->append(value.toString().toLatin1());
+        return;
+    case QVariant::ByteArray:
+        // hex bytea input, with the backslash escaped for COPY
+        row->append("\\\\x");
+        row->append(value.toByteArray().toHex());
+        return;
+    case QVariant::Date:
+        if (!value.toDate().isValid())
+            row->append("\\N");
+        else
+            row->append(value.toDate().toString(Qt::ISODate).toLatin1());
+        return;
+    case QVariant::Time:
+        if (!value.toTime().isValid())
+            row->append("\\N");
+        else
+            row->append(value.toTime().toString(QLatin1String("hh:mm:ss.zzz")).toLatin1());
+        return;
+    default:
+        break;
+    }
+
+    const QString str = value.toString();
+    const QByteArray encoded = isUtf8 ? str.toUtf8() : str.toLocal8Bit();
+    for (int i = 0; i < encoded.size(); ++i) {
+        const char c = encoded.at(i);
+        switch (c) {
+        case '\\':
+            row->append("\\\\");
+            break;
+        case '\n':
+            row->append("\\n");
+            break;
+        case '\r':
+            row->append("\\r");
+            break;
+        case '\t':
+            row->append("\\t");
+            break;
+        default:
+            row->append(c);
+            break;
+        }
+    }
+}
+
+static bool qExecSimpleCommand(QPSQLDriverPrivate *driver, const char *command)
+{
+    PGresult *result = driver->exec(command);
+    const bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    PQclear(result);
+    return ok;
+}
+
+// With the QPSQL_COPY_BATCHES connect option, a batch insert is sent with
+// COPY ... FROM STDIN, streaming the rows to the server instead of executing
+// the statement once per row. COPY does not apply rules and cannot target
+// views, so if it fails for any reason the batch is executed row by row
+// instead. Inside a transaction, a savepoint keeps the failed COPY from
+// aborting it.
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    const QVector<QVariant> values = boundValues();
+    QString copyStmt;
+    if (!d->drv_d_func()->copyBatches || values.isEmpty() || d->preparedStmtId.isEmpty()
+        || d->drv_d_func()->pro < QPSQLDriver::Version9
+        || !qMakeCopyStatement(lastQuery(), values.count(), &copyStmt)) {
+        return QSqlResult::execBatch(arrayBind);
+    }
+
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (int i = 0; i < values.count(); ++i) {
+        const QVariantList column = values.at(i).toList();
+        if (!columns.isEmpty() && column.count() != columns.at(0).count())
+            return QSqlResult::execBatch(arrayBind);
+        for (int j = 0; j < column.count(); ++j) {
+            if (!qCanCopyValue(column.at(j)))
+                return QSqlResult::execBatch(arrayBind);
+        }
+        columns.append(column);
+    }
+
+    cleanup();
+    QPSQLDriverPrivate *driver = d->drv_d_func();
+    PGconn *connection = driver->connection;
+    const bool savepoint = PQtransactionStatus(connection) == PQTRANS_INTRANS;
+    if (savepoint && !qExecSimpleCommand(driver, "SAVEPOINT qt_copy_batch"))
+        return QSqlResult::execBatch(arrayBind);
+
+    PGresult *copyResult = driver->exec(copyStmt);
+    if (PQresultStatus(copyResult) != PGRES_COPY_IN) {
+        PQclear(copyResult);
+        if (savepoint) {
+            qExecSimpleCommand(driver, "ROLLBACK TO SAVEPOINT qt_copy_batch");
+            qExecSimpleCommand(driver, "RELEASE SAVEPOINT qt_copy_batch");
+        }
+        return QSqlResult::execBatch(arrayBind);
+    }
+    PQclear(copyResult);
+
+    const int bufferSize = 64 * 1024;
+    const bool isUtf8 = d->drv_d_func()->isUtf8;
+    const int rows = columns.at(0).count();
+    QByteArray buffer;
+    buffer.reserve(bufferSize + 1024);
+    bool ok = true;
+    for (int row = 0; ok && row < rows; ++row) {
+        for (int column = 0; column < columns.count(); ++column) {
+            if (column)
+                buffer.append('\t');
+            qAppendCopyValue(&buffer, columns.at(column).at(row), isUtf8);
+        }
+        buffer.append('\n');
+        if (buffer.size() >= bufferSize || row == rows - 1) {
+            ok = PQputCopyData(connection, buffer.constData(), buffer.size()) == 1;
+            buffer.resize(0);
+        }
+    }
+    PQputCopyEnd(connection, ok ? 0 : "QPSQL: unable to send batch data");
+
+    PGresult *endResult = PQgetResult(connection);
+    while (PGresult *result = PQgetResult(connection))
+        PQclear(result);
+    if (PQresultStatus(endResult) != PGRES_COMMAND_OK) {
+        // Report the row that fails, and keep the rows before it, as the
+        // row by row execution does.
+        PQclear(endResult);
+        if (savepoint) {
+            qExecSimpleCommand(driver, "ROLLBACK TO SAVEPOINT qt_copy_batch");
+            qExecSimpleCommand(driver, "RELEASE SAVEPOINT qt_copy_batch");
+        }
+        return QSqlResult::execBatch(arrayBind);
+    }
+    if (savepoint)
+        qExecSimpleCommand(driver, "RELEASE SAVEPOINT qt_copy_batch");
+    d->result = endResult;
     return d->processResults();
 }
 
@@ -713,6 +1507,12 @@ void QPSQLDriverPrivate::detectBackslashEscape()
     }
 }
 
+void QPSQLDriverPrivate::detectIntegerDateTimes()
+{
+    const char *value = PQparameterStatus(connection, "integer_datetimes");
+    integerDateTimes = value && qstrcmp(value, "on") == 0;
+}
+
 static QPSQLDriver::Protocol qMakePSQLVersion(int vMaj, int vMin)
 {
     switch (vMaj) {
@@ -825,6 +1625,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
     if (conn) {
         d->pro = d->getPSQLVersion();
         d->detectBackslashEscape();
+        d->detectIntegerDateTimes();
         setOpen(true);
         setOpenError(false);
     }
@@ -908,9 +1709,20 @@ bool QPSQLDriver::open(const QString & db,
         connectString.append(QLatin1String(" port=")).append(qQuote(QString::number(port)));
 
     // add any connect options - the server will handle error detection
+    d->binaryResults = false;
+    d->copyBatches = false;
     if (!connOpts.isEmpty()) {
         QString opt = connOpts;
         opt.replace(QLatin1Char(';'), QLatin1Char(' '), Qt::CaseInsensitive);
+        // options handled by the driver itself must not reach libpq
+        const QLatin1String binaryResultsOption("QPSQL_BINARY_RESULTS");
+        const QLatin1String copyBatchesOption("QPSQL_COPY_BATCHES");
+        if (opt.contains(binaryResultsOption) || opt.contains(copyBatchesOption)) {
+            QStringList options = opt.split(QLatin1Char(' '), QString::SkipEmptyParts);
+            d->binaryResults = options.removeAll(binaryResultsOption) > 0;
+            d->copyBatches = options.removeAll(copyBatchesOption) > 0;
+            opt = options.join(QLatin1Char(' '));
+        }
         connectString.append(QLatin1Char(' ')).append(opt);
     }
 
@@ -927,6 +1739,7 @@ bool QPSQLDriver::open(const QString & db,
     d->detectBackslashEscape();
     d->isUtf8 = d->setEncodingUtf8();
     d->setDatestyle();
+    d->detectIntegerDateTimes();
 
     setOpen(true);
     setOpenError(false);
@@ -937,6 +1750,8 @@ void QPSQLDriver::close()
 {
     Q_D(QPSQLDriver);
     if (isOpen()) {
+        if (d->asyncResult)
+            d->finishAsyncQuery();
 
         d->seid.clear();
         if (d->sn) {
@@ -948,6 +1763,7 @@ void QPSQLDriver::close()
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
+        d->currentStmtId = QPSQLDriverPrivate::InvalidStatementId;
         setOpen(false);
         setOpenError(false);
     }
@@ -1426,10 +2242,7 @@ bool QPSQLDriver::subscribeToNotification(const QString &name)
         }
         PQclear(result);
 
-        if (!d->sn) {
-            d->sn = new QSocketNotifier(socket, QSocketNotifier::Read);
-            connect(d->sn, SIGNAL(activated(int)), this, SLOT(_q_handleNotification(int)));
-        }
+        d->enableSocketNotifier();
     } else {
         qWarning("QPSQLDriver::subscribeToNotificationImplementation: PQsocket didn't return a valid socket to listen on");
         return false;
@@ -1463,11 +2276,9 @@ bool QPSQLDriver::unsubscribeFromNotification(const QString &name)
 
     d->seid.removeAll(name);
 
-    if (d->seid.isEmpty()) {
-        disconnect(d->sn, SIGNAL(activated(int)), this, SLOT(_q_handleNotification(int)));
-        delete d->sn;
-        d->sn = 0;
-    }
+    // a pending asynchronous query still needs the notifier
+    if (d->seid.isEmpty() && !d->asyncResult)
+        d->disableSocketNotifier();
 
     return true;
 }
@@ -1482,7 +2293,9 @@ void QPSQLDriver::_q_handleNotification(int)
 {
     Q_D(QPSQLDriver);
     d->pendingNotifyCheck = false;
-    PQconsumeInput(d->connection);
+    // a broken connection is reported by the result of the pending query
+    if ((!PQconsumeInput(d->connection) || !PQisBusy(d->connection)) && d->asyncResult)
+        d->finishAsyncQuery();
 
     PGnotify *notify = 0;
     while((notify = PQnotifies(d->connection)) != 0) {
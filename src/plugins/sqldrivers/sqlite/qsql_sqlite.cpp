@@ -47,6 +47,7 @@
 #include <qsqlindex.h>
 #include <qsqlquery.h>
 #include <QtSql/private/qsqlcachedresult_p.h>
+#include <QtSql/private/qsqlcolumnblock_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 #include <qstringlist.h>
 #include <qvector.h>
@@ -125,6 +126,7 @@ protected:
     bool reset(const QString &query) Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
     int size() Q_DECL_OVERRIDE;
     int numRowsAffected() Q_DECL_OVERRIDE;
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
@@ -154,6 +156,9 @@ public:
     QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver *drv);
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    QVariant columnValue(int i) const;
+    void appendColumnValue(QSqlColumnBlockPrivate *block, int i) const;
+    bool fetchBlock(QSqlColumnBlockPrivate *block, int maxRows);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
@@ -247,6 +252,101 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     }
 }
 
+QVariant QSQLiteResultPrivate::columnValue(int i) const
+{
+    Q_Q(const QSQLiteResult);
+    switch (sqlite3_column_type(stmt, i)) {
+    case SQLITE_BLOB:
+        return QByteArray(static_cast<const char *>(
+                    sqlite3_column_blob(stmt, i)),
+                    sqlite3_column_bytes(stmt, i));
+    case SQLITE_INTEGER:
+        return sqlite3_column_int64(stmt, i);
+    case SQLITE_FLOAT:
+        switch(q->numericalPrecisionPolicy()) {
+            case QSql::LowPrecisionInt32:
+                return sqlite3_column_int(stmt, i);
+            case QSql::LowPrecisionInt64:
+                return sqlite3_column_int64(stmt, i);
+            case QSql::LowPrecisionDouble:
+            case QSql::HighPrecision:
+            default:
+                return sqlite3_column_double(stmt, i);
+        };
+    case SQLITE_NULL:
+        return QVariant(QVariant::String);
+    default:
+        return QString(reinterpret_cast<const QChar *>(
+                    sqlite3_column_text16(stmt, i)),
+                    sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+    }
+}
+
+void QSQLiteResultPrivate::appendColumnValue(QSqlColumnBlockPrivate *block, int i) const
+{
+    const int type = sqlite3_column_type(stmt, i);
+    if (type == SQLITE_NULL) {
+        block->appendNull(i);
+        return;
+    }
+    switch (block->columns.at(i).type) {
+    case QSqlColumnBlock::IntegerColumn:
+        if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+            block->appendInteger(i, sqlite3_column_int64(stmt, i));
+            return;
+        }
+        break;
+    case QSqlColumnBlock::RealColumn:
+        if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+            block->appendReal(i, sqlite3_column_double(stmt, i));
+            return;
+        }
+        break;
+    case QSqlColumnBlock::StringColumn:
+        if (type != SQLITE_BLOB) {
+            // the size is only valid after the conversion to UTF-16
+            const QChar *data = static_cast<const QChar *>(sqlite3_column_text16(stmt, i));
+            block->appendString(i, data, sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+            return;
+        }
+        break;
+    case QSqlColumnBlock::VariantColumn:
+        break;
+    }
+    block->appendValue(i, columnValue(i));
+}
+
+// Steps through the rows of a forward-only result decoding them straight
+// into block. Scrollable results cache every row anyway, so they are left
+// to the generic implementation.
+bool QSQLiteResultPrivate::fetchBlock(QSqlColumnBlockPrivate *block, int maxRows)
+{
+    Q_Q(QSQLiteResult);
+    if (!q->isForwardOnly() || atEnd)
+        return false;
+
+    const int columns = block->columns.count();
+    while (block->rowCount < maxRows) {
+        // only tells whether there is a row, without copying it
+        if (!fetchNext(cache, -1, false)) {
+            atEnd = true;
+            q->setAt(QSql::AfterLastRow);
+            return true;
+        }
+        q->setAt(q->at() + 1);
+        for (int i = 0; i < columns; ++i)
+            appendColumnValue(block, i);
+        block->endRow();
+    }
+
+    // the statement is still on the last row of the block; make it the
+    // current row for QSqlQuery::value()
+    cache.resize(colCount);
+    for (int i = 0; i < colCount; ++i)
+        cache[i] = columnValue(i);
+    return true;
+}
+
 bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch)
 {
     Q_Q(QSQLiteResult);
@@ -284,41 +384,8 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
             initColumns(false);
         if (idx < 0 && !initialFetch)
             return true;
-        for (i = 0; i < rInf.count(); ++i) {
-            switch (sqlite3_column_type(stmt, i)) {
-            case SQLITE_BLOB:
-                values[i + idx] = QByteArray(static_cast<const char *>(
-                            sqlite3_column_blob(stmt, i)),
-                            sqlite3_column_bytes(stmt, i));
-                break;
-            case SQLITE_INTEGER:
-                values[i + idx] = sqlite3_column_int64(stmt, i);
-                break;
-            case SQLITE_FLOAT:
-                switch(q->numericalPrecisionPolicy()) {
-                    case QSql::LowPrecisionInt32:
-                        values[i + idx] = sqlite3_column_int(stmt, i);
-                        break;
-                    case QSql::LowPrecisionInt64:
-                        values[i + idx] = sqlite3_column_int64(stmt, i);
-                        break;
-                    case QSql::LowPrecisionDouble:
-                    case QSql::HighPrecision:
-                    default:
-                        values[i + idx] = sqlite3_column_double(stmt, i);
-                        break;
-                };
-                break;
-            case SQLITE_NULL:
-                values[i + idx] = QVariant(QVariant::String);
-                break;
-            default:
-                values[i + idx] = QString(reinterpret_cast<const QChar *>(
-                            sqlite3_column_text16(stmt, i)),
-                            sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
-                break;
-            }
-        }
+        for (i = 0; i < rInf.count(); ++i)
+            values[i + idx] = columnValue(i);
         return true;
     case SQLITE_DONE:
         if (rInf.isEmpty())
@@ -366,6 +433,12 @@ QSQLiteResult::~QSQLiteResult()
 
 void QSQLiteResult::virtual_hook(int id, void *data)
 {
+    Q_D(QSQLiteResult);
+    if (id == QSqlResultPrivate::FetchBlockOperation) {
+        QSqlFetchBlockRequest *request = static_cast<QSqlFetchBlockRequest *>(data);
+        request->handled = d->fetchBlock(request->block, request->maxRows);
+        return;
+    }
     QSqlCachedResult::virtual_hook(id, data);
 }
 
@@ -505,6 +578,29 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_D(QSQLiteResult);
+    sqlite3 *access = d->drv_d_func()->access;
+    // In autocommit mode SQLite commits, and syncs its journal, after every
+    // row. Execute the prepared statement for all rows in one transaction
+    // instead, unless the caller already started one.
+    const bool ownTransaction = access && sqlite3_get_autocommit(access)
+            && sqlite3_exec(access, "BEGIN", 0, 0, 0) == SQLITE_OK;
+    const bool ok = QSqlCachedResult::execBatch(arrayBind);
+    if (ownTransaction) {
+        // as in autocommit mode, rows executed before a failing one are kept
+        const int res = sqlite3_exec(access, "COMMIT", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to commit batch"), QSqlError::TransactionError, res));
+            sqlite3_exec(access, "ROLLBACK", 0, 0, 0);
+            return false;
+        }
+    }
+    return ok;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     Q_D(QSQLiteResult);
@@ -1,6 +1,9 @@
 HEADERS +=      kernel/qsql.h \
                 kernel/qsqlquery.h \
                 kernel/qsqldatabase.h \
+                kernel/qsqlconnectionpool.h \
+                kernel/qsqlcolumnblock.h \
+                kernel/qsqlcolumnblock_p.h \
                 kernel/qsqlfield.h \
                 kernel/qsqlrecord.h \
                 kernel/qsqldriver.h \
@@ -15,6 +18,8 @@ HEADERS +=      kernel/qsql.h \
 
 SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqldatabase.cpp \
+                kernel/qsqlconnectionpool.cpp \
+                kernel/qsqlcolumnblock.cpp \
                 kernel/qsqlfield.cpp \
                 kernel/qsqlrecord.cpp \
                 kernel/qsqldriver.cpp \
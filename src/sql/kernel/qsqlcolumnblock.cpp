@@ -0,0 +1,552 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlcolumnblock.h"
+#include "qsqlcolumnblock_p.h"
+
+#include "qsqlfield.h"
+#include "qsqlrecord.h"
+
+QT_BEGIN_NAMESPACE
+
+// Floating point fields are stored the way the precision policy makes
+// QSqlQuery::value() return them.
+QSqlColumnBlock::ColumnType QSqlColumnBlockPrivate::columnType(QVariant::Type fieldType,
+                                                               QSql::NumericalPrecisionPolicy precisionPolicy)
+{
+    switch (int(fieldType)) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+        return QSqlColumnBlock::IntegerColumn;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        switch (precisionPolicy) {
+        case QSql::LowPrecisionInt32:
+        case QSql::LowPrecisionInt64:
+            return QSqlColumnBlock::IntegerColumn;
+        case QSql::LowPrecisionDouble:
+            return QSqlColumnBlock::RealColumn;
+        case QSql::HighPrecision:
+            break;
+        }
+        return QSqlColumnBlock::VariantColumn;
+    case QMetaType::QString:
+        return QSqlColumnBlock::StringColumn;
+    default:
+        return QSqlColumnBlock::VariantColumn;
+    }
+}
+
+// Returns the type of the values QSqlQuery::value() returns for a field of
+// the given type under the precision policy.
+static QVariant::Type qValueType(QVariant::Type fieldType, QSql::NumericalPrecisionPolicy precisionPolicy)
+{
+    if (fieldType != QVariant::Double && int(fieldType) != QMetaType::Float)
+        return fieldType;
+    switch (precisionPolicy) {
+    case QSql::LowPrecisionInt32:
+        return QVariant::Int;
+    case QSql::LowPrecisionInt64:
+        return QVariant::LongLong;
+    case QSql::LowPrecisionDouble:
+        return QVariant::Double;
+    case QSql::HighPrecision:
+        break;
+    }
+    return fieldType;
+}
+
+// Empties the container but keeps its memory, which resize() alone would
+// release when shrinking, so that a block is refilled without reallocating.
+// The memory grows with the rows fetched, not with the maximum requested.
+template <typename Container>
+static inline void qTruncateKeepingCapacity(Container &container, bool keep)
+{
+    if (keep) {
+        container.reserve(container.capacity());
+        container.resize(0);
+    } else {
+        container = Container();
+    }
+}
+
+void QSqlColumnBlockPrivate::reset(const QSqlRecord &record, QSql::NumericalPrecisionPolicy precisionPolicy)
+{
+    const int count = record.count();
+    columns.resize(count);
+    rowCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const QSqlField field = record.field(i);
+        Column &column = columns[i];
+        column.type = columnType(field.type(), precisionPolicy);
+        column.fieldType = field.type();
+        column.valueType = qValueType(field.type(), precisionPolicy);
+        column.name = field.name();
+        column.nulls.resize(0);
+
+        qTruncateKeepingCapacity(column.integers, column.type == QSqlColumnBlock::IntegerColumn);
+        qTruncateKeepingCapacity(column.reals, column.type == QSqlColumnBlock::RealColumn);
+        qTruncateKeepingCapacity(column.variants, column.type == QSqlColumnBlock::VariantColumn);
+        qTruncateKeepingCapacity(column.offsets, column.type == QSqlColumnBlock::StringColumn);
+        qTruncateKeepingCapacity(column.chars, column.type == QSqlColumnBlock::StringColumn);
+        if (column.type == QSqlColumnBlock::StringColumn)
+            column.offsets.append(0);
+    }
+}
+
+void QSqlColumnBlockPrivate::finish()
+{
+    for (int i = 0; i < columns.count(); ++i)
+        columns[i].nulls.resize(rowCount);
+}
+
+void QSqlColumnBlockPrivate::appendNull(int column)
+{
+    Column &c = columns[column];
+    if (rowCount >= c.nulls.size())
+        c.nulls.resize(qMax(64, qMax(rowCount + 1, c.nulls.size() * 2)));
+    c.nulls.setBit(rowCount);
+    switch (c.type) {
+    case QSqlColumnBlock::IntegerColumn:
+        c.integers.append(0);
+        break;
+    case QSqlColumnBlock::RealColumn:
+        c.reals.append(0.0);
+        break;
+    case QSqlColumnBlock::StringColumn:
+        c.offsets.append(c.chars.size());
+        break;
+    case QSqlColumnBlock::VariantColumn:
+        c.variants.append(QVariant(c.fieldType));
+        break;
+    }
+}
+
+void QSqlColumnBlockPrivate::appendInteger(int column, qint64 value)
+{
+    Column &c = columns[column];
+    switch (c.type) {
+    case QSqlColumnBlock::IntegerColumn:
+        c.integers.append(value);
+        break;
+    case QSqlColumnBlock::RealColumn:
+        c.reals.append(double(value));
+        break;
+    default:
+        appendValue(column, QVariant(qlonglong(value)));
+        break;
+    }
+}
+
+void QSqlColumnBlockPrivate::appendReal(int column, double value)
+{
+    Column &c = columns[column];
+    switch (c.type) {
+    case QSqlColumnBlock::RealColumn:
+        c.reals.append(value);
+        break;
+    case QSqlColumnBlock::IntegerColumn:
+        c.integers.append(qint64(value));
+        break;
+    default:
+        appendValue(column, QVariant(value));
+        break;
+    }
+}
+
+void QSqlColumnBlockPrivate::appendString(int column, const QChar *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type == QSqlColumnBlock::StringColumn) {
+        c.chars.append(data, size);
+        c.offsets.append(c.chars.size());
+    } else {
+        appendValue(column, QString(data, size));
+    }
+}
+
+void QSqlColumnBlockPrivate::appendLatin1(int column, const char *data, int size)
+{
+    Column &c = columns[column];
+    if (c.type == QSqlColumnBlock::StringColumn) {
+        c.chars.append(QLatin1String(data, size));
+        c.offsets.append(c.chars.size());
+    } else {
+        appendValue(column, QString::fromLatin1(data, size));
+    }
+}
+
+void QSqlColumnBlockPrivate::appendUtf8(int column, const char *data, int size)
+{
+    // plain ASCII, by far the most common case, needs no temporary string
+    for (int i = 0; i < size; ++i) {
+        if (uchar(data[i]) >= 0x80) {
+            const QString str = QString::fromUtf8(data, size);
+            appendString(column, str.constData(), str.size());
+            return;
+        }
+    }
+    appendLatin1(column, data, size);
+}
+
+void QSqlColumnBlockPrivate::appendValue(int column, const QVariant &value)
+{
+    if (value.isNull()) {
+        appendNull(column);
+        return;
+    }
+    Column &c = columns[column];
+    switch (c.type) {
+    case QSqlColumnBlock::IntegerColumn:
+        c.integers.append(value.toLongLong());
+        break;
+    case QSqlColumnBlock::RealColumn:
+        c.reals.append(value.toDouble());
+        break;
+    case QSqlColumnBlock::StringColumn:
+        c.chars.append(value.toString());
+        c.offsets.append(c.chars.size());
+        break;
+    case QSqlColumnBlock::VariantColumn:
+        c.variants.append(value);
+        break;
+    }
+}
+
+/*!
+    \class QSqlColumnBlock
+    \brief The QSqlColumnBlock class holds a block of rows fetched by
+    QSqlQuery::fetchBlock() column by column.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.9
+
+    Instead of one QVariant per value, a column block stores the values
+    of each column in a typed buffer, as chosen by columnType() from the
+    type of the corresponding field of QSqlQuery::record():
+
+    \table
+    \header \li Column type \li Field types \li Storage
+    \row \li IntegerColumn \li \c bool and the integer types
+         \li integerColumn(), one \c qint64 per row
+    \row \li RealColumn \li \c double and \c float
+         \li realColumn(), one \c double per row
+    \row \li StringColumn \li QString
+         \li stringData() holds the strings of all rows back to back,
+             stringOffsets() the position of each of them
+    \row \li VariantColumn \li all other types
+         \li variantColumn(), one QVariant per row
+    \endtable
+
+    The \c double and \c float fields are only stored in a RealColumn
+    with the default QSql::LowPrecisionDouble
+    \l{QSqlQuery::numericalPrecisionPolicy()}{numerical precision policy}.
+    With QSql::LowPrecisionInt32 and QSql::LowPrecisionInt64 they are
+    stored in an IntegerColumn, and with QSql::HighPrecision, which keeps
+    exact decimal values such as PostgreSQL \c NUMERIC as strings, in a
+    VariantColumn holding what QSqlQuery::value() returns.
+
+    Every column also has a nullBitmap() with one bit per row. The
+    buffer entries of NULL values are \c 0, \c 0.0, empty strings or
+    null QVariants.
+
+    Drivers that support it, such as the SQLite and PostgreSQL drivers,
+    decode the rows straight into the buffers. For the others the values
+    are retrieved with QSqlQuery::next() and QSqlQuery::value() and then
+    converted, so the buffers are filled the same way with every driver.
+
+    Reusing the same block for consecutive calls to
+    QSqlQuery::fetchBlock() avoids reallocating its buffers:
+
+    \snippet code/src_sql_kernel_qsqlcolumnblock.cpp 0
+
+    \sa QSqlQuery::fetchBlock()
+*/
+
+/*!
+    \enum QSqlColumnBlock::ColumnType
+
+    This enum type describes how the values of a column are stored.
+
+    \value IntegerColumn The values are stored as \c qint64.
+    \value RealColumn The values are stored as \c double.
+    \value StringColumn The values are stored in a single QString.
+    \value VariantColumn The values are stored as QVariant.
+*/
+
+/*!
+    Constructs an empty column block.
+*/
+QSqlColumnBlock::QSqlColumnBlock()
+    : d(new QSqlColumnBlockPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+
+    QSqlColumnBlock is implicitly shared, so copying a block is cheap.
+*/
+QSqlColumnBlock::QSqlColumnBlock(const QSqlColumnBlock &other)
+    : d(other.d)
+{
+}
+
+/*!
+    \fn QSqlColumnBlock &QSqlColumnBlock::operator=(QSqlColumnBlock &&other)
+
+    Move-assigns \a other to this column block.
+*/
+
+/*!
+    Assigns \a other to this column block and returns a reference to it.
+*/
+QSqlColumnBlock &QSqlColumnBlock::operator=(const QSqlColumnBlock &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the column block.
+*/
+QSqlColumnBlock::~QSqlColumnBlock()
+{
+}
+
+/*!
+    \fn void QSqlColumnBlock::swap(QSqlColumnBlock &other)
+
+    Swaps this column block with \a other. This operation is very fast
+    and never fails.
+*/
+
+/*!
+    Returns the number of rows in the block.
+
+    \sa columnCount(), isEmpty()
+*/
+int QSqlColumnBlock::rowCount() const
+{
+    return d->rowCount;
+}
+
+/*!
+    Returns the number of columns in the block, which is the number of
+    fields of the query the block was fetched from.
+*/
+int QSqlColumnBlock::columnCount() const
+{
+    return d->columns.count();
+}
+
+/*!
+    \fn bool QSqlColumnBlock::isEmpty() const
+
+    Returns \c true if the block holds no rows.
+*/
+
+/*!
+    Removes all rows and columns from the block.
+*/
+void QSqlColumnBlock::clear()
+{
+    d->columns.clear();
+    d->rowCount = 0;
+}
+
+/*!
+    Returns how the values of \a column are stored.
+*/
+QSqlColumnBlock::ColumnType QSqlColumnBlock::columnType(int column) const
+{
+    return d->columns.at(column).type;
+}
+
+/*!
+    Returns the name of the field \a column was fetched from.
+*/
+QString QSqlColumnBlock::columnName(int column) const
+{
+    return d->columns.at(column).name;
+}
+
+/*!
+    Returns the null bitmap of \a column. Bit \e i is set if the value
+    in row \e i is NULL.
+
+    \sa isNull()
+*/
+QBitArray QSqlColumnBlock::nullBitmap(int column) const
+{
+    return d->columns.at(column).nulls;
+}
+
+/*!
+    Returns \c true if the value at \a row in \a column is NULL.
+*/
+bool QSqlColumnBlock::isNull(int row, int column) const
+{
+    return d->columns.at(column).nulls.testBit(row);
+}
+
+/*!
+    Returns the values of \a column if it is an IntegerColumn, or an
+    empty vector otherwise.
+*/
+QVector<qint64> QSqlColumnBlock::integerColumn(int column) const
+{
+    return d->columns.at(column).integers;
+}
+
+/*!
+    Returns the values of \a column if it is a RealColumn, or an empty
+    vector otherwise.
+*/
+QVector<double> QSqlColumnBlock::realColumn(int column) const
+{
+    return d->columns.at(column).reals;
+}
+
+/*!
+    Returns the strings of all rows of \a column back to back if it is a
+    StringColumn, or a null string otherwise.
+
+    \sa stringOffsets(), string()
+*/
+QString QSqlColumnBlock::stringData(int column) const
+{
+    return d->columns.at(column).chars;
+}
+
+/*!
+    Returns the offsets of the strings in stringData() if \a column is a
+    StringColumn, or an empty vector otherwise. The string of row \e i
+    starts at offset \e i and ends at offset \e i + 1, so there is one
+    more offset than rows.
+*/
+QVector<int> QSqlColumnBlock::stringOffsets(int column) const
+{
+    return d->columns.at(column).offsets;
+}
+
+/*!
+    Returns the values of \a column if it is a VariantColumn, or an
+    empty vector otherwise.
+*/
+QVector<QVariant> QSqlColumnBlock::variantColumn(int column) const
+{
+    return d->columns.at(column).variants;
+}
+
+/*!
+    Returns the value at \a row in \a column converted to an integer.
+*/
+qint64 QSqlColumnBlock::integer(int row, int column) const
+{
+    const QSqlColumnBlockPrivate::Column &c = d->columns.at(column);
+    if (c.type == IntegerColumn)
+        return c.integers.at(row);
+    return value(row, column).toLongLong();
+}
+
+/*!
+    Returns the value at \a row in \a column converted to a double.
+*/
+double QSqlColumnBlock::real(int row, int column) const
+{
+    const QSqlColumnBlockPrivate::Column &c = d->columns.at(column);
+    if (c.type == RealColumn)
+        return c.reals.at(row);
+    return value(row, column).toDouble();
+}
+
+/*!
+    Returns the value at \a row in \a column converted to a string.
+*/
+QString QSqlColumnBlock::string(int row, int column) const
+{
+    const QSqlColumnBlockPrivate::Column &c = d->columns.at(column);
+    if (c.type == StringColumn) {
+        const int start = c.offsets.at(row);
+        return c.chars.mid(start, c.offsets.at(row + 1) - start);
+    }
+    return value(row, column).toString();
+}
+
+/*!
+    Returns the value at \a row in \a column as a QVariant of the type
+    QSqlQuery::value() returns for it. That is the type of the field it
+    was fetched from, except for \c double and \c float fields fetched
+    with a QSql::LowPrecisionInt32, QSql::LowPrecisionInt64 or
+    QSql::LowPrecisionDouble policy, whose values are returned as \c int,
+    \c qlonglong or \c double respectively.
+*/
+QVariant QSqlColumnBlock::value(int row, int column) const
+{
+    const QSqlColumnBlockPrivate::Column &c = d->columns.at(column);
+    if (c.type == VariantColumn)
+        return c.variants.at(row);
+    if (c.nulls.testBit(row))
+        return QVariant(c.valueType);
+
+    QVariant v;
+    switch (c.type) {
+    case IntegerColumn:
+        v = qlonglong(c.integers.at(row));
+        break;
+    case RealColumn:
+        v = c.reals.at(row);
+        break;
+    default:
+        v = string(row, column);
+        break;
+    }
+    if (c.valueType != QVariant::Invalid && v.type() != c.valueType)
+        v.convert(c.valueType);
+    return v;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLCOLUMNBLOCK_H
+#define QSQLCOLUMNBLOCK_H
+
+#include <QtSql/qsql.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QBitArray;
+class QSqlColumnBlockPrivate;
+
+class Q_SQL_EXPORT QSqlColumnBlock
+{
+public:
+    enum ColumnType {
+        IntegerColumn,
+        RealColumn,
+        StringColumn,
+        VariantColumn
+    };
+
+    QSqlColumnBlock();
+    QSqlColumnBlock(const QSqlColumnBlock &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QSqlColumnBlock &operator=(QSqlColumnBlock &&other) Q_DECL_NOTHROW { swap(other); return *this; }
+#endif
+    QSqlColumnBlock &operator=(const QSqlColumnBlock &other);
+    ~QSqlColumnBlock();
+
+    void swap(QSqlColumnBlock &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    int rowCount() const;
+    int columnCount() const;
+    bool isEmpty() const { return rowCount() == 0; }
+    void clear();
+
+    ColumnType columnType(int column) const;
+    QString columnName(int column) const;
+    QBitArray nullBitmap(int column) const;
+    bool isNull(int row, int column) const;
+
+    QVector<qint64> integerColumn(int column) const;
+    QVector<double> realColumn(int column) const;
+    QString stringData(int column) const;
+    QVector<int> stringOffsets(int column) const;
+    QVector<QVariant> variantColumn(int column) const;
+
+    qint64 integer(int row, int column) const;
+    double real(int row, int column) const;
+    QString string(int row, int column) const;
+    QVariant value(int row, int column) const;
+
+private:
+    friend class QSqlQuery;
+    QSharedDataPointer<QSqlColumnBlockPrivate> d;
+};
+
+Q_DECLARE_SHARED(QSqlColumnBlock)
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNBLOCK_H
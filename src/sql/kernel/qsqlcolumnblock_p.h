@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLCOLUMNBLOCK_P_H
+#define QSQLCOLUMNBLOCK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtSql/qsqlcolumnblock.h"
+#include "QtCore/qbitarray.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSqlRecord;
+
+class Q_SQL_EXPORT QSqlColumnBlockPrivate : public QSharedData
+{
+public:
+    struct Column
+    {
+        Column()
+            : type(QSqlColumnBlock::VariantColumn), fieldType(QVariant::Invalid), valueType(QVariant::Invalid) { }
+
+        QSqlColumnBlock::ColumnType type;
+        QVariant::Type fieldType;
+        QVariant::Type valueType; // what QSqlQuery::value() returns under the policy
+        QString name;
+        QBitArray nulls;
+        // only the vector matching type is filled, with one entry per row
+        QVector<qint64> integers;
+        QVector<double> reals;
+        QVector<QVariant> variants;
+        // the strings of all rows back to back; row i spans
+        // offsets[i] to offsets[i + 1]
+        QString chars;
+        QVector<int> offsets;
+    };
+
+    QSqlColumnBlockPrivate() : rowCount(0) { }
+
+    static QSqlColumnBlock::ColumnType columnType(QVariant::Type fieldType,
+                                                  QSql::NumericalPrecisionPolicy precisionPolicy);
+
+    // Sets up one column per field of record, reusing the memory of the
+    // previous block. The columns grow with the rows that are appended.
+    void reset(const QSqlRecord &record, QSql::NumericalPrecisionPolicy precisionPolicy);
+    void finish();
+
+    // Writers call one append function per column and then endRow().
+    void appendNull(int column);
+    void appendInteger(int column, qint64 value);
+    void appendReal(int column, double value);
+    void appendString(int column, const QChar *data, int size);
+    void appendLatin1(int column, const char *data, int size);
+    void appendUtf8(int column, const char *data, int size);
+    void appendValue(int column, const QVariant &value);
+    void endRow() { ++rowCount; }
+
+    QVector<Column> columns;
+    int rowCount;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNBLOCK_P_H
@@ -0,0 +1,653 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlconnectionpool.h"
+
+#ifndef QT_NO_THREAD
+
+#include "qcoreapplication.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qpointer.h"
+#include "qsqldriver.h"
+#include "qsqlerror.h"
+#include "qsqlquery.h"
+#include "qstringlist.h"
+#include "qthread.h"
+#include "qvector.h"
+#include "qwaitcondition.h"
+
+#include <limits.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QSqlPooledConnection
+{
+    QString name;
+    // thread the connection is bound to, or 0 if it can be moved to any thread
+    QThread *thread;
+    // tells whether that thread is gone, and the connection no longer in use
+    QPointer<QThread> owner;
+    QElapsedTimer idleTimer;
+};
+Q_DECLARE_TYPEINFO(QSqlPooledConnection, Q_MOVABLE_TYPE);
+
+class QSqlConnectionPoolPrivate
+{
+public:
+    QSqlConnectionPoolPrivate(const QString &name)
+        : connectionName(name),
+          minimumSize(0),
+          maximumSize(qMax(2, QThread::idealThreadCount())),
+          idleTimeout(60000),
+          connectionCount(0),
+          nextId(0),
+          acquireCount(0),
+          waitCount(0),
+          timeoutCount(0),
+          totalWaitTime(0),
+          maximumWaitTime(0)
+    { }
+
+    QString newConnectionName();
+    QStringList takeExpiredConnections(QThread *thread);
+    void evictIdleConnection(QStringList *removed);
+    static void removeConnections(const QStringList &names);
+
+    QString connectionName;
+    QString healthCheckQuery;
+    int minimumSize;
+    int maximumSize;
+    int idleTimeout;
+
+    mutable QMutex mutex;
+    QWaitCondition connectionReleased;
+    // least recently released first
+    QVector<QSqlPooledConnection> idle;
+    // idle connections bound to other threads, which are to close them
+    QVector<QSqlPooledConnection> evicted;
+    // names of the acquired connections, and whether they can be moved
+    // to another thread once they are released
+    QHash<QString, bool> acquired;
+    // idle, acquired and currently opening connections
+    int connectionCount;
+    int nextId;
+    QSqlError lastError;
+
+    int acquireCount;
+    int waitCount;
+    int timeoutCount;
+    qint64 totalWaitTime;
+    qint64 maximumWaitTime;
+};
+
+QString QSqlConnectionPoolPrivate::newConnectionName()
+{
+    return QString::fromLatin1("%1-pool-%2-%3").arg(connectionName)
+            .arg(quintptr(this), 0, 16).arg(++nextId);
+}
+
+// Takes the connections evicted from the pool that are bound to \a thread,
+// and those that have been idle for longer than the idle timeout, as long
+// as there are more than the minimum, out of the pool. Connections bound to
+// another thread are left to that thread.
+QStringList QSqlConnectionPoolPrivate::takeExpiredConnections(QThread *thread)
+{
+    QStringList names;
+    for (int i = 0; i < evicted.count();) {
+        if (evicted.at(i).thread == thread) {
+            names.append(evicted.at(i).name);
+            evicted.remove(i);
+            --connectionCount;
+        } else {
+            ++i;
+        }
+    }
+    if (idleTimeout < 0)
+        return names;
+    for (int i = 0; i < idle.count() && connectionCount > minimumSize;) {
+        const QSqlPooledConnection &connection = idle.at(i);
+        if (connection.idleTimer.elapsed() >= idleTimeout
+            && (!connection.thread || connection.thread == thread)) {
+            names.append(connection.name);
+            idle.remove(i);
+            --connectionCount;
+        } else {
+            ++i;
+        }
+    }
+    return names;
+}
+
+static inline bool qIsOwnerGone(const QSqlPooledConnection &connection)
+{
+    return !connection.owner || connection.owner->isFinished();
+}
+
+// Makes room for a new connection when the pool is full and only
+// connections bound to other threads are idle. A connection is only closed
+// by the thread it is bound to, the next time that thread acquires or
+// releases a connection, unless the thread has finished.
+void QSqlConnectionPoolPrivate::evictIdleConnection(QStringList *removed)
+{
+    for (int i = 0; i < evicted.count(); ++i) {
+        if (qIsOwnerGone(evicted.at(i))) {
+            removed->append(evicted.at(i).name);
+            evicted.remove(i);
+            --connectionCount;
+            return;
+        }
+    }
+    for (int i = 0; i < idle.count(); ++i) {
+        if (qIsOwnerGone(idle.at(i))) {
+            removed->append(idle.at(i).name);
+            idle.remove(i);
+            --connectionCount;
+            return;
+        }
+    }
+    if (evicted.isEmpty() && !idle.isEmpty())
+        evicted.append(idle.takeFirst());
+}
+
+void QSqlConnectionPoolPrivate::removeConnections(const QStringList &names)
+{
+    for (int i = 0; i < names.count(); ++i)
+        QSqlDatabase::removeDatabase(names.at(i));
+}
+
+// Drivers whose client library can use a connection from any thread, as
+// long as only one thread uses it at a time. Connections subscribed to
+// notifications rely on a socket notifier in the thread that subscribed.
+// QPSQL only keeps the socket notifier of QSqlQuery::execAsync() until the
+// query has finished, which it must have before the connection is released.
+static bool qCanMoveConnection(const QSqlDatabase &db)
+{
+    const QString driverName = db.driverName();
+    if (driverName != QLatin1String("QSQLITE")
+        && !driverName.startsWith(QLatin1String("QPSQL"))
+        && !driverName.startsWith(QLatin1String("QODBC"))) {
+        return false;
+    }
+    return db.driver()->subscribedToNotifications().isEmpty();
+}
+
+static bool qCheckConnection(const QSqlDatabase &db, const QString &healthCheckQuery, QSqlError *error)
+{
+    if (!db.isOpen()) {
+        *error = db.lastError().isValid() ? db.lastError()
+                 : QSqlError(QCoreApplication::translate("QSqlConnectionPool", "Connection is closed"),
+                             QString(), QSqlError::ConnectionError);
+        return false;
+    }
+    if (healthCheckQuery.isEmpty())
+        return true;
+    QSqlQuery query(db);
+    if (!query.exec(healthCheckQuery)) {
+        *error = query.lastError();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class shares database connections
+    between threads.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.9
+
+    A database connection may only be used by one thread at a time.
+    Instead of opening a connection for each task, threads can acquire()
+    a connection from a pool and release() it when they are done. The
+    pool opens new connections, with the same settings as the connection
+    it was created for, until maximumSize() connections are open; after
+    that acquire() waits until another thread releases a connection.
+
+    \snippet code/src_sql_kernel_qsqlconnectionpool.cpp 0
+
+    Released connections of the QSQLITE, QPSQL and QODBC drivers can be
+    acquired by any thread; the pool moves them to the thread that
+    acquires them. Connections of other drivers, and connections
+    subscribed to notifications, are only handed out again to the thread
+    that opened them. When the pool is full and another thread needs a
+    connection, such an idle connection is closed to make room; this is
+    done by the thread it belongs to the next time that thread calls
+    acquire() or release(), or right away if that thread has finished.
+
+    Connections that have been idle for longer than idleTimeout() are
+    closed, as long as more than minimumSize() connections are open. If a
+    healthCheckQuery() is set, it is executed on each connection before
+    it is handed out, and connections for which it fails are replaced.
+
+    The pool keeps statistics about how often and for how long acquire()
+    had to wait for a connection, which help to choose the maximum size.
+
+    All functions of QSqlConnectionPool are thread-safe.
+
+    \sa QSqlDatabase, {Threads and the SQL Module}
+*/
+
+/*!
+    Constructs a pool of connections opened with the same settings as the
+    database connection \a connectionName, which must have been added with
+    QSqlDatabase::addDatabase(). The connection itself is not used by the
+    pool.
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QString &connectionName)
+    : d(new QSqlConnectionPoolPrivate(connectionName))
+{
+}
+
+/*!
+    Destroys the pool and closes its idle connections. Connections that
+    are still acquired stay open.
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    QStringList names;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!d->acquired.isEmpty())
+            qWarning("QSqlConnectionPool: destroyed while %d connections are still in use",
+                     d->acquired.count());
+        for (int i = 0; i < d->idle.count(); ++i)
+            names.append(d->idle.at(i).name);
+        for (int i = 0; i < d->evicted.count(); ++i)
+            names.append(d->evicted.at(i).name);
+        d->idle.clear();
+        d->evicted.clear();
+    }
+    QSqlConnectionPoolPrivate::removeConnections(names);
+    delete d;
+}
+
+/*!
+    Returns the name of the connection whose settings the pool uses.
+*/
+QString QSqlConnectionPool::connectionName() const
+{
+    return d->connectionName;
+}
+
+/*!
+    Sets the number of connections that are kept open when they are idle
+    to \a size. The default is 0.
+
+    \sa setIdleTimeout()
+*/
+void QSqlConnectionPool::setMinimumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->minimumSize = qMax(0, size);
+}
+
+/*!
+    Returns the number of connections that are kept open when they are
+    idle.
+*/
+int QSqlConnectionPool::minimumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->minimumSize;
+}
+
+/*!
+    Sets the maximum number of open connections to \a size. The default
+    is QThread::idealThreadCount(), but at least 2.
+*/
+void QSqlConnectionPool::setMaximumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maximumSize = qMax(1, size);
+    d->connectionReleased.wakeAll();
+}
+
+/*!
+    Returns the maximum number of open connections.
+*/
+int QSqlConnectionPool::maximumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumSize;
+}
+
+/*!
+    Sets the time after which an idle connection is closed to \a msecs
+    milliseconds. A negative value keeps idle connections open. The
+    default is 60 seconds.
+
+    Idle connections are closed when connections are acquired or
+    released.
+*/
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    QMutexLocker locker(&d->mutex);
+    d->idleTimeout = msecs;
+}
+
+/*!
+    Returns the time in milliseconds after which an idle connection is
+    closed.
+*/
+int QSqlConnectionPool::idleTimeout() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the \a query that is executed on a connection before acquire()
+    returns it. A connection on which the query fails, for example
+    because the server closed it, is closed and replaced. By default no
+    query is executed, and only connections that are no longer open are
+    replaced.
+*/
+void QSqlConnectionPool::setHealthCheckQuery(const QString &query)
+{
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckQuery = query;
+}
+
+/*!
+    Returns the query that checks connections before they are acquired.
+*/
+QString QSqlConnectionPool::healthCheckQuery() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckQuery;
+}
+
+/*!
+    Returns an open connection for the calling thread, which has to be
+    handed back with release() when the thread is done with it.
+
+    If all connections are in use and the pool has reached its maximum
+    size, waits at most \a timeout milliseconds for another thread to
+    release one; a negative \a timeout waits forever. Returns an invalid
+    QSqlDatabase if no connection became available in time, or if a new
+    connection could not be opened; lastError() then returns the reason.
+*/
+QSqlDatabase QSqlConnectionPool::acquire(int timeout)
+{
+    QThread *currentThread = QThread::currentThread();
+    QElapsedTimer timer;
+    timer.start();
+    bool waited = false;
+
+    QMutexLocker locker(&d->mutex);
+    forever {
+        QStringList removed = d->takeExpiredConnections(currentThread);
+
+        // the most recently released connection usable in this thread
+        int index = d->idle.count() - 1;
+        while (index >= 0 && d->idle.at(index).thread && d->idle.at(index).thread != currentThread)
+            --index;
+
+        QString name;
+        bool isNew = false;
+        if (index >= 0) {
+            name = d->idle.at(index).name;
+            d->acquired.insert(name, !d->idle.at(index).thread);
+            d->idle.remove(index);
+        } else {
+            if (d->connectionCount >= d->maximumSize)
+                d->evictIdleConnection(&removed);
+            if (d->connectionCount < d->maximumSize) {
+                name = d->newConnectionName();
+                isNew = true;
+                d->acquired.insert(name, false);
+                ++d->connectionCount;
+            }
+        }
+
+        if (!removed.isEmpty()) {
+            d->connectionReleased.wakeAll();
+            locker.unlock();
+            QSqlConnectionPoolPrivate::removeConnections(removed);
+            locker.relock();
+        }
+
+        if (!name.isEmpty()) {
+            const bool movable = d->acquired.value(name);
+            const QString healthCheckQuery = d->healthCheckQuery;
+            locker.unlock();
+
+            QSqlError error;
+            QSqlDatabase db;
+            if (isNew) {
+                db = QSqlDatabase::cloneDatabase(QSqlDatabase::database(d->connectionName, false), name);
+                if (!db.isValid()) {
+                    error = QSqlError(QCoreApplication::translate("QSqlConnectionPool",
+                                      "Unknown connection '%1'").arg(d->connectionName),
+                                      QString(), QSqlError::ConnectionError);
+                } else if (!db.open()) {
+                    error = db.lastError();
+                }
+            } else {
+                db = QSqlDatabase::database(name, false);
+                if (movable)
+                    db.driver()->moveToThread(currentThread);
+            }
+            const bool ok = !error.isValid() && qCheckConnection(db, healthCheckQuery, &error);
+
+            locker.relock();
+            if (ok) {
+                if (isNew)
+                    d->acquired.insert(name, qCanMoveConnection(db));
+                ++d->acquireCount;
+                if (waited) {
+                    const qint64 waitTime = timer.elapsed();
+                    ++d->waitCount;
+                    d->totalWaitTime += waitTime;
+                    d->maximumWaitTime = qMax(d->maximumWaitTime, waitTime);
+                }
+                return db;
+            }
+
+            // replace the broken connection
+            d->acquired.remove(name);
+            --d->connectionCount;
+            d->lastError = error;
+            d->connectionReleased.wakeOne();
+            locker.unlock();
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(name);
+            locker.relock();
+            if (isNew)
+                return QSqlDatabase();
+            continue;
+        }
+
+        const qint64 remaining = timeout < 0 ? -1 : timeout - timer.elapsed();
+        if (timeout >= 0 && remaining <= 0) {
+            ++d->timeoutCount;
+            d->lastError = QSqlError(QCoreApplication::translate("QSqlConnectionPool",
+                                     "Timed out waiting for a connection"),
+                                     QString(), QSqlError::ConnectionError);
+            return QSqlDatabase();
+        }
+        waited = true;
+        d->connectionReleased.wait(&d->mutex, remaining < 0 ? ULONG_MAX : ulong(remaining));
+    }
+}
+
+/*!
+    Hands the connection \a db, which was returned by acquire(), back to
+    the pool. It should be released by the thread that acquired it, and
+    must not be used afterwards; queries on it should be finished or
+    destroyed first.
+*/
+void QSqlConnectionPool::release(const QSqlDatabase &db)
+{
+    const QString name = db.connectionName();
+    QThread *currentThread = QThread::currentThread();
+    QMutexLocker locker(&d->mutex);
+    QHash<QString, bool>::iterator it = d->acquired.find(name);
+    if (it == d->acquired.end()) {
+        qWarning("QSqlConnectionPool::release: connection '%s' was not acquired from this pool",
+                 qPrintable(name));
+        return;
+    }
+    QSqlDriver *driver = db.driver();
+    const bool movable = it.value() && driver->thread() == currentThread
+                         && driver->subscribedToNotifications().isEmpty();
+    d->acquired.erase(it);
+    locker.unlock();
+
+    if (movable)
+        driver->moveToThread(0);
+
+    locker.relock();
+    QSqlPooledConnection connection;
+    connection.name = name;
+    connection.thread = movable ? 0 : driver->thread();
+    connection.owner = connection.thread;
+    connection.idleTimer.start();
+    d->idle.append(connection);
+    d->connectionReleased.wakeOne();
+
+    const QStringList expired = d->takeExpiredConnections(currentThread);
+    if (!expired.isEmpty())
+        d->connectionReleased.wakeAll();
+    locker.unlock();
+    QSqlConnectionPoolPrivate::removeConnections(expired);
+}
+
+/*!
+    Returns the number of open connections, both idle and acquired ones.
+*/
+int QSqlConnectionPool::size() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->connectionCount;
+}
+
+/*!
+    Returns the number of open connections that are not acquired.
+*/
+int QSqlConnectionPool::idleCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idle.count();
+}
+
+/*!
+    Returns the reason why the last call to acquire() that failed did not
+    return a connection, or why the last connection was replaced.
+*/
+QSqlError QSqlConnectionPool::lastError() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->lastError;
+}
+
+/*!
+    Returns the number of connections handed out by acquire().
+
+    \sa resetStatistics()
+*/
+int QSqlConnectionPool::acquireCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->acquireCount;
+}
+
+/*!
+    Returns the number of calls to acquire() that had to wait until a
+    connection was released before they got one.
+
+    \sa totalWaitTime(), timeoutCount()
+*/
+int QSqlConnectionPool::waitCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->waitCount;
+}
+
+/*!
+    Returns the number of calls to acquire() that did not get a connection
+    within their timeout.
+*/
+int QSqlConnectionPool::timeoutCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->timeoutCount;
+}
+
+/*!
+    Returns the time in milliseconds that the calls counted by waitCount()
+    spent in acquire() altogether.
+*/
+qint64 QSqlConnectionPool::totalWaitTime() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->totalWaitTime;
+}
+
+/*!
+    Returns the longest time in milliseconds that a call to acquire()
+    waited for a connection.
+*/
+qint64 QSqlConnectionPool::maximumWaitTime() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumWaitTime;
+}
+
+/*!
+    Resets acquireCount(), waitCount(), timeoutCount(), totalWaitTime() and
+    maximumWaitTime() to 0.
+*/
+void QSqlConnectionPool::resetStatistics()
+{
+    QMutexLocker locker(&d->mutex);
+    d->acquireCount = 0;
+    d->waitCount = 0;
+    d->timeoutCount = 0;
+    d->totalWaitTime = 0;
+    d->maximumWaitTime = 0;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_THREAD
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLCONNECTIONPOOL_H
+#define QSQLCONNECTIONPOOL_H
+
+#include <QtSql/qsqldatabase.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_THREAD
+
+class QSqlError;
+class QSqlConnectionPoolPrivate;
+
+class Q_SQL_EXPORT QSqlConnectionPool
+{
+public:
+    explicit QSqlConnectionPool(const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+    ~QSqlConnectionPool();
+
+    QString connectionName() const;
+
+    void setMinimumSize(int size);
+    int minimumSize() const;
+    void setMaximumSize(int size);
+    int maximumSize() const;
+    void setIdleTimeout(int msecs);
+    int idleTimeout() const;
+    void setHealthCheckQuery(const QString &query);
+    QString healthCheckQuery() const;
+
+    QSqlDatabase acquire(int timeout = -1);
+    void release(const QSqlDatabase &db);
+
+    int size() const;
+    int idleCount() const;
+    QSqlError lastError() const;
+
+    int acquireCount() const;
+    int waitCount() const;
+    int timeoutCount() const;
+    qint64 totalWaitTime() const;
+    qint64 maximumWaitTime() const;
+    void resetStatistics();
+
+private:
+    Q_DISABLE_COPY(QSqlConnectionPool)
+    QSqlConnectionPoolPrivate *d;
+};
+
+#endif // QT_NO_THREAD
+
+QT_END_NAMESPACE
+
+#endif // QSQLCONNECTIONPOOL_H
@@ -1123,6 +1123,8 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li tty
     \li requiressl
     \li service
+    \li QPSQL_BINARY_RESULTS
+    \li QPSQL_COPY_BATCHES
     \endlist
 
     \header \li DB2 \li OCI \li TDS
@@ -48,9 +48,16 @@
 #include "qsqlresult.h"
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
+#include "qsqlcolumnblock.h"
+#ifndef QT_NO_QFUTURE
+#include "qfuture.h"
+#endif
+#include "private/qsqlcolumnblock_p.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
 #include "qvector.h"
 #include "qmap.h"
+#include "qcoreapplication.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -763,6 +770,59 @@ bool QSqlQuery::last()
     return b;
 }
 
+/*!
+  \since 5.9
+
+  Retrieves up to \a maxRows records following the current one into
+  \a block, replacing its previous contents, and returns the number of
+  records retrieved.
+
+  The values are stored column by column in typed buffers instead of
+  one QVariant per value; see QSqlColumnBlock for how each column is
+  stored. The SQLite and PostgreSQL drivers decode the records straight
+  into these buffers, which is considerably faster than calling next()
+  and value() for every record. With other drivers the block is filled
+  using next() and value().
+
+  Afterwards the query is positioned on the last record retrieved, so
+  that next() continues with the record following the block. If fewer
+  than \a maxRows records were left, the query is positioned after the
+  last record. Retrieving blocks is most efficient on
+  \l{setForwardOnly()}{forward only} queries.
+
+  The query must be \l{isActive()}{active} and isSelect() must return
+  true, otherwise no records are retrieved and 0 is returned.
+
+  \sa next(), QSqlColumnBlock
+*/
+int QSqlQuery::fetchBlock(QSqlColumnBlock *block, int maxRows)
+{
+    if (!block)
+        return 0;
+    QSqlColumnBlockPrivate *b = block->d.data();
+    const QSql::NumericalPrecisionPolicy precisionPolicy = d->sqlResult->numericalPrecisionPolicy();
+    if (!isSelect() || !isActive() || maxRows <= 0 || at() == QSql::AfterLastRow) {
+        b->reset(d->sqlResult->record(), precisionPolicy);
+        return 0;
+    }
+    b->reset(d->sqlResult->record(), precisionPolicy);
+
+    QSqlFetchBlockRequest request;
+    request.block = b;
+    request.maxRows = maxRows;
+    d->sqlResult->virtual_hook(QSqlResultPrivate::FetchBlockOperation, &request);
+    if (!request.handled) {
+        const int columnCount = b->columns.count();
+        while (b->rowCount < maxRows && next()) {
+            for (int i = 0; i < columnCount; ++i)
+                b->appendValue(i, d->sqlResult->data(i));
+            b->endRow();
+        }
+    }
+    b->finish();
+    return b->rowCount;
+}
+
 /*!
   Returns the size of the result (number of rows returned), or -1 if
   the size cannot be determined or if the database does not support
@@ -1070,6 +1130,116 @@ bool QSqlQuery::execBatch(BatchExecutionMode mode)
     return d->sqlResult->execBatch(mode == ValuesAsColumns);
 }
 
+#ifndef QT_NO_QFUTURE
+static QFuture<bool> qFinishedAsyncExec(bool result)
+{
+    QFutureInterface<bool> future(QFutureInterfaceBase::Started);
+    future.reportResult(result);
+    future.reportFinished();
+    return future.future();
+}
+
+// Drivers that cannot execute a query without blocking do not get it run on
+// another thread instead: most client libraries only allow a connection to
+// be used by the thread that opened it.
+static QSqlError qAsyncExecUnsupportedError()
+{
+    return QSqlError(QCoreApplication::translate("QSqlQuery",
+                         "Asynchronous execution is not supported by the driver"),
+                     QString(), QSqlError::StatementError);
+}
+
+/*!
+    \since 5.9
+
+    Starts executing the SQL in \a query without waiting for the
+    database to answer, and returns a future that reports whether the
+    query was executed successfully, in the same way as exec(\a query)
+    returns it. Use a QFutureWatcher to be notified when the query is
+    done.
+
+    The query is executed through the event loop of the thread the
+    database connection was opened in; for the QPSQL driver, the rows
+    arrive while the event loop processes other events. Drivers without
+    support for asynchronous execution return a future that has already
+    finished with the result \c false, and lastError() describes the
+    error.
+
+    The query, and any other query on the same database connection, must
+    not be used until the future has finished, and the connection must
+    not be used for synchronous queries in the meantime. Since the outcome
+    is reported by the event loop, do not call QFuture::waitForFinished()
+    in the thread of the connection.
+
+    The header only declares QFuture; include <QFuture> to use the result.
+
+    \sa exec(), QFutureWatcher
+*/
+QFuture<bool> QSqlQuery::execAsync(const QString &query)
+{
+    // a query shared with a pending asynchronous execution gets a new result
+    if (d->ref.load() != 1) {
+        bool fo = isForwardOnly();
+        *this = QSqlQuery(driver()->createResult());
+        d->sqlResult->setNumericalPrecisionPolicy(d->sqlResult->numericalPrecisionPolicy());
+        setForwardOnly(fo);
+    } else {
+        d->sqlResult->clear();
+        d->sqlResult->setActive(false);
+        d->sqlResult->setLastError(QSqlError());
+        d->sqlResult->setAt(QSql::BeforeFirstRow);
+        d->sqlResult->setNumericalPrecisionPolicy(d->sqlResult->numericalPrecisionPolicy());
+    }
+    d->sqlResult->setQuery(query.trimmed());
+    if (!driver()->isOpen() || driver()->isOpenError()) {
+        qWarning("QSqlQuery::execAsync: database not open");
+        return qFinishedAsyncExec(false);
+    }
+    if (query.isEmpty()) {
+        qWarning("QSqlQuery::execAsync: empty query");
+        return qFinishedAsyncExec(false);
+    }
+
+    QSqlAsyncExecRequest request;
+    request.query = query;
+    request.future.reportStarted();
+    d->sqlResult->virtual_hook(QSqlResultPrivate::AsyncExecOperation, &request);
+    if (!request.started) {
+        d->sqlResult->setLastError(qAsyncExecUnsupportedError());
+        return qFinishedAsyncExec(false);
+    }
+    return request.future.future();
+}
+
+/*!
+    \since 5.9
+    \overload
+
+    Starts executing a previously prepared SQL query without waiting for
+    the database to answer, and returns a future that reports whether the
+    query was executed successfully, in the same way as exec() returns it.
+    The bound values must not be changed until the future has finished.
+
+    \sa prepare(), exec()
+*/
+QFuture<bool> QSqlQuery::execAsync()
+{
+    d->sqlResult->resetBindCount();
+
+    if (d->sqlResult->lastError().isValid())
+        d->sqlResult->setLastError(QSqlError());
+
+    QSqlAsyncExecRequest request;
+    request.future.reportStarted();
+    d->sqlResult->virtual_hook(QSqlResultPrivate::AsyncExecOperation, &request);
+    if (!request.started) {
+        d->sqlResult->setLastError(qAsyncExecUnsupportedError());
+        return qFinishedAsyncExec(false);
+    }
+    return request.future.future();
+}
+#endif // QT_NO_QFUTURE
+
 /*!
   Set the placeholder \a placeholder to be bound to value \a val in
   the prepared statement. Note that the placeholder mark (e.g \c{:})
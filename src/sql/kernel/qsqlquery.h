@@ -52,7 +52,11 @@ class QSqlDriver;
 class QSqlError;
 class QSqlResult;
 class QSqlRecord;
+class QSqlColumnBlock;
 template <class Key, class T> class QMap;
+#ifndef QT_NO_QFUTURE
+template <typename T> class QFuture;
+#endif
 class QSqlQueryPrivate;
 
 class Q_SQL_EXPORT QSqlQuery
@@ -93,6 +97,7 @@ public:
     bool previous();
     bool first();
     bool last();
+    int fetchBlock(QSqlColumnBlock *block, int maxRows);
 
     void clear();
 
@@ -100,6 +105,10 @@ public:
     bool exec();
     enum BatchExecutionMode { ValuesAsRows, ValuesAsColumns };
     bool execBatch(BatchExecutionMode mode = ValuesAsRows);
+#ifndef QT_NO_QFUTURE
+    QFuture<bool> execAsync(const QString &query);
+    QFuture<bool> execAsync();
+#endif
     bool prepare(const QString& query);
     void bindValue(const QString& placeholder, const QVariant& val,
                    QSql::ParamType type = QSql::In);
@@ -953,9 +953,14 @@ bool QSqlResult::execBatch(bool arrayBind)
     QVector<QVariant> values = d->values;
     if (values.count() == 0)
         return false;
-    for (int i = 0; i < values.at(0).toList().count(); ++i) {
-        for (int j = 0; j < values.count(); ++j)
-            bindValue(j, values.at(j).toList().at(i), QSql::In);
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (int j = 0; j < values.count(); ++j)
+        columns.append(values.at(j).toList());
+    const int rows = columns.at(0).count();
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < columns.count(); ++j)
+            bindValue(j, columns.at(j).at(i), QSql::In);
         if (!exec())
             return false;
     }
@@ -52,6 +52,9 @@
 //
 
 #include <QtCore/qpointer.h>
+#ifndef QT_NO_QFUTURE
+#include <QtCore/qfutureinterface.h>
+#endif
 #include "qsqlerror.h"
 #include "qsqlresult.h"
 #include "qsqldriver.h"
@@ -71,11 +74,46 @@ struct QHolder {
     int holderPos;
 };
 
+#ifndef QT_NO_QFUTURE
+// Passed to QSqlResult::virtual_hook() by QSqlQuery::execAsync(). A driver
+// that can execute the query without blocking the calling thread starts it,
+// sets started and reports the outcome to future once it is done.
+struct QSqlAsyncExecRequest
+{
+    QSqlAsyncExecRequest() : started(false) { }
+
+    QString query; // executed as with reset(), or null to exec() the prepared query
+    QFutureInterface<bool> future;
+    bool started;
+};
+#endif
+
+class QSqlColumnBlockPrivate;
+
+// Passed to QSqlResult::virtual_hook() by QSqlQuery::fetchBlock(). A driver
+// that can decode rows straight into the block fetches up to maxRows rows
+// after the current one, leaves the result on the last of them (or after
+// the last row once the result set is exhausted) and sets handled.
+struct QSqlFetchBlockRequest
+{
+    QSqlFetchBlockRequest() : block(0), maxRows(0), handled(false) { }
+
+    QSqlColumnBlockPrivate *block;
+    int maxRows;
+    bool handled;
+};
+
 class Q_SQL_EXPORT QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlResult)
 
 public:
+    // ids for QSqlResult::virtual_hook()
+    enum VirtualHookOperation {
+        AsyncExecOperation = 0x100, // data is a QSqlAsyncExecRequest
+        FetchBlockOperation = 0x101 // data is a QSqlFetchBlockRequest
+    };
+
     QSqlResultPrivate(QSqlResult *q, const QSqlDriver *drv)
       : q_ptr(q),
         sqldriver(const_cast<QSqlDriver*>(drv)),
@@ -41,12 +41,173 @@
 #include "qsqlquerymodel_p.h"
 
 #include <qdebug.h>
+#include <qmetaobject.h>
+#include <qmutex.h>
+#include <qsqldatabase.h>
 #include <qsqldriver.h>
 #include <qsqlfield.h>
+#include <qthread.h>
+#include <qwaitcondition.h>
 
 QT_BEGIN_NAMESPACE
 
 #define QSQL_PREFETCH 255
+// the number of rows fetched at once grows up to this while a view
+// keeps asking for more rows
+#define QSQL_PREFETCH_MAX 16383
+// requests that follow each other within this many milliseconds grow
+// the number of rows fetched at once
+#define QSQL_PREFETCH_INTERVAL 250
+// the number of rows in each block fetched in the background
+#define QSQL_FETCH_BLOCK 256
+
+#ifndef QT_NO_THREAD
+// Executes the query of a model once more, forward-only, on a clone of its
+// database connection that is opened in a thread of its own, and fetches
+// rows in blocks until the model has as many as it asked for. Blocks are
+// handed over to the model through the queued _q_rowsFetched() slot.
+// Once all rows are fetched, or once canceled, the thread removes the
+// clone and the fetcher deletes itself, so that no thread is left idle
+// and the model never waits for it.
+class QSqlQueryModelFetcher : public QThread
+{
+public:
+    QSqlQueryModelFetcher(QSqlQueryModel *model, const QSqlQuery &query)
+        : model(model), sql(query.lastQuery()),
+          precisionPolicy(query.numericalPrecisionPolicy()),
+          fetched(0), requested(0), canceled(false), done(false), notified(false)
+    {
+        const QMetaObject &mo = QSqlQueryModel::staticMetaObject;
+        rowsFetched = mo.method(mo.indexOfSlot("_q_rowsFetched()"));
+        const int boundValueCount = query.boundValues().size();
+        for (int i = 0; i < boundValueCount; ++i)
+            boundValues.append(query.boundValue(i));
+        connect(this, &QThread::finished, this, &QObject::deleteLater);
+    }
+
+    bool start(const QSqlDatabase &source);
+    void cancel();
+    void run() Q_DECL_OVERRIDE;
+
+    QSqlQueryModel *model; // 0 once canceled
+    QMetaMethod rowsFetched;
+    QString connectionName;
+    QString sql;
+    QVector<QVariant> boundValues;
+    QSql::NumericalPrecisionPolicy precisionPolicy;
+
+    QMutex mutex;
+    QWaitCondition wakeUp;
+    QVector<QSqlColumnBlock> blocks; // not yet passed to the model
+    QSqlError error;
+    int fetched;
+    int requested;
+    uint canceled : 1;
+    uint done : 1;
+    uint notified : 1;
+};
+
+// Clones the connection of the query and hands it over to the thread,
+// which opens it. Deletes the fetcher if the connection cannot be cloned.
+bool QSqlQueryModelFetcher::start(const QSqlDatabase &source)
+{
+    connectionName = QLatin1String("qt_sql_background_fetch_")
+                     + QString::number(quintptr(this), 16);
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(source, connectionName);
+    if (!db.isValid()) {
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        delete this;
+        return false;
+    }
+    db.driver()->moveToThread(this);
+    QThread::start();
+    return true;
+}
+
+void QSqlQueryModelFetcher::cancel()
+{
+    QMutexLocker locker(&mutex);
+    model = 0;
+    canceled = true;
+    wakeUp.wakeAll();
+}
+
+void QSqlQueryModelFetcher::run()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        query.setNumericalPrecisionPolicy(precisionPolicy);
+
+        QMutexLocker locker(&mutex);
+        for (;;) {
+            while (!canceled && !done && fetched >= requested)
+                wakeUp.wait(&mutex);
+            if (canceled || done)
+                break;
+            locker.unlock();
+            QSqlColumnBlock block;
+            int count = 0;
+            if (!query.isActive() && db.open() && query.prepare(sql)) {
+                for (int i = 0; i < boundValues.size(); ++i)
+                    query.bindValue(i, boundValues.at(i));
+                query.exec();
+            }
+            if (query.isActive())
+                count = query.fetchBlock(&block, QSQL_FETCH_BLOCK);
+            locker.relock();
+
+            if (count > 0) {
+                blocks.append(block);
+                fetched += count;
+            }
+            if (count < QSQL_FETCH_BLOCK) {
+                if (db.lastError().isValid())
+                    error = db.lastError();
+                if (query.lastError().isValid())
+                    error = query.lastError();
+                query.finish();
+                db.close();
+                done = true;
+            }
+            if (!notified && model) {
+                notified = true;
+                rowsFetched.invoke(model, Qt::QueuedConnection);
+            }
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+// Returns the database connection the driver belongs to.
+static QSqlDatabase qDatabaseOf(const QSqlDriver *driver)
+{
+    const QStringList names = QSqlDatabase::connectionNames();
+    for (const QString &name : names) {
+        QSqlDatabase db = QSqlDatabase::database(name, false);
+        if (db.driver() == driver)
+            return db;
+    }
+    return QSqlDatabase();
+}
+
+// Returns \c true if a clone of the connection would not see the same
+// database, as for SQLite databases that live in memory or in a private
+// temporary file.
+static bool qIsPrivateDatabase(const QSqlDatabase &db)
+{
+    if (db.driver()->dbmsType() != QSqlDriver::SQLite)
+        return false;
+    const QString name = db.databaseName();
+    if (name.isEmpty() || name == QLatin1String(":memory:"))
+        return true;
+    return name.startsWith(QLatin1String("file:"))
+           && (name.startsWith(QLatin1String("file::memory:"))
+               || name.contains(QLatin1String("mode=memory")));
+}
+#endif // QT_NO_THREAD
 
 void QSqlQueryModelPrivate::prefetch(int limit)
 {
@@ -87,6 +248,162 @@ QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
 
+// Views call fetchMore() whenever they are scrolled to the last row. While
+// they do so in quick succession, e.g. while the scroll bar is dragged, the
+// number of rows fetched at once grows, so that fewer round trips are
+// needed to catch up with the view. Once the view comes to rest, it drops
+// back to QSQL_PREFETCH.
+int QSqlQueryModelPrivate::nextPrefetchSize()
+{
+    if (prefetchTimer.isValid() && !prefetchTimer.hasExpired(QSQL_PREFETCH_INTERVAL))
+        prefetchSize = qMin(prefetchSize * 2 + 1, QSQL_PREFETCH_MAX);
+    else
+        prefetchSize = QSQL_PREFETCH;
+    return prefetchSize;
+}
+
+// Counts the rows of the query with a separate statement, for drivers that
+// cannot report the size of a query. On success, the model knows all of its
+// rows up front, as if the driver supported QSqlDriver::QuerySize.
+bool QSqlQueryModelPrivate::probeRowCount()
+{
+    Q_Q(QSqlQueryModel);
+
+    QString sql = query.lastQuery().trimmed();
+    while (sql.endsWith(QLatin1Char(';')))
+        sql = sql.left(sql.size() - 1).trimmed();
+    if (sql.isEmpty() || !query.isSelect())
+        return false;
+
+    QSqlQuery count(query.driver()->createResult());
+    count.setForwardOnly(true);
+    if (!count.prepare(QSqlQueryModelSql::concat(
+                           QSqlQueryModelSql::select(QLatin1String("COUNT(*)")),
+                           QSqlQueryModelSql::from(QSqlQueryModelSql::concat(
+                               QSqlQueryModelSql::paren(sql), QLatin1String("qt_row_count"))))))
+        return false;
+    const int boundValueCount = query.boundValues().size();
+    for (int i = 0; i < boundValueCount; ++i)
+        count.bindValue(i, query.boundValue(i));
+    if (!count.exec() || !count.next())
+        return false;
+
+    bool ok = false;
+    const int rows = count.value(0).toInt(&ok);
+    if (!ok || rows < 0)
+        return false;
+    bottom = q->createIndex(rows - 1, bottom.column());
+    atEnd = true;
+    return true;
+}
+
+// Starts executing the query of the model once more, on a clone of its
+// database connection. Returns \c false, leaving the rows to be fetched
+// incrementally, if the clone would not see the same database.
+bool QSqlQueryModelPrivate::startBackgroundFetch()
+{
+#ifndef QT_NO_THREAD
+    Q_Q(QSqlQueryModel);
+
+    if (!query.isSelect() || query.lastQuery().isEmpty())
+        return false;
+
+    const QSqlDatabase source = qDatabaseOf(query.driver());
+    if (!source.isValid() || qIsPrivateDatabase(source))
+        return false;
+
+    QSqlQueryModelFetcher *f = new QSqlQueryModelFetcher(q, query);
+    if (!f->start(source))
+        return false;
+    fetcher = f;
+    backgroundFetch = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void QSqlQueryModelPrivate::stopBackgroundFetch()
+{
+#ifndef QT_NO_THREAD
+    if (fetcher) {
+        fetcher->cancel();
+        fetcher = 0;
+    }
+#endif
+    backgroundFetch = false;
+    fetchedBlocks.clear();
+    fetchedRows = 0;
+    requestedRows = 0;
+}
+
+// Asks the fetcher to have at least count rows fetched.
+void QSqlQueryModelPrivate::requestRows(int count)
+{
+#ifndef QT_NO_THREAD
+    if (!fetcher || count <= requestedRows)
+        return;
+    requestedRows = count;
+
+    QMutexLocker locker(&fetcher->mutex);
+    fetcher->requested = count;
+    fetcher->wakeUp.wakeAll();
+#else
+    Q_UNUSED(count);
+#endif
+}
+
+QVariant QSqlQueryModelPrivate::fetchedValue(int row, int column) const
+{
+    // all blocks but the last one are full
+    return fetchedBlocks.at(row / QSQL_FETCH_BLOCK).value(row % QSQL_FETCH_BLOCK, column);
+}
+
+void QSqlQueryModelPrivate::_q_rowsFetched()
+{
+#ifndef QT_NO_THREAD
+    Q_Q(QSqlQueryModel);
+    if (!fetcher)
+        return;
+
+    QVector<QSqlColumnBlock> blocks;
+    bool done;
+    {
+        QMutexLocker locker(&fetcher->mutex);
+        blocks.swap(fetcher->blocks);
+        fetcher->notified = false;
+        done = fetcher->done;
+        if (fetcher->error.isValid())
+            error = fetcher->error;
+    }
+    // the fetcher deletes itself once its thread has finished
+    if (done)
+        fetcher = 0;
+
+    const int firstRow = fetchedRows;
+    for (const QSqlColumnBlock &block : qAsConst(blocks)) {
+        Q_ASSERT(fetchedRows % QSQL_FETCH_BLOCK == 0);
+        fetchedBlocks.append(block);
+        fetchedRows += block.rowCount();
+    }
+
+    if (atEnd) {
+        // the row count was probed, so the rows are there already
+        const int lastRow = qMin(fetchedRows, bottom.row() + 1) - 1;
+        if (lastRow >= firstRow && !rec.isEmpty())
+            emit q->dataChanged(q->createIndex(firstRow, 0), q->createIndex(lastRow, rec.count() - 1));
+        return;
+    }
+    if (fetchedRows - 1 > bottom.row()) {
+        q->beginInsertRows(QModelIndex(), bottom.row() + 1, fetchedRows - 1);
+        bottom = q->createIndex(fetchedRows - 1, bottom.column());
+        q->endInsertRows();
+    }
+    if (done)
+        atEnd = true;
+#endif
+}
+
 void QSqlQueryModelPrivate::initColOffsets(int size)
 {
     colOffsets.resize(size);
@@ -142,7 +459,9 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
 
     If the database doesn't return the number of selected rows in
     a query, the model will fetch rows incrementally.
-    See fetchMore() for more information.
+    See fetchMore() for more information. With setFetchOptions(), the
+    model can instead count the rows up front, and fetch them on a
+    background thread.
 
     \sa QSqlTableModel, QSqlRelationalTableModel, QSqlQuery,
         {Model/View Programming}, {Query Model Example}
@@ -170,6 +489,8 @@ QSqlQueryModel::QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent)
 */
 QSqlQueryModel::~QSqlQueryModel()
 {
+    Q_D(QSqlQueryModel);
+    d->stopBackgroundFetch();
 }
 
 /*!
@@ -183,16 +504,30 @@ QSqlQueryModel::~QSqlQueryModel()
 
     \snippet code/src_sql_models_qsqlquerymodel.cpp 0
 
+    The number of rows fetched at once grows while fetchMore() is called
+    repeatedly in quick succession, as views do while they are scrolled
+    quickly.
+
+    If the BackgroundFetch option is in effect, this function returns
+    without waiting for the rows.
+
     \a parent should always be an invalid QModelIndex.
 
-    \sa canFetchMore()
+    \sa canFetchMore(), setFetchOptions()
 */
 void QSqlQueryModel::fetchMore(const QModelIndex &parent)
 {
     Q_D(QSqlQueryModel);
     if (parent.isValid())
         return;
-    d->prefetch(qMax(d->bottom.row(), 0) + QSQL_PREFETCH);
+    const int size = d->nextPrefetchSize();
+    if (d->backgroundFetch) {
+        // all rows are asked for at once if they have been counted
+        d->requestRows(d->atEnd ? d->bottom.row() + 1 : d->fetchedRows + size);
+    } else {
+        d->prefetch(qMax(d->bottom.row(), 0) + size);
+    }
+    d->prefetchTimer.start();
 }
 
 /*!
@@ -334,9 +669,11 @@ int QSqlQueryModel::columnCount(const QModelIndex &index) const
     Returns the value for the specified \a item and \a role.
 
     If \a item is out of bounds or if an error occurred, an invalid
-    QVariant is returned.
+    QVariant is returned. An invalid QVariant is also returned for rows
+    that are still being fetched in the background; the model emits
+    dataChanged() or rowsInserted() once they are available.
 
-    \sa lastError()
+    \sa lastError(), setFetchOptions()
 */
 QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
 {
@@ -351,6 +688,11 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+    if (d->backgroundFetch) {
+        if (dItem.row() < 0 || dItem.row() >= d->fetchedRows)
+            return v;
+        return d->fetchedValue(dItem.row(), dItem.column());
+    }
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -410,6 +752,7 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
 {
     Q_D(QSqlQueryModel);
     beginResetModel();
+    d->stopBackgroundFetch();
 
     QSqlRecord newRec = query.record();
     bool columnsChanged = (newRec != d->rec);
@@ -442,11 +785,17 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     } else {
         d->bottom = createIndex(-1, d->rec.count() - 1);
         d->atEnd = false;
+        if (d->fetchOptions & RowCountProbe)
+            d->probeRowCount();
+        if (d->fetchOptions & BackgroundFetch)
+            d->startBackgroundFetch();
     }
 
 
     // fetchMore does the rowsInserted stuff for incremental models
     fetchMore();
+    // only requests of the view grow the number of rows fetched at once
+    d->prefetchTimer.invalidate();
 
     endResetModel();
     queryChange();
@@ -478,6 +827,7 @@ void QSqlQueryModel::clear()
 {
     Q_D(QSqlQueryModel);
     beginResetModel();
+    d->stopBackgroundFetch();
     d->error = QSqlError();
     d->atEnd = true;
     d->query.clear();
@@ -488,6 +838,69 @@ void QSqlQueryModel::clear()
     endResetModel();
 }
 
+/*!
+    \enum QSqlQueryModel::FetchOption
+    \since 5.9
+
+    This enum specifies how the model fetches the rows of a query when
+    the database driver cannot report the size of a query (see
+    QSqlDriver::hasFeature()). The options have no effect otherwise.
+
+    \value NoFetchOptions The rows are fetched incrementally, in the
+    thread of the model, when a view asks for them. This is the default.
+
+    \value BackgroundFetch The query is executed once more, forward-only,
+    on a clone of its database connection (see
+    QSqlDatabase::cloneDatabase()) that is opened in a thread of its own.
+    Its rows are fetched there in blocks as fetchMore() asks for them, or
+    all at once if they have been counted, and are added to the model as
+    they arrive; the thread finishes once all rows have arrived. data()
+    returns an invalid QVariant for rows that have not arrived yet.
+    Since the query is executed twice, and the second time on a
+    connection of its own, this option must only be used for queries
+    that can be executed again and return the same rows when they are:
+    the clone does not see temporary tables or uncommitted changes of
+    the original connection, and rows that change between the two
+    executions may be seen in either state. For SQLite databases that
+    live in memory or in a private temporary file, which a clone cannot
+    open, the option is ignored and the rows are fetched incrementally.
+
+    \value RowCountProbe The rows are counted with a separate
+    \c{SELECT COUNT(*)} statement when the query is set, so that
+    rowCount() and the scroll bars of views are correct from the start.
+    If the count fails, the rows are fetched incrementally. The count
+    does not reflect changes made to the database after the query was
+    set.
+*/
+
+/*!
+    \since 5.9
+
+    Sets the options used to fetch rows to \a options. The options take
+    effect the next time a query is set.
+
+    \sa fetchOptions(), setQuery()
+*/
+void QSqlQueryModel::setFetchOptions(FetchOptions options)
+{
+    Q_D(QSqlQueryModel);
+    d->fetchOptions = options;
+}
+
+/*!
+    \since 5.9
+
+    Returns the options used to fetch rows. The default is
+    NoFetchOptions.
+
+    \sa setFetchOptions()
+*/
+QSqlQueryModel::FetchOptions QSqlQueryModel::fetchOptions() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->fetchOptions;
+}
+
 /*!
     Sets the caption for a horizontal header for the specified \a role to
     \a value. This is useful if the model is used to
@@ -678,3 +1091,5 @@ QModelIndex QSqlQueryModel::indexInQuery(const QModelIndex &item) const
 }
 
 QT_END_NAMESPACE
+
+#include "moc_qsqlquerymodel.cpp"
@@ -57,6 +57,14 @@ class Q_SQL_EXPORT QSqlQueryModel: public QAbstractTableModel
     Q_DECLARE_PRIVATE(QSqlQueryModel)
 
 public:
+    enum FetchOption {
+        NoFetchOptions = 0x0,
+        BackgroundFetch = 0x1,
+        RowCountProbe = 0x2
+    };
+    Q_DECLARE_FLAGS(FetchOptions, FetchOption)
+    Q_FLAG(FetchOptions)
+
     explicit QSqlQueryModel(QObject *parent = Q_NULLPTR);
     virtual ~QSqlQueryModel();
 
@@ -80,6 +88,9 @@ public:
 
     virtual void clear();
 
+    void setFetchOptions(FetchOptions options);
+    FetchOptions fetchOptions() const;
+
     QSqlError lastError() const;
 
     void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
@@ -105,8 +116,13 @@ protected:
     virtual QModelIndex indexInQuery(const QModelIndex &item) const;
     void setLastError(const QSqlError &error);
     QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent = Q_NULLPTR);
+
+private:
+    Q_PRIVATE_SLOT(d_func(), void _q_rowsFetched())
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QSqlQueryModel::FetchOptions)
+
 QT_END_NAMESPACE
 
 #endif // QSQLQUERYMODEL_H
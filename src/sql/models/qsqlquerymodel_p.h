@@ -52,34 +52,61 @@
 //
 
 #include "private/qabstractitemmodel_p.h"
+#include "QtSql/qsqlcolumnblock.h"
 #include "QtSql/qsqlerror.h"
 #include "QtSql/qsqlquery.h"
 #include "QtSql/qsqlrecord.h"
+#include "QtCore/qelapsedtimer.h"
 #include "QtCore/qhash.h"
 #include "QtCore/qvarlengtharray.h"
 #include "QtCore/qvector.h"
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQueryModelFetcher;
+
 class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate()
+        : atEnd(false), backgroundFetch(false), nestedResetLevel(0), prefetchSize(0),
+          fetcher(0), fetchedRows(0), requestedRows(0)
+    {}
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
+    int nextPrefetchSize();
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
+    bool probeRowCount();
+    bool startBackgroundFetch();
+    void stopBackgroundFetch();
+    void requestRows(int count);
+    QVariant fetchedValue(int row, int column) const;
+    void _q_rowsFetched();
+
     mutable QSqlQuery query;
     mutable QSqlError error;
     QModelIndex bottom;
     QSqlRecord rec;
     uint atEnd : 1;
+    uint backgroundFetch : 1; // rows come from the fetcher, see BackgroundFetch
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
+
+    QSqlQueryModel::FetchOptions fetchOptions;
+    int prefetchSize;
+    QElapsedTimer prefetchTimer;
+
+    // rows of a query executed again in the background; the fetcher is
+    // 0 once all rows have arrived
+    QSqlQueryModelFetcher *fetcher;
+    QVector<QSqlColumnBlock> fetchedBlocks;
+    int fetchedRows;
+    int requestedRows;
 };
 
 // helpers for building SQL expressions
@@ -13,6 +13,7 @@ HEADERS += graphicsview/qgraphicsgridlayout.h \
     graphicsview/qgraphicsscene.h \
     graphicsview/qgraphicsscene_bsp_p.h \
     graphicsview/qgraphicsscene_p.h \
+    graphicsview/qgraphicssceneaabbtreeindex_p.h \
     graphicsview/qgraphicsscenebsptreeindex_p.h \
     graphicsview/qgraphicssceneevent.h \
     graphicsview/qgraphicssceneindex_p.h \
@@ -40,6 +41,7 @@ SOURCES += graphicsview/qgraphicsgridlayout.cpp \
     graphicsview/qgraphicsproxywidget.cpp \
     graphicsview/qgraphicsscene.cpp \
     graphicsview/qgraphicsscene_bsp.cpp \
+    graphicsview/qgraphicssceneaabbtreeindex.cpp \
     graphicsview/qgraphicsscenebsptreeindex.cpp \
     graphicsview/qgraphicssceneevent.cpp \
     graphicsview/qgraphicssceneindex.cpp \
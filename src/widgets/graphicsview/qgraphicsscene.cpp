@@ -193,6 +193,13 @@
     removing items is logarithmic. This approach is best for static scenes
     (i.e., scenes where most items do not move).
 
+    \value AabbTreeIndex Since Qt 5.9. A balanced tree of the items'
+    axis-aligned bounding boxes is applied. Item location is of logarithmic
+    complexity, and does not depend on the scene rect. Adding, moving and
+    removing items is logarithmic too, and items that move by a small amount
+    do not need to be reindexed. This approach suits large scenes where many
+    items move, but which are still queried frequently.
+
     \value NoIndex No index is applied. Item location is of linear complexity,
     as all items on the scene are searched. Adding, moving and removing items,
     however, is done in constant time. This approach is ideal for dynamic
@@ -216,6 +223,7 @@
 #include "qgraphicswidget_p.h"
 #include "qgraphicssceneindex_p.h"
 #include "qgraphicsscenebsptreeindex_p.h"
+#include "qgraphicssceneaabbtreeindex_p.h"
 #include "qgraphicsscenelinearindex_p.h"
 
 #include <QtCore/qdebug.h>
@@ -1844,7 +1852,9 @@ void QGraphicsScene::render(QPainter *painter, const QRectF &target, const QRect
 
     For the common case, the default index method BspTreeIndex works fine.  If
     your scene uses many animations and you are experiencing slowness, you can
-    disable indexing by calling \c setItemIndexMethod(NoIndex).
+    switch to an index that is cheap to update by calling
+    \c setItemIndexMethod(AabbTreeIndex), or disable indexing by calling
+    \c setItemIndexMethod(NoIndex).
 
     \sa bspTreeDepth
 */
@@ -1865,6 +1875,8 @@ void QGraphicsScene::setItemIndexMethod(ItemIndexMethod method)
     delete d->index;
     if (method == BspTreeIndex)
         d->index = new QGraphicsSceneBspTreeIndex(this);
+    else if (method == AabbTreeIndex)
+        d->index = new QGraphicsSceneAabbTreeIndex(this);
     else
         d->index = new QGraphicsSceneLinearIndex(this);
     for (int i = oldItems.size() - 1; i >= 0; --i)
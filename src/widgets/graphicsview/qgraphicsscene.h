@@ -110,6 +110,7 @@ class Q_WIDGETS_EXPORT QGraphicsScene : public QObject
 public:
     enum ItemIndexMethod {
         BspTreeIndex,
+        AabbTreeIndex,
         NoIndex = -1
     };
 
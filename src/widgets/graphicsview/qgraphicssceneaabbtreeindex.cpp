@@ -0,0 +1,791 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+/*!
+    \class QGraphicsSceneAabbTreeIndex
+    \brief The QGraphicsSceneAabbTreeIndex class provides an implementation of
+    a dynamic bounding volume tree for discovering items in QGraphicsScene.
+    \since 5.9
+    \ingroup graphicsview-api
+
+    \internal
+
+    QGraphicsSceneAabbTreeIndex keeps every indexed item in a leaf of a
+    balanced binary tree of axis-aligned bounding boxes. Unlike the BSP
+    index, the tree does not depend on the scene rect and never needs to be
+    regenerated as a whole: adding, moving and removing an item costs
+    O(log n), and rect and point lookups only visit the subtrees whose
+    bounds intersect the query.
+
+    Each leaf stores a slightly enlarged ("fat") copy of the item's scene
+    bounding rect, so items that move by small amounts do not touch the
+    tree at all. Geometry changes are recorded cheaply and applied the next
+    time the index is queried. When a large share of the items changed
+    since the last query, as after populating a scene, the tree is rebuilt
+    in one pass by recursively splitting the leaves at the median along the
+    longest axis, which yields a better tree than inserting one by one.
+
+    \sa QGraphicsScene, QGraphicsView, QGraphicsSceneIndex
+*/
+
+#include <QtCore/qglobal.h>
+
+#ifndef QT_NO_GRAPHICSVIEW
+
+#include <private/qgraphicsscene_p.h>
+#include <private/qgraphicssceneaabbtreeindex_p.h>
+#include <private/qgraphicsscenebsptreeindex_p.h>
+#include <private/qgraphicssceneindex_p.h>
+
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// Pending updates are applied by rebuilding the whole tree when they
+// outnumber half of the indexed items, and at least this many.
+static const int QGRAPHICSSCENE_AABBTREE_BULKLOAD_THRESHOLD = 64;
+
+/*!
+    Constructs a private scene AABB tree index.
+*/
+QGraphicsSceneAabbTreeIndexPrivate::QGraphicsSceneAabbTreeIndexPrivate(QGraphicsScene *scene)
+    : QGraphicsSceneIndexPrivate(scene),
+    root(-1),
+    freeList(-1),
+    leafCount(0)
+{
+}
+
+/*!
+    \internal
+
+    Returns the id of an unused node, reset to an empty leaf.
+*/
+int QGraphicsSceneAabbTreeIndexPrivate::allocateNode()
+{
+    int id;
+    if (freeList != -1) {
+        id = freeList;
+        freeList = nodes.at(id).parent;
+    } else {
+        id = nodes.size();
+        nodes.append(Node());
+    }
+
+    Node &node = nodes[id];
+    node.bounds.left = node.bounds.top = node.bounds.right = node.bounds.bottom = 0;
+    node.item = 0;
+    node.parent = node.child1 = node.child2 = -1;
+    node.height = 0;
+    node.pending = node.inTree = node.untransformable = 0;
+    return id;
+}
+
+/*!
+    \internal
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::freeNode(int id)
+{
+    Node &node = nodes[id];
+    node.item = 0;
+    node.child1 = node.child2 = -1;
+    node.height = -1;
+    node.pending = node.inTree = node.untransformable = 0;
+    node.parent = freeList;
+    freeList = id;
+}
+
+/*!
+    \internal
+
+    Inserts the detached \a leaf into the tree, pairing it with the sibling
+    that increases the total perimeter of the tree the least.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::insertLeaf(int leaf)
+{
+    ++leafCount;
+    nodes[leaf].inTree = 1;
+    if (root == -1) {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    const Bounds leafBounds = nodes.at(leaf).bounds;
+    int index = root;
+    while (!nodes.at(index).isLeaf()) {
+        const Node &node = nodes.at(index);
+        const qreal area = node.bounds.perimeter();
+        const qreal combinedArea = node.bounds.united(leafBounds).perimeter();
+
+        // Cost of creating a new parent for this node and the new leaf, and
+        // the minimum cost of pushing the leaf further down the tree.
+        const qreal cost = 2 * combinedArea;
+        const qreal inheritanceCost = 2 * (combinedArea - area);
+
+        qreal childCost[2];
+        const int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i) {
+            const Node &child = nodes.at(children[i]);
+            const qreal united = child.bounds.united(leafBounds).perimeter();
+            childCost[i] = (child.isLeaf() ? united : united - child.bounds.perimeter()) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    const int sibling = index;
+    const int newParent = allocateNode();
+    const int oldParent = nodes.at(sibling).parent;
+    Node &parentNode = nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.bounds = nodes.at(sibling).bounds.united(leafBounds);
+    parentNode.height = nodes.at(sibling).height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != -1) {
+        Node &grandParent = nodes[oldParent];
+        if (grandParent.child1 == sibling)
+            grandParent.child1 = newParent;
+        else
+            grandParent.child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    fixUpwards(oldParent);
+}
+
+/*!
+    \internal
+
+    Detaches \a leaf from the tree. The leaf node itself stays allocated.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::removeLeaf(int leaf)
+{
+    --leafCount;
+    nodes[leaf].inTree = 0;
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    const int parent = nodes.at(leaf).parent;
+    const int grandParent = nodes.at(parent).parent;
+    const int sibling = nodes.at(parent).child1 == leaf ? nodes.at(parent).child2 : nodes.at(parent).child1;
+    nodes[leaf].parent = -1;
+    freeNode(parent);
+
+    nodes[sibling].parent = grandParent;
+    if (grandParent != -1) {
+        Node &node = nodes[grandParent];
+        if (node.child1 == parent)
+            node.child1 = sibling;
+        else
+            node.child2 = sibling;
+        fixUpwards(grandParent);
+    } else {
+        root = sibling;
+    }
+}
+
+/*!
+    \internal
+
+    Walks from \a id up to the root, rebalancing and refitting the bounds
+    of every internal node on the way.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::fixUpwards(int id)
+{
+    while (id != -1) {
+        id = balance(id);
+        Node &node = nodes[id];
+        const Node &child1 = nodes.at(node.child1);
+        const Node &child2 = nodes.at(node.child2);
+        node.height = 1 + qMax(child1.height, child2.height);
+        node.bounds = child1.bounds.united(child2.bounds);
+        id = node.parent;
+    }
+}
+
+/*!
+    \internal
+
+    Performs a left or right rotation if the subtree rooted at \a iA is
+    imbalanced, and returns the id of the new subtree root.
+*/
+int QGraphicsSceneAabbTreeIndexPrivate::balance(int iA)
+{
+    Node &A = nodes[iA];
+    if (A.isLeaf() || A.height < 2)
+        return iA;
+
+    const int iB = A.child1;
+    const int iC = A.child2;
+    Node &B = nodes[iB];
+    Node &C = nodes[iC];
+    const int heightDelta = C.height - B.height;
+
+    if (heightDelta > 1) {
+        // Rotate C up.
+        const int iF = C.child1;
+        const int iG = C.child2;
+        Node &F = nodes[iF];
+        Node &G = nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+        if (C.parent != -1) {
+            Node &parent = nodes[C.parent];
+            if (parent.child1 == iA)
+                parent.child1 = iC;
+            else
+                parent.child2 = iC;
+        } else {
+            root = iC;
+        }
+
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.bounds = B.bounds.united(G.bounds);
+            C.bounds = A.bounds.united(F.bounds);
+            A.height = 1 + qMax(B.height, G.height);
+            C.height = 1 + qMax(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.bounds = B.bounds.united(F.bounds);
+            C.bounds = A.bounds.united(G.bounds);
+            A.height = 1 + qMax(B.height, F.height);
+            C.height = 1 + qMax(A.height, G.height);
+        }
+        return iC;
+    }
+
+    if (heightDelta < -1) {
+        // Rotate B up.
+        const int iD = B.child1;
+        const int iE = B.child2;
+        Node &D = nodes[iD];
+        Node &E = nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+        if (B.parent != -1) {
+            Node &parent = nodes[B.parent];
+            if (parent.child1 == iA)
+                parent.child1 = iB;
+            else
+                parent.child2 = iB;
+        } else {
+            root = iB;
+        }
+
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.bounds = C.bounds.united(E.bounds);
+            B.bounds = A.bounds.united(D.bounds);
+            A.height = 1 + qMax(C.height, E.height);
+            B.height = 1 + qMax(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.bounds = C.bounds.united(D.bounds);
+            B.bounds = A.bounds.united(E.bounds);
+            A.height = 1 + qMax(C.height, D.height);
+            B.height = 1 + qMax(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+/*!
+    \internal
+
+    Builds a subtree over the leaves in [\a begin, \a end) by splitting them
+    at the median center along the longest axis, and returns its root.
+*/
+int QGraphicsSceneAabbTreeIndexPrivate::buildTree(int *begin, int *end)
+{
+    const int count = int(end - begin);
+    if (count == 1)
+        return *begin;
+
+    qreal minX = nodes.at(*begin).bounds.left + nodes.at(*begin).bounds.right;
+    qreal maxX = minX;
+    qreal minY = nodes.at(*begin).bounds.top + nodes.at(*begin).bounds.bottom;
+    qreal maxY = minY;
+    for (const int *it = begin + 1; it != end; ++it) {
+        const Bounds &b = nodes.at(*it).bounds;
+        minX = qMin(minX, b.left + b.right);
+        maxX = qMax(maxX, b.left + b.right);
+        minY = qMin(minY, b.top + b.bottom);
+        maxY = qMax(maxY, b.top + b.bottom);
+    }
+
+    int *middle = begin + count / 2;
+    const Node *data = nodes.constData();
+    if (maxX - minX >= maxY - minY) {
+        std::nth_element(begin, middle, end, [data](int a, int b) {
+            return data[a].bounds.left + data[a].bounds.right < data[b].bounds.left + data[b].bounds.right;
+        });
+    } else {
+        std::nth_element(begin, middle, end, [data](int a, int b) {
+            return data[a].bounds.top + data[a].bounds.bottom < data[b].bounds.top + data[b].bounds.bottom;
+        });
+    }
+
+    const int child1 = buildTree(begin, middle);
+    const int child2 = buildTree(middle, end);
+    const int id = allocateNode();
+    Node &node = nodes[id];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.height = 1 + qMax(nodes.at(child1).height, nodes.at(child2).height);
+    node.bounds = nodes.at(child1).bounds.united(nodes.at(child2).bounds);
+    nodes[child1].parent = id;
+    nodes[child2].parent = id;
+    return id;
+}
+
+/*!
+    \internal
+
+    Discards all internal nodes and bulk loads the tree from the leaves
+    that are marked as being in the tree.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::rebuildTree()
+{
+    QVector<int> leaves;
+    leaves.reserve(nodes.size() / 2 + 1);
+    for (int i = 0; i < nodes.size(); ++i) {
+        const Node &node = nodes.at(i);
+        if (node.height > 0)
+            freeNode(i);
+        else if (node.height == 0 && node.inTree)
+            leaves << i;
+    }
+
+    leafCount = leaves.size();
+    root = -1;
+    if (leaves.isEmpty())
+        return;
+    root = buildTree(leaves.data(), leaves.data() + leaves.size());
+    nodes[root].parent = -1;
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a item is kept in the tree. Untransformable items are
+    always returned by lookups, and items clipped by an ancestor are found
+    through that ancestor.
+*/
+bool QGraphicsSceneAabbTreeIndexPrivate::isIndexable(const QGraphicsItem *item)
+{
+    return !item->d_ptr->itemIsUntransformable()
+        && !(item->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorClipsChildren
+             || item->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorContainsChildren);
+}
+
+/*!
+    \internal
+
+    Schedules \a item, and its descendants if \a recursive is true, to have
+    their position in the tree refreshed on the next lookup.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::markPending(const QGraphicsItem *item, bool recursive)
+{
+    const int id = item->d_ptr->index;
+    if (id != -1 && !nodes.at(id).pending) {
+        nodes[id].pending = 1;
+        pendingNodes << id;
+    }
+
+    if (recursive) {
+        for (int i = 0; i < item->d_ptr->children.size(); ++i)
+            markPending(item->d_ptr->children.at(i), recursive);
+    }
+}
+
+/*!
+    \internal
+
+    Brings the tree up to date with all items that were added or whose
+    geometry or flags changed since the last lookup.
+*/
+void QGraphicsSceneAabbTreeIndexPrivate::updatePendingNodes()
+{
+    if (pendingNodes.isEmpty())
+        return;
+
+    const bool bulkLoad = pendingNodes.size() >= QGRAPHICSSCENE_AABBTREE_BULKLOAD_THRESHOLD
+                          && pendingNodes.size() > leafCount / 2;
+
+    for (int i = 0; i < pendingNodes.size(); ++i) {
+        const int id = pendingNodes.at(i);
+        if (!nodes.at(id).pending)
+            continue; // Removed since it was scheduled.
+        nodes[id].pending = 0;
+
+        QGraphicsItem *item = nodes.at(id).item;
+        const bool untransformable = item->d_ptr->itemIsUntransformable();
+        if (untransformable != bool(nodes.at(id).untransformable)) {
+            nodes[id].untransformable = untransformable;
+            if (untransformable)
+                untransformableItems << item;
+            else
+                untransformableItems.removeOne(item);
+        }
+
+        if (!QGraphicsSceneAabbTreeIndexPrivate::isIndexable(item)) {
+            if (nodes.at(id).inTree) {
+                if (bulkLoad)
+                    nodes[id].inTree = 0;
+                else
+                    removeLeaf(id);
+            }
+            continue;
+        }
+
+        const QRectF rect = item->d_ptr->sceneEffectiveBoundingRect();
+        const Bounds bounds = { rect.left(), rect.top(), rect.right(), rect.bottom() };
+        if (nodes.at(id).inTree && nodes.at(id).bounds.contains(bounds))
+            continue;
+
+        if (nodes.at(id).inTree && !bulkLoad)
+            removeLeaf(id);
+
+        const qreal margin = qMax(rect.width(), rect.height()) / 4;
+        const Bounds fatBounds = { bounds.left - margin, bounds.top - margin,
+                                   bounds.right + margin, bounds.bottom + margin };
+        nodes[id].bounds = fatBounds;
+        if (bulkLoad)
+            nodes[id].inTree = 1;
+        else
+            insertLeaf(id);
+    }
+    pendingNodes.clear();
+
+    if (bulkLoad)
+        rebuildTree();
+}
+
+QList<QGraphicsItem *> QGraphicsSceneAabbTreeIndexPrivate::estimateItems(const QRectF &rect, Qt::SortOrder order,
+                                                                         bool onlyTopLevelItems)
+{
+    Q_Q(QGraphicsSceneAabbTreeIndex);
+    if (onlyTopLevelItems && rect.isNull())
+        return q->QGraphicsSceneIndex::estimateTopLevelItems(rect, order);
+
+    updatePendingNodes();
+
+    QList<QGraphicsItem *> rectItems;
+    if (root != -1) {
+        const QRectF r = rect.normalized();
+        const Bounds query = { r.left(), r.top(), r.right(), r.bottom() };
+        QVarLengthArray<int, 64> stack;
+        stack.append(root);
+        while (!stack.isEmpty()) {
+            const Node &node = nodes.at(stack.last());
+            stack.removeLast();
+            if (!node.bounds.intersects(query))
+                continue;
+            if (!node.isLeaf()) {
+                stack.append(node.child1);
+                stack.append(node.child2);
+                continue;
+            }
+
+            QGraphicsItem *item = node.item;
+            if (onlyTopLevelItems && item->d_ptr->parent)
+                item = item->topLevelItem();
+            if (!item->d_ptr->itemDiscovered && item->d_ptr->visible) {
+                item->d_ptr->itemDiscovered = 1;
+                rectItems << item;
+            }
+        }
+    }
+
+    for (int i = 0; i < untransformableItems.size(); ++i) {
+        QGraphicsItem *item = untransformableItems.at(i);
+        if (onlyTopLevelItems && item->d_ptr->parent)
+            item = item->topLevelItem();
+        if (!item->d_ptr->itemDiscovered) {
+            item->d_ptr->itemDiscovered = 1;
+            rectItems << item;
+        }
+    }
+
+    // Reset discovery bits.
+    for (int i = 0; i < rectItems.size(); ++i)
+        rectItems.at(i)->d_ptr->itemDiscovered = 0;
+
+    QGraphicsSceneBspTreeIndexPrivate::sortItems(&rectItems, order, /*sortCacheEnabled=*/false,
+                                                 onlyTopLevelItems);
+    return rectItems;
+}
+
+/*!
+    Constructs an AABB tree scene index for the given \a scene.
+*/
+QGraphicsSceneAabbTreeIndex::QGraphicsSceneAabbTreeIndex(QGraphicsScene *scene)
+    : QGraphicsSceneIndex(*new QGraphicsSceneAabbTreeIndexPrivate(scene), scene)
+{
+}
+
+QGraphicsSceneAabbTreeIndex::~QGraphicsSceneAabbTreeIndex()
+{
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    for (int i = 0; i < d->nodes.size(); ++i) {
+        // Ensure item bits are reset properly.
+        if (QGraphicsItem *item = d->nodes.at(i).item)
+            item->d_ptr->index = -1;
+    }
+}
+
+/*!
+    \internal
+    Clear the whole AABB tree index.
+*/
+void QGraphicsSceneAabbTreeIndex::clear()
+{
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    for (int i = 0; i < d->nodes.size(); ++i) {
+        // Ensure item bits are reset properly.
+        if (QGraphicsItem *item = d->nodes.at(i).item)
+            item->d_ptr->index = -1;
+    }
+    d->nodes.clear();
+    d->root = -1;
+    d->freeList = -1;
+    d->leafCount = 0;
+    d->pendingNodes.clear();
+    d->untransformableItems.clear();
+}
+
+/*!
+    Add the \a item into the AABB tree index.
+
+    Indexing requires sceneBoundingRect(), but because \a item might not be
+    completely constructed at this point, the item is only inserted into the
+    tree on the next lookup.
+*/
+void QGraphicsSceneAabbTreeIndex::addItem(QGraphicsItem *item)
+{
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    if (!item)
+        return;
+
+    if (item->d_ptr->index != -1) {
+        qWarning("QGraphicsSceneAabbTreeIndex::addItem: item has already been added to this index");
+        return;
+    }
+
+    const int id = d->allocateNode();
+    d->nodes[id].item = item;
+    item->d_ptr->index = id;
+    d->markPending(item, /*recursive=*/false);
+
+    // Drop stale entries left behind by items removed before being indexed.
+    if (d->pendingNodes.size() > 2 * d->nodes.size()) {
+        d->pendingNodes.clear();
+        for (int i = 0; i < d->nodes.size(); ++i) {
+            if (d->nodes.at(i).pending)
+                d->pendingNodes << i;
+        }
+    }
+}
+
+/*!
+    Remove the \a item from the AABB tree index.
+
+    This does not call any virtual function on \a item, so it is safe to
+    use from the item's destructor.
+*/
+void QGraphicsSceneAabbTreeIndex::removeItem(QGraphicsItem *item)
+{
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    if (!item || item->d_ptr->index == -1)
+        return;
+
+    const int id = item->d_ptr->index;
+    Q_ASSERT(id < d->nodes.size());
+    Q_ASSERT(d->nodes.at(id).item == item);
+    Q_ASSERT(!item->d_ptr->itemDiscovered);
+
+    if (d->nodes.at(id).inTree)
+        d->removeLeaf(id);
+    if (d->nodes.at(id).untransformable)
+        d->untransformableItems.removeOne(item);
+    d->freeNode(id);
+    item->d_ptr->index = -1;
+}
+
+/*!
+    \internal
+    Update the AABB tree when the \a item 's bounding rect has changed.
+*/
+void QGraphicsSceneAabbTreeIndex::prepareBoundingRectChange(const QGraphicsItem *item)
+{
+    if (!item || item->d_ptr->index == -1 || !QGraphicsSceneAabbTreeIndexPrivate::isIndexable(item))
+        return; // Item is not in the tree; nothing to do.
+
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    d->markPending(item, /*recursive=*/false);
+    for (int i = 0; i < item->d_ptr->children.size(); ++i)
+        prepareBoundingRectChange(item->d_ptr->children.at(i));
+}
+
+/*!
+    Returns an estimation visible items that are either inside or
+    intersect with the specified \a rect and return a list sorted using \a order.
+*/
+QList<QGraphicsItem *> QGraphicsSceneAabbTreeIndex::estimateItems(const QRectF &rect, Qt::SortOrder order) const
+{
+    Q_D(const QGraphicsSceneAabbTreeIndex);
+    return const_cast<QGraphicsSceneAabbTreeIndexPrivate*>(d)->estimateItems(rect, order);
+}
+
+QList<QGraphicsItem *> QGraphicsSceneAabbTreeIndex::estimateTopLevelItems(const QRectF &rect, Qt::SortOrder order) const
+{
+    Q_D(const QGraphicsSceneAabbTreeIndex);
+    return const_cast<QGraphicsSceneAabbTreeIndexPrivate*>(d)->estimateItems(rect, order, /*onlyTopLevels=*/true);
+}
+
+/*!
+    \fn QList<QGraphicsItem *> QGraphicsSceneAabbTreeIndex::items(Qt::SortOrder order = Qt::DescendingOrder) const;
+
+    Return all items in the AABB tree index and sort them using \a order.
+*/
+QList<QGraphicsItem *> QGraphicsSceneAabbTreeIndex::items(Qt::SortOrder order) const
+{
+    Q_D(const QGraphicsSceneAabbTreeIndex);
+    QList<QGraphicsItem *> itemList;
+    itemList.reserve(d->nodes.size() / 2 + 1);
+    for (int i = 0; i < d->nodes.size(); ++i) {
+        if (QGraphicsItem *item = d->nodes.at(i).item)
+            itemList << item;
+    }
+
+    QGraphicsSceneBspTreeIndexPrivate::sortItems(&itemList, order, /*sortCacheEnabled=*/false);
+    return itemList;
+}
+
+/*!
+    Returns the number of levels of the tree, after applying any pending
+    changes; 0 if no item is indexed.
+*/
+int QGraphicsSceneAabbTreeIndex::treeHeight() const
+{
+    Q_D(const QGraphicsSceneAabbTreeIndex);
+    const_cast<QGraphicsSceneAabbTreeIndexPrivate*>(d)->updatePendingNodes();
+    return d->root == -1 ? 0 : d->nodes.at(d->root).height + 1;
+}
+
+/*!
+    \internal
+
+    This method react to the \a change of the \a item and use the \a value to
+    update the tree if necessary.
+*/
+void QGraphicsSceneAabbTreeIndex::itemChange(const QGraphicsItem *item, QGraphicsItem::GraphicsItemChange change, const void *const value)
+{
+    Q_D(QGraphicsSceneAabbTreeIndex);
+    switch (change) {
+    case QGraphicsItem::ItemFlagsChange: {
+        // Handle ItemIgnoresTransformations
+        QGraphicsItem::GraphicsItemFlags newFlags = *static_cast<const QGraphicsItem::GraphicsItemFlags *>(value);
+        bool ignoredTransform = item->d_ptr->flags & QGraphicsItem::ItemIgnoresTransformations;
+        bool willIgnoreTransform = newFlags & QGraphicsItem::ItemIgnoresTransformations;
+        bool clipsChildren = item->d_ptr->flags & QGraphicsItem::ItemClipsChildrenToShape
+                             || item->d_ptr->flags & QGraphicsItem::ItemContainsChildrenInShape;
+        bool willClipChildren = newFlags & QGraphicsItem::ItemClipsChildrenToShape
+                                || newFlags & QGraphicsItem::ItemContainsChildrenInShape;
+        if ((ignoredTransform != willIgnoreTransform) || (clipsChildren != willClipChildren)) {
+            // The item and its descendants may move between the tree and
+            // the untransformable or unindexed items; sort that out lazily.
+            d->markPending(item, /*recursive=*/true);
+        }
+        break;
+    }
+    case QGraphicsItem::ItemParentChange: {
+        // Handle ItemIgnoresTransformations
+        const QGraphicsItem *newParent = static_cast<const QGraphicsItem *>(value);
+        bool ignoredTransform = item->d_ptr->itemIsUntransformable();
+        bool willIgnoreTransform = (item->d_ptr->flags & QGraphicsItem::ItemIgnoresTransformations)
+                                   || (newParent && newParent->d_ptr->itemIsUntransformable());
+        bool ancestorClippedChildren = item->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorClipsChildren
+                                       || item->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorContainsChildren;
+        bool ancestorWillClipChildren = newParent
+                            && ((newParent->d_ptr->flags & QGraphicsItem::ItemClipsChildrenToShape
+                                 || newParent->d_ptr->flags & QGraphicsItem::ItemContainsChildrenInShape)
+                                || (newParent->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorClipsChildren
+                                    || newParent->d_ptr->ancestorFlags & QGraphicsItemPrivate::AncestorContainsChildren));
+        if ((ignoredTransform != willIgnoreTransform) || (ancestorClippedChildren != ancestorWillClipChildren))
+            d->markPending(item, /*recursive=*/true);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qgraphicssceneaabbtreeindex_p.cpp"
+
+#endif  // QT_NO_GRAPHICSVIEW
@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef QGRAPHICSSCENEAABBTREEINDEX_P_H
+#define QGRAPHICSSCENEAABBTREEINDEX_P_H
+
+#include <QtCore/qglobal.h>
+
+#if !defined(QT_NO_GRAPHICSVIEW)
+
+#include "qgraphicssceneindex_p.h"
+#include "qgraphicsitem_p.h"
+
+#include <QtCore/qrect.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGraphicsScene;
+class QGraphicsSceneAabbTreeIndexPrivate;
+
+class Q_AUTOTEST_EXPORT QGraphicsSceneAabbTreeIndex : public QGraphicsSceneIndex
+{
+    Q_OBJECT
+public:
+    QGraphicsSceneAabbTreeIndex(QGraphicsScene *scene = 0);
+    ~QGraphicsSceneAabbTreeIndex();
+
+    QList<QGraphicsItem *> estimateItems(const QRectF &rect, Qt::SortOrder order) const Q_DECL_OVERRIDE;
+    QList<QGraphicsItem *> estimateTopLevelItems(const QRectF &rect, Qt::SortOrder order) const Q_DECL_OVERRIDE;
+    QList<QGraphicsItem *> items(Qt::SortOrder order = Qt::DescendingOrder) const Q_DECL_OVERRIDE;
+
+    int treeHeight() const;
+
+protected:
+    void clear() Q_DECL_OVERRIDE;
+
+    void addItem(QGraphicsItem *item) Q_DECL_OVERRIDE;
+    void removeItem(QGraphicsItem *item) Q_DECL_OVERRIDE;
+    void prepareBoundingRectChange(const QGraphicsItem *item) Q_DECL_OVERRIDE;
+
+    void itemChange(const QGraphicsItem *item, QGraphicsItem::GraphicsItemChange change, const void *const value) Q_DECL_OVERRIDE;
+
+private:
+    Q_DECLARE_PRIVATE(QGraphicsSceneAabbTreeIndex)
+    Q_DISABLE_COPY(QGraphicsSceneAabbTreeIndex)
+};
+
+class QGraphicsSceneAabbTreeIndexPrivate : public QGraphicsSceneIndexPrivate
+{
+    Q_DECLARE_PUBLIC(QGraphicsSceneAabbTreeIndex)
+public:
+    QGraphicsSceneAabbTreeIndexPrivate(QGraphicsScene *scene);
+
+    // Bounds are kept as edges rather than QRectF, since QRectF::united()
+    // ignores empty rectangles, and items can have an empty bounding rect.
+    struct Bounds
+    {
+        qreal left, top, right, bottom;
+
+        inline qreal perimeter() const
+        { return 2 * ((right - left) + (bottom - top)); }
+        inline bool contains(const Bounds &other) const
+        { return left <= other.left && top <= other.top && right >= other.right && bottom >= other.bottom; }
+        inline bool intersects(const Bounds &other) const
+        { return left <= other.right && other.left <= right && top <= other.bottom && other.top <= bottom; }
+        inline Bounds united(const Bounds &other) const
+        {
+            Bounds b = { qMin(left, other.left), qMin(top, other.top),
+                         qMax(right, other.right), qMax(bottom, other.bottom) };
+            return b;
+        }
+    };
+
+    // A node is either a leaf, owning one item, or an internal node with two
+    // children. Free nodes are chained through 'parent'. Leaf ids are stable
+    // and stored in QGraphicsItemPrivate::index.
+    struct Node
+    {
+        Bounds bounds;
+        QGraphicsItem *item;
+        int parent;
+        int child1;
+        int child2;
+        int height; // -1 for free nodes, 0 for leaves
+        uint pending : 1;
+        uint inTree : 1;
+        uint untransformable : 1;
+
+        inline bool isLeaf() const { return child1 == -1; }
+    };
+
+    QVector<Node> nodes;
+    int root;
+    int freeList;
+    int leafCount;
+
+    QVector<int> pendingNodes;
+    QList<QGraphicsItem *> untransformableItems;
+
+    int allocateNode();
+    void freeNode(int id);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int iA);
+    void fixUpwards(int id);
+    int buildTree(int *begin, int *end);
+    void rebuildTree();
+
+    static bool isIndexable(const QGraphicsItem *item);
+    void markPending(const QGraphicsItem *item, bool recursive);
+    void updatePendingNodes();
+
+    QList<QGraphicsItem *> estimateItems(const QRectF &, Qt::SortOrder, bool onlyTopLevelItems = false);
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_GRAPHICSVIEW
+
+#endif // QGRAPHICSSCENEAABBTREEINDEX_P_H
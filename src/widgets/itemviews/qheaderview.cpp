@@ -58,6 +58,8 @@
 #include <private/qheaderview_p.h>
 #include <private/qabstractitemmodel_p.h>
 
+#include <algorithm>
+
 #ifndef QT_NO_DATASTREAM
 #include <qdatastream.h>
 #endif
@@ -3226,7 +3228,7 @@ bool QHeaderViewPrivate::isFirstVisibleSection(int section) const
     if (sectionStartposRecalc)
         recalcSectionStartPos();
     const SectionItem &item = sectionItems.at(section);
-    return item.size > 0 && item.calculated_startpos == 0;
+    return item.size > 0 && sectionStartPos(section) == 0;
 }
 
 bool QHeaderViewPrivate::isLastVisibleSection(int section) const
@@ -3234,7 +3236,7 @@ bool QHeaderViewPrivate::isLastVisibleSection(int section) const
     if (sectionStartposRecalc)
         recalcSectionStartPos();
     const SectionItem &item = sectionItems.at(section);
-    return item.size > 0 && item.calculatedEndPos() == length;
+    return item.size > 0 && sectionEndPos(section) == length;
 }
 
 /*!
@@ -3438,8 +3440,10 @@ void QHeaderViewPrivate::createSectionItems(int start, int end, int size, QHeade
     }
     SectionItem *sectiondata = sectionItems.data();
     for (int i = start; i <= end; ++i) {
-        length += (sizePerSection - sectiondata[i].size);
-        sectionStartposRecalc |= (sectiondata[i].size != sizePerSection);
+        const int delta = sizePerSection - sectiondata[i].size;
+        length += delta;
+        if (delta != 0)
+            shiftSectionStartPos(i, delta);
         sectiondata[i].size = sizePerSection;
         sectiondata[i].resizeMode = mode;
     }
@@ -3465,6 +3469,7 @@ void QHeaderViewPrivate::clear()
     sectionSelected.clear();
     hiddenSectionSize.clear();
     sectionItems.clear();
+    sectionStartposShifts.clear();
     invalidateCachedSizeHint();
     }
 }
@@ -3638,9 +3643,51 @@ void QHeaderViewPrivate::recalcSectionStartPos() const // linear (but fast)
         i->calculated_startpos = pixelpos; // write into const mutable
         pixelpos += i->size;
     }
+    sectionStartposShifts.clear();
     sectionStartposRecalc = false;
 }
 
+// returns the index of the first shift recorded for visual or a section after it
+static inline int sectionStartposShiftIndex(const QVector<QPair<int, int> > &shifts, int visual)
+{
+    const auto it = std::lower_bound(shifts.constBegin(), shifts.constEnd(), visual,
+                                     [](const QPair<int, int> &shift, int v) { return shift.first < v; });
+    return int(it - shifts.constBegin());
+}
+
+void QHeaderViewPrivate::shiftSectionStartPos(int visual, int delta)
+{
+    // a pending recalculation will pick up the new size anyway
+    if (sectionStartposRecalc || visual >= sectionItems.count() - 1)
+        return;
+    // beyond a handful of resized sections (e.g. when resizing to contents)
+    // a single linear pass is cheaper than looking up the shifts
+    static const int maxSectionStartposShifts = 64;
+    int i = sectionStartposShiftIndex(sectionStartposShifts, visual);
+    if (i == sectionStartposShifts.count() || sectionStartposShifts.at(i).first != visual) {
+        if (sectionStartposShifts.count() >= maxSectionStartposShifts) {
+            sectionStartposRecalc = true;
+            return;
+        }
+        const int shift = (i > 0 ? sectionStartposShifts.at(i - 1).second : 0);
+        sectionStartposShifts.insert(i, qMakePair(visual, shift));
+    }
+    QPair<int, int> *shifts = sectionStartposShifts.data();
+    for (const int count = sectionStartposShifts.count(); i < count; ++i)
+        shifts[i].second += delta;
+}
+
+int QHeaderViewPrivate::sectionStartPos(int visual) const
+{
+    int pos = sectionItems.at(visual).calculated_startpos;
+    if (!sectionStartposShifts.isEmpty()) {
+        const int i = sectionStartposShiftIndex(sectionStartposShifts, visual);
+        if (i > 0)
+            pos += sectionStartposShifts.at(i - 1).second;
+    }
+    return pos;
+}
+
 void QHeaderViewPrivate::resizeSectionItem(int visualIndex, int oldSize, int newSize)
 {
     Q_Q(QHeaderView);
@@ -3661,7 +3708,7 @@ int QHeaderViewPrivate::headerSectionPosition(int visual) const
     if (visual < sectionCount() && visual >= 0) {
         if (sectionStartposRecalc)
             recalcSectionStartPos();
-        return sectionItems.at(visual).calculated_startpos;
+        return sectionStartPos(visual);
     }
     return -1;
 }
@@ -3674,10 +3721,11 @@ int QHeaderViewPrivate::headerVisualIndexAt(int position) const
     int endidx = sectionItems.count() - 1;
     while (startidx <= endidx) {
         int middle = (endidx + startidx) / 2;
-        if (sectionItems.at(middle).calculated_startpos > position) {
+        const int startpos = sectionStartPos(middle);
+        if (startpos > position) {
             endidx = middle - 1;
         } else {
-            if (sectionItems.at(middle).calculatedEndPos() <= position)
+            if (startpos + sectionItems.at(middle).size <= position)
                 startidx = middle + 1;
             else // we found it.
                 return middle;
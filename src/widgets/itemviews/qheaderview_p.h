@@ -318,7 +318,6 @@ public:
         inline SectionItem(int length, QHeaderView::ResizeMode mode)
             : size(length), isHidden(0), resizeMode(mode), calculated_startpos(-1) {}
         inline int sectionSize() const { return size; }
-        inline int calculatedEndPos() const { return calculated_startpos + size; }
 #ifndef QT_NO_DATASTREAM
         inline void write(QDataStream &out) const
         { out << static_cast<int>(size); out << 1; out << (int)resizeMode; }
@@ -328,6 +327,10 @@ public:
     };
 
     QVector<SectionItem> sectionItems;
+    // Resizing a section only moves the sections after it, so instead of recalculating
+    // every start position we remember (visual index, accumulated shift) pairs sorted by
+    // visual index and fold them into calculated_startpos once there are too many.
+    mutable QVector<QPair<int, int> > sectionStartposShifts;
 
     void createSectionItems(int start, int end, int size, QHeaderView::ResizeMode mode);
     void removeSectionsFromSectionItems(int start, int end);
@@ -335,6 +338,10 @@ public:
     void setDefaultSectionSize(int size);
     void updateDefaultSectionSizeFromStyle();
     void recalcSectionStartPos() const; // not really const
+    void shiftSectionStartPos(int visual, int delta);
+    int sectionStartPos(int visual) const;
+    inline int sectionEndPos(int visual) const
+    { return sectionStartPos(visual) + sectionItems.at(visual).size; }
 
     inline int headerLength() const { // for debugging
         int len = 0;
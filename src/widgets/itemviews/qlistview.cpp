@@ -1990,7 +1990,7 @@ int QCommonListViewBase::horizontalScrollToValue(const int /*index*/, QListView:
  * ListMode ListView Implementation
 */
 QListModeViewBase::QListModeViewBase(QListView *q, QListViewPrivate *d)
-    : QCommonListViewBase(q, d)
+    : QCommonListViewBase(q, d), batchSavedPosition(0), uniformLayout(false)
 {
     dd->defaultDropAction = Qt::CopyAction;
 }
@@ -2161,7 +2161,7 @@ void QListModeViewBase::updateVerticalScrollBar(const QSize &step)
     if (verticalScrollMode() == QAbstractItemView::ScrollPerItem
         && ((flow() == QListView::TopToBottom && !isWrapping())
         || (flow() == QListView::LeftToRight && isWrapping()))) {
-            const int steps = (flow() == QListView::TopToBottom ? scrollValueMap : segmentPositions).count() - 1;
+            const int steps = (flow() == QListView::TopToBottom ? scrollValueCount() : segmentPositionCount()) - 1;
             if (steps > 0) {
                 const int pageSteps = perItemScrollingPageSteps(viewport()->height(), contentsSize.height(), isWrapping());
                 verticalScrollBar()->setSingleStep(1);
@@ -2182,7 +2182,7 @@ void QListModeViewBase::updateHorizontalScrollBar(const QSize &step)
     if (horizontalScrollMode() == QAbstractItemView::ScrollPerItem
         && ((flow() == QListView::TopToBottom && isWrapping())
         || (flow() == QListView::LeftToRight && !isWrapping()))) {
-            int steps = (flow() == QListView::TopToBottom ? segmentPositions : scrollValueMap).count() - 1;
+            int steps = (flow() == QListView::TopToBottom ? segmentPositionCount() : scrollValueCount()) - 1;
             if (steps > 0) {
                 const int pageSteps = perItemScrollingPageSteps(viewport()->width(), contentsSize.width(), isWrapping());
                 horizontalScrollBar()->setSingleStep(1);
@@ -2201,15 +2201,17 @@ int QListModeViewBase::verticalScrollToValue(int index, QListView::ScrollHint hi
 {
     if (verticalScrollMode() == QAbstractItemView::ScrollPerItem) {
         int value;
-        if (scrollValueMap.isEmpty()) {
+        if (scrollValueCount() == 0) {
             value = 0;
         } else {
             int scrollBarValue = verticalScrollBar()->value();
             int numHidden = 0;
-            for (int i = 0; i < flowPositions.count() - 1 && i <= scrollBarValue; ++i)
-                if (isHidden(i))
-                    ++numHidden;
-            value = qBound(0, scrollValueMap.at(verticalScrollBar()->value()) - numHidden, flowPositions.count() - 1);
+            if (!uniformLayout) { // the uniform layout has no hidden rows
+                for (int i = 0; i < flowPositions.count() - 1 && i <= scrollBarValue; ++i)
+                    if (isHidden(i))
+                        ++numHidden;
+            }
+            value = qBound(0, scrollValueAt(scrollBarValue) - numHidden, flowPositionCount() - 1);
         }
         if (above)
             hint = QListView::PositionAtTop;
@@ -2228,17 +2230,17 @@ int QListModeViewBase::horizontalOffset() const
 {
     if (horizontalScrollMode() == QAbstractItemView::ScrollPerItem) {
         if (isWrapping()) {
-            if (flow() == QListView::TopToBottom && !segmentPositions.isEmpty()) {
-                const int max = segmentPositions.count() - 1;
+            if (flow() == QListView::TopToBottom && segmentPositionCount() > 0) {
+                const int max = segmentPositionCount() - 1;
                 int currentValue = qBound(0, horizontalScrollBar()->value(), max);
-                int position = segmentPositions.at(currentValue);
+                int position = segmentPositionAt(currentValue);
                 int maximumValue = qBound(0, horizontalScrollBar()->maximum(), max);
-                int maximum = segmentPositions.at(maximumValue);
+                int maximum = segmentPositionAt(maximumValue);
                 return (isRightToLeft() ? maximum - position : position);
             }
-        } else if (flow() == QListView::LeftToRight && !flowPositions.isEmpty()) {
-            int position = flowPositions.at(scrollValueMap.at(horizontalScrollBar()->value()));
-            int maximum = flowPositions.at(scrollValueMap.at(horizontalScrollBar()->maximum()));
+        } else if (flow() == QListView::LeftToRight && flowPositionCount() > 0) {
+            int position = flowPositionAt(scrollValueAt(horizontalScrollBar()->value()));
+            int maximum = flowPositionAt(scrollValueAt(horizontalScrollBar()->maximum()));
             return (isRightToLeft() ? maximum - position : position);
         }
     }
@@ -2249,17 +2251,17 @@ int QListModeViewBase::verticalOffset() const
 {
     if (verticalScrollMode() == QAbstractItemView::ScrollPerItem) {
         if (isWrapping()) {
-            if (flow() == QListView::LeftToRight && !segmentPositions.isEmpty()) {
+            if (flow() == QListView::LeftToRight && segmentPositionCount() > 0) {
                 int value = verticalScrollBar()->value();
-                if (value >= segmentPositions.count())
+                if (value >= segmentPositionCount())
                     return 0;
-                return segmentPositions.at(value) - spacing();
+                return segmentPositionAt(value) - spacing();
             }
-        } else if (flow() == QListView::TopToBottom && !flowPositions.isEmpty()) {
+        } else if (flow() == QListView::TopToBottom && flowPositionCount() > 0) {
             int value = verticalScrollBar()->value();
-            if (value > scrollValueMap.count())
+            if (value > scrollValueCount())
                 return 0;
-            return flowPositions.at(scrollValueMap.at(value)) - spacing();
+            return flowPositionAt(scrollValueAt(value)) - spacing();
         }
     }
     return QCommonListViewBase::verticalOffset();
@@ -2272,10 +2274,10 @@ int QListModeViewBase::horizontalScrollToValue(int index, QListView::ScrollHint
         return QCommonListViewBase::horizontalScrollToValue(index, hint, leftOf, rightOf, area, rect);
 
     int value;
-    if (scrollValueMap.isEmpty())
+    if (scrollValueCount() == 0)
         value = 0;
     else
-        value = qBound(0, scrollValueMap.at(horizontalScrollBar()->value()), flowPositions.count() - 1);
+        value = qBound(0, scrollValueAt(horizontalScrollBar()->value()), flowPositionCount() - 1);
     if (leftOf)
         hint = QListView::PositionAtTop;
     else if (rightOf)
@@ -2295,37 +2297,37 @@ void QListModeViewBase::scrollContentsBy(int dx, int dy, bool scrollElasticBand)
     const bool horizontal = (horizontalScrollMode() == QAbstractItemView::ScrollPerItem);
 
     if (isWrapping()) {
-        if (segmentPositions.isEmpty())
+        if (segmentPositionCount() == 0)
             return;
-        const int max = segmentPositions.count() - 1;
+        const int max = segmentPositionCount() - 1;
         if (horizontal && flow() == QListView::TopToBottom && dx != 0) {
             int currentValue = qBound(0, horizontalValue, max);
             int previousValue = qBound(0, currentValue + dx, max);
-            int currentCoordinate = segmentPositions.at(currentValue) - spacing();
-            int previousCoordinate = segmentPositions.at(previousValue) - spacing();
+            int currentCoordinate = segmentPositionAt(currentValue) - spacing();
+            int previousCoordinate = segmentPositionAt(previousValue) - spacing();
             dx = previousCoordinate - currentCoordinate;
         } else if (vertical && flow() == QListView::LeftToRight && dy != 0) {
             int currentValue = qBound(0, verticalValue, max);
             int previousValue = qBound(0, currentValue + dy, max);
-            int currentCoordinate = segmentPositions.at(currentValue) - spacing();
-            int previousCoordinate = segmentPositions.at(previousValue) - spacing();
+            int currentCoordinate = segmentPositionAt(currentValue) - spacing();
+            int previousCoordinate = segmentPositionAt(previousValue) - spacing();
             dy = previousCoordinate - currentCoordinate;
         }
     } else {
-        if (flowPositions.isEmpty())
+        if (flowPositionCount() == 0)
             return;
-        const int max = scrollValueMap.count() - 1;
+        const int max = scrollValueCount() - 1;
         if (vertical && flow() == QListView::TopToBottom && dy != 0) {
             int currentValue = qBound(0, verticalValue, max);
             int previousValue = qBound(0, currentValue + dy, max);
-            int currentCoordinate = flowPositions.at(scrollValueMap.at(currentValue));
-            int previousCoordinate = flowPositions.at(scrollValueMap.at(previousValue));
+            int currentCoordinate = flowPositionAt(scrollValueAt(currentValue));
+            int previousCoordinate = flowPositionAt(scrollValueAt(previousValue));
             dy = previousCoordinate - currentCoordinate;
         } else if (horizontal && flow() == QListView::LeftToRight && dx != 0) {
             int currentValue = qBound(0, horizontalValue, max);
             int previousValue = qBound(0, currentValue + dx, max);
-            int currentCoordinate = flowPositions.at(scrollValueMap.at(currentValue));
-            int previousCoordinate = flowPositions.at(scrollValueMap.at(previousValue));
+            int currentCoordinate = flowPositionAt(scrollValueAt(currentValue));
+            int previousCoordinate = flowPositionAt(scrollValueAt(previousValue));
             dx = previousCoordinate - currentCoordinate;
         }
     }
@@ -2334,7 +2336,8 @@ void QListModeViewBase::scrollContentsBy(int dx, int dy, bool scrollElasticBand)
 
 bool QListModeViewBase::doBatchedItemLayout(const QListViewLayoutInfo &info, int max)
 {
-    doStaticLayout(info);
+    if (!doUniformLayout(info))
+        doStaticLayout(info);
     if (batchStartRow > max) { // stop items layout
         flowPositions.resize(flowPositions.count());
         segmentPositions.resize(segmentPositions.count());
@@ -2346,13 +2349,12 @@ bool QListModeViewBase::doBatchedItemLayout(const QListViewLayoutInfo &info, int
 
 QListViewItem QListModeViewBase::indexToListViewItem(const QModelIndex &index) const
 {
-    if (flowPositions.isEmpty()
-        || segmentPositions.isEmpty()
-        || index.row() >= flowPositions.count())
+    if (flowPositionCount() == 0
+        || segmentPositionCount() == 0
+        || index.row() >= flowPositionCount())
         return QListViewItem();
 
-    const int segment = qBinarySearch<int>(segmentStartRows, index.row(),
-                                           0, segmentStartRows.count() - 1);
+    const int segment = segmentForRow(index.row());
 
 
     QStyleOptionViewItem options = viewOptions();
@@ -2362,15 +2364,15 @@ QListViewItem QListModeViewBase::indexToListViewItem(const QModelIndex &index) c
 
     QPoint pos;
     if (flow() == QListView::LeftToRight) {
-        pos.setX(flowPositions.at(index.row()));
-        pos.setY(segmentPositions.at(segment));
+        pos.setX(flowPositionAt(index.row()));
+        pos.setY(segmentPositionAt(segment));
     } else { // TopToBottom
-        pos.setY(flowPositions.at(index.row()));
-        pos.setX(segmentPositions.at(segment));
+        pos.setY(flowPositionAt(index.row()));
+        pos.setX(segmentPositionAt(segment));
         if (isWrapping()) { // make the items as wide as the segment
-            int right = (segment + 1 >= segmentPositions.count()
+            int right = (segment + 1 >= segmentPositionCount()
                      ? contentsSize.width()
-                     : segmentPositions.at(segment + 1));
+                     : segmentPositionAt(segment + 1));
             size.setWidth(right - pos.x());
         } else { // make the items as wide as the viewport
             size.setWidth(qMax(size.width(), viewport()->width() - 2 * spacing()));
@@ -2384,6 +2386,7 @@ QPoint QListModeViewBase::initStaticLayout(const QListViewLayoutInfo &info)
 {
     int x, y;
     if (info.first == 0) {
+        uniformLayout = false;
         flowPositions.clear();
         segmentPositions.clear();
         segmentStartRows.clear();
@@ -2519,6 +2522,145 @@ void QListModeViewBase::doStaticLayout(const QListViewLayoutInfo &info)
         viewport()->update();
 }
 
+/*!
+  \internal
+  Lays out all items at once when they all take the same space, because
+  there is a grid or the item sizes are uniform, and no row is hidden.
+  Instead of storing positions per item, only the steps between items and
+  segments are stored. Returns \c false if the layout has to be done by
+  doStaticLayout().
+*/
+bool QListModeViewBase::doUniformLayout(const QListViewLayoutInfo &info)
+{
+    const bool useItemSize = !info.grid.isValid();
+    if (info.first != 0 || hiddenCount() > 0 || (useItemSize && !uniformItemSizes()))
+        return false;
+
+    QSize hint = info.grid;
+    if (useItemSize) {
+        QStyleOptionViewItem option = viewOptions();
+        option.rect = info.bounds;
+        option.rect.adjust(info.spacing, info.spacing, -info.spacing, -info.spacing);
+        hint = itemSize(option, modelIndex(0));
+        hint += QSize(info.spacing, info.spacing);
+    }
+
+    // the same quantities as in doStaticLayout()
+    int segStartPosition;
+    int segEndPosition;
+    int deltaFlowPosition;
+    int deltaSegHint;
+    int flowPosition;
+    int segPosition;
+
+    if (info.flow == QListView::LeftToRight) {
+        segStartPosition = info.bounds.left();
+        segEndPosition = info.bounds.width();
+        flowPosition = segStartPosition + info.spacing;
+        segPosition = info.bounds.top() + info.spacing;
+        deltaFlowPosition = hint.width();
+        deltaSegHint = hint.height();
+    } else { // flow == QListView::TopToBottom
+        segStartPosition = info.bounds.top();
+        segEndPosition = info.bounds.height();
+        flowPosition = segStartPosition + info.spacing;
+        segPosition = info.bounds.left() + info.spacing;
+        deltaFlowPosition = hint.height();
+        deltaSegHint = hint.width();
+    }
+
+    const int flowStep = info.spacing + deltaFlowPosition;
+    if (flowStep <= 0 || deltaSegHint <= 0)
+        return false;
+
+    const int rows = info.max + 1;
+    int itemsPerSegment = rows;
+    if (info.wrap) {
+        // doStaticLayout() starts every segment at the same flow position, but
+        // creates empty segments if not even one item fits
+        if (flowPosition + deltaFlowPosition >= segEndPosition)
+            return false;
+        itemsPerSegment = qMin(rows, (segEndPosition - 1 - flowPosition - deltaFlowPosition) / flowStep + 1);
+    }
+
+    flowPositions.clear();
+    segmentPositions.clear();
+    segmentStartRows.clear();
+    segmentExtents.clear();
+    scrollValueMap.clear();
+
+    uniformLayout = true;
+    uniform.rowCount = rows;
+    uniform.itemsPerSegment = itemsPerSegment;
+    uniform.segmentCount = (rows - 1) / itemsPerSegment + 1;
+    uniform.flowStart = flowPosition;
+    uniform.flowStep = flowStep;
+    uniform.segmentStart = segPosition;
+    uniform.segmentStep = deltaSegHint + info.spacing;
+
+    const int lastSegmentRows = rows - (uniform.segmentCount - 1) * itemsPerSegment;
+    const int lastSegPosition = segPosition + (uniform.segmentCount - 1) * uniform.segmentStep;
+    uniform.flowEnd = flowPosition + lastSegmentRows * flowStep - info.spacing;
+    uniform.segmentEdge = info.wrap ? lastSegPosition + deltaSegHint : INT_MAX;
+
+    batchSavedPosition = uniform.flowEnd;
+    batchSavedDeltaSeg = deltaSegHint;
+    batchStartRow = rows;
+
+    // set the contents size
+    QRect rect = info.bounds;
+    if (info.flow == QListView::LeftToRight) {
+        rect.setRight(uniform.segmentCount == 1 ? uniform.flowEnd : info.bounds.right());
+        rect.setBottom(lastSegPosition + deltaSegHint);
+    } else { // TopToBottom
+        rect.setRight(lastSegPosition + deltaSegHint);
+        rect.setBottom(uniform.segmentCount == 1 ? uniform.flowEnd : info.bounds.bottom());
+    }
+    contentsSize = QSize(rect.right(), rect.bottom());
+
+    viewport()->update();
+    return true;
+}
+
+int QListModeViewBase::segmentForRow(int row) const
+{
+    if (uniformLayout)
+        return qMin(row / uniform.itemsPerSegment, uniform.segmentCount - 1);
+    return qBinarySearch<int>(segmentStartRows, row, 0, segmentStartRows.count() - 1);
+}
+
+/*!
+  \internal
+  Returns the last segment up to \a last starting at or before \a position.
+*/
+int QListModeViewBase::segmentAt(int position, int last) const
+{
+    if (!uniformLayout)
+        return qBinarySearch<int>(segmentPositions, position, 0, last);
+
+    int segment = 0;
+    if (position >= uniform.segmentStart)
+        segment = qMin((position - uniform.segmentStart) / uniform.segmentStep, uniform.segmentCount - 1);
+    if (last >= uniform.segmentCount && position >= uniform.segmentEdge)
+        segment = uniform.segmentCount;
+    return qMin(segment, last);
+}
+
+/*!
+  \internal
+  Returns the last row between \a first and \a last, which must be in the
+  same segment, starting at or before \a flowPosition.
+*/
+int QListModeViewBase::rowAt(int flowPosition, int first, int last) const
+{
+    if (!uniformLayout)
+        return qBinarySearch<int>(flowPositions, flowPosition, first, last);
+
+    if (flowPosition < uniform.flowStart)
+        return first;
+    return first + qMin((flowPosition - uniform.flowStart) / uniform.flowStep, last - first);
+}
+
 /*!
   \internal
   Finds the set of items intersecting with \a area.
@@ -2542,18 +2684,18 @@ QVector<QModelIndex> QListModeViewBase::intersectingSet(const QRect &area) const
         flowStartPosition = area.top();
         flowEndPosition = area.bottom();
     }
-    if (segmentPositions.count() < 2 || flowPositions.isEmpty())
+    if (segmentPositionCount() < 2 || flowPositionCount() == 0)
         return ret;
     // the last segment position is actually the edge of the last segment
-    const int segLast = segmentPositions.count() - 2;
-    int seg = qBinarySearch<int>(segmentPositions, segStartPosition, 0, segLast + 1);
-    for (; seg <= segLast && segmentPositions.at(seg) <= segEndPosition; ++seg) {
-        int first = segmentStartRows.at(seg);
-        int last = (seg < segLast ? segmentStartRows.at(seg + 1) : batchStartRow) - 1;
-        if (segmentExtents.at(seg) < flowStartPosition)
+    const int segLast = segmentPositionCount() - 2;
+    int seg = segmentAt(segStartPosition, segLast + 1);
+    for (; seg <= segLast && segmentPositionAt(seg) <= segEndPosition; ++seg) {
+        int first = segmentStartRowAt(seg);
+        int last = (seg < segLast ? segmentStartRowAt(seg + 1) : batchStartRow) - 1;
+        if (segmentExtentAt(seg) < flowStartPosition)
             continue;
-        int row = qBinarySearch<int>(flowPositions, flowStartPosition, first, last);
-        for (; row <= last && flowPositions.at(row) <= flowEndPosition; ++row) {
+        int row = rowAt(flowStartPosition, first, last);
+        for (; row <= last && flowPositionAt(row) <= flowEndPosition; ++row) {
             if (isHidden(row))
                 continue;
             QModelIndex index = modelIndex(row);
@@ -2593,30 +2735,33 @@ QRect QListModeViewBase::mapToViewport(const QRect &rect) const
 
 int QListModeViewBase::perItemScrollingPageSteps(int length, int bounds, bool wrap) const
 {
-    QVector<int> positions;
+    // the positions are looked up rather than copied, the uniform layout
+    // does not store them
+    int count = 0;
     if (wrap)
-        positions = segmentPositions;
-    else if (!flowPositions.isEmpty()) {
-        positions.reserve(scrollValueMap.size());
-        foreach (int itemShown, scrollValueMap)
-            positions.append(flowPositions.at(itemShown));
-    }
-    if (positions.isEmpty() || bounds <= length)
-        return positions.count();
+        count = segmentPositionCount();
+    else if (flowPositionCount() > 0)
+        count = scrollValueCount();
+    const auto positionAt = [this, wrap](int i) {
+        return wrap ? segmentPositionAt(i) : flowPositionAt(scrollValueAt(i));
+    };
+
+    if (count == 0 || bounds <= length)
+        return count;
     if (uniformItemSizes()) {
-        for (int i = 1; i < positions.count(); ++i)
-            if (positions.at(i) > 0)
-                return length / positions.at(i);
+        for (int i = 1; i < count; ++i)
+            if (positionAt(i) > 0)
+                return length / positionAt(i);
         return 0; // all items had height 0
     }
     int pageSteps = 0;
-    int steps = positions.count() - 1;
+    int steps = count - 1;
     int max = qMax(length, bounds);
     int min = qMin(length, bounds);
-    int pos = min - (max - positions.last());
+    int pos = min - (max - positionAt(count - 1));
 
     while (pos >= 0 && steps > 0) {
-        pos -= (positions.at(steps) - positions.at(steps - 1));
+        pos -= (positionAt(steps) - positionAt(steps - 1));
         if (pos >= 0) //this item should be visible
             ++pageSteps;
         --steps;
@@ -2635,19 +2780,24 @@ int QListModeViewBase::perItemScrollToValue(int index, int scrollValue, int view
 
     itemExtent += spacing();
     QVector<int> visibleFlowPositions;
-    visibleFlowPositions.reserve(flowPositions.count() - 1);
-    for (int i = 0; i < flowPositions.count() - 1; i++) { // flowPositions count is +1 larger than actual row count
-        if (!isHidden(i))
-            visibleFlowPositions.append(flowPositions.at(i));
+    if (!uniformLayout) { // the uniform layout has no hidden rows
+        visibleFlowPositions.reserve(flowPositions.count() - 1);
+        for (int i = 0; i < flowPositions.count() - 1; i++) { // flowPositions count is +1 larger than actual row count
+            if (!isHidden(i))
+                visibleFlowPositions.append(flowPositions.at(i));
+        }
     }
+    const auto visibleFlowPositionAt = [this, &visibleFlowPositions](int i) {
+        return uniformLayout ? flowPositionAt(i) : visibleFlowPositions.at(i);
+    };
 
     if (!wrap) {
         int topIndex = index;
         const int bottomIndex = topIndex;
-        const int bottomCoordinate = visibleFlowPositions.at(index);
+        const int bottomCoordinate = visibleFlowPositionAt(index);
 
         while (topIndex > 0 &&
-               (bottomCoordinate - visibleFlowPositions.at(topIndex - 1) + itemExtent) <= (viewportSize)) {
+               (bottomCoordinate - visibleFlowPositionAt(topIndex - 1) + itemExtent) <= (viewportSize)) {
             topIndex--;
         }
 
@@ -2667,15 +2817,15 @@ int QListModeViewBase::perItemScrollToValue(int index, int scrollValue, int view
                                            ? Qt::Horizontal : Qt::Vertical);
         if (flowOrientation == orientation) { // scrolling in the "flow" direction
             // ### wrapped scrolling in the flow direction
-            return visibleFlowPositions.at(index); // ### always pixel based for now
-        } else if (!segmentStartRows.isEmpty()) { // we are scrolling in the "segment" direction
-            int segment = qBinarySearch<int>(segmentStartRows, index, 0, segmentStartRows.count() - 1);
+            return visibleFlowPositionAt(index); // ### always pixel based for now
+        } else if (uniformLayout || !segmentStartRows.isEmpty()) { // we are scrolling in the "segment" direction
+            int segment = segmentForRow(index);
             int leftSegment = segment;
             const int rightSegment = leftSegment;
-            const int bottomCoordinate = segmentPositions.at(segment);
+            const int bottomCoordinate = segmentPositionAt(segment);
 
             while (leftSegment > scrollValue &&
-                (bottomCoordinate - segmentPositions.at(leftSegment-1) + itemExtent) <= (viewportSize)) {
+                (bottomCoordinate - segmentPositionAt(leftSegment-1) + itemExtent) <= (viewportSize)) {
                     leftSegment--;
             }
 
@@ -2697,6 +2847,7 @@ int QListModeViewBase::perItemScrollToValue(int index, int scrollValue, int view
 
 void QListModeViewBase::clear()
 {
+    uniformLayout = false;
     flowPositions.clear();
     segmentPositions.clear();
     segmentStartRows.clear();
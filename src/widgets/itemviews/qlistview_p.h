@@ -207,12 +207,30 @@ public:
     // used when laying out in batches
     int batchSavedPosition;
 
+    // When every item takes the same space and no row is hidden, the layout
+    // is described by these instead of the vectors above, and positions are
+    // computed from the row. Nothing is stored per item then.
+    struct UniformLayout
+    {
+        int rowCount;
+        int itemsPerSegment;
+        int segmentCount;
+        int flowStart;
+        int flowStep;
+        int segmentStart;
+        int segmentStep;
+        int segmentEdge;     // the edge of the last segment
+        int flowEnd;         // the end of the last item
+    };
+    UniformLayout uniform;
+    bool uniformLayout;
+
     //reimplementations
     int itemIndex(const QListViewItem &item) const { return item.indexHint; }
     QListViewItem indexToListViewItem(const QModelIndex &index) const;
     bool doBatchedItemLayout(const QListViewLayoutInfo &info, int max);
     void clear();
-    void setRowCount(int rowCount) { flowPositions.resize(rowCount); }
+    void setRowCount(int) { } // the positions are rebuilt by the first layout batch
     QVector<QModelIndex> intersectingSet(const QRect &area) const;
     void dataChanged(const QModelIndex &, const QModelIndex &);
 
@@ -238,6 +256,47 @@ public:
 private:
     QPoint initStaticLayout(const QListViewLayoutInfo &info);
     void doStaticLayout(const QListViewLayoutInfo &info);
+    bool doUniformLayout(const QListViewLayoutInfo &info);
+
+    // accessors that work for both the stored and the uniform layout
+    inline int flowPositionCount() const
+    { return uniformLayout ? uniform.rowCount + 1 : flowPositions.count(); }
+    inline int flowPositionAt(int row) const
+    {
+        if (!uniformLayout)
+            return flowPositions.at(row);
+        return row < uniform.rowCount
+            ? uniform.flowStart + (row % uniform.itemsPerSegment) * uniform.flowStep
+            : uniform.flowEnd;
+    }
+    inline int segmentPositionCount() const
+    { return uniformLayout ? uniform.segmentCount + 1 : segmentPositions.count(); }
+    inline int segmentPositionAt(int segment) const
+    {
+        if (!uniformLayout)
+            return segmentPositions.at(segment);
+        return segment < uniform.segmentCount
+            ? uniform.segmentStart + segment * uniform.segmentStep
+            : uniform.segmentEdge;
+    }
+    inline int segmentStartRowAt(int segment) const
+    { return uniformLayout ? segment * uniform.itemsPerSegment : segmentStartRows.at(segment); }
+    inline int segmentExtentAt(int segment) const
+    {
+        if (!uniformLayout)
+            return segmentExtents.at(segment);
+        return segment < uniform.segmentCount - 1
+            ? uniform.flowStart + uniform.itemsPerSegment * uniform.flowStep
+            : uniform.flowEnd;
+    }
+    inline int scrollValueCount() const
+    { return uniformLayout ? uniform.rowCount + 1 : scrollValueMap.count(); }
+    inline int scrollValueAt(int value) const
+    { return uniformLayout ? value : scrollValueMap.at(value); }
+    int segmentForRow(int row) const;
+    int segmentAt(int position, int last) const;
+    int rowAt(int flowPosition, int first, int last) const;
+
     int perItemScrollToValue(int index, int value, int height,
                              QAbstractItemView::ScrollHint hint,
                              Qt::Orientation orientation, bool wrap, int extent) const;
@@ -237,6 +237,7 @@ void QTreeView::setModel(QAbstractItemModel *model)
         disconnect(d->model, SIGNAL(modelAboutToBeReset()), this, SLOT(_q_modelAboutToBeReset()));
     }
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
     d->expandedIndexes.clear();
     d->hiddenIndexes.clear();
     d->header->setModel(model);
@@ -455,6 +456,7 @@ void QTreeView::setUniformRowHeights(bool uniform)
 {
     Q_D(QTreeView);
     d->uniformRowHeights = uniform;
+    d->invalidateItemPositions(0);
 }
 
 /*!
@@ -1399,6 +1401,7 @@ void QTreeViewPrivate::_q_modelDestroyed()
     //we need to clear the viewItems because it contains QModelIndexes to
     //the model currently being destroyed
     viewItems.clear();
+    invalidateItemPositions(0);
     QAbstractItemViewPrivate::_q_modelDestroyed();
 }
 
@@ -2109,6 +2112,7 @@ void QTreeView::doItemsLayout()
         }
     }
     d->viewItems.clear(); // prepare for new layout
+    d->invalidateItemPositions(0);
     QModelIndex parent = d->root;
     if (d->model->hasChildren(parent)) {
         d->layout(-1);
@@ -2127,6 +2131,7 @@ void QTreeView::reset()
     d->hiddenIndexes.clear();
     d->spanningIndexes.clear();
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
     QAbstractItemView::reset();
 }
 
@@ -2156,16 +2161,12 @@ int QTreeView::verticalOffset() const
         if (d->uniformRowHeights)
             return verticalScrollBar()->value() * d->defaultItemHeight;
         // If we are scrolling per item and have non-uniform row heights,
-        // finding the vertical offset in pixels is going to be relatively slow.
-        // ### find a faster way to do this
+        // the offset is the position of the top item in the view.
         d->executePostedLayout();
-        int offset = 0;
-        for (int i = 0; i < d->viewItems.count(); ++i) {
-            if (i == verticalScrollBar()->value())
-                return offset;
-            offset += d->itemHeight(i);
-        }
-        return 0;
+        const int value = verticalScrollBar()->value();
+        if (value < 0 || value >= d->viewItems.count())
+            return 0;
+        return d->itemPosition(value);
     }
     // scroll per pixel
     return verticalScrollBar()->value();
@@ -2554,7 +2555,12 @@ void QTreeView::rowsInserted(const QModelIndex &parent, int start, int end)
     const int parentItem = d->viewIndex(parent);
     if (((parentItem != -1) && d->viewItems.at(parentItem).expanded)
         || (parent == d->root)) {
-        d->doDelayedItemsLayout();
+        if (d->appendViewItems(parentItem, start, end)) {
+            updateGeometries();
+            viewport()->update();
+        } else {
+            d->doDelayedItemsLayout();
+        }
     } else if (parentItem != -1 && parentRowCount == delta) {
         // the parent just went from 0 children to more. update to re-paint the decoration
         d->viewItems[parentItem].hasChildren = true;
@@ -2572,6 +2578,7 @@ void QTreeView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int e
     Q_D(QTreeView);
     QAbstractItemView::rowsAboutToBeRemoved(parent, start, end);
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
 }
 
 /*!
@@ -2584,6 +2591,7 @@ void QTreeView::rowsRemoved(const QModelIndex &parent, int start, int end)
 {
     Q_D(QTreeView);
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
     d->doDelayedItemsLayout();
     d->hasRemovedItems = true;
     d->_q_rowsRemoved(parent, start, end);
@@ -2717,6 +2725,7 @@ void QTreeView::expandAll()
 {
     Q_D(QTreeView);
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
     d->interruptDelayedItemsLayout();
     d->layout(-1, true);
     updateGeometries();
@@ -2757,6 +2766,7 @@ void QTreeView::expandToDepth(int depth)
 {
     Q_D(QTreeView);
     d->viewItems.clear();
+    d->invalidateItemPositions(0);
     QSet<QPersistentModelIndex> old_expandedIndexes;
     old_expandedIndexes = d->expandedIndexes;
     d->expandedIndexes.clear();
@@ -3092,6 +3102,7 @@ void QTreeViewPrivate::expand(int item, bool emitSignal)
 
 void QTreeViewPrivate::insertViewItems(int pos, int count, const QTreeViewItem &viewItem)
 {
+    invalidateItemPositions(pos);
     viewItems.insert(pos, count, viewItem);
     QTreeViewItem *items = viewItems.data();
     for (int i = pos + count; i < viewItems.count(); i++)
@@ -3099,8 +3110,63 @@ void QTreeViewPrivate::insertViewItems(int pos, int count, const QTreeViewItem &
             items[i].parentItem += count;
 }
 
+/*!
+  \internal
+  Lays out the rows \a start to \a end that were just inserted under the
+  expanded \a parentItem (or the root if \a parentItem is -1) without
+  relayouting the whole tree. This is only possible when the rows were
+  appended, so that the view items of their siblings are still valid, and
+  none of the new rows is expanded. Returns false if a complete relayout is
+  needed instead.
+*/
+bool QTreeViewPrivate::appendViewItems(int parentItem, int start, int end)
+{
+    Q_Q(QTreeView);
+    if (viewItems.isEmpty() || !hiddenIndexes.isEmpty())
+        return false;
+    const QModelIndex parent = (parentItem == -1) ? QModelIndex(root) : viewItems.at(parentItem).index;
+    if (model->rowCount(parent) != end + 1)
+        return false;
+
+    const int count = end - start + 1;
+    const uint level = (parentItem == -1) ? 0 : viewItems.at(parentItem).level + 1;
+    QVector<QTreeViewItem> items(count);
+    for (int row = start; row <= end; ++row) {
+        const QModelIndex current = model->index(row, 0, parent);
+        if (isIndexExpanded(current))
+            return false;
+        QTreeViewItem &item = items[row - start];
+        item.index = current;
+        item.parentItem = parentItem;
+        item.level = level;
+        item.spanning = q->isFirstColumnSpanned(row, parent);
+        item.hasChildren = hasVisibleChildren(current);
+        item.hasMoreSiblings = row < end;
+    }
+
+    const int pos = (parentItem == -1) ? viewItems.count() : parentItem + viewItems.at(parentItem).total + 1;
+    if (start > 0) {
+        // the previous last child is the closest ancestor of the item before pos
+        int sibling = pos - 1;
+        while (sibling > -1 && viewItems.at(sibling).parentItem != parentItem)
+            sibling = viewItems.at(sibling).parentItem;
+        if (sibling <= parentItem)
+            return false;
+        viewItems[sibling].hasMoreSiblings = true;
+    }
+
+    insertViewItems(pos, count, QTreeViewItem());
+    std::copy(items.constBegin(), items.constEnd(), viewItems.begin() + pos);
+    for (int i = parentItem; i > -1; i = viewItems.at(i).parentItem)
+        viewItems[i].total += count;
+    if (parentItem != -1)
+        viewItems[parentItem].hasChildren = true;
+    return true;
+}
+
 void QTreeViewPrivate::removeViewItems(int pos, int count)
 {
+    invalidateItemPositions(pos);
     viewItems.remove(pos, count);
     QTreeViewItem *items = viewItems.data();
     for (int i = pos; i < viewItems.count(); i++)
@@ -3278,12 +3344,14 @@ void QTreeViewPrivate::_q_endAnimatedOperation()
 void QTreeViewPrivate::_q_modelAboutToBeReset()
 {
     viewItems.clear();
+    invalidateItemPositions(0);
 }
 
 void QTreeViewPrivate::_q_columnsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
     if (start <= 0 && 0 <= end)
         viewItems.clear();
+        invalidateItemPositions(0);
     QAbstractItemViewPrivate::_q_columnsAboutToBeRemoved(parent, start, end);
 }
 
@@ -3321,6 +3389,7 @@ void QTreeViewPrivate::layout(int i, bool recursiveExpanding, bool afterIsUninit
         count = model->rowCount(parent);
     }
 
+    invalidateItemPositions(i + 1);
     bool expanding = true;
     if (i == -1) {
         if (uniformRowHeights) {
@@ -3438,6 +3507,57 @@ int QTreeViewPrivate::itemHeight(int item) const
 }
 
 
+/*!
+  \internal
+  Returns the contents y coordinate of the top of \a item when the rows
+  don't have uniform heights. The item positions are accumulated on demand
+  and kept until the items before them change, so only the heights up to
+  \a item are ever queried and repeated lookups are constant time.
+*/
+int QTreeViewPrivate::itemPosition(int item) const
+{
+    const int count = qMin(item, viewItems.count());
+    if (count <= 0)
+        return 0;
+    if (itemBottoms.count() < count) {
+        itemBottoms.reserve(viewItems.count());
+        int y = itemBottoms.isEmpty() ? 0 : itemBottoms.last();
+        for (int i = itemBottoms.count(); i < count; ++i) {
+            y += itemHeight(i); // the height value is cached
+            itemBottoms.append(y);
+        }
+    }
+    return itemBottoms.at(count - 1);
+}
+
+/*!
+  \internal
+  Returns the index of the view item covering the contents y coordinate
+  \a position when the rows don't have uniform heights, or -1 if the
+  position is below the last item. If \a includeBottomEdge is true, the
+  coordinate of the bottom edge of an item, which is also the top edge of
+  the next one, belongs to the upper item. The lookup is a binary search
+  over the accumulated item positions.
+*/
+int QTreeViewPrivate::itemAtPosition(int position, bool includeBottomEdge) const
+{
+    const int itemCount = viewItems.count();
+    if (itemCount == 0)
+        return -1;
+    if (itemBottoms.isEmpty() || itemBottoms.last() <= position) {
+        itemBottoms.reserve(itemCount);
+        int y = itemBottoms.isEmpty() ? 0 : itemBottoms.last();
+        for (int i = itemBottoms.count(); i < itemCount && y <= position; ++i) {
+            y += itemHeight(i); // the height value is cached
+            itemBottoms.append(y);
+        }
+    }
+    const QVector<int>::const_iterator it = includeBottomEdge
+            ? std::lower_bound(itemBottoms.constBegin(), itemBottoms.constEnd(), position)
+            : std::upper_bound(itemBottoms.constBegin(), itemBottoms.constEnd(), position);
+    return it == itemBottoms.constEnd() ? -1 : int(it - itemBottoms.constBegin());
+}
+
 /*!
   \internal
   Returns the viewport y coordinate for \a item.
@@ -3447,13 +3567,8 @@ int QTreeViewPrivate::coordinateForItem(int item) const
     if (verticalScrollMode == QAbstractItemView::ScrollPerPixel) {
         if (uniformRowHeights)
             return (item * defaultItemHeight) - vbar->value();
-        // ### optimize (maybe do like QHeaderView by letting items have startposition)
-        int y = 0;
-        for (int i = 0; i < viewItems.count(); ++i) {
-            if (i == item)
-                return y - vbar->value();
-            y += itemHeight(i);
-        }
+        if (item >= 0 && item < viewItems.count())
+            return itemPosition(item) - vbar->value();
     } else { // ScrollPerItem
         int topViewItemIndex = vbar->value();
         if (uniformRowHeights)
@@ -3505,14 +3620,7 @@ int QTreeViewPrivate::itemAtCoordinate(int coordinate) const
             const int viewItemIndex = (coordinate + vbar->value()) / defaultItemHeight;
             return ((viewItemIndex >= itemCount || viewItemIndex < 0) ? -1 : viewItemIndex);
         }
-        // ### optimize
-        int viewItemCoordinate = 0;
-        const int contentsCoordinate = coordinate + vbar->value();
-        for (int viewItemIndex = 0; viewItemIndex < viewItems.count(); ++viewItemIndex) {
-            viewItemCoordinate += itemHeight(viewItemIndex);
-            if (viewItemCoordinate >= contentsCoordinate)
-                return (viewItemIndex >= itemCount ? -1 : viewItemIndex);
-        }
+        return itemAtPosition(coordinate + vbar->value(), true);
     } else { // ScrollPerItem
         int topViewItemIndex = vbar->value();
         if (uniformRowHeights) {
@@ -3614,16 +3722,10 @@ int QTreeViewPrivate::firstVisibleItem(int *offset) const
             *offset = -(value % defaultItemHeight);
         return value / defaultItemHeight;
     }
-    int y = 0; // ### (maybe do like QHeaderView by letting items have startposition)
-    for (int i = 0; i < viewItems.count(); ++i) {
-        y += itemHeight(i); // the height value is cached
-        if (y > value) {
-            if (offset)
-                *offset = y - value - itemHeight(i);
-            return i;
-        }
-    }
-    return -1;
+    const int i = itemAtPosition(value);
+    if (i != -1 && offset)
+        *offset = itemPosition(i) - value;
+    return i;
 }
 
 int QTreeViewPrivate::lastVisibleItem(int firstVisual, int offset) const
@@ -3687,9 +3789,8 @@ void QTreeViewPrivate::updateScrollBars()
         int contentsHeight = 0;
         if (uniformRowHeights) {
             contentsHeight = defaultItemHeight * viewItems.count();
-        } else { // ### (maybe do like QHeaderView by letting items have startposition)
-            for (int i = 0; i < viewItems.count(); ++i)
-                contentsHeight += itemHeight(i);
+        } else {
+            contentsHeight = itemPosition(viewItems.count());
         }
         vbar->setRange(0, contentsHeight - viewportSize.height());
         vbar->setPageStep(viewportSize.height());
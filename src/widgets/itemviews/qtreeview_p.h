@@ -142,12 +142,17 @@ public:
     int indentationForItem(int item) const;
     int coordinateForItem(int item) const;
     int itemAtCoordinate(int coordinate) const;
+    int itemPosition(int item) const;
+    int itemAtPosition(int position, bool includeBottomEdge = false) const;
+    inline void invalidateItemPositions(int item) const
+        { if (item < itemBottoms.count()) itemBottoms.resize(qMax(item, 0)); }
 
     int viewIndex(const QModelIndex &index) const;
     QModelIndex modelIndex(int i, int column = 0) const;
 
     void insertViewItems(int pos, int count, const QTreeViewItem &viewItem);
     void removeViewItems(int pos, int count);
+    bool appendViewItems(int parentItem, int start, int end);
 #if 0
     bool checkViewItems() const;
 #endif
@@ -182,6 +187,9 @@ public:
     int indent;
 
     mutable QVector<QTreeViewItem> viewItems;
+    // bottom edge of each view item when the rows don't have uniform
+    // heights, accumulated lazily; only the first count() entries are valid
+    mutable QVector<int> itemBottoms;
     mutable int lastViewedItem;
     int defaultItemHeight; // this is just a number; contentsHeight() / numItems
     bool uniformRowHeights; // used when all rows have the same height
@@ -202,10 +210,9 @@ public:
     bool animationsEnabled;
 
     inline bool storeExpanded(const QPersistentModelIndex &idx) {
-        if (expandedIndexes.contains(idx))
-            return false;
+        const int count = expandedIndexes.count();
         expandedIndexes.insert(idx);
-        return true;
+        return expandedIndexes.count() != count;
     }
 
     inline bool isIndexExpanded(const QModelIndex &idx) const {
@@ -235,7 +242,7 @@ public:
     inline int below(int item) const
         { int i = item; while (isItemHiddenOrDisabled(++item)){} return item >= viewItems.count() ? i : item; }
     inline void invalidateHeightCache(int item) const
-        { viewItems[item].height = 0; }
+        { viewItems[item].height = 0; invalidateItemPositions(item); }
 
     inline int accessibleTable2Index(const QModelIndex &index) const {
         return (viewIndex(index) + (header ? 1 : 0)) * model->columnCount()+index.column();
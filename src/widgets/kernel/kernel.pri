@@ -11,6 +11,7 @@ HEADERS += \
 	kernel/qapplication.h \
 	kernel/qapplication_p.h \
         kernel/qwidgetbackingstore_p.h \
+        kernel/qwidgetrepaintprofiler_p.h \
 	kernel/qboxlayout.h \
 	kernel/qdesktopwidget.h \
 	kernel/qformlayout.h \
@@ -42,6 +43,7 @@ SOURCES += \
 	kernel/qactiongroup.cpp \
 	kernel/qapplication.cpp \
         kernel/qwidgetbackingstore.cpp \
+        kernel/qwidgetrepaintprofiler.cpp \
         kernel/qboxlayout.cpp \
 	kernel/qformlayout.cpp \
 	kernel/qgridlayout.cpp \
@@ -67,6 +67,7 @@
 #include "private/qstyle_p.h"
 #include "qmessagebox.h"
 #include "qwidgetwindow_p.h"
+#include "qwidgetrepaintprofiler_p.h"
 #include <QtWidgets/qgraphicsproxywidget.h>
 #include <QtGui/qstylehints.h>
 #include <QtGui/qinputmethod.h>
@@ -642,6 +643,9 @@ void QApplicationPrivate::initialize()
     if (qEnvironmentVariableIntValue("QT_USE_NATIVE_WINDOWS") > 0)
         QCoreApplication::setAttribute(Qt::AA_NativeWindows);
 
+    if (!qEnvironmentVariableIsEmpty("QT_WIDGETS_REPAINT_PROFILE"))
+        QWidgetRepaintProfiler::setEnabled(true);
+
 #ifndef QT_NO_WHEELEVENT
     QApplicationPrivate::wheel_scroll_lines = 3;
 #endif
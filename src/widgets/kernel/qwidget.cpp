@@ -85,6 +85,7 @@
 #include <private/qgraphicseffect_p.h>
 #include <qbackingstore.h>
 #include <private/qwidgetbackingstore_p.h>
+#include <private/qwidgetrepaintprofiler_p.h>
 #ifdef Q_DEAD_CODE_FROM_QT4_MAC
 # include <private/qpaintengine_mac_p.h>
 #endif
@@ -5562,6 +5563,10 @@ void QWidgetPrivate::drawWidget(QPaintDevice *pdev, const QRegion &rgn, const QP
                 qWarning("QWidget::repaint: Recursive repaint detected");
             q->setAttribute(Qt::WA_WState_InPaintEvent);
 
+            QWidgetRepaintProfiler *profiler = QWidgetRepaintProfiler::isActive()
+                    ? QWidgetRepaintProfiler::instance() : 0;
+            const qint64 paintStart = profiler ? profiler->now() : 0;
+
             //clip away the new area
 #ifndef QT_NO_PAINT_DEBUG
             bool flushed = QWidgetBackingStore::flushPaint(q, toBePainted);
@@ -5650,6 +5655,9 @@ void QWidgetPrivate::drawWidget(QPaintDevice *pdev, const QRegion &rgn, const QP
                 sendPaintEvent(toBePainted);
             }
 
+            if (profiler)
+                profiler->recordPaint(q, toBePainted, paintStart);
+
             // Native widgets need to be marked dirty on screen so painting will be done in correct context
             if (backingStore && !onScreen && !asRoot && (q->internalWinId() || (q->nativeParentWidget() && !q->nativeParentWidget()->isWindow())))
                 backingStore->markDirtyOnScreen(toBePainted, q, offset);
@@ -10760,6 +10768,7 @@ void QWidget::scroll(int dx, int dy)
         // Graphics View maintains its own dirty region as a list of rects;
         // until we can connect item updates directly to the view, we must
         // separately add a translated dirty region.
+        d->mergePendingDirty();
         for (const QRect &rect : d->dirty)
             proxy->update(rect.translated(dx, dy));
         proxy->scroll(dx, dy, proxy->subWidgetRect(this));
@@ -10800,6 +10809,7 @@ void QWidget::scroll(int dx, int dy, const QRect &r)
         // Graphics View maintains its own dirty region as a list of rects;
         // until we can connect item updates directly to the view, we must
         // separately add a translated dirty region.
+        d->mergePendingDirty();
         if (!d->dirty.isEmpty()) {
             for (const QRect &rect : d->dirty.translated(dx, dy) & r)
                 proxy->update(rect);
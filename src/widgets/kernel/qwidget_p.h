@@ -57,6 +57,7 @@
 #include "QtCore/qlocale.h"
 #include "QtCore/qset.h"
 #include "QtGui/qregion.h"
+#include <private/qregion_p.h>
 #include "QtGui/qinputmethod.h"
 #include "QtGui/qopengl.h"
 #include "QtGui/qsurfaceformat.h"
@@ -426,6 +427,12 @@ public:
     const QRegion &getOpaqueChildren() const;
     void setDirtyOpaqueRegion();
 
+    inline void mergePendingDirty()
+    {
+        if (!pendingDirty.isEmpty())
+            dirty += pendingDirty.takeRegion();
+    }
+
     bool close_helper(CloseMode mode);
 
     void setWindowIcon_helper();
@@ -691,6 +698,7 @@ public:
     // Implicit pointers (shared_null/shared_empty).
     QRegion opaqueChildren;
     QRegion dirty;
+    QRegionAccumulator pendingDirty; // not yet merged into dirty
 #ifndef QT_NO_TOOLTIP
     QString toolTip;
     int toolTipDuration;
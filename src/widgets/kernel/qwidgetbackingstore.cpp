@@ -55,6 +55,7 @@
 #include <private/qpaintengine_raster_p.h>
 #include <private/qgraphicseffect_p.h>
 #include <private/qwidgetwindow_p.h>
+#include <private/qwidgetrepaintprofiler_p.h>
 #include <QtGui/private/qwindow_p.h>
 
 #include <qpa/qplatformbackingstore.h>
@@ -109,6 +110,10 @@ void QWidgetBackingStore::qt_flush(QWidget *widget, const QRegion &region, QBack
     if (widget != tlw)
         offset += widget->mapTo(tlw, QPoint());
 
+    QWidgetRepaintProfiler *profiler = QWidgetRepaintProfiler::isActive()
+            ? QWidgetRepaintProfiler::instance() : 0;
+    const qint64 flushStart = profiler ? profiler->now() : 0;
+
 #ifndef QT_NO_OPENGL
     if (widgetTextures) {
         qt_window_private(tlw->windowHandle())->compositing = true;
@@ -125,6 +130,9 @@ void QWidgetBackingStore::qt_flush(QWidget *widget, const QRegion &region, QBack
     } else
 #endif
         backingStore->flush(region, widget->windowHandle(), offset);
+
+    if (profiler)
+        profiler->recordFlush(widget, region, flushStart);
 }
 
 #ifndef QT_NO_PAINT_DEBUG
@@ -371,6 +379,7 @@ QRegion QWidgetBackingStore::dirtyRegion(QWidget *widget) const
         QWidget *w = dirtyWidgets.at(i);
         if (widgetDirty && w != widget && !widget->isAncestorOf(w))
             continue;
+        w->d_func()->mergePendingDirty();
         r += w->d_func()->dirty.translated(w->mapTo(tlw, QPoint()));
     }
 
@@ -579,6 +588,7 @@ void QWidgetBackingStore::markDirty(const QRegion &rgn, QWidget *widget,
     }
 
     if (widget->d_func()->inDirtyList) {
+        widget->d_func()->mergePendingDirty();
         if (!qt_region_strictContains(widget->d_func()->dirty, widgetRect)) {
 #ifndef QT_NO_GRAPHICSEFFECT
             if (widget->d_func()->graphicsEffect)
@@ -676,8 +686,10 @@ void QWidgetBackingStore::markDirty(const QRect &rect, QWidget *widget,
     }
 
     if (widget->d_func()->inDirtyList) {
+        // Widgets that receive many small updates before the next sync()
+        // would otherwise rebuild their dirty region for every one of them.
         if (!qt_region_strictContains(widget->d_func()->dirty, widgetRect))
-            widget->d_func()->dirty += widgetRect;
+            widget->d_func()->pendingDirty.add(widgetRect);
     } else {
         addDirtyWidget(widget, rect);
     }
@@ -918,6 +930,7 @@ void QWidgetPrivate::scrollRect(const QRect &rect, int dx, int dy)
         }
 
         if (inDirtyList) {
+            mergePendingDirty();
             if (rect == q->rect()) {
                 dirty.translate(dx, dy);
             } else {
@@ -1201,6 +1214,8 @@ void QWidgetBackingStore::doSync()
         if (wd->data.in_destructor)
             continue;
 
+        wd->mergePendingDirty();
+
         // Clip with mask() and clipRect().
         wd->dirty &= wd->clipRect();
         wd->clipToEffectiveMask(wd->dirty);
@@ -1320,6 +1335,10 @@ void QWidgetBackingStore::doSync()
     }
 #endif
 
+    QWidgetRepaintProfiler *profiler = QWidgetRepaintProfiler::isActive()
+            ? QWidgetRepaintProfiler::instance() : 0;
+    const qint64 frameStart = profiler ? profiler->beginFrame() : 0;
+
     BeginPaintInfo beginPaintInfo;
     beginPaint(toClean, tlw, store, &beginPaintInfo);
     if (beginPaintInfo.nothingToPaint) {
@@ -1327,6 +1346,8 @@ void QWidgetBackingStore::doSync()
             resetWidget(opaqueNonOverlappedWidgets[i]);
         dirty = QRegion();
         updateRequestSent = false;
+        if (profiler)
+            profiler->endFrame(tlw, toClean, frameStart);
         return;
     }
 
@@ -1365,6 +1386,9 @@ void QWidgetBackingStore::doSync()
     }
 
     endPaint(toClean, store, &beginPaintInfo);
+
+    if (profiler)
+        profiler->endFrame(tlw, toClean, frameStart);
 }
 
 /*!
@@ -282,6 +282,7 @@ private:
             widget->d_func()->isScrolled = false;
             widget->d_func()->isMoved = false;
             widget->d_func()->dirty = QRegion();
+            widget->d_func()->pendingDirty.clear();
         }
     }
 
@@ -0,0 +1,308 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWidgets module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qwidgetrepaintprofiler_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtGui/qregion.h>
+#include <QtWidgets/qwidget.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcWidgetRepaintProfile, "qt.widgets.painting.profile")
+
+/*
+    QWidgetRepaintProfiler records, per backing store sync, which widgets
+    were painted, the size of their dirty regions, how long their paint
+    events took and how long flushing to the window took. The events are
+    kept in a ring buffer, so only the most recent ones are available.
+
+    Profiling is active while the qt.widgets.painting.profile logging
+    category is enabled for debug output, in which case a summary line is
+    also logged per frame, or when QT_WIDGETS_REPAINT_PROFILE is set. The
+    latter names a file the events are written to in the Chrome trace
+    event format when the application exits; load it in chrome://tracing.
+*/
+
+enum { DefaultCapacity = 8192 };
+
+bool QWidgetRepaintProfiler::enabled = false;
+static QWidgetRepaintProfiler *profilerInstance = 0;
+
+static void cleanupRepaintProfiler()
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("QT_WIDGETS_REPAINT_PROFILE"));
+    if (!fileName.isEmpty() && !profilerInstance->writeChromeTrace(fileName))
+        qWarning("QWidgetRepaintProfiler: Cannot write %s", qPrintable(fileName));
+    delete profilerInstance;
+    profilerInstance = 0;
+}
+
+QWidgetRepaintProfiler::QWidgetRepaintProfiler()
+    : buffer(DefaultCapacity), next(0), count(0),
+      frameCount(0), frameDepth(0), framePaintedArea(0), framePaintCount(0),
+      framePaintTime(0), frameFlushTime(0)
+{
+    timer.start();
+}
+
+/*
+    Turns profiling on or off regardless of the logging category.
+    QApplication calls this when QT_WIDGETS_REPAINT_PROFILE is set.
+*/
+void QWidgetRepaintProfiler::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
+QWidgetRepaintProfiler *QWidgetRepaintProfiler::instance()
+{
+    if (!profilerInstance) {
+        profilerInstance = new QWidgetRepaintProfiler;
+        qAddPostRoutine(cleanupRepaintProfiler);
+    }
+    return profilerInstance;
+}
+
+void QWidgetRepaintProfiler::setCapacity(int capacity)
+{
+    const QVector<Event> kept = events();
+    buffer = QVector<Event>(qMax(capacity, 1));
+    next = 0;
+    count = 0;
+    for (int i = qMax(0, kept.size() - buffer.size()); i < kept.size(); ++i)
+        append(Event(kept.at(i)));
+}
+
+/*
+    Returns the recorded events, oldest first.
+*/
+QVector<QWidgetRepaintProfiler::Event> QWidgetRepaintProfiler::events() const
+{
+    QVector<Event> result;
+    result.reserve(count);
+    const int first = (next - count + buffer.size()) % buffer.size();
+    for (int i = 0; i < count; ++i)
+        result.append(buffer.at((first + i) % buffer.size()));
+    return result;
+}
+
+void QWidgetRepaintProfiler::clear()
+{
+    for (Event &event : buffer)
+        event.objectName.clear();
+    next = 0;
+    count = 0;
+}
+
+void QWidgetRepaintProfiler::append(Event &&event)
+{
+    buffer[next] = std::move(event);
+    next = (next + 1) % buffer.size();
+    if (count < buffer.size())
+        ++count;
+}
+
+void QWidgetRepaintProfiler::fillWidget(Event *event, QWidget *widget, const QRegion &region) const
+{
+    event->frame = frameCount;
+    event->widget = quintptr(widget);
+    event->className = widget->metaObject()->className();
+    event->objectName = widget->objectName();
+    event->boundingRect = region.boundingRect();
+    event->area = 0;
+    event->rectCount = 0;
+    for (const QRect &rect : region) {
+        event->area += qint64(rect.width()) * rect.height();
+        ++event->rectCount;
+    }
+    event->paintedArea = 0;
+    event->paintCount = 0;
+}
+
+/*
+    Starts a frame and returns its start time, which is to be passed to
+    endFrame(). Frames do not nest; a sync() triggered from within a
+    paint event is accounted to the outer frame.
+*/
+qint64 QWidgetRepaintProfiler::beginFrame()
+{
+    if (frameDepth++ == 0) {
+        ++frameCount;
+        framePaintedArea = 0;
+        framePaintCount = 0;
+        framePaintTime = 0;
+        frameFlushTime = 0;
+    }
+    return now();
+}
+
+void QWidgetRepaintProfiler::endFrame(QWidget *window, const QRegion &dirty, qint64 start)
+{
+    if (--frameDepth > 0)
+        return;
+
+    Event event;
+    event.type = Frame;
+    event.start = start;
+    event.duration = now() - start;
+    fillWidget(&event, window, dirty);
+    event.paintedArea = framePaintedArea;
+    event.paintCount = framePaintCount;
+
+    qCDebug(lcWidgetRepaintProfile,
+            "frame %llu %s: %d widgets, %lld of %lld dirty pixels painted, "
+            "%.3f ms total, %.3f ms painting, %.3f ms flushing",
+            event.frame, event.className, event.paintCount, event.paintedArea, event.area,
+            event.duration / 1e6, framePaintTime / 1e6, frameFlushTime / 1e6);
+
+    append(std::move(event));
+}
+
+void QWidgetRepaintProfiler::recordPaint(QWidget *widget, const QRegion &region, qint64 start)
+{
+    Event event;
+    event.type = Paint;
+    event.start = start;
+    event.duration = now() - start;
+    fillWidget(&event, widget, region);
+
+    framePaintedArea += event.area;
+    ++framePaintCount;
+    framePaintTime += event.duration;
+
+    append(std::move(event));
+}
+
+void QWidgetRepaintProfiler::recordFlush(QWidget *widget, const QRegion &region, qint64 start)
+{
+    Event event;
+    event.type = Flush;
+    event.start = start;
+    event.duration = now() - start;
+    fillWidget(&event, widget, region);
+
+    frameFlushTime += event.duration;
+
+    append(std::move(event));
+}
+
+/*
+    Returns the recorded events in the Chrome trace event format, as
+    complete ("X") events on a single thread.
+*/
+QByteArray QWidgetRepaintProfiler::toChromeTrace() const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+    QJsonObject threadName;
+    threadName.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+    threadName.insert(QStringLiteral("ph"), QStringLiteral("M"));
+    threadName.insert(QStringLiteral("pid"), pid);
+    threadName.insert(QStringLiteral("tid"), 1);
+    threadName.insert(QStringLiteral("args"), QJsonObject{ { QStringLiteral("name"), QStringLiteral("GUI thread") } });
+    traceEvents.append(threadName);
+
+    const QVector<Event> recorded = events();
+    for (const Event &event : recorded) {
+        QString name = QLatin1String(event.className);
+        if (!event.objectName.isEmpty())
+            name += QLatin1Char('/') + event.objectName;
+
+        QJsonObject args;
+        args.insert(QStringLiteral("frame"), qint64(event.frame));
+        args.insert(QStringLiteral("widget"), QString::number(event.widget, 16));
+        args.insert(QStringLiteral("x"), event.boundingRect.x());
+        args.insert(QStringLiteral("y"), event.boundingRect.y());
+        args.insert(QStringLiteral("width"), event.boundingRect.width());
+        args.insert(QStringLiteral("height"), event.boundingRect.height());
+        args.insert(QStringLiteral("area"), event.area);
+        args.insert(QStringLiteral("rects"), event.rectCount);
+
+        QString category;
+        switch (event.type) {
+        case Frame:
+            category = QStringLiteral("frame");
+            name = QLatin1String("Frame ") + name;
+            args.insert(QStringLiteral("paintedArea"), event.paintedArea);
+            args.insert(QStringLiteral("widgetsPainted"), event.paintCount);
+            if (event.area > 0)
+                args.insert(QStringLiteral("overdraw"), double(event.paintedArea) / event.area);
+            break;
+        case Paint:
+            category = QStringLiteral("paint");
+            break;
+        case Flush:
+            category = QStringLiteral("flush");
+            name = QLatin1String("Flush ") + name;
+            break;
+        }
+
+        QJsonObject traceEvent;
+        traceEvent.insert(QStringLiteral("name"), name);
+        traceEvent.insert(QStringLiteral("cat"), category);
+        traceEvent.insert(QStringLiteral("ph"), QStringLiteral("X"));
+        traceEvent.insert(QStringLiteral("ts"), event.start / 1000.0);
+        traceEvent.insert(QStringLiteral("dur"), event.duration / 1000.0);
+        traceEvent.insert(QStringLiteral("pid"), pid);
+        traceEvent.insert(QStringLiteral("tid"), 1);
+        traceEvent.insert(QStringLiteral("args"), args);
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("traceEvents"), traceEvents);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool QWidgetRepaintProfiler::writeChromeTrace(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(toChromeTrace()) >= 0;
+}
+
+QT_END_NAMESPACE
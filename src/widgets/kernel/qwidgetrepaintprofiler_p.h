@@ -0,0 +1,135 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWidgets module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QWIDGETREPAINTPROFILER_P_H
+#define QWIDGETREPAINTPROFILER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(lcWidgetRepaintProfile)
+
+class QRegion;
+class QWidget;
+
+class Q_WIDGETS_EXPORT QWidgetRepaintProfiler
+{
+public:
+    enum EventType {
+        Frame,  // one QWidgetBackingStore::sync() of a top-level
+        Paint,  // one widget painted into the backing store
+        Flush   // backing store contents flushed to a window
+    };
+
+    struct Event
+    {
+        EventType type;
+        quint64 frame;
+        qint64 start;           // nanoseconds since the profiler was created
+        qint64 duration;
+        quintptr widget;        // identifies the widget, never dereferenced
+        const char *className;  // static meta object data
+        QString objectName;
+        QRect boundingRect;     // in widget coordinates; the window's for Frame
+        qint64 area;            // pixels in the region
+        int rectCount;
+        qint64 paintedArea;     // Frame: pixels painted by all widgets
+        int paintCount;         // Frame: number of widgets painted
+    };
+
+    static inline bool isActive()
+    { return Q_UNLIKELY(enabled) || Q_UNLIKELY(lcWidgetRepaintProfile().isDebugEnabled()); }
+    static void setEnabled(bool enable);
+    static QWidgetRepaintProfiler *instance();
+
+    qint64 now() const { return timer.nsecsElapsed(); }
+
+    qint64 beginFrame();
+    void endFrame(QWidget *window, const QRegion &dirty, qint64 start);
+    void recordPaint(QWidget *widget, const QRegion &region, qint64 start);
+    void recordFlush(QWidget *widget, const QRegion &region, qint64 start);
+
+    int capacity() const { return buffer.size(); }
+    void setCapacity(int capacity);
+    QVector<Event> events() const;
+    void clear();
+
+    QByteArray toChromeTrace() const;
+    bool writeChromeTrace(const QString &fileName) const;
+
+private:
+    QWidgetRepaintProfiler();
+    void append(Event &&event);
+    void fillWidget(Event *event, QWidget *widget, const QRegion &region) const;
+
+    static bool enabled;
+
+    QElapsedTimer timer;
+    QVector<Event> buffer;  // ring buffer, next is the slot written next
+    int next;
+    int count;
+
+    quint64 frameCount;
+    int frameDepth;
+    qint64 framePaintedArea;
+    int framePaintCount;
+    qint64 framePaintTime;
+    qint64 frameFlushTime;
+};
+
+QT_END_NAMESPACE
+
+#endif // QWIDGETREPAINTPROFILER_P_H
@@ -2663,11 +2663,68 @@ void QStyleSheetStyle::unsetStyleSheetFont(QWidget *w) const
     }
 }
 
-static void updateObjects(const QList<const QObject *>& objects)
+// Two rule lists produce the same styling if they consist of the same
+// declarations, applied for the same pseudo states and elements, in the same
+// order. The declarations are implicitly shared with the parsed style sheets,
+// so rules coming from a style sheet that was not reparsed compare cheaply.
+// Style sheets are parsed again whenever they change, so declarations
+// must be compared by value rather than by their shared data.
+static bool sameDeclarations(const QVector<Declaration> &a, const QVector<Declaration> &b)
 {
+    if (a.count() != b.count())
+        return false;
+    for (int i = 0; i < a.count(); ++i) {
+        const Declaration::DeclarationData *da = a.at(i).d.constData();
+        const Declaration::DeclarationData *db = b.at(i).d.constData();
+        if (da == db)
+            continue;
+        if (da->propertyId != db->propertyId || da->property != db->property
+            || da->important != db->important || da->values.count() != db->values.count())
+            return false;
+        for (int j = 0; j < da->values.count(); ++j) {
+            const Value &va = da->values.at(j);
+            const Value &vb = db->values.at(j);
+            if (va.type != vb.type || va.variant != vb.variant)
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool sameStyleRules(const QVector<StyleRule> &a, const QVector<StyleRule> &b)
+{
+    if (a.count() != b.count())
+        return false;
+    for (int i = 0; i < a.count(); ++i) {
+        const StyleRule &ra = a.at(i);
+        const StyleRule &rb = b.at(i);
+        if (!sameDeclarations(ra.declarations, rb.declarations))
+            return false;
+        const Selector &sa = ra.selectors.at(0);
+        const Selector &sb = rb.selectors.at(0);
+        quint64 negatedA = 0, negatedB = 0;
+        if (sa.pseudoClass(&negatedA) != sb.pseudoClass(&negatedB) || negatedA != negatedB
+            || sa.pseudoElement() != sb.pseudoElement())
+            return false;
+    }
+    return true;
+}
+
+void QStyleSheetStyle::updateObjects(const QList<const QObject *>& objects)
+{
+    // With style sheet propagation the result of polishing a widget also
+    // depends on its ancestors, so unchanged rules are not enough to skip it.
+    const bool skipUnchanged = !QCoreApplication::testAttribute(Qt::AA_UseStyleSheetPropagationInWidgetStyles);
+    QHash<const QObject *, QVector<StyleRule> > previousRules;
+
     if (!styleSheetCaches->styleRulesCache.isEmpty() || !styleSheetCaches->hasStyleRuleCache.isEmpty() || !styleSheetCaches->renderRulesCache.isEmpty()) {
         for (int i = 0; i < objects.size(); ++i) {
             const QObject *object = objects.at(i);
+            if (skipUnchanged) {
+                QHash<const QObject *, QVector<StyleRule> >::const_iterator it = styleSheetCaches->styleRulesCache.constFind(object);
+                if (it != styleSheetCaches->styleRulesCache.constEnd())
+                    previousRules.insert(object, it.value());
+            }
             styleSheetCaches->styleRulesCache.remove(object);
             styleSheetCaches->hasStyleRuleCache.remove(object);
             styleSheetCaches->renderRulesCache.remove(object);
@@ -2682,7 +2739,18 @@ static void updateObjects(const QList<const QObject *>& objects)
 
     QEvent event(QEvent::StyleChange);
     foreach (QWidget *widget, widgets) {
+        QHash<const QObject *, QVector<StyleRule> >::const_iterator previous = previousRules.constFind(widget);
+        if (previous != previousRules.constEnd()) {
+            // Only repolish the widgets the change actually affects; the rules
+            // computed here are current and are reused by polish().
+            if (QStyleSheetStyle *proxy = qobject_cast<QStyleSheetStyle *>(widget->style())) {
+                if (sameStyleRules(previous.value(), proxy->styleRules(widget)))
+                    continue;
+                styleSheetCaches->rulesUpToDate = widget;
+            }
+        }
         widget->style()->polish(widget);
+        styleSheetCaches->rulesUpToDate = 0;
         QApplication::sendEvent(widget, &event);
     }
 }
@@ -2716,6 +2784,11 @@ QStyle *QStyleSheetStyle::baseStyle() const
     return QApplication::style();
 }
 
+QStyleSheetStyleCaches::QStyleSheetStyleCaches()
+    : rulesUpToDate(0)
+{
+}
+
 void QStyleSheetStyleCaches::objectDestroyed(QObject *o)
 {
     styleRulesCache.remove(o);
@@ -2760,7 +2833,7 @@ void QStyleSheetStyle::polish(QWidget *w)
     if (!initObject(w))
         return;
 
-    if (styleSheetCaches->styleRulesCache.contains(w)) {
+    if (w != styleSheetCaches->rulesUpToDate && styleSheetCaches->styleRulesCache.contains(w)) {
         // the widget accessed its style pointer before polish (or repolish)
         // (exemple: the QAbstractSpinBox constructor ask for the stylehint)
         styleSheetCaches->styleRulesCache.remove(w);
@@ -2861,9 +2934,10 @@ void QStyleSheetStyle::repolish(QApplication *app)
     Q_UNUSED(app);
     const QList<const QObject*> allObjects = styleSheetCaches->styleRulesCache.keys();
     styleSheetCaches->styleSheetCache.remove(qApp);
-    styleSheetCaches->styleRulesCache.clear();
     styleSheetCaches->hasStyleRuleCache.clear();
     styleSheetCaches->renderRulesCache.clear();
+    // Replaces the style rules of allObjects, also of the widgets it skips,
+    // so that the next change still finds them.
     updateObjects(allObjects);
 }
 
@@ -159,6 +159,7 @@ private:
     void unsetStyleSheetFont(QWidget *) const;
     QVector<QCss::StyleRule> styleRules(const QObject *obj) const;
     bool hasStyleRule(const QObject *obj, int part) const;
+    void updateObjects(const QList<const QObject *> &objects);
 
     QHash<QStyle::SubControl, QRect> titleBarLayout(const QWidget *w, const QStyleOptionTitleBar *tb) const;
 
@@ -182,6 +183,8 @@ public Q_SLOTS:
     void objectDestroyed(QObject *);
     void styleDestroyed(QObject *);
 public:
+    QStyleSheetStyleCaches();
+
     QHash<const QObject *, QVector<QCss::StyleRule> > styleRulesCache;
     QHash<const QObject *, QHash<int, bool> > hasStyleRuleCache;
     typedef QHash<int, QHash<quint64, QRenderRule> > QRenderRules;
@@ -192,6 +195,8 @@ public:
     // QPair<old widget value, resolve mask of stylesheet value>
     QHash<const QWidget *, QPair<QPalette, uint> > customPaletteWidgets;
     QHash<const QWidget *, QPair<QFont, uint> > customFontWidgets;
+    // widget being repolished whose cached style rules were just computed
+    const QObject *rulesUpToDate;
 };
 
 
@@ -396,14 +396,14 @@ public:
     QString text();
 
     // Reimplemented from QDomNodePrivate
-    QDomNamedNodeMapPrivate* attributes() { return m_attr; }
-    bool hasAttributes() { return (m_attr->length() > 0); }
+    QDomNamedNodeMapPrivate* attributes();
+    bool hasAttributes() { return m_attr && m_attr->length() > 0; }
     QDomNode::NodeType nodeType() const Q_DECL_OVERRIDE { return QDomNode::ElementNode; }
     QDomNodePrivate* cloneNode(bool deep = true) Q_DECL_OVERRIDE;
     virtual void save(QTextStream& s, int, int) const Q_DECL_OVERRIDE;
 
     // Variables
-    QDomNamedNodeMapPrivate* m_attr;
+    QDomNamedNodeMapPrivate* m_attr; // created on first use, most elements have no attributes
 };
 
 
@@ -608,8 +608,12 @@ public:
     int errorColumn;
 
 private:
+    QString internName(const QString &name);
+    void internNames(QDomNodePrivate *n);
+
     QDomDocumentPrivate *doc;
     QDomNodePrivate *node;
+    QSet<QString> names; // element and attribute names seen so far, shared between nodes
     QString entityName;
     bool cdata;
     bool nsProcessing;
@@ -3770,7 +3774,7 @@ QString QDomDocumentType::internalSubset() const
 QDomDocumentFragmentPrivate::QDomDocumentFragmentPrivate(QDomDocumentPrivate* doc, QDomNodePrivate* parent)
     : QDomNodePrivate(doc, parent)
 {
-    name = QLatin1String("#document-fragment");
+    name = QStringLiteral("#document-fragment");
 }
 
 QDomDocumentFragmentPrivate::QDomDocumentFragmentPrivate(QDomNodePrivate* n, bool deep)
@@ -3872,7 +3876,7 @@ QDomCharacterDataPrivate::QDomCharacterDataPrivate(QDomDocumentPrivate* d, QDomN
     : QDomNodePrivate(d, p)
 {
     value = data;
-    name = QLatin1String("#character-data");
+    name = QStringLiteral("#character-data");
 }
 
 QDomCharacterDataPrivate::QDomCharacterDataPrivate(QDomCharacterDataPrivate* n, bool deep)
@@ -4394,7 +4398,7 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
     : QDomNodePrivate(d, p)
 {
     name = tagname;
-    m_attr = new QDomNamedNodeMapPrivate(this);
+    m_attr = 0;
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p,
@@ -4404,23 +4408,33 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
     qt_split_namespace(prefix, name, qName, !nsURI.isNull());
     namespaceURI = nsURI;
     createdWithDom1Interface = false;
-    m_attr = new QDomNamedNodeMapPrivate(this);
+    m_attr = 0;
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomElementPrivate* n, bool deep) :
     QDomNodePrivate(n, deep)
 {
-    m_attr = n->m_attr->clone(this);
-    // Reference is down to 0, so we set it to 1 here.
-    m_attr->ref.ref();
+    m_attr = 0;
+    if (n->m_attr) {
+        m_attr = n->m_attr->clone(this);
+        // Reference is down to 0, so we set it to 1 here.
+        m_attr->ref.ref();
+    }
 }
 
 QDomElementPrivate::~QDomElementPrivate()
 {
-    if (!m_attr->ref.deref())
+    if (m_attr && !m_attr->ref.deref())
         delete m_attr;
 }
 
+QDomNamedNodeMapPrivate* QDomElementPrivate::attributes()
+{
+    if (!m_attr)
+        m_attr = new QDomNamedNodeMapPrivate(this);
+    return m_attr;
+}
+
 QDomNodePrivate* QDomElementPrivate::cloneNode(bool deep)
 {
     QDomNodePrivate* p = new QDomElementPrivate(this, deep);
@@ -4431,7 +4445,7 @@ QDomNodePrivate* QDomElementPrivate::cloneNode(bool deep)
 
 QString QDomElementPrivate::attribute(const QString& name_, const QString& defValue) const
 {
-    QDomNodePrivate* n = m_attr->namedItem(name_);
+    QDomNodePrivate* n = m_attr ? m_attr->namedItem(name_) : 0;
     if (!n)
         return defValue;
 
@@ -4440,7 +4454,7 @@ QString QDomElementPrivate::attribute(const QString& name_, const QString& defVa
 
 QString QDomElementPrivate::attributeNS(const QString& nsURI, const QString& localName, const QString& defValue) const
 {
-    QDomNodePrivate* n = m_attr->namedItemNS(nsURI, localName);
+    QDomNodePrivate* n = m_attr ? m_attr->namedItemNS(nsURI, localName) : 0;
     if (!n)
         return defValue;
 
@@ -4449,7 +4463,7 @@ QString QDomElementPrivate::attributeNS(const QString& nsURI, const QString& loc
 
 void QDomElementPrivate::setAttribute(const QString& aname, const QString& newValue)
 {
-    QDomNodePrivate* n = m_attr->namedItem(aname);
+    QDomNodePrivate* n = attributes()->namedItem(aname);
     if (!n) {
         n = new QDomAttrPrivate(ownerDocument(), this, aname);
         n->setNodeValue(newValue);
@@ -4467,7 +4481,7 @@ void QDomElementPrivate::setAttributeNS(const QString& nsURI, const QString& qNa
 {
     QString prefix, localName;
     qt_split_namespace(prefix, localName, qName, true);
-    QDomNodePrivate* n = m_attr->namedItemNS(nsURI, localName);
+    QDomNodePrivate* n = attributes()->namedItemNS(nsURI, localName);
     if (!n) {
         n = new QDomAttrPrivate(ownerDocument(), this, nsURI, qName);
         n->setNodeValue(newValue);
@@ -4484,6 +4498,8 @@ void QDomElementPrivate::setAttributeNS(const QString& nsURI, const QString& qNa
 
 void QDomElementPrivate::removeAttribute(const QString& aname)
 {
+    if (!m_attr)
+        return;
     QDomNodePrivate* p = m_attr->removeNamedItem(aname);
     if (p && p->ref.load() == 0)
         delete p;
@@ -4491,17 +4507,17 @@ void QDomElementPrivate::removeAttribute(const QString& aname)
 
 QDomAttrPrivate* QDomElementPrivate::attributeNode(const QString& aname)
 {
-    return (QDomAttrPrivate*)m_attr->namedItem(aname);
+    return m_attr ? (QDomAttrPrivate*)m_attr->namedItem(aname) : 0;
 }
 
 QDomAttrPrivate* QDomElementPrivate::attributeNodeNS(const QString& nsURI, const QString& localName)
 {
-    return (QDomAttrPrivate*)m_attr->namedItemNS(nsURI, localName);
+    return m_attr ? (QDomAttrPrivate*)m_attr->namedItemNS(nsURI, localName) : 0;
 }
 
 QDomAttrPrivate* QDomElementPrivate::setAttributeNode(QDomAttrPrivate* newAttr)
 {
-    QDomNodePrivate* n = m_attr->namedItem(newAttr->nodeName());
+    QDomNodePrivate* n = attributes()->namedItem(newAttr->nodeName());
 
     // Referencing is done by the maps
     m_attr->setNamedItem(newAttr);
@@ -4515,27 +4531,27 @@ QDomAttrPrivate* QDomElementPrivate::setAttributeNodeNS(QDomAttrPrivate* newAttr
 {
     QDomNodePrivate* n = 0;
     if (!newAttr->prefix.isNull())
-        n = m_attr->namedItemNS(newAttr->namespaceURI, newAttr->name);
+        n = attributes()->namedItemNS(newAttr->namespaceURI, newAttr->name);
 
     // Referencing is done by the maps
-    m_attr->setNamedItem(newAttr);
+    attributes()->setNamedItem(newAttr);
 
     return (QDomAttrPrivate*)n;
 }
 
 QDomAttrPrivate* QDomElementPrivate::removeAttributeNode(QDomAttrPrivate* oldAttr)
 {
-    return (QDomAttrPrivate*)m_attr->removeNamedItem(oldAttr->nodeName());
+    return m_attr ? (QDomAttrPrivate*)m_attr->removeNamedItem(oldAttr->nodeName()) : 0;
 }
 
 bool QDomElementPrivate::hasAttribute(const QString& aname)
 {
-    return m_attr->contains(aname);
+    return m_attr && m_attr->contains(aname);
 }
 
 bool QDomElementPrivate::hasAttributeNS(const QString& nsURI, const QString& localName)
 {
-    return m_attr->containsNS(nsURI, localName);
+    return m_attr && m_attr->containsNS(nsURI, localName);
 }
 
 QString QDomElementPrivate::text()
@@ -4585,7 +4601,7 @@ void QDomElementPrivate::save(QTextStream& s, int depth, int indent) const
     QSet<QString> outputtedPrefixes;
 
     /* Write out attributes. */
-    if (!m_attr->map.isEmpty()) {
+    if (m_attr && !m_attr->map.isEmpty()) {
         QHash<QString, QDomNodePrivate *>::const_iterator it = m_attr->map.constBegin();
         for (; it != m_attr->map.constEnd(); ++it) {
             s << ' ';
@@ -5160,7 +5176,7 @@ QString QDomElement::text() const
 QDomTextPrivate::QDomTextPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent, const QString& val)
     : QDomCharacterDataPrivate(d, parent, val)
 {
-    name = QLatin1String("#text");
+    name = QStringLiteral("#text");
 }
 
 QDomTextPrivate::QDomTextPrivate(QDomTextPrivate* n, bool deep)
@@ -5296,7 +5312,7 @@ QDomText QDomText::splitText(int offset)
 QDomCommentPrivate::QDomCommentPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent, const QString& val)
     : QDomCharacterDataPrivate(d, parent, val)
 {
-    name = QLatin1String("#comment");
+    name = QStringLiteral("#comment");
 }
 
 QDomCommentPrivate::QDomCommentPrivate(QDomCommentPrivate* n, bool deep)
@@ -5409,7 +5425,7 @@ QDomCDATASectionPrivate::QDomCDATASectionPrivate(QDomDocumentPrivate* d, QDomNod
                                                     const QString& val)
     : QDomTextPrivate(d, parent, val)
 {
-    name = QLatin1String("#cdata-section");
+    name = QStringLiteral("#cdata-section");
 }
 
 QDomCDATASectionPrivate::QDomCDATASectionPrivate(QDomCDATASectionPrivate* n, bool deep)
@@ -6147,7 +6163,7 @@ QDomDocumentPrivate::QDomDocumentPrivate()
     type = new QDomDocumentTypePrivate(this, this);
     type->ref.deref();
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(const QString& aname)
@@ -6159,7 +6175,7 @@ QDomDocumentPrivate::QDomDocumentPrivate(const QString& aname)
     type->ref.deref();
     type->name = aname;
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentTypePrivate* dt)
@@ -6174,7 +6190,7 @@ QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentTypePrivate* dt)
         type->ref.deref();
     }
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentPrivate* n, bool deep)
@@ -7391,6 +7407,29 @@ bool QDomHandler::startDTD(const QString& name, const QString& publicId, const Q
     return true;
 }
 
+/*
+    The reader hands out a fresh string for every tag and attribute name, so a
+    large document would otherwise carry one copy of each name per node. The
+    names are interned for the duration of the parse instead; nodes then share
+    the string data, which is detached as usual if a name is ever modified.
+*/
+QString QDomHandler::internName(const QString &name)
+{
+    if (name.isEmpty())
+        return name;
+    QSet<QString>::const_iterator it = names.constFind(name);
+    if (it == names.constEnd())
+        it = names.insert(name);
+    return *it;
+}
+
+void QDomHandler::internNames(QDomNodePrivate *n)
+{
+    n->name = internName(n->name);
+    n->prefix = internName(n->prefix);
+    n->namespaceURI = internName(n->namespaceURI);
+}
+
 bool QDomHandler::startElement(const QString& nsURI, const QString&, const QString& qName, const QXmlAttributes& atts)
 {
     // tag name
@@ -7404,6 +7443,7 @@ bool QDomHandler::startElement(const QString& nsURI, const QString&, const QStri
     if (!n)
         return false;
 
+    internNames(n);
     n->setLocation(locator->lineNumber(), locator->columnNumber());
 
     node->appendChild(n);
@@ -7412,10 +7452,12 @@ bool QDomHandler::startElement(const QString& nsURI, const QString&, const QStri
     // attributes
     for (int i=0; i<atts.length(); i++)
     {
+        // Unprefixed names are used as they are for the attribute name and
+        // its key in the attribute map, so they end up shared as well.
         if (nsProcessing) {
-            ((QDomElementPrivate*)node)->setAttributeNS(atts.uri(i), atts.qName(i), atts.value(i));
+            ((QDomElementPrivate*)node)->setAttributeNS(internName(atts.uri(i)), internName(atts.qName(i)), atts.value(i));
         } else {
-            ((QDomElementPrivate*)node)->setAttribute(atts.qName(i), atts.value(i));
+            ((QDomElementPrivate*)node)->setAttribute(internName(atts.qName(i)), atts.value(i));
         }
     }
 
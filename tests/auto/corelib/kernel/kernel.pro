@@ -3,6 +3,7 @@ SUBDIRS=\
     qcoreapplication \
     qeventdispatcher \
     qeventloop \
+    qeventloopinstrumentation \
     qmath \
     qmetaobject \
     qmetaobjectbuilder \
@@ -0,0 +1,259 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QAbstractEventDispatcher>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <private/qeventloopinstrumentation_p.h>
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    Receiver() : sleep(0), received(0) {}
+
+    int sleep;
+    QAtomicInt received;
+
+protected:
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() != QEvent::User)
+            return QObject::event(event);
+        if (sleep)
+            QThread::msleep(sleep);
+        received.ref();
+        return true;
+    }
+};
+
+class tst_QEventLoopInstrumentation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void histogram();
+    void disabled();
+    void handlers();
+    void phases();
+    void otherThread();
+    void watchdog();
+};
+
+static const QEventLoopInstrumentation::HandlerStatistics *findHandler(
+        const QEventLoopInstrumentation::ThreadStatistics &stats, int type, const char *className)
+{
+    for (const QEventLoopInstrumentation::HandlerStatistics &handler : stats.handlers) {
+        if (handler.eventType == type && handler.receiverClass == className)
+            return &handler;
+    }
+    return 0;
+}
+
+// only QEventDispatcherUNIX reports the phases of its iterations
+static bool dispatcherReportsPhases()
+{
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    return dispatcher && dispatcher->inherits("QEventDispatcherUNIX");
+}
+
+void tst_QEventLoopInstrumentation::init()
+{
+    QEventLoopInstrumentation::setEnabled(true);
+    QEventLoopInstrumentation::resetStatistics(QThread::currentThread());
+}
+
+void tst_QEventLoopInstrumentation::cleanup()
+{
+    QEventLoopInstrumentation::setWatchdogThreshold(0);
+    QEventLoopInstrumentation::setStallHandler(0);
+    QEventLoopInstrumentation::setEnabled(false);
+}
+
+void tst_QEventLoopInstrumentation::histogram()
+{
+    QEventLoopInstrumentation::Histogram histogram;
+    histogram.add(500);         // below 1 us
+    histogram.add(1500);        // 1 us
+    histogram.add(3000);        // 3 us
+    histogram.add(3999);
+    histogram.add(Q_INT64_C(1000000000000)); // way beyond the last bucket
+
+    QCOMPARE(histogram.count, quint64(5));
+    QCOMPARE(histogram.total, Q_INT64_C(1000000008999));
+    QCOMPARE(histogram.max, Q_INT64_C(1000000000000));
+    QCOMPARE(histogram.buckets[0], quint64(1));
+    QCOMPARE(histogram.buckets[1], quint64(1));
+    QCOMPARE(histogram.buckets[2], quint64(2));
+    QCOMPARE(histogram.buckets[QEventLoopInstrumentation::BucketCount - 1], quint64(1));
+}
+
+void tst_QEventLoopInstrumentation::disabled()
+{
+    QEventLoopInstrumentation::setEnabled(false);
+
+    Receiver receiver;
+    for (int i = 0; i < 10; ++i)
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.received.load(), 10);
+
+    const QEventLoopInstrumentation::ThreadStatistics stats =
+            QEventLoopInstrumentation::statistics(QThread::currentThread());
+    QVERIFY(!findHandler(stats, QEvent::User, "Receiver"));
+    QCOMPARE(stats.maxPostedEventQueueDepth, 0);
+    QCOMPARE(stats.iterations, quint64(0));
+}
+
+void tst_QEventLoopInstrumentation::handlers()
+{
+    Receiver receiver;
+    for (int i = 0; i < 10; ++i)
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.received.load(), 10);
+
+    const QEventLoopInstrumentation::ThreadStatistics stats =
+            QEventLoopInstrumentation::statistics(QThread::currentThread());
+    const QEventLoopInstrumentation::HandlerStatistics *handler = findHandler(stats, QEvent::User, "Receiver");
+    QVERIFY(handler);
+    QCOMPARE(handler->durations.count, quint64(10));
+    QVERIFY(handler->durations.max <= handler->durations.total);
+    QVERIFY(stats.maxPostedEventQueueDepth >= 10);
+
+    if (!dispatcherReportsPhases())
+        QSKIP("The event dispatcher does not report loop phases");
+    QVERIFY(stats.iterations > 0);
+    QVERIFY(stats.phases[QEventLoopInstrumentation::PostedEvents].count > 0);
+}
+
+void tst_QEventLoopInstrumentation::phases()
+{
+    if (!dispatcherReportsPhases())
+        QSKIP("The event dispatcher does not report loop phases");
+
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    timer.start(20);
+    loop.exec();
+
+    const QEventLoopInstrumentation::ThreadStatistics stats =
+            QEventLoopInstrumentation::statistics(QThread::currentThread());
+    QVERIFY(stats.phases[QEventLoopInstrumentation::Poll].count > 0);
+    QVERIFY(stats.phases[QEventLoopInstrumentation::Timers].count > 0);
+    // most of the time was spent waiting for the timer
+    QVERIFY(stats.phases[QEventLoopInstrumentation::Poll].total >= Q_INT64_C(10000000));
+    QVERIFY(findHandler(stats, QEvent::Timer, "QTimer"));
+}
+
+void tst_QEventLoopInstrumentation::otherThread()
+{
+    QThread thread;
+    Receiver receiver;
+    receiver.moveToThread(&thread);
+    thread.start();
+
+    for (int i = 0; i < 5; ++i)
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QTRY_COMPARE(receiver.received.load(), 5);
+
+    QTRY_VERIFY(findHandler(QEventLoopInstrumentation::statistics(&thread), QEvent::User, "Receiver"));
+    const QEventLoopInstrumentation::ThreadStatistics stats = QEventLoopInstrumentation::statistics(&thread);
+    QCOMPARE(findHandler(stats, QEvent::User, "Receiver")->durations.count, quint64(5));
+    QVERIFY(!findHandler(QEventLoopInstrumentation::statistics(QThread::currentThread()),
+                         QEvent::User, "Receiver"));
+
+    thread.quit();
+    QVERIFY(thread.wait());
+}
+
+static QAtomicInt stallCount;
+static QMutex stallMutex;
+static QEventLoopInstrumentation::StallReport lastStall;
+
+static void recordStall(const QEventLoopInstrumentation::StallReport &report)
+{
+    QMutexLocker locker(&stallMutex);
+    lastStall = report;
+    stallCount.ref();
+}
+
+void tst_QEventLoopInstrumentation::watchdog()
+{
+    stallCount.store(0);
+    QEventLoopInstrumentation::setStallHandler(recordStall);
+    QEventLoopInstrumentation::setWatchdogThreshold(50);
+    QCOMPARE(QEventLoopInstrumentation::watchdogThreshold(), 50);
+
+    // an idle loop is not stalled
+    QEventLoop loop;
+    QTimer::singleShot(200, &loop, SLOT(quit()));
+    loop.exec();
+    QCOMPARE(stallCount.load(), 0);
+
+    Receiver receiver;
+    receiver.sleep = 300;
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.received.load(), 1);
+
+    // reported once, while the handler was running
+    QCOMPARE(stallCount.load(), 1);
+    QMutexLocker locker(&stallMutex);
+    QCOMPARE(lastStall.threadId, QThread::currentThreadId());
+    QCOMPARE(lastStall.eventType, int(QEvent::User));
+    QCOMPARE(lastStall.receiverClass, QByteArray("Receiver"));
+    QVERIFY(lastStall.stalledFor >= 50);
+    locker.unlock();
+
+    // a handler running outside of any event loop is timed on its own
+    stallCount.store(0);
+    receiver.sleep = 300;
+    QEvent event(QEvent::User);
+    QCoreApplication::sendEvent(&receiver, &event);
+    QCOMPARE(receiver.received.load(), 2);
+    QCOMPARE(stallCount.load(), 1);
+
+    // and the thread is idle again once it returns
+    receiver.sleep = 0;
+    QTest::qSleep(200);
+    QCOMPARE(stallCount.load(), 1);
+
+    QEventLoopInstrumentation::setWatchdogThreshold(0);
+    QCOMPARE(QEventLoopInstrumentation::watchdogThreshold(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QEventLoopInstrumentation)
+#include "tst_qeventloopinstrumentation.moc"
@@ -557,6 +557,11 @@ private slots:
     void checkCommentIndentation_data() const;
     void crashInXmlStreamReader() const;
     void hasError() const;
+    void fastScanBoundaries_data() const;
+    void fastScanBoundaries() const;
+    void fastScanWhitespace() const;
+    void readLargeChunks_data() const;
+    void readLargeChunks() const;
 
 private:
     static QByteArray readFile(const QString &filename);
@@ -1576,5 +1581,172 @@ void tst_QXmlStream::hasError() const
 
 }
 
+void tst_QXmlStream::fastScanBoundaries_data() const
+{
+    QTest::addColumn<QString>("special");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("attribute");
+
+    const QString nonAscii = QString::fromUtf8("\xc3\xa4\xe2\x82\xac");
+    const QString surrogates = QString::fromUtf8("\xf0\x9d\x84\x9e");
+
+    QTest::newRow("amp") << "&amp;" << "&" << "&";
+    QTest::newRow("lt") << "&lt;" << "<" << "<";
+    QTest::newRow("bracket") << "]" << "]" << "]";
+    QTest::newRow("brackets") << "]]" << "]]" << "]]";
+    QTest::newRow("tab") << "\t" << "\t" << " ";
+    QTest::newRow("newline") << "\n" << "\n" << " ";
+    QTest::newRow("crlf") << "\r\n" << "\n" << " ";
+    QTest::newRow("quote") << "\"" << "\"" << "\"";
+    QTest::newRow("apostrophe") << "'" << "'" << "'";
+    QTest::newRow("non-ascii") << nonAscii << nonAscii << nonAscii;
+    QTest::newRow("surrogates") << surrogates << surrogates << surrogates;
+}
+
+// The scanners for text and attribute values skip over runs of ordinary
+// characters in blocks; check every position of the interesting ones.
+void tst_QXmlStream::fastScanBoundaries() const
+{
+    QFETCH(QString, special);
+    QFETCH(QString, text);
+    QFETCH(QString, attribute);
+
+    const QChar quote = special.contains(QLatin1Char('"')) ? QLatin1Char('\'') : QLatin1Char('"');
+    for (int i = 0; i < 20; ++i) {
+        const QString before(i, QLatin1Char('x'));
+        const QString after(19 - i, QLatin1Char('y'));
+        const QString content = before + special + after;
+
+        QXmlStreamReader reader(QLatin1String("<a b=") + quote + content + quote + QLatin1Char('>')
+                                + content + QLatin1String("</a>"));
+        QVERIFY(reader.readNextStartElement());
+        QCOMPARE(reader.attributes().value(QLatin1String("b")).toString(), before + attribute + after);
+        QCOMPARE(reader.readElementText(), before + text + after);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+        QXmlStreamReader invalid(QLatin1String("<a>") + content + QLatin1String("]]>") + after + QLatin1String("</a>"));
+        while (!invalid.atEnd())
+            invalid.readNext();
+        QCOMPARE(invalid.error(), QXmlStreamReader::NotWellFormedError);
+    }
+}
+
+void tst_QXmlStream::fastScanWhitespace() const
+{
+    for (int i = 1; i < 20; ++i) {
+        const QString spaces(i, QLatin1Char(' '));
+
+        QXmlStreamReader reader(QLatin1String("<a>") + spaces + QLatin1String("</a>"));
+        QVERIFY(reader.readNextStartElement());
+        QCOMPARE(reader.readNext(), QXmlStreamReader::Characters);
+        QVERIFY(reader.isWhitespace());
+
+        for (int j = 0; j < i; ++j) {
+            QString text = spaces;
+            text[j] = QLatin1Char('x');
+            QXmlStreamReader reader(QLatin1String("<a>") + text + QLatin1String("</a>"));
+            QVERIFY(reader.readNextStartElement());
+            QCOMPARE(reader.readNext(), QXmlStreamReader::Characters);
+            QVERIFY(!reader.isWhitespace());
+        }
+    }
+}
+
+// Reads all tokens of data, adding it to the reader chunkSize bytes at a
+// time. Consecutive character tokens are merged, since their number
+// depends on how the data is split.
+static QStringList readTokens(const QByteArray &data, int chunkSize)
+{
+    QXmlStreamReader reader;
+    QStringList tokens;
+    QXmlStreamReader::TokenType last = QXmlStreamReader::NoToken;
+    int pos = 0;
+    for (;;) {
+        const QXmlStreamReader::TokenType type = reader.readNext();
+        if (reader.error() == QXmlStreamReader::PrematureEndOfDocumentError && pos < data.size()) {
+            reader.addData(data.mid(pos, chunkSize));
+            pos += chunkSize;
+            continue;
+        }
+        if (reader.hasError())
+            break;
+
+        if (type == QXmlStreamReader::Characters && last == QXmlStreamReader::Characters) {
+            tokens.last() += reader.text().toString();
+            continue;
+        }
+        QString token = reader.tokenString() + QLatin1Char(' ') + reader.name().toString();
+        const QXmlStreamAttributes attributes = reader.attributes();
+        for (const QXmlStreamAttribute &attribute : attributes)
+            token += QLatin1Char(' ') + attribute.name().toString() + QLatin1Char('=') + attribute.value().toString();
+        if (type == QXmlStreamReader::Characters)
+            token += QLatin1Char(' ') + reader.text().toString();
+        tokens.append(token);
+        last = type;
+        if (type == QXmlStreamReader::EndDocument)
+            break;
+    }
+    if (reader.hasError())
+        tokens.append(reader.errorString());
+    return tokens;
+}
+
+void tst_QXmlStream::readLargeChunks_data() const
+{
+    QTest::addColumn<QByteArray>("encoding");
+
+    QTest::newRow("UTF-8") << QByteArray("UTF-8");
+    QTest::newRow("UTF-16") << QByteArray("UTF-16");
+    QTest::newRow("ISO-8859-1") << QByteArray("ISO-8859-1");
+}
+
+// Data added in one go is decoded a few kilobytes at a time, so multibyte
+// characters have to survive being split between those pieces.
+void tst_QXmlStream::readLargeChunks() const
+{
+    QFETCH(QByteArray, encoding);
+
+    QTextCodec *codec = QTextCodec::codecForName(encoding);
+    QVERIFY(codec);
+    const QString piece = encoding == "ISO-8859-1"
+            ? QString::fromUtf8("a\xc3\xa4\xc3\xb6 ")
+            : QString::fromUtf8("a\xc3\xa4\xe2\x82\xac\xf0\x9d\x84\x9e ");
+    QString text;
+    while (text.size() < 40000)
+        text += piece;
+    const QString document = QLatin1String("<?xml version=\"1.0\" encoding=\"") + QLatin1String(encoding)
+            + QLatin1String("\"?><doc a=\"") + text + QLatin1String("\">") + text
+            + QLatin1String("<b/>") + text + QLatin1String("</doc>");
+    const QByteArray data = codec->fromUnicode(document);
+
+    QXmlStreamReader reader(data);
+    QVERIFY(reader.readNextStartElement());
+    QCOMPARE(reader.attributes().value(QLatin1String("a")).toString(), text);
+    QCOMPARE(reader.readNext(), QXmlStreamReader::Characters);
+    QCOMPARE(reader.text().toString(), text);
+    QVERIFY(reader.readNextStartElement());
+    QCOMPARE(reader.name().toString(), QString("b"));
+    QCOMPARE(reader.readNext(), QXmlStreamReader::EndElement);
+    QCOMPARE(reader.readNext(), QXmlStreamReader::Characters);
+    QCOMPARE(reader.text().toString(), text);
+    QCOMPARE(reader.readNext(), QXmlStreamReader::EndElement);
+    QCOMPARE(reader.readNext(), QXmlStreamReader::EndDocument);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    const QStringList tokens = readTokens(data, data.size());
+    QCOMPARE(tokens.size(), 8);
+    QCOMPARE(readTokens(data, 7), tokens);
+    QCOMPARE(readTokens(data, 8191), tokens);
+    QCOMPARE(readTokens(data, 20000), tokens);
+
+    QBuffer buffer;
+    buffer.setData(data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QXmlStreamReader deviceReader(&buffer);
+    QVERIFY(deviceReader.readNextStartElement());
+    QCOMPARE(deviceReader.attributes().value(QLatin1String("a")).toString(), text);
+    QCOMPARE(deviceReader.readElementText(QXmlStreamReader::IncludeChildElements), text + text);
+}
+
 #include "tst_qxmlstream.moc"
 // vim: et:ts=4:sw=4:sts=4
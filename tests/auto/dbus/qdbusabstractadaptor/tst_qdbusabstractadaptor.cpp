@@ -66,6 +66,69 @@ namespace QTest {
 }
 QT_END_NAMESPACE
 
+class ProgressAdaptor: public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "local.Progress")
+    Q_PROPERTY(int progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(QString status READ status NOTIFY statusChanged)
+public:
+    ProgressAdaptor(QObject *parent)
+        : QDBusAbstractAdaptor(parent), m_progress(0)
+    { }
+
+    using QDBusAbstractAdaptor::setPropertyChangeInterval;
+    using QDBusAbstractAdaptor::propertyChangeInterval;
+
+    int progress() const { return m_progress; }
+    void setProgress(int progress)
+    {
+        m_progress = progress;
+        emit progressChanged(progress);
+    }
+
+    QString status() const { return m_status; }
+    void setStatus(const QString &status)
+    {
+        m_status = status;
+        emit statusChanged();
+    }
+
+signals:
+    void progressChanged(int progress);
+    void statusChanged();
+
+private:
+    int m_progress;
+    QString m_status;
+};
+
+class PropertiesChangedSpy: public QObject
+{
+    Q_OBJECT
+public slots:
+    void slot(const QDBusMessage &msg)
+    {
+        if (msg.member() != QLatin1String("PropertiesChanged")) {
+            ++otherSignals;
+            return;
+        }
+        ++count;
+        interface = msg.arguments().value(0).toString();
+        changed = qdbus_cast<QVariantMap>(msg.arguments().value(1));
+        invalidated = qdbus_cast<QStringList>(msg.arguments().value(2));
+    }
+
+public:
+    PropertiesChangedSpy() : count(0), otherSignals(0) { }
+
+    int count;
+    int otherSignals;
+    QString interface;
+    QVariantMap changed;
+    QStringList invalidated;
+};
+
 class TypesInterface: public QDBusAbstractAdaptor
 {
     Q_OBJECT
@@ -407,6 +470,8 @@ private slots:
     void sameSignalDifferentPaths();
     void sameObjectDifferentPaths();
     void scriptableSignalOrNot();
+    void coalescedPropertyChanges_data();
+    void coalescedPropertyChanges();
     void overloadedSignalEmission_data();
     void overloadedSignalEmission();
     void readProperties();
@@ -750,6 +815,67 @@ void tst_QDBusAbstractAdaptor::sameObjectDifferentPaths()
     QVERIFY(spy.signature.isEmpty());
 }
 
+void tst_QDBusAbstractAdaptor::coalescedPropertyChanges_data()
+{
+    QTest::addColumn<int>("interval");
+
+    QTest::newRow("event-loop") << 0;
+    QTest::newRow("interval") << 100;
+}
+
+void tst_QDBusAbstractAdaptor::coalescedPropertyChanges()
+{
+    QFETCH(int, interval);
+
+    QDBusConnection con = QDBusConnection::sessionBus();
+    QVERIFY(con.isConnected());
+
+    QObject obj;
+    ProgressAdaptor *adaptor = new ProgressAdaptor(&obj);
+    QCOMPARE(adaptor->propertyChangeInterval(), -1);
+    adaptor->setPropertyChangeInterval(interval);
+    QCOMPARE(adaptor->propertyChangeInterval(), interval);
+    QVERIFY(con.registerObject("/p1", &obj, QDBusConnection::ExportAdaptors));
+
+    PropertiesChangedSpy spy;
+    con.connect(con.baseService(), "/p1", "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                &spy, SLOT(slot(QDBusMessage)));
+    con.connect(con.baseService(), "/p1", "local.Progress", "progressChanged",
+                &spy, SLOT(slot(QDBusMessage)));
+
+    for (int i = 1; i <= 1000; ++i)
+        adaptor->setProgress(i);
+    adaptor->setStatus("done");
+
+    QTRY_COMPARE(spy.count, 1);
+    QCOMPARE(spy.interface, QString("local.Progress"));
+    QCOMPARE(spy.changed.count(), 2);
+    QCOMPARE(spy.changed.value("progress").toInt(), 1000);
+    QCOMPARE(spy.changed.value("status").toString(), QString("done"));
+    QVERIFY(spy.invalidated.isEmpty());
+
+    // the notify signals themselves are not relayed, and nothing else is sent
+    QTest::qWait(interval + 100);
+    QCOMPARE(spy.count, 1);
+    QCOMPARE(spy.otherSignals, 0);
+
+    // changes after the emission start a new batch
+    adaptor->setProgress(5);
+    QTRY_COMPARE(spy.count, 2);
+    QCOMPARE(spy.changed.count(), 1);
+    QCOMPARE(spy.changed.value("progress").toInt(), 5);
+
+    // disabling coalescing sends pending changes right away and restores relaying
+    adaptor->setPropertyChangeInterval(interval + 60000);
+    adaptor->setProgress(6);
+    adaptor->setPropertyChangeInterval(-1);
+    QTRY_COMPARE(spy.count, 3);
+    QCOMPARE(spy.changed.value("progress").toInt(), 6);
+    adaptor->setProgress(7);
+    QTRY_COMPARE(spy.otherSignals, 1);
+    QCOMPARE(spy.count, 3);
+}
+
 void tst_QDBusAbstractAdaptor::scriptableSignalOrNot()
 {
     QDBusConnection con = QDBusConnection::sessionBus();
@@ -74,6 +74,9 @@ private slots:
     void sendArgument_data();
     void sendArgument();
 
+    void sendMappedData();
+    void mappedDataUnsealed();
+
     void sendSignalErrors();
     void sendCallErrors_data();
     void sendCallErrors();
@@ -764,6 +767,67 @@ void tst_QDBusMarshall::sendBasic()
     }
 }
 
+void tst_QDBusMarshall::sendMappedData()
+{
+    QByteArray data(4 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7);
+
+    QDBusUnixFileDescriptor fd = QDBusUnixFileDescriptor::fromData(data);
+    if (!QDBusUnixFileDescriptor::isSupported()) {
+        QVERIFY(!fd.isValid());
+        QVERIFY(fd.mappedData().isEmpty());
+        QSKIP("Unix file descriptors are not supported on this platform");
+    }
+    QVERIFY(fd.isValid());
+    QCOMPARE(fd.mappedData(), data);
+
+    // the mapping is shared between copies
+    QDBusUnixFileDescriptor copy = fd;
+    QCOMPARE(copy.mappedData().constData(), fd.mappedData().constData());
+
+    if (!fileDescriptorPassing)
+        QSKIP("Your session bus does not allow sending Unix file descriptors");
+
+    QDBusConnection con = QDBusConnection::sessionBus();
+    QVERIFY(con.isConnected());
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(serviceName,
+                                                      objectPath, interfaceName, "ping");
+    msg << QVariant::fromValue(fd);
+
+    QDBusMessage reply = con.call(msg);
+    QVERIFY2(reply.type() == QDBusMessage::ReplyMessage,
+             qPrintable(reply.errorName() + ": " + reply.errorMessage()));
+    QCOMPARE(reply.signature(), QString("h"));
+
+    QDBusUnixFileDescriptor received = qvariant_cast<QDBusUnixFileDescriptor>(reply.arguments().at(0));
+    QVERIFY(received.isValid());
+    QVERIFY(received.fileDescriptor() != fd.fileDescriptor());
+    QCOMPARE(received.mappedData(), data);
+}
+
+void tst_QDBusMarshall::mappedDataUnsealed()
+{
+    if (!QDBusUnixFileDescriptor::isSupported())
+        QSKIP("Unix file descriptors are not supported on this platform");
+
+    const QByteArray data(64 * 1024, 'x');
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.flush());
+
+    // the file can still change, so its contents are copied, not mapped
+    QDBusUnixFileDescriptor fd(file.handle());
+    QVERIFY(fd.isValid());
+    const QByteArray contents = fd.mappedData();
+    QCOMPARE(contents, data);
+    QVERIFY(file.resize(0));
+    QCOMPARE(contents, data);
+    QCOMPARE(fd.mappedData().constData(), contents.constData());
+}
+
 void tst_QDBusMarshall::sendVariant()
 {
     QFETCH(QVariant, value);
@@ -4,6 +4,7 @@ SUBDIRS=\
    qicoimageformat \
    qpixmap \
    qpixmapcache \
+   qsharedimagecache \
    qimage \
    qimageiohandler \
    qimagewriter \
@@ -16,4 +17,5 @@ SUBDIRS=\
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
            qpixmapcache \
+           qsharedimagecache \
 
@@ -0,0 +1,358 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qimage.h>
+#include <qtemporarydir.h>
+#include <qthread.h>
+#include <private/qsharedimagecache_p.h>
+
+class tst_QSharedImageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertFind();
+    void replace();
+    void remove();
+    void cacheLimit();
+    void cacheLimitAcrossShards();
+    void statistics();
+    void concurrentAccess();
+    void diskCache();
+    void diskCacheSkipsColorTables();
+    void diskCacheRejectsCorruptFiles();
+    void diskCacheLimit();
+};
+
+static QImage filledImage(int w, int h, QRgb color, QImage::Format format = QImage::Format_ARGB32_Premultiplied)
+{
+    QImage image(w, h, format);
+    image.fill(color);
+    return image;
+}
+
+void tst_QSharedImageCache::insertFind()
+{
+    QSharedImageCache cache;
+    const QImage image = filledImage(20, 20, 0xff00ff00);
+    QVERIFY(cache.insert(QStringLiteral("green"), image));
+
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("green"), &found));
+    QCOMPARE(found, image);
+    QVERIFY(cache.find(QStringLiteral("green"), 0));
+    QVERIFY(!cache.find(QStringLiteral("red"), &found));
+
+    QVERIFY(!cache.insert(QStringLiteral("null"), QImage()));
+}
+
+void tst_QSharedImageCache::replace()
+{
+    QSharedImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("key"), filledImage(4, 4, 0xffff0000)));
+    QVERIFY(cache.insert(QStringLiteral("key"), filledImage(4, 4, 0xff0000ff)));
+
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("key"), &found));
+    QCOMPARE(found.pixel(0, 0), 0xff0000ffu);
+    QCOMPARE(cache.statistics().count, 1);
+}
+
+void tst_QSharedImageCache::remove()
+{
+    QSharedImageCache cache;
+    cache.insert(QStringLiteral("a"), filledImage(4, 4, 0xffff0000));
+    cache.insert(QStringLiteral("b"), filledImage(4, 4, 0xffff0000));
+    cache.remove(QStringLiteral("a"));
+    QVERIFY(!cache.find(QStringLiteral("a"), 0));
+    QVERIFY(cache.find(QStringLiteral("b"), 0));
+
+    cache.clear();
+    QVERIFY(!cache.find(QStringLiteral("b"), 0));
+    QCOMPARE(cache.statistics().count, 0);
+}
+
+void tst_QSharedImageCache::cacheLimit()
+{
+    // One shard so that eviction order is fully determined.
+    QSharedImageCache cache(100, 1);
+    QCOMPARE(cache.cacheLimit(), 100);
+    QCOMPARE(cache.shardCount(), 1);
+
+    // 64x64 ARGB32 images cost 16 KB each.
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(cache.insert(QString::number(i), filledImage(64, 64, 0xff000000 | i)));
+    QVERIFY(cache.statistics().totalCost <= 100);
+    QVERIFY(!cache.find(QStringLiteral("0"), 0));
+    QVERIFY(cache.find(QStringLiteral("9"), 0));
+
+    // Too large for the cache.
+    QVERIFY(!cache.insert(QStringLiteral("big"), filledImage(256, 256, 0xffffffff)));
+
+    cache.setCacheLimit(16);
+    QVERIFY(cache.statistics().totalCost <= 16);
+    QVERIFY(cache.find(QStringLiteral("9"), 0));
+}
+
+void tst_QSharedImageCache::cacheLimitAcrossShards()
+{
+    QSharedImageCache cache(1024, 16);
+
+    // A single image may use most of the limit, whatever its shard.
+    QVERIFY(cache.insert(QStringLiteral("large"), filledImage(448, 448, 0xffff0000)));
+    QVERIFY(cache.find(QStringLiteral("large"), 0));
+
+    // The limit holds for all shards together.
+    for (int i = 0; i < 64; ++i)
+        QVERIFY(cache.insert(QString::number(i), filledImage(64, 64, 0xff000000 | i)));
+    QSharedImageCache::Statistics stats = cache.statistics();
+    QVERIFY(stats.totalCost <= 1024);
+    // Eviction is least recently used per shard, so the large image made
+    // room once its shard was trimmed, and most small images stay.
+    QVERIFY(stats.count > 32);
+    QVERIFY(!cache.find(QStringLiteral("large"), 0));
+    QVERIFY(cache.find(QStringLiteral("63"), 0));
+
+    cache.setCacheLimit(256);
+    stats = cache.statistics();
+    QVERIFY(stats.totalCost <= 256);
+    QVERIFY(stats.count > 0);
+
+    cache.clear();
+    QCOMPARE(cache.statistics().totalCost, 0);
+    QVERIFY(cache.insert(QStringLiteral("large"), filledImage(256, 256, 0xff00ff00)));
+}
+
+void tst_QSharedImageCache::statistics()
+{
+    QSharedImageCache cache;
+    cache.insert(QStringLiteral("a"), filledImage(8, 8, 0xffffffff));
+    cache.find(QStringLiteral("a"), 0);
+    cache.find(QStringLiteral("a"), 0);
+    cache.find(QStringLiteral("b"), 0);
+
+    QSharedImageCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.insertions, qint64(1));
+    QCOMPARE(stats.hits, qint64(2));
+    QCOMPARE(stats.misses, qint64(1));
+    QCOMPARE(stats.diskHits, qint64(0));
+    QCOMPARE(stats.count, 1);
+    QCOMPARE(stats.totalCost, 1);
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(0));
+    QCOMPARE(stats.misses, qint64(0));
+    QCOMPARE(stats.insertions, qint64(0));
+    QCOMPARE(stats.count, 1);
+}
+
+class CacheWorker : public QThread
+{
+public:
+    CacheWorker(QSharedImageCache *cache, int id) : cache(cache), id(id), failures(0) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < 500; ++i) {
+            const QString key = QString::number(i % 50);
+            QImage image;
+            if (cache->find(key, &image)) {
+                // All threads store the same content for a key.
+                if (image.pixel(0, 0) != (0xff000000 | uint(i % 50)))
+                    ++failures;
+            } else {
+                QImage tile(32, 32, QImage::Format_RGB32);
+                tile.fill(0xff000000 | uint(i % 50));
+                cache->insert(key, tile);
+            }
+            if ((i + id) % 97 == 0)
+                cache->remove(key);
+        }
+    }
+
+    QSharedImageCache *cache;
+    int id;
+    int failures;
+};
+
+void tst_QSharedImageCache::concurrentAccess()
+{
+    QSharedImageCache cache(1024, 4);
+    QVector<CacheWorker *> workers;
+    for (int i = 0; i < 8; ++i)
+        workers.append(new CacheWorker(&cache, i));
+    for (CacheWorker *worker : qAsConst(workers))
+        worker->start();
+    for (CacheWorker *worker : qAsConst(workers)) {
+        QVERIFY(worker->wait(60000));
+        QCOMPARE(worker->failures, 0);
+    }
+    qDeleteAll(workers);
+
+    const QSharedImageCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.hits + stats.misses, qint64(8 * 500));
+}
+
+void tst_QSharedImageCache::diskCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage image = filledImage(33, 17, 0x80402010);
+    image.setDevicePixelRatio(2);
+    image.setDotsPerMeterX(5000);
+    {
+        QSharedImageCache cache;
+        cache.setDiskCacheDirectory(dir.path());
+        QCOMPARE(cache.diskCacheDirectory(), dir.path());
+        QVERIFY(cache.insert(QStringLiteral("tile:1"), image));
+    }
+
+    // A new cache, as in a later process, finds the image on disk.
+    QSharedImageCache cache;
+    cache.setDiskCacheDirectory(dir.path());
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("tile:1"), &found));
+    QCOMPARE(found, image);
+    QCOMPARE(found.devicePixelRatio(), qreal(2));
+    QCOMPARE(found.dotsPerMeterX(), 5000);
+    QCOMPARE(cache.statistics().diskHits, qint64(1));
+
+    // The second lookup is served from memory.
+    QVERIFY(cache.find(QStringLiteral("tile:1"), &found));
+    QCOMPARE(cache.statistics().hits, qint64(1));
+
+    // Painting on the mapped image must not modify the file.
+    found.fill(Qt::red);
+    cache.clear();
+    QVERIFY(cache.find(QStringLiteral("tile:1"), &found));
+    QCOMPARE(found, image);
+
+    cache.remove(QStringLiteral("tile:1"));
+    QVERIFY(!cache.find(QStringLiteral("tile:1"), 0));
+}
+
+void tst_QSharedImageCache::diskCacheSkipsColorTables()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage indexed(8, 8, QImage::Format_Indexed8);
+    indexed.setColorCount(2);
+    indexed.setColor(0, 0xff000000);
+    indexed.setColor(1, 0xffffffff);
+    indexed.fill(1);
+
+    QSharedImageCache cache;
+    cache.setDiskCacheDirectory(dir.path());
+    QVERIFY(cache.insert(QStringLiteral("indexed"), indexed));
+    cache.waitForDiskWrites();
+    QVERIFY(QDir(dir.path()).entryList(QDir::Files).isEmpty());
+    QVERIFY(cache.find(QStringLiteral("indexed"), 0));
+}
+
+void tst_QSharedImageCache::diskCacheRejectsCorruptFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QSharedImageCache cache;
+    cache.setDiskCacheDirectory(dir.path());
+    QVERIFY(cache.insert(QStringLiteral("tile"), filledImage(16, 16, 0xffffffff)));
+    cache.waitForDiskWrites();
+    cache.clear();
+
+    const QStringList files = QDir(dir.path()).entryList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QFile file(dir.path() + QLatin1Char('/') + files.first());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(64));
+    file.close();
+
+    QVERIFY(!cache.find(QStringLiteral("tile"), 0));
+    QCOMPARE(cache.statistics().misses, qint64(1));
+}
+
+void tst_QSharedImageCache::diskCacheLimit()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Each 64x64 ARGB32 image takes 16 KB on disk plus the header.
+    QSharedImageCache cache;
+    QCOMPARE(cache.diskCacheLimit(), 102400);
+    cache.setDiskCacheLimit(40);
+    cache.setDiskCacheDirectory(dir.path());
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(cache.insert(QString::number(i), filledImage(64, 64, 0xff000000 | uint(i))));
+        cache.waitForDiskWrites();
+    }
+    QSharedImageCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.diskCount, 2);
+    QVERIFY(stats.diskCost <= 40);
+    QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 2);
+
+    // The least recently used file was evicted.
+    cache.clear();
+    QVERIFY(!cache.find(QStringLiteral("0"), 0));
+    QVERIFY(cache.find(QStringLiteral("1"), 0));
+    QVERIFY(cache.find(QStringLiteral("2"), 0));
+
+    // A disk hit counts as a use, so "2" is evicted next.
+    cache.clear();
+    QVERIFY(cache.find(QStringLiteral("1"), 0));
+    QVERIFY(cache.insert(QStringLiteral("3"), filledImage(64, 64, 0xff000003)));
+    cache.waitForDiskWrites();
+    cache.clear();
+    QVERIFY(cache.find(QStringLiteral("1"), 0));
+    QVERIFY(!cache.find(QStringLiteral("2"), 0));
+    QVERIFY(cache.find(QStringLiteral("3"), 0));
+
+    // A new cache picks up the existing files and honors a lower limit.
+    QSharedImageCache later;
+    later.setDiskCacheDirectory(dir.path());
+    later.setDiskCacheLimit(20);
+    later.waitForDiskWrites();
+    QCOMPARE(later.statistics().diskCount, 1);
+    QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+
+    // Images larger than the limit are only kept in memory.
+    later.setDiskCacheLimit(8);
+    later.waitForDiskWrites();
+    QVERIFY(later.insert(QStringLiteral("large"), filledImage(64, 64, 0xffffffff)));
+    later.waitForDiskWrites();
+    QCOMPARE(later.statistics().diskCount, 0);
+    QVERIFY(QDir(dir.path()).entryList(QDir::Files).isEmpty());
+}
+
+QTEST_MAIN(tst_QSharedImageCache)
+
+#include "tst_qsharedimagecache.moc"
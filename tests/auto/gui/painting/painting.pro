@@ -12,11 +12,13 @@ SUBDIRS=\
    qpdfwriter \
    qpen \
    qpaintengine \
+   qrastertilerenderer \
    qtransform \
    qwmatrix \
    qpolygon \
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
     qpathclipper \
+    qrastertilerenderer \
 
 
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qrastertilerenderer
+SOURCES += tst_qrastertilerenderer.cpp
+QT += gui-private testlib
+
+requires(contains(QT_CONFIG,private_tests))
@@ -0,0 +1,333 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qimage.h>
+#include <qpainter.h>
+#include <qpicture.h>
+#include <qpa/qplatformintegration.h>
+#include <private/qguiapplication_p.h>
+#include <private/qrastertilerenderer_p.h>
+
+Q_DECLARE_METATYPE(QImage::Format)
+
+class tst_QRasterTileRenderer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tiledMatchesImmediate_data();
+    void tiledMatchesImmediate();
+    void culledCommandsMatchImmediate();
+    void textNeedsThreadedFontRendering();
+    void clipFallsBackToImmediate();
+    void autoBandCount();
+    void moreBandsThanRows();
+    void flushClearsRecording();
+    void flushWithActivePainter();
+    void destructorFlushes();
+};
+
+static void paintScene(QPainter *p, const QSize &size)
+{
+    p->setRenderHint(QPainter::Antialiasing);
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, QColor(255, 0, 0, 180));
+    gradient.setColorAt(1, QColor(0, 0, 255, 90));
+
+    for (int i = 0; i < 40; ++i) {
+        const qreal x = (i * 37) % size.width();
+        const qreal y = (i * 53) % size.height();
+        p->setPen(QPen(QColor::fromHsv((i * 31) % 360, 200, 200), 1 + i % 5));
+        p->setBrush(i % 2 ? QBrush(gradient) : QBrush(QColor(0, 128, 0, 100)));
+        p->drawEllipse(QRectF(x, y, 60.5, 41.3));
+        p->drawLine(QPointF(x, y), QPointF(size.width() - x, size.height() - y));
+    }
+
+    QPainterPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(size.width(), 0, 0, size.height(), size.width() - 10, size.height() - 10);
+    path.closeSubpath();
+    p->save();
+    p->translate(3.25, -1.5);
+    p->rotate(7);
+    p->setOpacity(0.6);
+    p->setBrush(QRadialGradient(size.width() / 2, size.height() / 2, size.width() / 3));
+    p->drawPath(path);
+    p->restore();
+
+    QImage sprite(17, 23, QImage::Format_ARGB32_Premultiplied);
+    sprite.fill(QColor(200, 100, 50, 128));
+    p->setCompositionMode(QPainter::CompositionMode_Multiply);
+    p->drawImage(QRectF(20.5, 30, 130, 170), sprite);
+    p->setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    p->setPen(Qt::black);
+    p->setFont(QFont(QStringLiteral("Sans Serif"), 14));
+    for (int y = 0; y < size.height(); y += 29)
+        p->drawText(QPointF(5, y), QStringLiteral("The quick brown fox jumps over the lazy dog"));
+}
+
+static QPicture recordScene(const QSize &size)
+{
+    QPicture picture;
+    QPainter p(&picture);
+    paintScene(&p, size);
+    p.end();
+    return picture;
+}
+
+void tst_QRasterTileRenderer::tiledMatchesImmediate_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<int>("bandCount");
+
+    QTest::newRow("argb32pm, 2 bands") << QImage::Format_ARGB32_Premultiplied << 2;
+    QTest::newRow("argb32pm, 7 bands") << QImage::Format_ARGB32_Premultiplied << 7;
+    QTest::newRow("argb32, 3 bands") << QImage::Format_ARGB32 << 3;
+    QTest::newRow("rgb32, 5 bands") << QImage::Format_RGB32 << 5;
+    QTest::newRow("rgb16, 4 bands") << QImage::Format_RGB16 << 4;
+    QTest::newRow("rgb888, 3 bands") << QImage::Format_RGB888 << 3;
+    QTest::newRow("rgba8888, 6 bands") << QImage::Format_RGBA8888 << 6;
+}
+
+void tst_QRasterTileRenderer::tiledMatchesImmediate()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(int, bandCount);
+
+    const QSize size(301, 257);
+    const QPicture picture = recordScene(size);
+    QVERIFY(QRasterTileRenderer::canRenderTiled(picture, QImage(size, format)));
+
+    QImage immediate(size, format);
+    immediate.fill(0);
+    bool tiled = true;
+    QVERIFY(QRasterTileRenderer::render(picture, &immediate, 1, &tiled));
+    QVERIFY(!tiled);
+
+    QImage banded(size, format);
+    banded.fill(0);
+    QVERIFY(QRasterTileRenderer::render(picture, &banded, bandCount, &tiled));
+    QVERIFY(tiled);
+
+    QCOMPARE(banded, immediate);
+
+    // both replay the same recording, so also check against painting the
+    // scene directly, which catches mistakes in recording it
+    QImage direct(size, format);
+    direct.fill(0);
+    {
+        QPainter p(&direct);
+        paintScene(&p, size);
+    }
+    QCOMPARE(banded, direct);
+}
+
+static void paintBandCrossers(QPainter *p, const QSize &size)
+{
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+    p->setRenderHint(QPainter::Antialiasing);
+
+    // sharp miter joins reach far outside the points of the polyline
+    QPen miter(QColor(0, 0, 200, 160), 9, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin);
+    miter.setMiterLimit(8);
+    p->setPen(miter);
+    const QPointF spike[] = { QPointF(20, 60), QPointF(40, 64), QPointF(60, 60) };
+    p->drawPolyline(spike, 3);
+
+    QPen cosmetic(QColor(200, 0, 0, 200), 6);
+    cosmetic.setCosmetic(true);
+    p->setPen(cosmetic);
+    p->save();
+    p->scale(0.25, 0.25);
+    p->drawLine(QPointF(80, 254), QPointF(780, 254));
+    p->restore();
+
+    p->setPen(QPen(Qt::darkGreen, 3));
+    p->save();
+    p->translate(150, 120);
+    p->rotate(33);
+    p->drawRect(QRectF(-40, -20, 80, 40));
+    p->restore();
+
+    p->setPen(Qt::black);
+    p->setFont(QFont(QStringLiteral("Sans Serif"), 20, -1, true));
+    p->drawText(QPointF(20.5, 170.25), QStringLiteral("Jagged fjords"));
+
+    for (int i = 0; i < 32; ++i) {
+        p->setPen(QPen(QColor::fromHsv(i * 11, 255, 200), 1 + i % 4));
+        p->drawPoint(QPointF(10 + i * 7.5, 31.5 + i % 2));
+        p->drawLine(QPointF(10 + i * 7, 127), QPointF(14 + i * 7, 129));
+    }
+}
+
+void tst_QRasterTileRenderer::culledCommandsMatchImmediate()
+{
+    // Bands are four rows high, so that most commands are only replayed in
+    // some of them and everything crosses band boundaries.
+    const QSize size(256, 192);
+    QPicture picture;
+    {
+        QPainter p(&picture);
+        paintBandCrossers(&p, size);
+    }
+
+    QImage direct(size, QImage::Format_ARGB32_Premultiplied);
+    direct.fill(0);
+    {
+        QPainter p(&direct);
+        paintBandCrossers(&p, size);
+    }
+
+    QImage banded(size, QImage::Format_ARGB32_Premultiplied);
+    banded.fill(0);
+    bool tiled = false;
+    QVERIFY(QRasterTileRenderer::render(picture, &banded, size.height() / 4, &tiled));
+    QVERIFY(tiled);
+    QCOMPARE(banded, direct);
+}
+
+void tst_QRasterTileRenderer::textNeedsThreadedFontRendering()
+{
+    const QSize size(200, 100);
+    QPicture picture;
+    {
+        QPainter p(&picture);
+        p.drawText(QPointF(10, 50), QStringLiteral("Text"));
+    }
+
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    bool tiled = false;
+    QVERIFY(QRasterTileRenderer::render(picture, &image, 4, &tiled));
+    QCOMPARE(tiled, QGuiApplicationPrivate::platformIntegration()
+                        ->hasCapability(QPlatformIntegration::ThreadedFontRendering));
+}
+
+void tst_QRasterTileRenderer::clipFallsBackToImmediate()
+{
+    const QSize size(200, 200);
+    QPicture picture;
+    {
+        QPainter p(&picture);
+        p.setClipRect(QRect(10, 10, 100, 100));
+        paintScene(&p, size);
+    }
+    QVERIFY(!QRasterTileRenderer::canRenderTiled(picture, QImage(size, QImage::Format_RGB32)));
+
+    QImage expected(size, QImage::Format_RGB32);
+    expected.fill(0);
+    {
+        QPainter p(&expected);
+        QPicture(picture).play(&p);
+    }
+
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(0);
+    bool tiled = true;
+    QVERIFY(QRasterTileRenderer::render(picture, &image, 4, &tiled));
+    QVERIFY(!tiled);
+    QCOMPARE(image, expected);
+}
+
+void tst_QRasterTileRenderer::autoBandCount()
+{
+    QCOMPARE(QRasterTileRenderer::autoBandCount(QImage(64, 64, QImage::Format_RGB32)), 1);
+    QCOMPARE(QRasterTileRenderer::autoBandCount(QImage(4096, 16, QImage::Format_RGB32)), 1);
+
+    const int count = QRasterTileRenderer::autoBandCount(QImage(1024, 1024, QImage::Format_RGB32));
+    QVERIFY(count >= 1);
+    QVERIFY(count <= QThreadPool::globalInstance()->maxThreadCount());
+}
+
+void tst_QRasterTileRenderer::moreBandsThanRows()
+{
+    QImage image(10, 3, QImage::Format_RGB32);
+    image.fill(0);
+    QPicture picture;
+    {
+        QPainter p(&picture);
+        p.fillRect(0, 0, 10, 3, Qt::red);
+    }
+    bool tiled = false;
+    QVERIFY(QRasterTileRenderer::render(picture, &image, 8, &tiled));
+    QVERIFY(tiled);
+    QCOMPARE(image.pixel(9, 2), QColor(Qt::red).rgb());
+}
+
+void tst_QRasterTileRenderer::flushClearsRecording()
+{
+    QImage image(128, 128, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QRasterTileRenderer renderer(&image);
+    renderer.setBandCount(4);
+    {
+        QPainter p(renderer.device());
+        p.fillRect(0, 0, 128, 128, Qt::blue);
+    }
+    QVERIFY(renderer.flush());
+    QVERIFY(renderer.lastFlushWasTiled());
+    QCOMPARE(image.pixel(64, 127), QColor(Qt::blue).rgba());
+
+    // Nothing is replayed twice.
+    image.fill(Qt::transparent);
+    QVERIFY(renderer.flush());
+    QVERIFY(!renderer.lastFlushWasTiled());
+    QCOMPARE(image.pixel(64, 127), 0u);
+}
+
+void tst_QRasterTileRenderer::flushWithActivePainter()
+{
+    QImage image(64, 64, QImage::Format_RGB32);
+    QRasterTileRenderer renderer(&image);
+    QPainter p(renderer.device());
+    QTest::ignoreMessage(QtWarningMsg, "QRasterTileRenderer::flush: Painter on the recording device is still active");
+    QVERIFY(!renderer.flush());
+}
+
+void tst_QRasterTileRenderer::destructorFlushes()
+{
+    QImage image(64, 64, QImage::Format_RGB32);
+    image.fill(Qt::black);
+    {
+        QRasterTileRenderer renderer(&image);
+        renderer.setBandCount(2);
+        QPainter p(renderer.device());
+        p.fillRect(0, 0, 64, 64, Qt::green);
+    }
+    QCOMPARE(image.pixel(0, 63), QColor(Qt::green).rgb());
+}
+
+QTEST_MAIN(tst_QRasterTileRenderer)
+
+#include "tst_qrastertilerenderer.moc"
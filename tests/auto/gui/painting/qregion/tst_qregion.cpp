@@ -29,6 +29,7 @@
 
 #include <QtTest/QtTest>
 #include <qregion.h>
+#include <private/qregion_p.h>
 
 #include <qbitmap.h>
 #include <qpainter.h>
@@ -85,6 +86,10 @@ private slots:
 
     void regionFromPath();
 
+    void accumulator_data();
+    void accumulator();
+    void accumulatorFallback();
+
 #ifdef QT_BUILD_INTERNAL
     void regionToPath_data();
     void regionToPath();
@@ -1052,5 +1057,84 @@ void tst_QRegion::regionToPath()
 }
 #endif
 
+void tst_QRegion::accumulator_data()
+{
+    QTest::addColumn<QVector<QRect> >("rects");
+
+    QTest::newRow("empty") << QVector<QRect>();
+    QTest::newRow("single") << (QVector<QRect>() << QRect(10, 10, 20, 20));
+    QTest::newRow("empty rects") << (QVector<QRect>() << QRect() << QRect(5, 5, 0, 10)
+                                     << QRect(1, 1, 2, 2));
+    QTest::newRow("repeated") << (QVector<QRect>() << QRect(0, 0, 50, 50) << QRect(10, 10, 5, 5)
+                                  << QRect(0, 0, 50, 50) << QRect(40, 40, 10, 10));
+    QTest::newRow("disjoint") << (QVector<QRect>() << QRect(0, 0, 10, 10) << QRect(200, 0, 10, 10)
+                                  << QRect(0, 200, 10, 10) << QRect(200, 200, 10, 10));
+
+    // Sparse enough that region() never falls back to the bounding rect.
+    QVector<QRect> sparse;
+    for (int i = 0; i < 200; ++i)
+        sparse << QRect((i * 7919) % 2000, (i * 104729) % 2000, 4 + i % 5, 3 + i % 7);
+    QTest::newRow("sparse") << sparse;
+
+    QVector<QRect> overlapping;
+    for (int i = 0; i < 12; ++i)
+        overlapping << QRect(i * 15, (i % 3) * 20, 30, 30);
+    QTest::newRow("overlapping") << overlapping;
+}
+
+void tst_QRegion::accumulator()
+{
+    QFETCH(QVector<QRect>, rects);
+
+    QRegion expected;
+    QRegionAccumulator accumulator;
+    for (const QRect &rect : qAsConst(rects)) {
+        expected += rect;
+        accumulator.add(rect);
+    }
+
+    QCOMPARE(accumulator.isEmpty(), expected.isEmpty());
+    QCOMPARE(accumulator.boundingRect(), expected.boundingRect());
+    QCOMPARE(accumulator.region(), expected);
+    QVERIFY(accumulator.count() <= rects.size());
+
+    QRegionAccumulator fromRegion;
+    fromRegion.add(expected);
+    QCOMPARE(fromRegion.region(), expected);
+
+    QCOMPARE(accumulator.takeRegion(), expected);
+    QVERIFY(accumulator.isEmpty());
+    QCOMPARE(accumulator.region(), QRegion());
+}
+
+void tst_QRegion::accumulatorFallback()
+{
+    // Many small rectangles densely covering an area collapse to the
+    // bounding rect, which contains their union.
+    QRegion expected;
+    QRegionAccumulator accumulator;
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 10; ++x) {
+            const QRect rect(x * 12, y * 12, 10, 10);
+            expected += rect;
+            accumulator.add(rect);
+        }
+    }
+    QCOMPARE(accumulator.count(), 100);
+    const QRegion region = accumulator.region();
+    QCOMPARE(region, QRegion(expected.boundingRect()));
+    QVERIFY((expected - region).isEmpty());
+
+    // Far apart rectangles keep their exact union.
+    QRegionAccumulator sparse;
+    QRegion sparseExpected;
+    for (int i = 0; i < 20; ++i) {
+        const QRect rect(i * 500, (i % 2) * 500, 5, 5);
+        sparseExpected += rect;
+        sparse.add(rect);
+    }
+    QCOMPARE(sparse.region(), sparseExpected);
+}
+
 QTEST_MAIN(tst_QRegion)
 #include "tst_qregion.moc"
@@ -66,6 +66,7 @@ private slots:
     void specificitySort();
     void rulesForNode_data();
     void rulesForNode();
+    void classIndex();
     void shorthandBackgroundProperty_data();
     void shorthandBackgroundProperty();
     void pseudoElement_data();
@@ -1248,6 +1249,18 @@ void tst_QCssParser::rulesForNode_data()
     QTest::newRow("!-3") << QString("<p/>")
         << QString("p:checked:!hover:!pressed { color: red; } p:!checked:hover { color: gray } p:!focus { color: blue; }")
         << quint64(QCss::PseudoClass_Pressed) << 1 << "blue" << "";
+
+    QTest::newRow("class") << QString("<p class=\"foo bar\"/>")
+        << QString(".baz { color: red } .bar { color: gray } *.foo:hover { color: white }")
+        << quint64(QCss::PseudoClass_Hover) << 2 << "gray" << "white";
+
+    QTest::newRow("class-duplicate") << QString("<p class=\"foo foo\"/>")
+        << QString(".foo { color: red }")
+        << (quint64)QCss::PseudoClass_Unspecified << 1 << "red" << "";
+
+    QTest::newRow("class-and-attribute") << QString("<p class=\"foo\" lang=\"en\"/>")
+        << QString(".foo[lang=\"de\"] { color: red } .foo[lang=\"en\"] { color: blue }")
+        << (quint64)QCss::PseudoClass_Unspecified << 1 << "blue" << "";
 }
 
 void tst_QCssParser::rulesForNode()
@@ -1292,6 +1305,21 @@ void tst_QCssParser::rulesForNode()
         QCOMPARE(decls.at(1).d->values.at(0).variant.toString(), value1);
 }
 
+void tst_QCssParser::classIndex()
+{
+    QCss::Parser parser(".foo { color: red } p.foo { color: blue } [class~=\"bar\"] { color: gray } *[class=\"bar\"] { color: white }");
+    QCss::StyleSheet sheet;
+    QVERIFY(parser.parse(&sheet));
+
+    // class selectors without element name or id are indexed by class name,
+    // exact attribute matches stay with the unindexed rules
+    QCOMPARE(sheet.classIndex.count(), 2);
+    QCOMPARE(sheet.classIndex.count("foo"), 1);
+    QCOMPARE(sheet.classIndex.count("bar"), 1);
+    QCOMPARE(sheet.nameIndex.count("p"), 1);
+    QCOMPARE(sheet.styleRules.count(), 1);
+}
+
 void tst_QCssParser::shorthandBackgroundProperty_data()
 {
     QTest::addColumn<QString>("css");
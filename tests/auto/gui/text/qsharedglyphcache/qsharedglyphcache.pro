@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsharedglyphcache
+QT += testlib
+QT += gui-private
+SOURCES  += tst_qsharedglyphcache.cpp
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qfont.h>
+#include <qimage.h>
+#include <qpainter.h>
+#include <qthread.h>
+#include <private/qsharedglyphcache_p.h>
+
+class tst_QSharedGlyphCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertFind();
+    void disabled();
+    void cacheLimit();
+    void sharedBetweenThreads();
+};
+
+static QSharedGlyphCache::Glyph makeGlyph(int size, char fill)
+{
+    QSharedGlyphCache::Glyph glyph;
+    glyph.width = size;
+    glyph.height = size;
+    glyph.x = 1;
+    glyph.y = -2;
+    glyph.advance = size + 1;
+    glyph.linearAdvance = size + 2;
+    glyph.format = 1;
+    glyph.data = QByteArray(size * size, fill);
+    return glyph;
+}
+
+void tst_QSharedGlyphCache::insertFind()
+{
+    QSharedGlyphCache cache(64);
+    QVERIFY(cache.isEnabled());
+
+    const QSharedGlyphCache::Glyph glyph = makeGlyph(8, 'a');
+    cache.insert(QByteArrayLiteral("face\0" "1"), glyph);
+
+    QSharedGlyphCache::Glyph found;
+    QVERIFY(cache.find(QByteArrayLiteral("face\0" "1"), &found));
+    QCOMPARE(found.width, glyph.width);
+    QCOMPARE(found.height, glyph.height);
+    QCOMPARE(found.x, glyph.x);
+    QCOMPARE(found.y, glyph.y);
+    QCOMPARE(found.advance, glyph.advance);
+    QCOMPARE(found.linearAdvance, glyph.linearAdvance);
+    QCOMPARE(found.format, glyph.format);
+    QCOMPARE(found.data, glyph.data);
+
+    QVERIFY(!cache.find(QByteArrayLiteral("face\0" "2"), &found));
+
+    const QSharedGlyphCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(1));
+    QCOMPARE(stats.misses, qint64(1));
+    QCOMPARE(stats.count, 1);
+
+    cache.clear();
+    QVERIFY(!cache.find(QByteArrayLiteral("face\0" "1"), &found));
+}
+
+void tst_QSharedGlyphCache::disabled()
+{
+    QSharedGlyphCache cache(0);
+    QVERIFY(!cache.isEnabled());
+    cache.insert("key", makeGlyph(4, 'b'));
+
+    QSharedGlyphCache::Glyph found;
+    QVERIFY(!cache.find("key", &found));
+    QCOMPARE(cache.statistics().count, 0);
+
+    // The shared instance is opt-in.
+    if (!qEnvironmentVariableIsSet("QT_SHARED_GLYPH_CACHE_LIMIT"))
+        QCOMPARE(QSharedGlyphCache::defaultCacheLimit(), 0);
+}
+
+void tst_QSharedGlyphCache::cacheLimit()
+{
+    QSharedGlyphCache cache(4, 1);
+    QCOMPARE(cache.cacheLimit(), 4);
+
+    // 1 KB glyphs, the oldest ones get evicted.
+    for (int i = 0; i < 16; ++i)
+        cache.insert(QByteArray::number(i), makeGlyph(32, 'c'));
+    QVERIFY(cache.statistics().totalCost <= 4 * 1024);
+
+    QSharedGlyphCache::Glyph found;
+    QVERIFY(!cache.find("0", &found));
+    QVERIFY(cache.find("15", &found));
+
+    cache.setCacheLimit(0);
+    QCOMPARE(cache.statistics().count, 0);
+    QVERIFY(!cache.find("15", &found));
+}
+
+class TextRenderer : public QThread
+{
+public:
+    void run() Q_DECL_OVERRIDE { image = render(); }
+
+    static QImage render()
+    {
+        QImage image(200, 40, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter p(&image);
+        QFont font(QStringLiteral("Sans Serif"));
+        font.setPixelSize(17);
+        p.setFont(font);
+        p.drawText(QPointF(2, 25), QStringLiteral("Shared glyphs 0123"));
+        return image;
+    }
+
+    QImage image;
+};
+
+void tst_QSharedGlyphCache::sharedBetweenThreads()
+{
+    QSharedGlyphCache *cache = QSharedGlyphCache::instance();
+    const int cacheLimit = cache->cacheLimit();
+    cache->setCacheLimit(2048);
+    cache->clear();
+
+    const QSharedGlyphCache::Statistics before = cache->statistics();
+    const QImage expected = TextRenderer::render();
+    if (cache->statistics().misses == before.misses) {
+        cache->setCacheLimit(cacheLimit);
+        QSKIP("The font engine does not use the shared glyph cache");
+    }
+
+    // Font engines are per thread, the glyphs come from the shared cache.
+    const qint64 hits = cache->statistics().hits;
+    TextRenderer renderer;
+    renderer.start();
+    QVERIFY(renderer.wait(30000));
+    cache->setCacheLimit(cacheLimit);
+    QVERIFY(cache->statistics().hits > hits);
+    QCOMPARE(renderer.image, expected);
+}
+
+QTEST_MAIN(tst_QSharedGlyphCache)
+
+#include "tst_qsharedglyphcache.moc"
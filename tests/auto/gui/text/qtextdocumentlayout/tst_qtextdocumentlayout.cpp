@@ -58,6 +58,7 @@ private slots:
     void floatingTablePageBreak();
     void imageAtRightAlignedTab();
     void blockVisibility();
+    void viewportDrivenLayout();
 
 private:
     QTextDocument *doc;
@@ -344,5 +345,41 @@ void tst_QTextDocumentLayout::blockVisibility()
     QCOMPARE(doc->size(), halfSize);
 }
 
+void tst_QTextDocumentLayout::viewportDrivenLayout()
+{
+    QString text;
+    for (int i = 0; i < 20000; ++i)
+        text += QString::fromLatin1("Line %1 of a long log file\n").arg(i);
+
+    doc->setPageSize(QSizeF(300, -1));
+    QVERIFY(doc->documentLayout()->setProperty("viewportDrivenLayout", true));
+    QVERIFY(doc->documentLayout()->property("viewportDrivenLayout").toBool());
+    doc->setPlainText(text);
+
+    // Nothing beyond the first layout step is done in the background.
+    QTest::qWait(100);
+    QTextBlock last = doc->lastBlock();
+    QVERIFY(doc->firstBlock().layout()->lineCount() > 0);
+    QCOMPARE(last.layout()->lineCount(), 0);
+
+    QTextDocument reference;
+    reference.setPageSize(QSizeF(300, -1));
+    reference.setPlainText(text);
+
+    // Querying a block lays out up to that block, with the same result.
+    const QTextBlock middle = doc->findBlockByNumber(10000);
+    QCOMPARE(doc->documentLayout()->blockBoundingRect(middle),
+             reference.documentLayout()->blockBoundingRect(reference.findBlockByNumber(10000)));
+    QCOMPARE(last.layout()->lineCount(), 0);
+
+    QCOMPARE(doc->documentLayout()->documentSize(), reference.documentLayout()->documentSize());
+    QVERIFY(last.layout()->lineCount() > 0);
+
+    // Switching back completes the layout in the background again.
+    QVERIFY(doc->documentLayout()->setProperty("viewportDrivenLayout", false));
+    doc->setPlainText(text);
+    QTRY_VERIFY(doc->lastBlock().layout()->lineCount() > 0);
+}
+
 QTEST_MAIN(tst_QTextDocumentLayout)
 #include "tst_qtextdocumentlayout.moc"
@@ -8,6 +8,7 @@ SUBDIRS=\
    qfontmetrics \
    qglyphrun \
    qrawfont \
+   qsharedglyphcache \
    qstatictext \
    qsyntaxhighlighter \
    qtextblock \
@@ -29,6 +30,7 @@ win32:SUBDIRS -= qtextpiecetable
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
            qfontcache \
+           qsharedglyphcache \
            qcssparser \
            qtextlayout \
            qtextpiecetable \
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlconnectionpool
+QT = core sql testlib
+
+SOURCES += tst_qsqlconnectionpool.cpp
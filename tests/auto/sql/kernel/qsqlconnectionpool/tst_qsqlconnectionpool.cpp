@@ -0,0 +1,380 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void acquireRelease();
+    void timeout();
+    void waitForRelease();
+    void idleTimeout();
+    void healthCheck();
+    void unknownConnection();
+    void concurrentThreads();
+    void evictBoundConnection();
+
+private:
+    QTemporaryDir dir;
+};
+
+static const char connectionName[] = "pooltest";
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("QSQLITE driver not available");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QLatin1String(connectionName));
+    db.setDatabaseName(dir.path() + QLatin1String("/pool.db"));
+    QVERIFY(db.open());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("create table items (id int)")));
+    QVERIFY(q.exec(QStringLiteral("insert into items values (1)")));
+    db.close();
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    QSqlDatabase::removeDatabase(QLatin1String(connectionName));
+}
+
+void tst_QSqlConnectionPool::cleanup()
+{
+    // the pools of the test functions have removed all their connections
+    QCOMPARE(QSqlDatabase::connectionNames(), QStringList() << QLatin1String(connectionName));
+}
+
+void tst_QSqlConnectionPool::acquireRelease()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(2);
+    QCOMPARE(pool.size(), 0);
+
+    QSqlDatabase db1 = pool.acquire();
+    QVERIFY(db1.isOpen());
+    QCOMPARE(db1.driverName(), QStringLiteral("QSQLITE"));
+    QVERIFY(db1.connectionName() != QLatin1String(connectionName));
+    QSqlDatabase db2 = pool.acquire();
+    QVERIFY(db2.isOpen());
+    QVERIFY(db1.connectionName() != db2.connectionName());
+    QCOMPARE(pool.size(), 2);
+    QCOMPARE(pool.idleCount(), 0);
+
+    {
+        QSqlQuery q(db1);
+        QVERIFY(q.exec(QStringLiteral("select id from items")));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 1);
+    }
+
+    const QString name = db1.connectionName();
+    pool.release(db1);
+    db1 = QSqlDatabase();
+    QCOMPARE(pool.idleCount(), 1);
+
+    // the released connection is handed out again
+    QSqlDatabase db3 = pool.acquire();
+    QCOMPARE(db3.connectionName(), name);
+    QVERIFY(db3.isOpen());
+    QCOMPARE(pool.size(), 2);
+    QCOMPARE(pool.acquireCount(), 3);
+    QCOMPARE(pool.waitCount(), 0);
+
+    QTest::ignoreMessage(QtWarningMsg, "QSqlConnectionPool::release: connection 'pooltest' was not acquired from this pool");
+    pool.release(QSqlDatabase::database(QLatin1String(connectionName), false));
+
+    pool.release(db2);
+    pool.release(db3);
+    QCOMPARE(pool.idleCount(), 2);
+    db2 = db3 = QSqlDatabase();
+}
+
+void tst_QSqlConnectionPool::timeout()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(1);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+
+    QElapsedTimer timer;
+    timer.start();
+    QSqlDatabase none = pool.acquire(50);
+    QVERIFY(!none.isValid());
+    QVERIFY(timer.elapsed() >= 50);
+    QCOMPARE(pool.lastError().type(), QSqlError::ConnectionError);
+    QCOMPARE(pool.timeoutCount(), 1);
+    QCOMPARE(pool.acquire(0).isValid(), false);
+    QCOMPARE(pool.timeoutCount(), 2);
+
+    pool.release(db);
+    db = pool.acquire(0);
+    QVERIFY(db.isValid());
+    pool.release(db);
+    db = QSqlDatabase();
+
+    pool.resetStatistics();
+    QCOMPARE(pool.timeoutCount(), 0);
+    QCOMPARE(pool.acquireCount(), 0);
+}
+
+class AcquireThread : public QThread
+{
+public:
+    AcquireThread(QSqlConnectionPool *pool, int timeout = -1)
+        : pool(pool), timeout(timeout), selected(false)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QSqlDatabase db = pool->acquire(timeout);
+        connectionName = db.connectionName();
+        if (db.isValid()) {
+            {
+                QSqlQuery q(db);
+                selected = q.exec(QStringLiteral("select id from items")) && q.next();
+            }
+            pool->release(db);
+        }
+    }
+
+    QSqlConnectionPool *pool;
+    int timeout;
+    bool selected;
+    QString connectionName;
+};
+
+void tst_QSqlConnectionPool::waitForRelease()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(1);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+    const QString name = db.connectionName();
+
+    AcquireThread thread(&pool, 10000);
+    thread.start();
+    QTest::qSleep(50);
+    QVERIFY(thread.isRunning());
+    pool.release(db);
+    db = QSqlDatabase();
+    QVERIFY(thread.wait(10000));
+
+    // the connection was moved to the other thread and back
+    QCOMPARE(thread.connectionName, name);
+    QVERIFY(thread.selected);
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.waitCount(), 1);
+    QVERIFY(pool.maximumWaitTime() > 0);
+    QCOMPARE(pool.totalWaitTime(), pool.maximumWaitTime());
+
+    db = pool.acquire(0);
+    QCOMPARE(db.connectionName(), name);
+    QVERIFY(db.driver()->thread() == QThread::currentThread());
+    pool.release(db);
+    db = QSqlDatabase();
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(3);
+    pool.setMinimumSize(1);
+    pool.setIdleTimeout(10);
+
+    QSqlDatabase db1 = pool.acquire();
+    QSqlDatabase db2 = pool.acquire();
+    QSqlDatabase db3 = pool.acquire();
+    QCOMPARE(pool.size(), 3);
+    pool.release(db1);
+    pool.release(db2);
+    pool.release(db3);
+    QCOMPARE(pool.size(), 3);
+    QCOMPARE(pool.idleCount(), 3);
+    db1 = db2 = QSqlDatabase();
+
+    QTest::qSleep(20);
+    // the most recently released connection is kept
+    QSqlDatabase db = pool.acquire();
+    QCOMPARE(db.connectionName(), db3.connectionName());
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+    db3 = QSqlDatabase();
+    pool.release(db);
+    db = QSqlDatabase();
+}
+
+void tst_QSqlConnectionPool::healthCheck()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setHealthCheckQuery(QStringLiteral("select 1"));
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+    const QString name = db.connectionName();
+    // a connection closed while it was acquired is replaced
+    db.close();
+    pool.release(db);
+    db = QSqlDatabase();
+    db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(db.connectionName() != name);
+    QCOMPARE(pool.size(), 1);
+    QVERIFY(!QSqlDatabase::contains(name));
+    pool.release(db);
+    db = QSqlDatabase();
+
+    pool.setHealthCheckQuery(QStringLiteral("select * from no_such_table"));
+    QVERIFY(!pool.acquire().isValid());
+    QCOMPARE(pool.lastError().type(), QSqlError::StatementError);
+    QCOMPARE(pool.size(), 0);
+}
+
+void tst_QSqlConnectionPool::unknownConnection()
+{
+    QSqlConnectionPool pool(QStringLiteral("nosuchconnection"));
+    QVERIFY(!pool.acquire().isValid());
+    QVERIFY(pool.lastError().isValid());
+    QCOMPARE(pool.size(), 0);
+}
+
+void tst_QSqlConnectionPool::concurrentThreads()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(2);
+
+    class Worker : public QThread
+    {
+    public:
+        QSqlConnectionPool *pool;
+        int failures;
+
+        void run() Q_DECL_OVERRIDE
+        {
+            failures = 0;
+            for (int i = 0; i < 50; ++i) {
+                QSqlDatabase db = pool->acquire();
+                {
+                    QSqlQuery q(db);
+                    if (!q.exec(QStringLiteral("select id from items")) || !q.next())
+                        ++failures;
+                }
+                pool->release(db);
+            }
+        }
+    };
+
+    Worker workers[4];
+    for (int i = 0; i < 4; ++i) {
+        workers[i].pool = &pool;
+        workers[i].start();
+    }
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(workers[i].wait(60000));
+        QCOMPARE(workers[i].failures, 0);
+    }
+    QCOMPARE(pool.acquireCount(), 200);
+    QVERIFY(pool.size() <= 2);
+    QCOMPARE(pool.idleCount(), pool.size());
+}
+
+class BoundConnectionThread : public QThread
+{
+public:
+    BoundConnectionThread(QSqlConnectionPool *pool, bool usesPoolAgain)
+        : pool(pool), usesPoolAgain(usesPoolAgain)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        {
+            QSqlDatabase db = pool->acquire();
+            connectionName = db.connectionName();
+            // a connection subscribed to notifications stays in this thread
+            db.driver()->subscribeToNotification(QStringLiteral("items"));
+            pool->release(db);
+        }
+        released.release();
+        proceed.acquire();
+        // closes the connections evicted in the meantime
+        if (usesPoolAgain)
+            pool->release(pool->acquire());
+    }
+
+    QSqlConnectionPool *pool;
+    bool usesPoolAgain;
+    QString connectionName;
+    QSemaphore released;
+    QSemaphore proceed;
+};
+
+void tst_QSqlConnectionPool::evictBoundConnection()
+{
+    QSqlConnectionPool pool(connectionName);
+    pool.setMaximumSize(1);
+
+    for (int usesPoolAgain = 1; usesPoolAgain >= 0; --usesPoolAgain) {
+        BoundConnectionThread thread(&pool, usesPoolAgain);
+        thread.start();
+        thread.released.acquire();
+        QCOMPARE(pool.idleCount(), 1);
+
+        // the connection is not closed behind the back of its thread
+        QVERIFY(!pool.acquire(50).isValid());
+        QVERIFY(QSqlDatabase::contains(thread.connectionName));
+        QCOMPARE(pool.size(), 1);
+
+        thread.proceed.release();
+        QVERIFY(thread.wait(10000));
+        // either the thread closed it, or it is closed here since the
+        // thread has finished
+        QCOMPARE(QSqlDatabase::contains(thread.connectionName), !usesPoolAgain);
+
+        QSqlDatabase db = pool.acquire(10000);
+        QVERIFY(db.isOpen());
+        QVERIFY(db.connectionName() != thread.connectionName);
+        QVERIFY(!QSqlDatabase::contains(thread.connectionName));
+        QCOMPARE(pool.size(), 1);
+        pool.release(db);
+    }
+    QCOMPARE(pool.timeoutCount(), 2);
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "tst_qsqlconnectionpool.moc"
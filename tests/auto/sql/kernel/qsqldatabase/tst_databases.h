@@ -277,6 +277,19 @@ public:
             return false;
         addDb( QStringLiteral("QSQLITE"), QDir::toNativeSeparators(sqLiteDir->path() + QStringLiteral("/foo.db")) );
 //         addDb( "QSQLITE2", QDir::toNativeSeparators(dbDir.path() + "/foo2.db") );
+
+        // a locally started PostgreSQL server, e.g.
+        // QT_TEST_PSQL_DATABASE=testdb QT_TEST_PSQL_USER=$USER QT_TEST_PSQL_PORT=5433
+        const QString psqlDatabase = QString::fromLocal8Bit(qgetenv("QT_TEST_PSQL_DATABASE"));
+        if (!psqlDatabase.isEmpty()) {
+            bool portOk = false;
+            const int psqlPort = qEnvironmentVariableIntValue("QT_TEST_PSQL_PORT", &portOk);
+            addDb(QStringLiteral("QPSQL"), psqlDatabase,
+                  QString::fromLocal8Bit(qgetenv("QT_TEST_PSQL_USER")),
+                  QString::fromLocal8Bit(qgetenv("QT_TEST_PSQL_PASSWORD")),
+                  QString::fromLocal8Bit(qgetenv("QT_TEST_PSQL_HOST")),
+                  portOk ? psqlPort : -1);
+        }
 //         addDb( "QODBC3", "DRIVER={SQL SERVER};SERVER=iceblink.qt-project.org\\ICEBLINK", "troll", "trond", "" );
 //         addDb( "QODBC3", "DRIVER={SQL Native Client};SERVER=silence.qt-project.org\\SQLEXPRESS", "troll", "trond", "" );
 
@@ -144,6 +144,18 @@ private slots:
     void invalidQuery();
     void batchExec_data() { generic_data(); }
     void batchExec();
+    void batchExecTransaction_data() { generic_data(); }
+    void batchExecTransaction();
+    void execAsync_data() { generic_data(); }
+    void execAsync();
+    void execAsyncPrepared_data() { generic_data(); }
+    void execAsyncPrepared();
+    void execAsyncQueued_data() { generic_data(); }
+    void execAsyncQueued();
+    void execAsyncUnsupported_data() { generic_data(); }
+    void execAsyncUnsupported();
+    void fetchBlock_data() { generic_data(); }
+    void fetchBlock();
     void QTBUG_43874_data() { generic_data(); }
     void QTBUG_43874();
     void oraArrayBind_data() { generic_data(); }
@@ -158,6 +170,12 @@ private slots:
     void psql_bindWithDoubleColonCastOperator();
     void psql_specialFloatValues_data() { generic_data("QPSQL"); }
     void psql_specialFloatValues();
+    void psql_forwardOnlySingleRowMode_data() { generic_data("QPSQL"); }
+    void psql_forwardOnlySingleRowMode();
+    void psql_binaryResults_data() { generic_data("QPSQL"); }
+    void psql_binaryResults();
+    void psql_batchExecCopy_data() { generic_data("QPSQL"); }
+    void psql_batchExecCopy();
     void queryOnInvalidDatabase_data() { generic_data(); }
     void queryOnInvalidDatabase();
     void createQueryOnClosedDatabase_data() { generic_data(); }
@@ -343,6 +361,7 @@ void tst_QSqlQuery::dropTestTables( QSqlDatabase db )
                << qTableName("blobstest", __FILE__, db)
                << qTableName("oraRowId", __FILE__, db)
                << qTableName("qtest_batch", __FILE__, db)
+               << qTableName("qtest_fetchblock", __FILE__, db)
                << qTableName("bug43874", __FILE__, db)
                << qTableName("bug6421", __FILE__, db).toUpper()
                << qTableName("bug5765", __FILE__, db)
@@ -2173,6 +2192,268 @@ void tst_QSqlQuery::batchExec()
     QVERIFY( q.value( 3 ).isNull() );
 }
 
+void tst_QSqlQuery::batchExecTransaction()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
+        QSKIP( "Database can't do BatchOperations");
+
+    const QString tableName = qTableName("qtest_batchtrans", __FILE__, db);
+    tst_Databases::safeDropTable( db, tableName );
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int, name varchar(20))" ) );
+
+    const int rows = 1000;
+    QVariantList ids;
+    QVariantList names;
+    for (int i = 0; i < rows; ++i) {
+        ids << i;
+        names << QString("name %1").arg(i);
+    }
+
+    // outside of a transaction
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, name) values (?, ?)" ) );
+    q.addBindValue( ids );
+    q.addBindValue( names );
+    QVERIFY_SQL( q, execBatch() );
+    QVERIFY_SQL( q, exec( "select count(*) from " + tableName ) );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toInt(), rows );
+
+    // inside of a transaction the batch is part of it
+    if ( db.driver()->hasFeature( QSqlDriver::Transactions ) ) {
+        QVERIFY_SQL( db, transaction() );
+        QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, name) values (?, ?)" ) );
+        q.addBindValue( ids );
+        q.addBindValue( names );
+        QVERIFY_SQL( q, execBatch() );
+        QVERIFY_SQL( db, rollback() );
+        QVERIFY_SQL( q, exec( "select count(*) from " + tableName ) );
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toInt(), rows );
+    }
+
+    QVERIFY_SQL( q, exec( "select id, name from " + tableName + " order by id" ) );
+    for (int i = 0; i < rows; ++i) {
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toInt(), i );
+        QCOMPARE( q.value( 1 ).toString(), names.at( i ).toString() );
+    }
+    QVERIFY( !q.next() );
+}
+
+void tst_QSqlQuery::execAsync()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    if ( tst_Databases::getDatabaseType( db ) != QSqlDriver::PostgreSQL )
+        QSKIP( "Test requires asynchronous execution support" );
+
+    for (int forwardOnly = 0; forwardOnly < 2; ++forwardOnly) {
+        QSqlQuery q( db );
+        q.setForwardOnly( forwardOnly );
+        QFutureWatcher<bool> watcher;
+        QSignalSpy spy( &watcher, SIGNAL(finished()) );
+        watcher.setFuture( q.execAsync( "select id, t_varchar from " + qtest + " order by id" ) );
+        QTRY_COMPARE( spy.count(), 1 );
+        QVERIFY2( watcher.result(), qPrintable( tst_Databases::printError( q.lastError(), db ) ) );
+        QVERIFY( q.isActive() );
+        QVERIFY( q.isSelect() );
+        for (int i = 1; i <= 5; ++i) {
+            QVERIFY( q.next() );
+            QCOMPARE( q.value( 0 ).toInt(), i );
+            QCOMPARE( q.value( 1 ).toString(), QString( "VarChar%1" ).arg( i ) );
+        }
+        QVERIFY( !q.next() );
+
+        // the query can be used synchronously again afterwards
+        QVERIFY_SQL( q, exec( "select count(*) from " + qtest ) );
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toInt(), 5 );
+    }
+
+    QSqlQuery q( db );
+    QFuture<bool> future = q.execAsync( "select no_such_column from " + qtest );
+    QTRY_VERIFY( future.isFinished() );
+    QVERIFY( !future.result() );
+    QVERIFY( q.lastError().isValid() );
+    QVERIFY( !q.isActive() );
+
+    // nothing bound to this thread is left behind, so that a connection
+    // pool can move the connection to another thread
+    QTRY_VERIFY( db.driver()->findChildren<QSocketNotifier *>().isEmpty() );
+}
+
+void tst_QSqlQuery::execAsyncPrepared()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    if ( tst_Databases::getDatabaseType( db ) != QSqlDriver::PostgreSQL )
+        QSKIP( "Test requires asynchronous execution support" );
+
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, prepare( "select t_varchar from " + qtest + " where id = ?" ) );
+    for (int i = 1; i <= 5; ++i) {
+        q.addBindValue( i );
+        QFuture<bool> future = q.execAsync();
+        QTRY_VERIFY( future.isFinished() );
+        QVERIFY2( future.result(), qPrintable( tst_Databases::printError( q.lastError(), db ) ) );
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toString(), QString( "VarChar%1" ).arg( i ) );
+        QVERIFY( !q.next() );
+    }
+}
+
+void tst_QSqlQuery::execAsyncQueued()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    if ( tst_Databases::getDatabaseType( db ) != QSqlDriver::PostgreSQL )
+        QSKIP( "Test requires asynchronous execution support" );
+
+    QSqlQuery q1( db );
+    QSqlQuery q2( db );
+    QFuture<bool> f1 = q1.execAsync( "select id from " + qtest + " where id < 3 order by id" );
+    QFuture<bool> f2 = q2.execAsync( "select id from " + qtest + " where id >= 3 order by id" );
+    QTRY_VERIFY( f1.isFinished() && f2.isFinished() );
+    QVERIFY2( f1.result(), qPrintable( tst_Databases::printError( q1.lastError(), db ) ) );
+    QVERIFY2( f2.result(), qPrintable( tst_Databases::printError( q2.lastError(), db ) ) );
+
+    QList<int> ids;
+    while (q1.next())
+        ids << q1.value( 0 ).toInt();
+    while (q2.next())
+        ids << q2.value( 0 ).toInt();
+    QCOMPARE( ids, QList<int>() << 1 << 2 << 3 << 4 << 5 );
+}
+
+void tst_QSqlQuery::execAsyncUnsupported()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    if ( tst_Databases::getDatabaseType( db ) == QSqlDriver::PostgreSQL )
+        QSKIP( "Test requires a driver without asynchronous execution support" );
+
+    // the query is neither run on another thread nor blocks the caller
+    QSqlQuery q( db );
+    QFuture<bool> future = q.execAsync( "select id from " + qtest );
+    QVERIFY( future.isFinished() );
+    QVERIFY( !future.result() );
+    QCOMPARE( q.lastError().type(), QSqlError::StatementError );
+    QVERIFY( !q.isActive() );
+
+    QVERIFY_SQL( q, prepare( "select id from " + qtest + " where id = ?" ) );
+    q.addBindValue( 1 );
+    future = q.execAsync();
+    QVERIFY( future.isFinished() );
+    QVERIFY( !future.result() );
+    QCOMPARE( q.lastError().type(), QSqlError::StatementError );
+
+    // the connection is still usable synchronously
+    QVERIFY_SQL( q, exec() );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toInt(), 1 );
+}
+
+void tst_QSqlQuery::fetchBlock()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName = qTableName("qtest_fetchblock", __FILE__, db);
+    tst_Databases::safeDropTable( db, tableName );
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int, r real, t varchar(20))" ) );
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, r, t) values (?, ?, ?)" ) );
+    const int rows = 10;
+    for (int i = 0; i < rows; ++i) {
+        q.addBindValue( i );
+        // every third row has NULLs
+        q.addBindValue( i % 3 ? QVariant( i + 0.5 ) : QVariant( QVariant::Double ) );
+        q.addBindValue( i % 3 ? QVariant( QString::fromUtf8( "t\xc3\xa4xt %1" ).arg( i ) ) : QVariant( QVariant::String ) );
+        QVERIFY_SQL( q, exec() );
+    }
+
+    for (int forwardOnly = 0; forwardOnly < 2; ++forwardOnly) {
+        q.setForwardOnly( forwardOnly );
+        QVERIFY_SQL( q, exec( "select id, r, t from " + tableName + " order by id" ) );
+
+        QSqlColumnBlock block;
+        QCOMPARE( q.fetchBlock( &block, 4 ), 4 );
+        QCOMPARE( block.rowCount(), 4 );
+        QCOMPARE( block.columnCount(), 3 );
+        QCOMPARE( block.columnType( 1 ), QSqlColumnBlock::RealColumn );
+        QCOMPARE( block.columnType( 2 ), QSqlColumnBlock::StringColumn );
+        QCOMPARE( block.nullBitmap( 1 ).count( true ), 2 );
+        for (int row = 0; row < 4; ++row) {
+            QCOMPARE( block.integer( row, 0 ), qint64( row ) );
+            QCOMPARE( block.isNull( row, 1 ), row % 3 == 0 );
+            QCOMPARE( block.isNull( row, 2 ), row % 3 == 0 );
+            if (row % 3) {
+                QCOMPARE( block.real( row, 1 ), row + 0.5 );
+                QCOMPARE( block.string( row, 2 ), QString::fromUtf8( "t\xc3\xa4xt %1" ).arg( row ) );
+            } else {
+                QVERIFY( block.value( row, 1 ).isNull() );
+                QVERIFY( block.string( row, 2 ).isEmpty() );
+            }
+        }
+        QCOMPARE( block.stringOffsets( 2 ).count(), 5 );
+
+        // the query is on the last row of the block
+        QCOMPARE( q.at(), 3 );
+        QCOMPARE( q.value( 0 ).toInt(), 3 );
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toInt(), 4 );
+
+        // the remaining rows, reusing the block
+        QCOMPARE( q.fetchBlock( &block, 100 ), rows - 5 );
+        QCOMPARE( block.integer( 0, 0 ), qint64( 5 ) );
+        QCOMPARE( block.string( 3, 2 ), QString::fromUtf8( "t\xc3\xa4xt %1" ).arg( 8 ) );
+        QVERIFY( block.isNull( 4, 2 ) );
+        QCOMPARE( q.at(), int( QSql::AfterLastRow ) );
+        QVERIFY( !q.next() );
+        QCOMPARE( q.fetchBlock( &block, 100 ), 0 );
+        QVERIFY( block.isEmpty() );
+    }
+
+    // floating point values are stored as value() returns them
+    const QSql::NumericalPrecisionPolicy policies[] = { QSql::LowPrecisionInt32, QSql::LowPrecisionInt64,
+                                                        QSql::HighPrecision };
+    const QSqlColumnBlock::ColumnType types[] = { QSqlColumnBlock::IntegerColumn, QSqlColumnBlock::IntegerColumn,
+                                                  QSqlColumnBlock::VariantColumn };
+    for (int i = 0; i < 3; ++i) {
+        QSqlQuery pq( db );
+        pq.setForwardOnly( true );
+        pq.setNumericalPrecisionPolicy( policies[i] );
+        const QString select = "select r from " + tableName + " order by id";
+        QVERIFY_SQL( pq, exec( select ) );
+        QSqlColumnBlock block;
+        QCOMPARE( pq.fetchBlock( &block, 1000 ), rows );
+        QCOMPARE( block.columnType( 0 ), types[i] );
+        QVERIFY_SQL( pq, exec( select ) );
+        for (int row = 0; row < rows; ++row) {
+            QVERIFY( pq.next() );
+            QCOMPARE( block.isNull( row, 0 ), pq.isNull( 0 ) );
+            if (!pq.isNull( 0 )) {
+                QCOMPARE( block.value( row, 0 ).toString(), pq.value( 0 ).toString() );
+                QCOMPARE( block.value( row, 0 ).type(), pq.value( 0 ).type() );
+            }
+        }
+    }
+
+    QVERIFY_SQL( q, exec( "delete from " + tableName ) );
+    QSqlColumnBlock block;
+    QCOMPARE( q.fetchBlock( &block, 10 ), 0 );
+}
+
 void tst_QSqlQuery::QTBUG_43874()
 {
     QFETCH(QString, dbName);
@@ -2454,6 +2735,205 @@ void tst_QSqlQuery::psql_specialFloatValues()
     QVERIFY_SQL( query, exec("drop table " + tableName) );
 }
 
+void tst_QSqlQuery::psql_forwardOnlySingleRowMode()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, exec("select id, t_varchar from " + qtest + " order by id"));
+    QVERIFY(q.isSelect());
+    // rows are retrieved one at a time, so the size is unknown
+    QCOMPARE(q.size(), -1);
+    QCOMPARE(q.record().count(), 2);
+    int count = 0;
+    while (q.next()) {
+        ++count;
+        QCOMPARE(q.value(0).toInt(), count);
+        QCOMPARE(q.value(1).toString(), QString("VarChar%1").arg(count));
+    }
+    QCOMPARE(count, 5);
+    QVERIFY(!q.lastError().isValid());
+
+    QVERIFY_SQL(q, exec("select id from " + qtest + " order by id"));
+    QVERIFY(q.seek(2));
+    QCOMPARE(q.value(0).toInt(), 3);
+    QVERIFY(q.last());
+    QCOMPARE(q.value(0).toInt(), 5);
+    QVERIFY(!q.next());
+
+    QVERIFY_SQL(q, exec("select id from " + qtest + " where id < 0"));
+    QVERIFY(!q.next());
+
+    // the pending rows are discarded once another statement is executed
+    QVERIFY_SQL(q, exec("select id from " + qtest + " order by id"));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1);
+    QSqlQuery q2(db);
+    QVERIFY_SQL(q2, exec("select count(*) from " + qtest));
+    QVERIFY(q2.next());
+    QCOMPARE(q2.value(0).toInt(), 5);
+    QVERIFY(!q.next());
+    QVERIFY(q.lastError().isValid());
+
+    QVERIFY_SQL(q, exec("update " + qtest + " set t_varchar = t_varchar where id = 1"));
+    QVERIFY(!q.isSelect());
+    QCOMPARE(q.numRowsAffected(), 1);
+}
+
+void tst_QSqlQuery::psql_binaryResults()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName = qTableName("binaryresults", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (i2 smallint, i4 integer, i8 bigint, f8 double precision, "
+                        "b boolean, t text, v varchar(20), d date, tm time, ts timestamp, tstz timestamptz, ba bytea)"));
+    QVERIFY_SQL(q, exec("insert into " + tableName + " values (-2, 123456, -9876543210, 0.25, true, 'text', 'varchar', "
+                        "'2016-02-29', '12:34:56.789', '1999-12-31 23:59:59.5', '2016-06-01 10:00:00+02', E'\\001\\377')"));
+    QVERIFY_SQL(q, exec("insert into " + tableName + " values (null, null, 42, null, false, null, null, null, null, null, null, null)"));
+
+    QSqlDatabase binaryDb = QSqlDatabase::cloneDatabase(db, db.connectionName() + QLatin1String("_binary"));
+    binaryDb.setConnectOptions("QPSQL_BINARY_RESULTS");
+    QVERIFY_SQL(binaryDb, open());
+
+    for (int forwardOnly = 0; forwardOnly < 2; ++forwardOnly) {
+        QSqlQuery textQuery(db);
+        QSqlQuery binaryQuery(binaryDb);
+        textQuery.setForwardOnly(forwardOnly);
+        binaryQuery.setForwardOnly(forwardOnly);
+        const QString select = "select * from " + tableName + " order by i8";
+        QVERIFY_SQL(textQuery, exec(select));
+        QVERIFY_SQL(binaryQuery, prepare(select));
+        QVERIFY_SQL(binaryQuery, exec());
+        const int columns = textQuery.record().count();
+        QCOMPARE(binaryQuery.record().count(), columns);
+        int rows = 0;
+        while (textQuery.next()) {
+            QVERIFY(binaryQuery.next());
+            for (int i = 0; i < columns; ++i) {
+                QCOMPARE(binaryQuery.isNull(i), textQuery.isNull(i));
+                QCOMPARE(binaryQuery.value(i).type(), textQuery.value(i).type());
+                QCOMPARE(binaryQuery.value(i), textQuery.value(i));
+            }
+            ++rows;
+        }
+        QVERIFY(!binaryQuery.next());
+        QCOMPARE(rows, 2);
+    }
+
+    binaryDb.close();
+    binaryDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase(db.connectionName() + QLatin1String("_binary"));
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::psql_batchExecCopy()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName = qTableName("batchcopy", __FILE__, db);
+    const QString viewName = qTableName("batchcopy_view", __FILE__, db);
+    tst_Databases::safeDropView(db, viewName);
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id integer, t text, b boolean, f8 double precision, "
+                        "d date, tm time, ba bytea)"));
+
+    QSqlDatabase copyDb = QSqlDatabase::cloneDatabase(db, db.connectionName() + QLatin1String("_copy"));
+    copyDb.setConnectOptions("QPSQL_COPY_BATCHES");
+    QVERIFY_SQL(copyDb, open());
+    q = QSqlQuery(copyDb);
+
+    QVariantList ids, texts, bools, doubles, dates, times, blobs;
+    ids << 1 << 2 << 3;
+    texts << QString("tab\there\\back\nslash") << QString::fromUtf8("\xc3\xa6\xc3\xb8\xc3\xa5") << QVariant(QVariant::String);
+    bools << true << false << QVariant(QVariant::Bool);
+    doubles << 0.5 << qInf() << QVariant(QVariant::Double);
+    dates << QDate(2016, 2, 29) << QDate(1999, 12, 31) << QVariant(QVariant::Date);
+    times << QTime(12, 34, 56, 789) << QTime(0, 0) << QVariant(QVariant::Time);
+    blobs << QByteArray("\0\1\\\t\xff", 5) << QByteArray("") << QVariant(QVariant::ByteArray);
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, t, b, f8, d, tm, ba) VALUES (?, ?, ?, ?, ?, ?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(texts);
+    q.addBindValue(bools);
+    q.addBindValue(doubles);
+    q.addBindValue(dates);
+    q.addBindValue(times);
+    q.addBindValue(blobs);
+    QVERIFY_SQL(q, execBatch());
+    QCOMPARE(q.numRowsAffected(), 3);
+
+    QVERIFY_SQL(q, exec("select id, t, b, f8, d, tm, ba from " + tableName + " order by id"));
+    for (int row = 0; row < 3; ++row) {
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), ids.at(row).toInt());
+        QCOMPARE(q.isNull(1), texts.at(row).isNull());
+        QCOMPARE(q.value(1).toString(), texts.at(row).toString());
+        QCOMPARE(q.isNull(2), bools.at(row).isNull());
+        QCOMPARE(q.value(2).toBool(), bools.at(row).toBool());
+        QCOMPARE(q.isNull(3), doubles.at(row).isNull());
+        QCOMPARE(q.value(3).toDouble(), doubles.at(row).toDouble());
+        QCOMPARE(q.value(4).toDate(), dates.at(row).toDate());
+        QCOMPARE(q.value(5).toTime(), times.at(row).toTime());
+        QCOMPARE(q.isNull(6), blobs.at(row).isNull());
+        QCOMPARE(q.value(6).toByteArray(), blobs.at(row).toByteArray());
+    }
+    QVERIFY(!q.next());
+
+    // a failing row fails the batch, and the rows before it are kept as
+    // without COPY
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, t) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 4 << QString("not a number"));
+    q.addBindValue(QVariantList() << QString("four") << QString("five"));
+    QVERIFY(!q.execBatch());
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 4);
+
+    // inside a transaction the failed COPY does not abort the transaction
+    QVERIFY_SQL(copyDb, transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, t) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 5 << QString("not a number"));
+    q.addBindValue(QVariantList() << QString("five") << QString("six"));
+    QVERIFY(!q.execBatch());
+    QVERIFY_SQL(copyDb, rollback());
+    QVERIFY_SQL(copyDb, transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, t) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 5 << 6);
+    q.addBindValue(QVariantList() << QString("five") << QString("six"));
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY_SQL(copyDb, commit());
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 6);
+
+    // COPY cannot target a view, the rule on it is applied row by row
+    QVERIFY_SQL(q, exec("create view " + viewName + " as select id, t from " + tableName));
+    QVERIFY_SQL(q, exec("create rule " + viewName + "_insert as on insert to " + viewName
+                        + " do instead insert into " + tableName + " (id, t) values (new.id, new.t)"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + viewName + " (id, t) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 7 << 8);
+    q.addBindValue(QVariantList() << QString("seven") << QString("eight"));
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 8);
+
+    q.clear();
+    copyDb.close();
+    tst_Databases::safeDropView(db, viewName);
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 /* For task 157397: Using QSqlQuery with an invalid QSqlDatabase
    does not set the last error of the query.
    This test function will output some warnings, that's ok.
@@ -70,6 +70,11 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void rowCountProbe_data() { generic_data(); }
+    void rowCountProbe();
+    void backgroundFetch_data() { generic_data(); }
+    void backgroundFetch();
+    void backgroundFetchPrivateDatabase();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -490,6 +495,111 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::rowCountProbe()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryModel model;
+    QCOMPARE(model.fetchOptions(), QSqlQueryModel::NoFetchOptions);
+    model.setFetchOptions(QSqlQueryModel::RowCountProbe);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, prepare("select * from " + qTableName("many", __FILE__, db) + " where id >= ? order by id"));
+    q.addBindValue(48);
+    QVERIFY_SQL(q, exec());
+    model.setQuery(q);
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+
+    // the count is known up front, whether the driver reports it or not
+    QCOMPARE(model.rowCount(), 2000);
+    QVERIFY(!model.canFetchMore());
+    QCOMPARE(model.data(model.index(0, 0)).toInt(), 48);
+    QCOMPARE(model.data(model.index(1999, 0)).toInt(), 2047);
+    QCOMPARE(model.data(model.index(1999, 1)).toString(), QString("harry"));
+    QVERIFY(!model.data(model.index(2000, 0)).isValid());
+}
+
+void tst_QSqlQueryModel::backgroundFetch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString query = "select * from " + qTableName("many", __FILE__, db) + " order by id";
+
+    QSqlQueryModel model;
+    model.setFetchOptions(QSqlQueryModel::BackgroundFetch);
+    model.setQuery(QSqlQuery(query, db));
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+
+    // fetch everything, in the background if the driver doesn't report the size
+    QTRY_VERIFY(model.rowCount() > 0);
+    while (model.canFetchMore()) {
+        const int rowCount = model.rowCount();
+        model.fetchMore();
+        QTRY_VERIFY(model.rowCount() > rowCount || !model.canFetchMore());
+    }
+    QCOMPARE(model.rowCount(), 2048);
+    for (int i = 0; i < model.rowCount(); i += 97) {
+        QCOMPARE(model.data(model.index(i, 0)).toInt(), i);
+        QCOMPARE(model.data(model.index(i, 1)).toString(), QString("harry"));
+    }
+    QCOMPARE(model.record(2047).value(0).toInt(), 2047);
+    // no thread is left behind once all rows have arrived
+    QTRY_COMPARE(QSqlDatabase::connectionNames().filter("qt_sql_background_fetch_").size(), 0);
+
+    // rows become available in place when the count is probed
+    model.setFetchOptions(QSqlQueryModel::BackgroundFetch | QSqlQueryModel::RowCountProbe);
+    model.setQuery(QSqlQuery(query, db));
+    QCOMPARE(model.rowCount(), 2048);
+    QTRY_COMPARE(model.data(model.index(2000, 0)).toInt(), 2000);
+    QCOMPARE(model.data(model.index(0, 0)).toInt(), 0);
+
+    // the rows are fetched on a connection of their own, which is
+    // removed without waiting once the model is cleared
+    model.setQuery(QSqlQuery(query, db));
+    QSqlQuery q(db);
+    QVERIFY2(q.exec("select count(*) from " + qTableName("many", __FILE__, db)), tst_Databases::printError(q.lastError()));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 2048);
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QTRY_COMPARE(QSqlDatabase::connectionNames().filter("qt_sql_background_fetch_").size(), 0);
+}
+
+void tst_QSqlQueryModel::backgroundFetchPrivateDatabase()
+{
+    if (!QSqlDatabase::isDriverAvailable("QSQLITE"))
+        QSKIP("This test requires the SQLite driver");
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "backgroundFetchPrivateDatabase");
+        db.setDatabaseName(":memory:");
+        QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+        QSqlQuery q(db);
+        QVERIFY2(q.exec("create table t (id int)"), qPrintable(q.lastError().text()));
+        for (int i = 0; i < 300; ++i)
+            QVERIFY2(q.exec(QString("insert into t values (%1)").arg(i)), qPrintable(q.lastError().text()));
+
+        // a clone would open another, empty database, so the rows are
+        // fetched from the query itself
+        QSqlQueryModel model;
+        model.setFetchOptions(QSqlQueryModel::BackgroundFetch);
+        model.setQuery(QSqlQuery("select id from t order by id", db));
+        QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+        QVERIFY(QSqlDatabase::connectionNames().filter("qt_sql_background_fetch_").isEmpty());
+        QVERIFY(model.rowCount() > 0);
+        QCOMPARE(model.data(model.index(0, 0)).toInt(), 0);
+        while (model.canFetchMore())
+            model.fetchMore();
+        QCOMPARE(model.rowCount(), 300);
+        QCOMPARE(model.data(model.index(299, 0)).toInt(), 299);
+    }
+    QSqlDatabase::removeDatabase("backgroundFetchPrivateDatabase");
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
@@ -29,6 +29,7 @@
 
 #include <QtTest/QtTest>
 #include <QtWidgets/qgraphicsscene.h>
+#include <private/qgraphicssceneaabbtreeindex_p.h>
 #include <private/qgraphicsscenebsptreeindex_p.h>
 #include <private/qgraphicssceneindex_p.h>
 #include <private/qgraphicsscenelinearindex_p.h>
@@ -52,10 +53,13 @@ private slots:
     void boundingRectPointIntersection();
     void removeItems();
     void clear();
+    void aabbTreeMatchesLinearIndex();
+    void aabbTreeHeight();
 
 private:
     void common_data();
     QGraphicsSceneIndex *createIndex(const QString &name);
+    static QGraphicsScene::ItemIndexMethod itemIndexMethod(const QString &name);
 };
 
 void tst_QGraphicsSceneIndex::initTestCase()
@@ -68,6 +72,16 @@ void tst_QGraphicsSceneIndex::common_data()
 
     QTest::newRow("BSP") << QString("bsp");
     QTest::newRow("Linear") << QString("linear");
+    QTest::newRow("AABB") << QString("aabb");
+}
+
+QGraphicsScene::ItemIndexMethod tst_QGraphicsSceneIndex::itemIndexMethod(const QString &name)
+{
+    if (name == "linear")
+        return QGraphicsScene::NoIndex;
+    if (name == "aabb")
+        return QGraphicsScene::AabbTreeIndex;
+    return QGraphicsScene::BspTreeIndex;
 }
 
 QGraphicsSceneIndex *tst_QGraphicsSceneIndex::createIndex(const QString &indexMethod)
@@ -80,6 +94,9 @@ QGraphicsSceneIndex *tst_QGraphicsSceneIndex::createIndex(const QString &indexMe
     if (indexMethod == "linear")
         index = new QGraphicsSceneLinearIndex(scene);
 
+    if (indexMethod == "aabb")
+        index = new QGraphicsSceneAabbTreeIndex(scene);
+
     return index;
 }
 
@@ -93,7 +110,7 @@ void tst_QGraphicsSceneIndex::scatteredItems()
     QFETCH(QString, indexMethod);
 
     QGraphicsScene scene;
-    scene.setItemIndexMethod(indexMethod == "linear" ? QGraphicsScene::NoIndex : QGraphicsScene::BspTreeIndex);
+    scene.setItemIndexMethod(itemIndexMethod(indexMethod));
 
     for (int i = 0; i < 10; ++i)
         scene.addRect(i*50, i*50, 40, 35);
@@ -117,7 +134,7 @@ void tst_QGraphicsSceneIndex::overlappedItems()
     QFETCH(QString, indexMethod);
 
     QGraphicsScene scene;
-    scene.setItemIndexMethod(indexMethod == "linear" ? QGraphicsScene::NoIndex : QGraphicsScene::BspTreeIndex);
+    scene.setItemIndexMethod(itemIndexMethod(indexMethod));
 
     for (int i = 0; i < 10; ++i)
         for (int j = 0; j < 10; ++j)
@@ -146,7 +163,7 @@ void tst_QGraphicsSceneIndex::movingItems()
     QFETCH(QString, indexMethod);
 
     QGraphicsScene scene;
-    scene.setItemIndexMethod(indexMethod == "linear" ? QGraphicsScene::NoIndex : QGraphicsScene::BspTreeIndex);
+    scene.setItemIndexMethod(itemIndexMethod(indexMethod));
 
     for (int i = 0; i < 10; ++i)
         scene.addRect(i*50, i*50, 40, 35);
@@ -358,5 +375,104 @@ void tst_QGraphicsSceneIndex::clear()
     QTRY_COMPARE(item->numPaints, 1);
 }
 
+void tst_QGraphicsSceneIndex::aabbTreeMatchesLinearIndex()
+{
+    QGraphicsScene aabbScene;
+    aabbScene.setItemIndexMethod(QGraphicsScene::AabbTreeIndex);
+    QGraphicsScene linearScene;
+    linearScene.setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    QList<QGraphicsRectItem *> aabbItems;
+    QList<QGraphicsRectItem *> linearItems;
+    QList<QGraphicsItem *> aabbList;
+    QList<QGraphicsItem *> linearList;
+
+    qsrand(42);
+    for (int i = 0; i < 500; ++i) {
+        const QRectF rect(0, 0, 1 + qrand() % 40, 1 + qrand() % 40);
+        const QPointF pos(qrand() % 1000, qrand() % 1000);
+        QGraphicsRectItem *parent = 0;
+        if (i % 10 == 9) // Some children, to exercise top-level lookups.
+            parent = aabbItems.at(qrand() % aabbItems.size());
+        QGraphicsRectItem *aabbItem = new QGraphicsRectItem(rect, parent);
+        aabbItem->setPos(pos);
+        QGraphicsRectItem *linearParent = parent ? linearItems.at(aabbItems.indexOf(parent)) : 0;
+        QGraphicsRectItem *linearItem = new QGraphicsRectItem(rect, linearParent);
+        linearItem->setPos(pos);
+        if (!parent) {
+            aabbScene.addItem(aabbItem);
+            linearScene.addItem(linearItem);
+        }
+        aabbItems << aabbItem;
+        linearItems << linearItem;
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        // Move a varying share of the items, so that both the incremental
+        // updates and the bulk rebuild are exercised.
+        const int moves = round % 2 ? 10 : 400;
+        for (int i = 0; i < moves; ++i) {
+            const int n = qrand() % aabbItems.size();
+            const QPointF delta(qrand() % 61 - 30, qrand() % 61 - 30);
+            aabbItems.at(n)->moveBy(delta.x(), delta.y());
+            linearItems.at(n)->moveBy(delta.x(), delta.y());
+        }
+        if (round == 5) {
+            aabbItems.at(3)->setFlag(QGraphicsItem::ItemIgnoresTransformations);
+            linearItems.at(3)->setFlag(QGraphicsItem::ItemIgnoresTransformations);
+        }
+        if (round == 7) {
+            aabbItems.at(4)->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+            linearItems.at(4)->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+        }
+        if (round == 9) {
+            aabbItems.at(3)->setFlag(QGraphicsItem::ItemIgnoresTransformations, false);
+            linearItems.at(3)->setFlag(QGraphicsItem::ItemIgnoresTransformations, false);
+            delete aabbItems.takeAt(20);
+            delete linearItems.takeAt(20);
+        }
+
+        for (int q = 0; q < 20; ++q) {
+            const QRectF rect(qrand() % 1000, qrand() % 1000, qrand() % 200, qrand() % 200);
+            aabbList = aabbScene.items(rect);
+            linearList = linearScene.items(rect);
+            QCOMPARE(aabbList.size(), linearList.size());
+            for (int i = 0; i < aabbList.size(); ++i)
+                QCOMPARE(aabbItems.indexOf(static_cast<QGraphicsRectItem *>(aabbList.at(i))),
+                         linearItems.indexOf(static_cast<QGraphicsRectItem *>(linearList.at(i))));
+
+            const QPointF point = rect.center();
+            aabbList = aabbScene.items(point);
+            linearList = linearScene.items(point);
+            QCOMPARE(aabbList.size(), linearList.size());
+            for (int i = 0; i < aabbList.size(); ++i)
+                QCOMPARE(aabbItems.indexOf(static_cast<QGraphicsRectItem *>(aabbList.at(i))),
+                         linearItems.indexOf(static_cast<QGraphicsRectItem *>(linearList.at(i))));
+        }
+    }
+
+    QCOMPARE(aabbScene.items().size(), aabbItems.size());
+}
+
+void tst_QGraphicsSceneIndex::aabbTreeHeight()
+{
+    QGraphicsScene scene;
+    scene.setItemIndexMethod(QGraphicsScene::AabbTreeIndex);
+    QGraphicsSceneAabbTreeIndex *index = scene.findChild<QGraphicsSceneAabbTreeIndex *>();
+    QVERIFY(index);
+    QCOMPARE(index->treeHeight(), 0);
+
+    // Inserted one by one along a line, the worst case for an unbalanced tree.
+    for (int i = 0; i < 1024; ++i) {
+        scene.addRect(0, 0, 10, 10)->setPos(i * 20, 0);
+        if (i % 16 == 0)
+            QCOMPARE(scene.items(QPointF(i * 20 + 5, 5)).size(), 1);
+    }
+    QVERIFY(index->treeHeight() > 10);
+    QVERIFY(index->treeHeight() <= 2 * 10 + 1);
+    QCOMPARE(scene.items(QRectF(100, 0, 1, 1)).size(), 1);
+    QCOMPARE(scene.items().size(), 1024);
+}
+
 QTEST_MAIN(tst_QGraphicsSceneIndex)
 #include "tst_qgraphicssceneindex.moc"
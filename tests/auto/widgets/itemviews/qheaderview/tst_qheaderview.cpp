@@ -208,6 +208,7 @@ private slots:
     void QTBUG50171_visualRegionForSwappedItems();
     void ensureNoIndexAtLength();
     void offsetConsistent();
+    void sectionPositionsAfterResizes();
 
     void initialSortOrderRole();
 
@@ -2316,6 +2317,60 @@ void tst_QHeaderView::offsetConsistent()
     QVERIFY(offset2 > offset1);
 }
 
+static void verifySectionPositions(const QHeaderView *hv)
+{
+    int position = 0;
+    for (int visual = 0; visual < hv->count(); ++visual) {
+        const int logical = hv->logicalIndex(visual);
+        const int size = hv->sectionSize(logical);
+        QCOMPARE(hv->sectionPosition(logical), position);
+        if (size > 0) {
+            QCOMPARE(hv->visualIndexAt(position), visual);
+            QCOMPARE(hv->visualIndexAt(position + size - 1), visual);
+        }
+        position += size;
+    }
+    QCOMPARE(hv->length(), position);
+    QCOMPARE(hv->visualIndexAt(position), -1);
+}
+
+void tst_QHeaderView::sectionPositionsAfterResizes()
+{
+    // Section start positions are shifted incrementally on resize;
+    // they must stay consistent with a linear walk over the sizes.
+    QStandardItemModel model(500, 1);
+    QTableView table;
+    table.setModel(&model);
+    QHeaderView *hv = table.verticalHeader();
+
+    hv->resizeSection(10, 50);
+    hv->resizeSection(5, 7);
+    hv->resizeSection(10, 3);
+    verifySectionPositions(hv);
+    QCOMPARE(hv->sectionPosition(11), hv->sectionPosition(10) + 3);
+
+    hv->hideSection(3);
+    hv->swapSections(20, 400);
+    hv->resizeSection(499, 100);
+    verifySectionPositions(hv);
+
+    // more distinct resizes than are remembered as shifts
+    for (int i = 0; i < 200; ++i) {
+        hv->resizeSection((i * 37) % 500, 5 + i % 13);
+        if (i % 50 == 0)
+            verifySectionPositions(hv);
+    }
+    verifySectionPositions(hv);
+
+    hv->moveSection(0, 250);
+    hv->showSection(3);
+    hv->resizeSection(hv->logicalIndex(251), 42);
+    verifySectionPositions(hv);
+    model.removeRows(100, 50);
+    hv->resizeSection(60, 1);
+    verifySectionPositions(hv);
+}
+
 void tst_QHeaderView::initialSortOrderRole()
 {
     QTableView view; // ### Shadowing member view (of type QHeaderView)
@@ -149,6 +149,8 @@ private slots:
     void horizontalScrollingByVerticalWheelEvents();
     void taskQTBUG_7232_AllowUserToControlSingleStep();
     void taskQTBUG_51086_skippingIndexesInSelectedIndexes();
+    void uniformLayout_data();
+    void uniformLayout();
 };
 
 // Testing get/set functions
@@ -2482,5 +2484,88 @@ void tst_QListView::taskQTBUG_51086_skippingIndexesInSelectedIndexes()
     QVERIFY(!indexes.contains(data.index(8, 0)));
 }
 
+void tst_QListView::uniformLayout_data()
+{
+    QTest::addColumn<int>("flow");
+    QTest::addColumn<bool>("wrapping");
+    QTest::addColumn<int>("spacing");
+    QTest::addColumn<int>("scrollMode");
+
+    for (int flow = QListView::LeftToRight; flow <= QListView::TopToBottom; ++flow) {
+        for (int wrapping = 0; wrapping < 2; ++wrapping) {
+            for (int spacing = 0; spacing <= 5; spacing += 5) {
+                for (int mode = QAbstractItemView::ScrollPerItem; mode <= QAbstractItemView::ScrollPerPixel; ++mode) {
+                    const QByteArray name = QByteArray(flow == QListView::LeftToRight ? "LeftToRight" : "TopToBottom")
+                        + (wrapping ? " wrapping" : "") + " spacing " + QByteArray::number(spacing)
+                        + (mode == QAbstractItemView::ScrollPerItem ? " per item" : " per pixel");
+                    QTest::newRow(name.constData()) << flow << bool(wrapping) << spacing << mode;
+                }
+            }
+        }
+    }
+}
+
+// The uniform item sizes layout is computed arithmetically; it has to
+// produce the same geometry as the per-item layout for equally sized items.
+void tst_QListView::uniformLayout()
+{
+    QFETCH(int, flow);
+    QFETCH(bool, wrapping);
+    QFETCH(int, spacing);
+    QFETCH(int, scrollMode);
+
+    QStringList list;
+    for (int i = 0; i < 200; ++i)
+        list << QString::number(i % 10);
+    QStringListModel model(list);
+
+    QWidget topLevel;
+    ListView_9455 views[2];
+    for (int i = 0; i < 2; ++i) {
+        ListView_9455 &view = views[i];
+        view.setParent(&topLevel);
+        view.setGeometry(i * 200, 0, 200, 150);
+        view.setUniformItemSizes(i == 1);
+        view.setFlow(static_cast<QListView::Flow>(flow));
+        view.setWrapping(wrapping);
+        view.setSpacing(spacing);
+        view.setVerticalScrollMode(static_cast<QAbstractItemView::ScrollMode>(scrollMode));
+        view.setHorizontalScrollMode(static_cast<QAbstractItemView::ScrollMode>(scrollMode));
+        view.setModel(&model);
+    }
+    topLevel.resize(400, 150);
+    topLevel.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+
+    ListView_9455 &reference = views[0];
+    ListView_9455 &uniform = views[1];
+    QCOMPARE(uniform.contentsSize(), reference.contentsSize());
+    if (scrollMode == QAbstractItemView::ScrollPerPixel) {
+        // per item, the page step is estimated differently for uniform item sizes
+        QCOMPARE(uniform.verticalScrollBar()->maximum(), reference.verticalScrollBar()->maximum());
+        QCOMPARE(uniform.horizontalScrollBar()->maximum(), reference.horizontalScrollBar()->maximum());
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            const int vertical = qMin(uniform.verticalScrollBar()->maximum(),
+                                      reference.verticalScrollBar()->maximum()) / 2;
+            const int horizontal = qMin(uniform.horizontalScrollBar()->maximum(),
+                                        reference.horizontalScrollBar()->maximum()) / 2;
+            reference.verticalScrollBar()->setValue(vertical);
+            uniform.verticalScrollBar()->setValue(vertical);
+            reference.horizontalScrollBar()->setValue(horizontal);
+            uniform.horizontalScrollBar()->setValue(horizontal);
+        }
+        for (int row = 0; row < model.rowCount(); ++row) {
+            const QModelIndex index = model.index(row, 0);
+            const QRect rect = reference.visualRect(index);
+            QCOMPARE(uniform.visualRect(index), rect);
+            if (uniform.viewport()->rect().contains(rect.center()))
+                QCOMPARE(uniform.indexAt(rect.center()), index);
+        }
+    }
+}
+
 QTEST_MAIN(tst_QListView)
 #include "tst_qlistview.moc"
@@ -211,6 +211,8 @@ private slots:
     void renderToPixmap();
     void styleOptionViewItem();
     void keyboardNavigationWithDisabled();
+    void appendRowsToExpandedParent();
+    void nonUniformRowHeightsPerPixel();
 
     // task-specific tests:
     void task174627_moveLeftToRoot();
@@ -4405,6 +4407,106 @@ void tst_QTreeView::taskQTBUG_45697_crash()
     QTRY_VERIFY(testWidget.timerTick() >= 2);
 }
 
+static void collectExpandedRows(const QAbstractItemModel *model, const QModelIndex &parent,
+                                QModelIndexList *rows)
+{
+    for (int row = 0; row < model->rowCount(parent); ++row) {
+        const QModelIndex index = model->index(row, 0, parent);
+        rows->append(index);
+        collectExpandedRows(model, index, rows);
+    }
+}
+
+void tst_QTreeView::appendRowsToExpandedParent()
+{
+    QStandardItemModel model;
+    for (int i = 0; i < 3; ++i) {
+        QStandardItem *item = new QStandardItem(QString("top %1").arg(i));
+        for (int j = 0; j < 3; ++j)
+            item->appendRow(new QStandardItem(QString("child %1.%2").arg(i).arg(j)));
+        model.appendRow(item);
+    }
+
+    QTreeView view;
+    view.setModel(&model);
+    view.expandAll();
+
+    // rows appended to expanded parents are laid out in place
+    model.item(1)->appendRow(new QStandardItem("child 1.3"));
+    model.item(1)->child(0)->appendRow(new QStandardItem("child 1.0.0"));
+    QList<QStandardItem *> grandChildren;
+    grandChildren << new QStandardItem("child 0.2.0") << new QStandardItem("child 0.2.1");
+    model.item(0)->child(2)->appendRows(grandChildren);
+    model.appendRow(new QStandardItem("top 3"));
+
+    QModelIndexList expected;
+    collectExpandedRows(&model, QModelIndex(), &expected);
+
+    QModelIndexList rows;
+    int previousTop = -1;
+    for (QModelIndex index = model.index(0, 0); index.isValid(); index = view.indexBelow(index)) {
+        rows.append(index);
+        const QRect rect = view.visualRect(index);
+        QVERIFY(rect.top() > previousTop);
+        previousTop = rect.top();
+        QCOMPARE(view.indexAt(rect.center()), index);
+    }
+    QCOMPARE(rows, expected);
+    QVERIFY(view.isExpanded(model.index(2, 0, model.index(0, 0))));
+    QCOMPARE(view.indexAbove(model.index(3, 0)), model.index(2, 0, model.index(2, 0)));
+    QCOMPARE(view.verticalScrollBar()->maximum() + view.verticalScrollBar()->pageStep(), expected.count());
+}
+
+void tst_QTreeView::nonUniformRowHeightsPerPixel()
+{
+    QStandardItemModel model;
+    for (int i = 0; i < 100; ++i) {
+        QStandardItem *item = new QStandardItem(QString::number(i));
+        item->setSizeHint(QSize(50, 10 + (i % 5) * 4));
+        model.appendRow(item);
+    }
+
+    QTreeView view;
+    view.setModel(&model);
+    view.setHeaderHidden(true);
+    view.setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    view.resize(200, 200);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    const auto checkRows = [&]() {
+        const int offset = view.verticalScrollBar()->value();
+        int top = 0;
+        for (int i = 0; i < model.rowCount(); ++i) {
+            const QModelIndex index = model.index(i, 0);
+            const int height = model.item(i)->sizeHint().height();
+            const QRect rect = view.visualRect(index);
+            QCOMPARE(rect.top(), top - offset);
+            QCOMPARE(rect.height(), height);
+            if (rect.bottom() >= 0 && rect.top() < view.viewport()->height()) {
+                QCOMPARE(view.indexAt(QPoint(5, rect.top() + 1)), index);
+                QCOMPARE(view.indexAt(QPoint(5, rect.bottom())), index);
+                // the top edge of a row belongs to the row above it
+                if (i > 0)
+                    QCOMPARE(view.indexAt(QPoint(5, rect.top())), model.index(i - 1, 0));
+            }
+            top += height;
+        }
+        QCOMPARE(view.verticalScrollBar()->maximum(), top - view.viewport()->height());
+    };
+
+    checkRows();
+    view.verticalScrollBar()->setValue(333);
+    checkRows();
+    model.item(3)->setSizeHint(QSize(50, 40));
+    checkRows();
+    model.removeRow(10);
+    QApplication::processEvents();
+    checkRows();
+    view.verticalScrollBar()->setValue(view.verticalScrollBar()->maximum());
+    checkRows();
+}
+
 void tst_QTreeView::taskQTBUG_7232_AllowUserToControlSingleStep()
 {
     // When we set the scrollMode to ScrollPerPixel it will adjust the scrollbars singleStep automatically
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qwidgetrepaintprofiler
+QT += widgets widgets-private testlib
+SOURCES += tst_qwidgetrepaintprofiler.cpp
@@ -0,0 +1,212 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtWidgets/QWidget>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+
+#include <private/qwidgetrepaintprofiler_p.h>
+
+class PaintCountWidget : public QWidget
+{
+public:
+    PaintCountWidget(QWidget *parent = 0) : QWidget(parent), paints(0) {}
+    int paints;
+
+protected:
+    void paintEvent(QPaintEvent *) Q_DECL_OVERRIDE { ++paints; }
+};
+
+class tst_QWidgetRepaintProfiler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void recordsFrames();
+    void ringBuffer();
+    void chromeTrace();
+
+private:
+    QWidgetRepaintProfiler *profiler;
+};
+
+void tst_QWidgetRepaintProfiler::init()
+{
+    QWidgetRepaintProfiler::setEnabled(true);
+    profiler = QWidgetRepaintProfiler::instance();
+    profiler->clear();
+}
+
+void tst_QWidgetRepaintProfiler::cleanup()
+{
+    QWidgetRepaintProfiler::setEnabled(false);
+    profiler->setCapacity(8192);
+    profiler->clear();
+}
+
+static QVector<QWidgetRepaintProfiler::Event> eventsOfType(QWidgetRepaintProfiler *profiler,
+                                                          QWidgetRepaintProfiler::EventType type)
+{
+    QVector<QWidgetRepaintProfiler::Event> result;
+    const QVector<QWidgetRepaintProfiler::Event> events = profiler->events();
+    for (const QWidgetRepaintProfiler::Event &event : events) {
+        if (event.type == type)
+            result.append(event);
+    }
+    return result;
+}
+
+void tst_QWidgetRepaintProfiler::recordsFrames()
+{
+    QWidget window;
+    window.setObjectName(QStringLiteral("window"));
+    window.resize(200, 200);
+    PaintCountWidget child(&window);
+    child.setObjectName(QStringLiteral("child"));
+    child.setGeometry(10, 10, 50, 50);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_VERIFY(child.paints > 0);
+    QTRY_VERIFY(!eventsOfType(profiler, QWidgetRepaintProfiler::Flush).isEmpty());
+
+    profiler->clear();
+    const int paints = child.paints;
+    child.update(0, 0, 20, 10);
+    QTRY_VERIFY(child.paints > paints);
+    QTRY_VERIFY(!eventsOfType(profiler, QWidgetRepaintProfiler::Frame).isEmpty());
+
+    const QVector<QWidgetRepaintProfiler::Event> paintEvents = eventsOfType(profiler, QWidgetRepaintProfiler::Paint);
+    const QVector<QWidgetRepaintProfiler::Event> frames = eventsOfType(profiler, QWidgetRepaintProfiler::Frame);
+    QVERIFY(!paintEvents.isEmpty());
+    QCOMPARE(frames.size(), 1);
+
+    const QWidgetRepaintProfiler::Event &frame = frames.first();
+    QCOMPARE(frame.widget, quintptr(&window));
+    QCOMPARE(frame.boundingRect, QRect(10, 10, 20, 10));
+    QCOMPARE(frame.area, qint64(200));
+
+    bool childPainted = false;
+    qint64 paintedArea = 0;
+    for (const QWidgetRepaintProfiler::Event &paint : paintEvents) {
+        QCOMPARE(paint.frame, frame.frame);
+        QVERIFY(paint.start >= frame.start);
+        QVERIFY(paint.start + paint.duration <= frame.start + frame.duration);
+        paintedArea += paint.area;
+        if (paint.widget == quintptr(&child)) {
+            childPainted = true;
+            QCOMPARE(paint.objectName, QStringLiteral("child"));
+            QCOMPARE(paint.boundingRect, QRect(0, 0, 20, 10));
+        }
+    }
+    QVERIFY(childPainted);
+    QCOMPARE(frame.paintedArea, paintedArea);
+    QCOMPARE(frame.paintCount, paintEvents.size());
+
+    QWidgetRepaintProfiler::setEnabled(false);
+    profiler->clear();
+    child.update();
+    QTRY_VERIFY(child.paints > paints + 1);
+    QVERIFY(profiler->events().isEmpty());
+}
+
+void tst_QWidgetRepaintProfiler::ringBuffer()
+{
+    profiler->setCapacity(4);
+
+    QWidget window;
+    window.resize(100, 100);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    for (int i = 0; i < 5; ++i) {
+        window.repaint();
+        QCoreApplication::processEvents();
+    }
+
+    const QVector<QWidgetRepaintProfiler::Event> events = profiler->events();
+    QCOMPARE(events.size(), 4);
+    // events are recorded when they end, a frame after the paints it contains
+    for (int i = 1; i < events.size(); ++i) {
+        QVERIFY(events.at(i).start + events.at(i).duration
+                >= events.at(i - 1).start + events.at(i - 1).duration);
+    }
+
+    profiler->setCapacity(2);
+    const QVector<QWidgetRepaintProfiler::Event> kept = profiler->events();
+    QCOMPARE(kept.size(), 2);
+    QCOMPARE(kept.at(0).start, events.at(2).start);
+    QCOMPARE(kept.at(1).start, events.at(3).start);
+}
+
+void tst_QWidgetRepaintProfiler::chromeTrace()
+{
+    QWidget window;
+    window.setObjectName(QStringLiteral("traced"));
+    window.resize(100, 100);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_VERIFY(!eventsOfType(profiler, QWidgetRepaintProfiler::Frame).isEmpty());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/trace.json");
+    QVERIFY(profiler->writeChromeTrace(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonArray traceEvents = document.object().value(QStringLiteral("traceEvents")).toArray();
+    QVERIFY(traceEvents.size() > 1);
+    QSet<QString> categories;
+    bool foundWidget = false;
+    for (const QJsonValue &value : traceEvents) {
+        const QJsonObject event = value.toObject();
+        if (event.value(QStringLiteral("ph")).toString() != QLatin1String("X"))
+            continue;
+        QVERIFY(event.contains(QStringLiteral("ts")));
+        QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 0);
+        categories.insert(event.value(QStringLiteral("cat")).toString());
+        if (event.value(QStringLiteral("name")).toString() == QLatin1String("QWidget/traced"))
+            foundWidget = true;
+    }
+    QVERIFY(foundWidget);
+    QVERIFY(categories.contains(QStringLiteral("frame")));
+    QVERIFY(categories.contains(QStringLiteral("paint")));
+    QVERIFY(categories.contains(QStringLiteral("flush")));
+}
+
+QTEST_MAIN(tst_QWidgetRepaintProfiler)
+#include "tst_qwidgetrepaintprofiler.moc"
@@ -58,6 +58,7 @@ private slots:
     void widgetStyleSheet();
     void reparentWithNoChildStyleSheet();
     void reparentWithChildStyleSheet();
+    void repolishOnlyAffectedWidgets();
     void dynamicProperty();
     // NB! Invoking this slot after layoutSpacing crashes on Mac.
     void namespaces();
@@ -548,6 +549,63 @@ void tst_QStyleSheetStyle::appStyle()
     QCOMPARE(QApplication::style(), style1.data());
 }
 
+class StyleChangeCounter : public QObject
+{
+public:
+    StyleChangeCounter(QWidget *w) : count(0) { w->installEventFilter(this); }
+    bool eventFilter(QObject *, QEvent *e) Q_DECL_OVERRIDE
+    {
+        if (e->type() == QEvent::StyleChange)
+            ++count;
+        return false;
+    }
+    int count;
+};
+
+void tst_QStyleSheetStyle::repolishOnlyAffectedWidgets()
+{
+    const QColor red(Qt::red);
+    const QColor blue(Qt::blue);
+    qApp->setStyleSheet("");
+    QWidget parent;
+    QPushButton *affected = new QPushButton(&parent);
+    affected->setObjectName("affected");
+    QPushButton *unaffected = new QPushButton(&parent);
+    unaffected->setObjectName("unaffected");
+    parent.setStyleSheet("QPushButton#affected { color: red }");
+    parent.ensurePolished();
+    QCOMPARE(COLOR(*affected), red);
+    QCOMPARE(COLOR(*unaffected), APPCOLOR(*unaffected));
+
+    StyleChangeCounter affectedCounter(affected);
+    StyleChangeCounter unaffectedCounter(unaffected);
+    parent.setStyleSheet("QPushButton#affected { color: blue }");
+    QCOMPARE(COLOR(*affected), blue);
+    QCOMPARE(COLOR(*unaffected), APPCOLOR(*unaffected));
+    QCOMPARE(affectedCounter.count, 1);
+    QCOMPARE(unaffectedCounter.count, 0);
+
+    parent.setStyleSheet("QPushButton { color: red }");
+    QCOMPARE(COLOR(*affected), red);
+    QCOMPARE(COLOR(*unaffected), red);
+    QCOMPARE(affectedCounter.count, 2);
+    QCOMPARE(unaffectedCounter.count, 1);
+
+    // Changing an unrelated rule of the application style sheet parses the
+    // whole sheet again, but leaves widgets with the same rules alone.
+    parent.setStyleSheet(QString());
+    qApp->setStyleSheet("QPushButton#affected { color: red } QLabel { color: blue }");
+    QCOMPARE(COLOR(*affected), red);
+    const int affectedCount = affectedCounter.count;
+    qApp->setStyleSheet("QPushButton#affected { color: red } QLabel { color: green }");
+    QCOMPARE(COLOR(*affected), red);
+    QCOMPARE(affectedCounter.count, affectedCount);
+    qApp->setStyleSheet("QPushButton#affected { color: blue } QLabel { color: green }");
+    QCOMPARE(COLOR(*affected), blue);
+    QCOMPARE(affectedCounter.count, affectedCount + 1);
+    qApp->setStyleSheet(QString());
+}
+
 void tst_QStyleSheetStyle::dynamicProperty()
 {
     qApp->setStyleSheet(QString());
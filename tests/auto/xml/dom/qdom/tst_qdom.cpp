@@ -115,6 +115,8 @@ private slots:
     void DTDNotationDecl();
     void DTDEntityDecl();
     void QTBUG49113_dontCrashWithNegativeIndex() const;
+    void attributesOfElementWithoutAttributes() const;
+    void sharedNamesAreIndependent() const;
 
     void cleanupTestCase() const;
 
@@ -1983,5 +1985,49 @@ void tst_QDom::QTBUG49113_dontCrashWithNegativeIndex() const
     QVERIFY(node.isNull());
 }
 
+void tst_QDom::attributesOfElementWithoutAttributes() const
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(QByteArray("<root><a/><b x=\"1\"/></root>")));
+    QDomElement a = doc.documentElement().firstChildElement("a");
+    QVERIFY(!a.hasAttributes());
+    QVERIFY(!a.hasAttribute("x"));
+    QCOMPARE(a.attribute("x", "none"), QString("none"));
+    QVERIFY(a.attributeNode("x").isNull());
+    a.removeAttribute("x");
+
+    // The map returned for an element without attributes must stay live.
+    QDomNamedNodeMap map = a.attributes();
+    QCOMPARE(map.count(), 0);
+    a.setAttribute("y", "2");
+    QCOMPARE(map.count(), 1);
+    QCOMPARE(map.namedItem("y").nodeValue(), QString("2"));
+
+    QDomElement clone = doc.documentElement().cloneNode(true).toElement();
+    QVERIFY(!clone.hasAttributes());
+    QCOMPARE(clone.firstChildElement("a").attribute("y"), QString("2"));
+    QCOMPARE(clone.firstChildElement("b").attribute("x"), QString("1"));
+    clone.setAttributeNS("urn:test", "t:z", "3");
+    QCOMPARE(clone.attributeNS("urn:test", "z"), QString("3"));
+}
+
+void tst_QDom::sharedNamesAreIndependent() const
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(QByteArray("<root xmlns:p=\"urn:p\"><p:item name=\"1\"/><p:item name=\"2\"/></root>"), true));
+    QDomElement first = doc.documentElement().firstChildElement();
+    QDomElement second = first.nextSiblingElement();
+    QCOMPARE(first.localName(), QString("item"));
+    QCOMPARE(second.prefix(), QString("p"));
+
+    first.setPrefix("q");
+    first.setTagName("other");
+    QCOMPARE(first.prefix(), QString("q"));
+    QCOMPARE(second.prefix(), QString("p"));
+    QCOMPARE(second.localName(), QString("item"));
+    QCOMPARE(second.namespaceURI(), QString("urn:p"));
+    QCOMPARE(second.attribute("name"), QString("2"));
+}
+
 QTEST_MAIN(tst_QDom)
 #include "tst_qdom.moc"
@@ -7,7 +7,8 @@ SUBDIRS = \
         thread \
         tools \
         codecs \
-        plugin
+        plugin \
+        xml
 
 TRUSTED_BENCHMARKS += \
     kernel/qmetaobject \
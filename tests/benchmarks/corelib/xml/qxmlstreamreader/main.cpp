@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QXmlStreamReader>
+#include <qtest.h>
+
+class tst_QXmlStreamReader : public QObject
+{
+    Q_OBJECT
+private slots:
+    void read_data() const;
+    void read() const;
+    void readDevice_data() const;
+    void readDevice() const;
+    void readString_data() const;
+    void readString() const;
+};
+
+// Generates a document of roughly size bytes with records made of text,
+// attributes or markup.
+static QByteArray generateDocument(const QByteArray &kind, int size)
+{
+    const QString sentence = QString::fromUtf8("The quick brown fox jumps over the lazy dog, "
+                                               "und der Hund schl\xc3\xa4""ft weiter. ");
+    QString document = QLatin1String("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>\n");
+    for (int i = 0; document.size() < size; ++i) {
+        if (kind == "text") {
+            document += QLatin1String("<entry>");
+            for (int j = 0; j < 20; ++j)
+                document += sentence;
+            document += QLatin1String("&amp; more</entry>\n");
+        } else if (kind == "attributes") {
+            document += QString::fromLatin1("<entry id=\"%1\" title=\"%2\" summary=\"%2\" link=\"http://example.com/feed/%1\"/>\n")
+                    .arg(i).arg(sentence);
+        } else {
+            document += QString::fromLatin1("<entry id=\"%1\"><a><b>x</b><c/></a><d>%1</d></entry>\n").arg(i);
+        }
+    }
+    document += QLatin1String("</feed>\n");
+    return document.toUtf8();
+}
+
+static void addDocuments()
+{
+    QTest::addColumn<QByteArray>("document");
+
+    const int size = 4 * 1024 * 1024;
+    QTest::newRow("text") << generateDocument("text", size);
+    QTest::newRow("attributes") << generateDocument("attributes", size);
+    QTest::newRow("markup") << generateDocument("markup", size);
+}
+
+static void readAll(QXmlStreamReader &reader)
+{
+    while (!reader.atEnd())
+        reader.readNext();
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+}
+
+void tst_QXmlStreamReader::read_data() const
+{
+    addDocuments();
+}
+
+void tst_QXmlStreamReader::read() const
+{
+    QFETCH(QByteArray, document);
+
+    QBENCHMARK {
+        QXmlStreamReader reader(document);
+        readAll(reader);
+    }
+}
+
+void tst_QXmlStreamReader::readDevice_data() const
+{
+    addDocuments();
+}
+
+void tst_QXmlStreamReader::readDevice() const
+{
+    QFETCH(QByteArray, document);
+
+    QBENCHMARK {
+        QBuffer buffer(&document);
+        buffer.open(QIODevice::ReadOnly);
+        QXmlStreamReader reader(&buffer);
+        readAll(reader);
+    }
+}
+
+void tst_QXmlStreamReader::readString_data() const
+{
+    addDocuments();
+}
+
+void tst_QXmlStreamReader::readString() const
+{
+    QFETCH(QByteArray, document);
+    const QString string = QString::fromUtf8(document);
+
+    QBENCHMARK {
+        QXmlStreamReader reader(string);
+        readAll(reader);
+    }
+}
+
+QTEST_MAIN(tst_QXmlStreamReader)
+
+#include "main.moc"
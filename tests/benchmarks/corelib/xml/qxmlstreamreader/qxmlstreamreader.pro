@@ -0,0 +1,3 @@
+TARGET = tst_bench_qxmlstreamreader
+QT = core testlib
+SOURCES += main.cpp
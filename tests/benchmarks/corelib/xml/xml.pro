@@ -0,0 +1,2 @@
+TEMPLATE = subdirs
+SUBDIRS = qxmlstreamreader
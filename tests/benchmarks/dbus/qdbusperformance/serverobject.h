@@ -66,6 +66,18 @@ public slots:
     {
         return data.size();
     }
+    int size(const QDBusUnixFileDescriptor &data)
+    {
+        return data.mappedData().size();
+    }
+    int size(const QList<int> &data)
+    {
+        return data.size() * int(sizeof(int));
+    }
+    int size(const QList<double> &data)
+    {
+        return data.size() * int(sizeof(double));
+    }
     int size(const QDBusVariant &data)
     {
         QVariant v = data.variant();
@@ -89,6 +101,18 @@ public slots:
     {
         return data;
     }
+    QDBusUnixFileDescriptor echo(const QDBusUnixFileDescriptor &data)
+    {
+        return data;
+    }
+    QList<int> echo(const QList<int> &data)
+    {
+        return data;
+    }
+    QList<double> echo(const QList<double> &data)
+    {
+        return data;
+    }
     QDBusVariant echo(const QDBusVariant &data)
     {
         return data;
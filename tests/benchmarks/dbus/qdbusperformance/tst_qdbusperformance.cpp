@@ -44,6 +44,7 @@ class tst_QDBusPerformance: public QObject
     QDBusInterface *local;
 
     bool executeTest(const char *funcname, int size, const QVariant &data);
+    bool executeMappedTest(const char *funcname, const QByteArray &data);
 
 public slots:
     void initTestCase_data();
@@ -62,6 +63,9 @@ private slots:
     void roundTrip();
     void roundTripVariant_data();
     void roundTripVariant();
+
+    void payloadSweep_data();
+    void payloadSweep();
 };
 
 void tst_QDBusPerformance::initTestCase()
@@ -149,6 +153,34 @@ bool tst_QDBusPerformance::executeTest(const char *funcname, int size, const QVa
     return true;
 }
 
+// Like executeTest(), but creates a new memory file for every call, so that
+// the cost of copying the payload into it is included.
+bool tst_QDBusPerformance::executeMappedTest(const char *funcname, const QByteArray &data)
+{
+    QElapsedTimer timer;
+
+    int callCount = 0;
+    qint64 transferred = 0;
+    timer.start();
+    while (timer.elapsed() < runTime) {
+        const QDBusUnixFileDescriptor fd = QDBusUnixFileDescriptor::fromData(data);
+        QDBusMessage reply = target->call(funcname, QVariant::fromValue(fd));
+        if (reply.type() != QDBusMessage::ReplyMessage)
+            return false;
+        if (reply.arguments().value(0).userType() == qMetaTypeId<QDBusUnixFileDescriptor>()
+                && qvariant_cast<QDBusUnixFileDescriptor>(reply.arguments().at(0)).mappedData().size() != data.size())
+            return false;
+
+        transferred += data.size();
+        ++callCount;
+    }
+    qDebug() << transferred << "bytes in" << timer.elapsed() << "ms"
+             << "(in" << callCount << "calls):"
+             << (transferred * 1000.0 / timer.elapsed() / 1024 / 1024) << "MB/s";
+
+    return true;
+}
+
 void tst_QDBusPerformance::oneWay_data()
 {
     QTest::addColumn<QVariant>("data");
@@ -214,5 +246,50 @@ void tst_QDBusPerformance::roundTripVariant()
     QVERIFY(executeTest("echo", size, QVariant::fromValue(QDBusVariant(data))));
 }
 
+void tst_QDBusPerformance::payloadSweep_data()
+{
+    QTest::addColumn<QString>("kind");
+    QTest::addColumn<QByteArray>("function");
+    QTest::addColumn<int>("size");
+
+    const QByteArray functions[] = { "size", "echo" };
+    const char *kinds[] = { "byteArray", "memfd", "intList", "doubleList" };
+    for (const QByteArray &function : functions) {
+        for (int size = 1024; size <= 16 * 1024 * 1024; size *= 4) {
+            for (const char *kind : kinds) {
+                QTest::newRow(QString("%1-%2-%3").arg(function.constData()).arg(size).arg(kind).toLatin1())
+                        << QString::fromLatin1(kind) << function << size;
+            }
+        }
+    }
+}
+
+void tst_QDBusPerformance::payloadSweep()
+{
+    QFETCH(QString, kind);
+    QFETCH(QByteArray, function);
+    QFETCH(int, size);
+
+    if (kind == QLatin1String("memfd")) {
+        if (!(target->connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing))
+            QSKIP("Your session bus does not allow sending Unix file descriptors");
+        QVERIFY(executeMappedTest(function, QByteArray(size, 'a')));
+    } else if (kind == QLatin1String("intList")) {
+        QList<int> list;
+        list.reserve(size / int(sizeof(int)));
+        for (int i = 0; i < size / int(sizeof(int)); ++i)
+            list << i;
+        QVERIFY(executeTest(function, size, QVariant::fromValue(list)));
+    } else if (kind == QLatin1String("doubleList")) {
+        QList<double> list;
+        list.reserve(size / int(sizeof(double)));
+        for (int i = 0; i < size / int(sizeof(double)); ++i)
+            list << i * 0.5;
+        QVERIFY(executeTest(function, size, QVariant::fromValue(list)));
+    } else {
+        QVERIFY(executeTest(function, size, QVariant::fromValue(QByteArray(size, 'a'))));
+    }
+}
+
 QTEST_MAIN(tst_QDBusPerformance)
 #include "tst_qdbusperformance.moc"
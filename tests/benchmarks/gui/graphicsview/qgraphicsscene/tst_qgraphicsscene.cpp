@@ -49,6 +49,8 @@ private slots:
     void addItem();
     void itemAt_data();
     void itemAt();
+    void moveAndQuery_data();
+    void moveAndQuery();
     void initialShow();
 };
 
@@ -224,6 +226,78 @@ void tst_QGraphicsScene::itemAt()
     qApp->processEvents();
 }
 
+void tst_QGraphicsScene::moveAndQuery_data()
+{
+    QTest::addColumn<int>("indexMethod");
+    QTest::addColumn<int>("numItems_X");
+    QTest::addColumn<int>("numItems_Y");
+    QTest::addColumn<int>("moveEvery");
+
+    const struct {
+        const char *name;
+        QGraphicsScene::ItemIndexMethod method;
+    } methods[] = {
+        { "NoIndex", QGraphicsScene::NoIndex },
+        { "BspTreeIndex", QGraphicsScene::BspTreeIndex },
+        { "AabbTreeIndex", QGraphicsScene::AabbTreeIndex }
+    };
+
+    for (const auto &m : methods) {
+        const QByteArray name(m.name);
+        QTest::newRow(name + " 100x100 static") << int(m.method) << 100 << 100 << 0;
+        QTest::newRow(name + " 100x100 1% moving") << int(m.method) << 100 << 100 << 100;
+        QTest::newRow(name + " 100x100 all moving") << int(m.method) << 100 << 100 << 1;
+        QTest::newRow(name + " 250x250 static") << int(m.method) << 250 << 250 << 0;
+        QTest::newRow(name + " 250x250 1% moving") << int(m.method) << 250 << 250 << 100;
+        QTest::newRow(name + " 250x250 all moving") << int(m.method) << 250 << 250 << 1;
+    }
+}
+
+void tst_QGraphicsScene::moveAndQuery()
+{
+    QFETCH(int, indexMethod);
+    QFETCH(int, numItems_X);
+    QFETCH(int, numItems_Y);
+    QFETCH(int, moveEvery);
+
+    QGraphicsScene scene;
+    scene.setItemIndexMethod(QGraphicsScene::ItemIndexMethod(indexMethod));
+
+    QList<QGraphicsItem *> movingItems;
+    for (int y = 0; y < numItems_Y; ++y) {
+        for (int x = 0; x < numItems_X; ++x) {
+            QGraphicsRectItem *item = scene.addRect(0, 0, 10, 10);
+            item->setPos(x * 20, y * 20);
+            if (moveEvery && (y * numItems_X + x) % moveEvery == 0)
+                movingItems << item;
+        }
+    }
+
+    scene.items(QPointF(0, 0)); // triggers indexing
+    processEvents();
+
+    const qreal width = numItems_X * 20;
+    const qreal height = numItems_Y * 20;
+    qreal step = 3;
+    QBENCHMARK {
+        // Items move back and forth, as in an animation.
+        step = -step;
+        for (QGraphicsItem *item : qAsConst(movingItems))
+            item->moveBy(step, step);
+
+        // One frame's worth of lookups: exposed areas and hit tests.
+        for (int i = 0; i < 50; ++i) {
+            const qreal x = (i * 37 % 50) * width / 50;
+            const qreal y = (i * 13 % 50) * height / 50;
+            scene.items(QRectF(x, y, 100, 100));
+            scene.items(QPointF(x + 5, y + 5));
+        }
+    }
+
+    //let QGraphicsScene::_q_polishItems be called so ~QGraphicsItem doesn't spend all his time cleaning the unpolished list
+    qApp->processEvents();
+}
+
 void tst_QGraphicsScene::initialShow()
 {
     QGraphicsScene scene;
@@ -1,4 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qlistview \
         qtableview \
+        qtreeview \
         qheaderview
@@ -29,6 +29,19 @@
 #include <QtTest/QtTest>
 #include <QtWidgets/QtWidgets>
 
+class ManyRowsModel : public QAbstractTableModel
+{
+public:
+    explicit ManyRowsModel(int rows) : m_rows(rows) {}
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : m_rows; }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : 1; }
+    QVariant data(const QModelIndex &, int) const override { return QVariant(); }
+private:
+    int m_rows;
+};
+
 class BenchQHeaderView : public QObject
 {
     Q_OBJECT
@@ -64,6 +77,7 @@ private slots:
     void removeBench_data()            {setupTestData();}
     void insertBench_data()            {setupTestData();}
     void truncBench_data()             {setupTestData();}
+    void manySectionsResize_data()     {setupTestData();}
 
     void visualIndexAtSpecial();
     void visualIndexAt();
@@ -74,6 +88,7 @@ private slots:
     void removeBench();
     void insertBench();
     void truncBench();
+    void manySectionsResize();
 };
 
 void BenchQHeaderView::setupTestData()
@@ -154,6 +169,28 @@ void BenchQHeaderView::visualIndexAtSpecial()
     }
 }
 
+void BenchQHeaderView::manySectionsResize()
+{
+    // resizing single sections and looking up positions far behind them
+    ManyRowsModel model(1000000);
+    QHeaderView hv(Qt::Vertical);
+    hv.setModel(&model);
+    hv.setDefaultSectionSize(25);
+    if (m_worst_case) {
+        hv.swapSections(0, model.rowCount() - 1);
+        hv.hideSection(model.rowCount() / 2);
+    }
+    const int lookup_pos = hv.length() - 50;
+    int testnum = 0;
+
+    QBENCHMARK {
+        ++testnum;
+        hv.resizeSection((testnum * 7919) % 1000, 10 + testnum % 31);
+        hv.visualIndexAt(lookup_pos);
+        hv.sectionPosition(model.rowCount() / 3);
+    }
+}
+
 void BenchQHeaderView::visualIndexAt()
 {
     const int center_pos = m_hv->length() / 2;
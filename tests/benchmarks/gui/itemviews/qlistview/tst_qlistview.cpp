@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QListView>
+#include <QAbstractListModel>
+#include <QScrollBar>
+
+class CountingModel : public QAbstractListModel
+{
+public:
+    CountingModel(int rows, QObject *parent = 0)
+        : QAbstractListModel(parent), row_count(rows) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const
+    { return parent.isValid() ? 0 : row_count; }
+
+    QVariant data(const QModelIndex &index, int role) const
+    {
+        if (role == Qt::DisplayRole)
+            return QString::number(index.row());
+        return QVariant();
+    }
+
+private:
+    int row_count;
+};
+
+class tst_QListView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void layout_data();
+    void layout();
+    void scrollToBottom_data();
+    void scrollToBottom();
+};
+
+static void addLayoutData()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<bool>("uniformItemSizes");
+    QTest::addColumn<bool>("wrapping");
+
+    const int rowCounts[] = { 1000, 100000, 1000000 };
+    for (int rows : rowCounts) {
+        for (int uniform = 0; uniform < 2; ++uniform) {
+            // the per-item layout of a million rows takes too long to be useful
+            if (!uniform && rows > 100000)
+                continue;
+            for (int wrapping = 0; wrapping < 2; ++wrapping) {
+                const QByteArray name = QByteArray::number(rows) + " rows"
+                        + (uniform ? " uniform" : "") + (wrapping ? " wrapping" : "");
+                QTest::newRow(name.constData()) << rows << bool(uniform) << bool(wrapping);
+            }
+        }
+    }
+}
+
+static void setupView(QListView *view, QAbstractItemModel *model, bool uniform, bool wrapping)
+{
+    view->setUniformItemSizes(uniform);
+    view->setWrapping(wrapping);
+    view->setFlow(wrapping ? QListView::LeftToRight : QListView::TopToBottom);
+    view->resize(400, 400);
+    view->setModel(model);
+}
+
+void tst_QListView::layout_data()
+{
+    addLayoutData();
+}
+
+void tst_QListView::layout()
+{
+    QFETCH(int, rowCount);
+    QFETCH(bool, uniformItemSizes);
+    QFETCH(bool, wrapping);
+
+    CountingModel model(rowCount);
+    QListView view;
+    setupView(&view, &model, uniformItemSizes, wrapping);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QBENCHMARK {
+        view.doItemsLayout();
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_QListView::scrollToBottom_data()
+{
+    addLayoutData();
+}
+
+void tst_QListView::scrollToBottom()
+{
+    QFETCH(int, rowCount);
+    QFETCH(bool, uniformItemSizes);
+    QFETCH(bool, wrapping);
+
+    CountingModel model(rowCount);
+    QListView view;
+    setupView(&view, &model, uniformItemSizes, wrapping);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QBENCHMARK {
+        view.scrollToTop();
+        QCoreApplication::processEvents();
+        view.scrollToBottom();
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(tst_QListView)
+#include "tst_qlistview.moc"
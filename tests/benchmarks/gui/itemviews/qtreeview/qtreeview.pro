@@ -0,0 +1,6 @@
+QT += widgets testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qtreeview
+
+SOURCES += tst_qtreeview.cpp
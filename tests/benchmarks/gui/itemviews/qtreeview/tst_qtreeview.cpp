@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QDebug>
+
+#include <qtest.h>
+#include <QTreeView>
+#include <QImage>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStandardItemModel>
+
+class tst_QTreeView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void expandAll_data();
+    void expandAll();
+    void scroll_data();
+    void scroll();
+    void insert_data();
+    void insert();
+
+private:
+    static void populate(QStandardItemModel *model, int topLevelRows, int childRows,
+                         bool uniformHeights = true);
+};
+
+void tst_QTreeView::populate(QStandardItemModel *model, int topLevelRows, int childRows,
+                             bool uniformHeights)
+{
+    QList<QStandardItem *> topLevelItems;
+    topLevelItems.reserve(topLevelRows);
+    for (int i = 0; i < topLevelRows; ++i) {
+        QStandardItem *item = new QStandardItem(QString::number(i));
+        QList<QStandardItem *> children;
+        children.reserve(childRows);
+        for (int j = 0; j < childRows; ++j) {
+            QStandardItem *child = new QStandardItem(QString::number(j));
+            if (!uniformHeights)
+                child->setSizeHint(QSize(100, 16 + (j % 3) * 4));
+            children.append(child);
+        }
+        item->appendRows(children);
+        topLevelItems.append(item);
+    }
+    model->invisibleRootItem()->appendRows(topLevelItems);
+}
+
+void tst_QTreeView::expandAll_data()
+{
+    QTest::addColumn<int>("topLevelRows");
+    QTest::addColumn<int>("childRows");
+
+    QTest::newRow("100x100") << 100 << 100;
+    QTest::newRow("1000x100") << 1000 << 100;
+    QTest::newRow("100x1000") << 100 << 1000;
+}
+
+void tst_QTreeView::expandAll()
+{
+    QFETCH(int, topLevelRows);
+    QFETCH(int, childRows);
+
+    QStandardItemModel model;
+    populate(&model, topLevelRows, childRows);
+    QTreeView view;
+    view.setUniformRowHeights(true);
+    view.setModel(&model);
+
+    QBENCHMARK {
+        view.expandAll();
+    }
+}
+
+void tst_QTreeView::scroll_data()
+{
+    QTest::addColumn<bool>("uniformHeights");
+    QTest::addColumn<QAbstractItemView::ScrollMode>("scrollMode");
+
+    QTest::newRow("uniform, per item") << true << QAbstractItemView::ScrollPerItem;
+    QTest::newRow("uniform, per pixel") << true << QAbstractItemView::ScrollPerPixel;
+    QTest::newRow("non-uniform, per item") << false << QAbstractItemView::ScrollPerItem;
+    QTest::newRow("non-uniform, per pixel") << false << QAbstractItemView::ScrollPerPixel;
+}
+
+void tst_QTreeView::scroll()
+{
+    QFETCH(bool, uniformHeights);
+    QFETCH(QAbstractItemView::ScrollMode, scrollMode);
+
+    QStandardItemModel model;
+    populate(&model, 100, 1000, uniformHeights);
+    QTreeView view;
+    view.setUniformRowHeights(uniformHeights);
+    view.setVerticalScrollMode(scrollMode);
+    view.setModel(&model);
+    view.resize(400, 600);
+    view.expandAll();
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QImage image(view.size(), QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QScrollBar *scrollBar = view.verticalScrollBar();
+    const int steps = 50;
+    QBENCHMARK {
+        for (int i = 0; i <= steps; ++i) {
+            scrollBar->setValue(scrollBar->maximum() / steps * i);
+            view.render(&painter);
+        }
+    }
+}
+
+void tst_QTreeView::insert_data()
+{
+    QTest::addColumn<bool>("uniformHeights");
+    QTest::addColumn<bool>("append");
+
+    QTest::newRow("uniform, append") << true << true;
+    QTest::newRow("uniform, prepend") << true << false;
+    QTest::newRow("non-uniform, append") << false << true;
+    QTest::newRow("non-uniform, prepend") << false << false;
+}
+
+void tst_QTreeView::insert()
+{
+    QFETCH(bool, uniformHeights);
+    QFETCH(bool, append);
+
+    QStandardItemModel model;
+    populate(&model, 100, 1000, uniformHeights);
+    QTreeView view;
+    view.setUniformRowHeights(uniformHeights);
+    view.setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    view.setModel(&model);
+    view.resize(400, 600);
+    view.expandAll();
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QStandardItem *parent = model.item(model.rowCount() / 2);
+    int row = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 10; ++i) {
+            QStandardItem *item = new QStandardItem(QString::number(row++));
+            if (append)
+                parent->appendRow(item);
+            else
+                parent->insertRow(0, item);
+            // force the pending layout, if any, like the next paint event would
+            view.indexAt(QPoint(0, 0));
+        }
+    }
+}
+
+QTEST_MAIN(tst_QTreeView)
+#include "tst_qtreeview.moc"
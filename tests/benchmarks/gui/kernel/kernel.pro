@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 qtHaveModule(widgets): SUBDIRS = \
         qapplication \
+        qbackingstore \
         qwidget \
         qguimetatype \
         qguivariant
@@ -0,0 +1,4 @@
+QT += gui-private testlib
+
+TARGET = tst_bench_qbackingstore
+SOURCES += tst_qbackingstore.cpp
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QBackingStore>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QPainter>
+#include <QtGui/QWindow>
+#include <qpa/qplatformnativeinterface.h>
+
+// Runs on the offscreen platform unless another one is requested, which
+// reports the bytes each flush had to present through window properties.
+
+class tst_QBackingStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void flush_data();
+    void flush();
+    void frameRate_data();
+    void frameRate();
+};
+
+static QVariant flushProperty(QWindow *window, const char *name)
+{
+    QPlatformNativeInterface *nativeInterface = QGuiApplication::platformNativeInterface();
+    if (!nativeInterface || !window->handle())
+        return QVariant();
+    return nativeInterface->windowProperty(window->handle(), QLatin1String(name));
+}
+
+void tst_QBackingStore::flush_data()
+{
+    QTest::addColumn<QRegion>("damage");
+
+    const QRect windowRect(0, 0, 800, 600);
+
+    QTest::newRow("full window") << QRegion(windowRect);
+    QTest::newRow("single 32x32") << QRegion(100, 100, 32, 32);
+
+    QRegion caret(400, 300, 2, 16);
+    caret += QRect(10, 10, 120, 16);
+    QTest::newRow("caret and label") << caret;
+
+    QRegion scattered;
+    for (int i = 0; i < 16; ++i)
+        scattered += QRect((i * 97) % 760, (i * 61) % 560, 24, 24);
+    QTest::newRow("16 scattered 24x24") << scattered;
+
+    QRegion corners;
+    corners += QRect(0, 0, 16, 16);
+    corners += QRect(784, 584, 16, 16);
+    QTest::newRow("opposite corners") << corners;
+}
+
+void tst_QBackingStore::flush()
+{
+    QFETCH(QRegion, damage);
+
+    QWindow window;
+    window.setSurfaceType(QSurface::RasterSurface);
+    window.setGeometry(0, 0, 800, 600);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QBackingStore backingStore(&window);
+    backingStore.resize(window.size());
+
+    backingStore.beginPaint(QRect(QPoint(), window.size()));
+    QPainter(backingStore.paintDevice()).fillRect(QRect(QPoint(), window.size()), Qt::white);
+    backingStore.endPaint();
+    backingStore.flush(QRect(QPoint(), window.size()));
+
+    int frame = 0;
+    QBENCHMARK {
+        backingStore.beginPaint(damage);
+        QPainter painter(backingStore.paintDevice());
+        const QColor color = (++frame & 1) ? Qt::red : Qt::blue;
+        for (const QRect &rect : damage)
+            painter.fillRect(rect, color);
+        painter.end();
+        backingStore.endPaint();
+        backingStore.flush(damage);
+    }
+
+    const QVariant bytes = flushProperty(&window, "lastFlushedBytes");
+    if (bytes.isValid()) {
+        const int bytesPerPixel = backingStore.paintDevice()->depth() / 8;
+        qint64 expected = 0;
+        for (const QRect &rect : damage)
+            expected += qint64(rect.width()) * rect.height() * bytesPerPixel;
+        QCOMPARE(bytes.toLongLong(), expected);
+        // the benchmarked function runs several times, report once per row
+        static QByteArray reportedTag;
+        if (reportedTag == QTest::currentDataTag())
+            return;
+        reportedTag = QTest::currentDataTag();
+        qDebug("bytes copied per frame: %lld (full window: %lld)", bytes.toLongLong(),
+               qint64(window.width()) * window.height() * bytesPerPixel);
+    }
+}
+
+void tst_QBackingStore::frameRate_data()
+{
+    QTest::addColumn<QRect>("animated");
+
+    QTest::newRow("blinking caret") << QRect(400, 300, 2, 16);
+    QTest::newRow("200x200 animation") << QRect(300, 200, 200, 200);
+    QTest::newRow("full window") << QRect(0, 0, 800, 600);
+}
+
+// Paints and flushes the same area frame after frame without waiting in
+// between, so every frame paints over what the previous one just handed to
+// the window system.
+void tst_QBackingStore::frameRate()
+{
+    QFETCH(QRect, animated);
+
+    QWindow window;
+    window.setSurfaceType(QSurface::RasterSurface);
+    window.setGeometry(0, 0, 800, 600);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QBackingStore backingStore(&window);
+    backingStore.resize(window.size());
+
+    const QRegion damage(animated);
+    const int frames = 500;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < frames; ++frame) {
+        backingStore.beginPaint(damage);
+        QPainter painter(backingStore.paintDevice());
+        painter.fillRect(animated, QColor::fromHsv(frame % 360, 255, 255));
+        painter.end();
+        backingStore.endPaint();
+        backingStore.flush(damage);
+    }
+    const qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+
+    QTest::setBenchmarkResult(frames * 1000.0 / elapsed, QTest::FramesPerSecond);
+}
+
+int main(int argc, char **argv)
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    tst_QBackingStore test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_qbackingstore.moc"
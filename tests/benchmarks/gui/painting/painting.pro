@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 SUBDIRS = \
         qpainter \
         qregion \
+        qrastertilerenderer \
         qtransform \
         qtbench
 
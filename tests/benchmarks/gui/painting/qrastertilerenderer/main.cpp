@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+// This file contains benchmarks for replaying a complex scene with
+// QRasterTileRenderer, compared to replaying it on a single thread.
+
+#include <QDebug>
+#include <qtest.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpicture.h>
+#include <QtCore/qmath.h>
+#include <QtGui/private/qrastertilerenderer_p.h>
+
+class tst_QRasterTileRenderer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void renderScene_data();
+    void renderScene();
+};
+
+// A chart-like scene: a dense grid, many antialiased polylines with
+// gradient fills underneath, scatter points and labels.
+static QPicture recordScene(const QSize &size)
+{
+    QPicture picture;
+    QPainter p(&picture);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.fillRect(QRect(QPoint(0, 0), size), Qt::white);
+
+    p.setPen(QPen(QColor(220, 220, 220), 1));
+    for (int x = 0; x < size.width(); x += 16)
+        p.drawLine(x, 0, x, size.height());
+    for (int y = 0; y < size.height(); y += 16)
+        p.drawLine(0, y, size.width(), y);
+
+    for (int series = 0; series < 12; ++series) {
+        QPainterPath line;
+        const qreal base = size.height() * (series + 1) / 14.0;
+        line.moveTo(0, base);
+        for (int x = 0; x <= size.width(); x += 4)
+            line.lineTo(x, base + 40 * qSin((x + series * 17) / 37.0) * qCos(x / 113.0));
+        QPainterPath area = line;
+        area.lineTo(size.width(), size.height());
+        area.lineTo(0, size.height());
+        area.closeSubpath();
+
+        const QColor color = QColor::fromHsv(series * 30, 200, 220);
+        QLinearGradient gradient(0, base - 40, 0, size.height());
+        gradient.setColorAt(0, QColor(color.red(), color.green(), color.blue(), 60));
+        gradient.setColorAt(1, Qt::transparent);
+        p.fillPath(area, gradient);
+        p.strokePath(line, QPen(color, 2));
+    }
+
+    p.setPen(Qt::NoPen);
+    for (int i = 0; i < 4000; ++i) {
+        p.setBrush(QColor::fromHsv(i % 360, 255, 200, 160));
+        p.drawEllipse(QPointF((i * 7919) % size.width(), (i * 104729) % size.height()), 3.5, 3.5);
+    }
+
+    p.setPen(Qt::black);
+    for (int y = 20; y < size.height(); y += 40)
+        p.drawText(QPointF(8, y), QStringLiteral("Series value %1").arg(y));
+    p.end();
+    return picture;
+}
+
+void tst_QRasterTileRenderer::renderScene_data()
+{
+    QTest::addColumn<int>("bandCount");
+
+    QTest::newRow("immediate") << 1;
+    QTest::newRow("2 bands") << 2;
+    QTest::newRow("4 bands") << 4;
+    QTest::newRow("8 bands") << 8;
+    QTest::newRow("auto") << 0;
+}
+
+void tst_QRasterTileRenderer::renderScene()
+{
+    QFETCH(int, bandCount);
+
+    const QSize size(2048, 1536);
+    const QPicture picture = recordScene(size);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        QRasterTileRenderer::render(picture, &image, bandCount);
+    }
+}
+
+QTEST_MAIN(tst_QRasterTileRenderer)
+
+#include "main.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = tst_bench_qrastertilerenderer
+QT += testlib gui-private
+CONFIG += release
+
+SOURCES += main.cpp
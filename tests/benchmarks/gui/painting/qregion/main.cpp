@@ -29,6 +29,7 @@
 
 #include <QDebug>
 #include <qtest.h>
+#include <private/qregion_p.h>
 
 class tst_qregion : public QObject
 {
@@ -39,6 +40,13 @@ private slots:
 
     void intersects_data();
     void intersects();
+
+    void unitedRects_data();
+    void unitedRects();
+    void accumulatedRects_data();
+    void accumulatedRects();
+    void subtractedRects_data();
+    void subtractedRects();
 };
 
 
@@ -121,6 +129,90 @@ void tst_qregion::intersects()
     }
 }
 
+static QVector<QRect> updateRects(const QString &pattern)
+{
+    // Typical update() patterns of an animated UI, within a 1000x1000 window.
+    QVector<QRect> rects;
+    if (pattern == QLatin1String("scattered")) {
+        for (int i = 0; i < 300; ++i)
+            rects << QRect((i * 7919) % 980, (i * 104729) % 980, 8 + i % 13, 6 + i % 11);
+    } else if (pattern == QLatin1String("grid")) {
+        for (int y = 0; y < 15; ++y) {
+            for (int x = 0; x < 20; ++x)
+                rects << QRect(x * 50, y * 40, 24, 16);
+        }
+    } else if (pattern == QLatin1String("overlapping")) {
+        for (int i = 0; i < 300; ++i)
+            rects << QRect(400 + (i % 37) * 3, 300 + (i % 23) * 4, 40, 30);
+    } else if (pattern == QLatin1String("repeated")) {
+        for (int i = 0; i < 300; ++i)
+            rects << QRect(100 + (i % 4) * 200, 100, 64, 64);
+    }
+    return rects;
+}
+
+static void addUpdatePatterns()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::newRow("scattered") << QStringLiteral("scattered");
+    QTest::newRow("grid") << QStringLiteral("grid");
+    QTest::newRow("overlapping") << QStringLiteral("overlapping");
+    QTest::newRow("repeated") << QStringLiteral("repeated");
+}
+
+void tst_qregion::unitedRects_data()
+{
+    addUpdatePatterns();
+}
+
+void tst_qregion::unitedRects()
+{
+    QFETCH(QString, pattern);
+    const QVector<QRect> rects = updateRects(pattern);
+
+    QBENCHMARK {
+        QRegion region;
+        for (const QRect &rect : rects)
+            region += rect;
+    }
+}
+
+void tst_qregion::accumulatedRects_data()
+{
+    addUpdatePatterns();
+}
+
+void tst_qregion::accumulatedRects()
+{
+    QFETCH(QString, pattern);
+    const QVector<QRect> rects = updateRects(pattern);
+
+    QBENCHMARK {
+        QRegionAccumulator accumulator;
+        for (const QRect &rect : rects)
+            accumulator.add(rect);
+        accumulator.region();
+    }
+}
+
+void tst_qregion::subtractedRects_data()
+{
+    addUpdatePatterns();
+}
+
+void tst_qregion::subtractedRects()
+{
+    QFETCH(QString, pattern);
+    const QVector<QRect> rects = updateRects(pattern);
+
+    // Opaque children punched out of a dirty window, as done by sync().
+    QBENCHMARK {
+        QRegion region(0, 0, 1000, 1000);
+        for (const QRect &rect : rects)
+            region -= rect;
+    }
+}
+
 QTEST_MAIN(tst_qregion)
 
 #include "main.moc"
@@ -1,6 +1,6 @@
 TEMPLATE = app
 TARGET = tst_bench_qregion
-QT += testlib
+QT += gui-private testlib
 CONFIG += release
 
 SOURCES += main.cpp
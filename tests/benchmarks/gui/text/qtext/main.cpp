@@ -36,6 +36,7 @@
 #include <QPainter>
 #include <QBuffer>
 #include <qtest.h>
+#include <private/qtextdocumentlayout_p.h>
 
 Q_DECLARE_METATYPE(QVector<QTextLayout::FormatRange>)
 
@@ -72,6 +73,9 @@ private slots:
     void paintLayoutToPixmap();
     void paintLayoutToPixmap_painterFill();
 
+    void largeDocumentLayout_data();
+    void largeDocumentLayout();
+
     void document();
     void paintDocToPixmap();
     void paintDocToPixmap_painterFill();
@@ -302,6 +306,38 @@ void tst_QText::layout()
     }
 }
 
+void tst_QText::largeDocumentLayout_data()
+{
+    QTest::addColumn<bool>("viewportDriven");
+
+    QTest::newRow("background") << false;
+    QTest::newRow("viewport-driven") << true;
+}
+
+// Measures the layout work done on the GUI thread between loading a
+// 200000 line document and being idle with its first screen shown.
+void tst_QText::largeDocumentLayout()
+{
+    QFETCH(bool, viewportDriven);
+
+    QString text;
+    for (int i = 0; i < 200000; ++i)
+        text += QString::fromLatin1("%1 [info] request served in %2 ms\n").arg(i).arg(i % 97);
+
+    QBENCHMARK {
+        QTextDocument doc;
+        QTextDocumentLayout *layout = qobject_cast<QTextDocumentLayout *>(doc.documentLayout());
+        QVERIFY(layout);
+        layout->setViewportDrivenLayout(viewportDriven);
+        doc.setPageSize(QSizeF(800, -1));
+        doc.setPlainText(text);
+        layout->ensureLayouted(600);
+        // what the background layout would do once the event loop is idle
+        if (!viewportDriven)
+            layout->documentSize();
+    }
+}
+
 //### requires tst_QText to be a friend of QTextLayout
 /*void tst_QText::stackTextLayout()
 {
@@ -52,6 +52,13 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void psqlLargeSelect_data();
+    void psqlLargeSelect();
+    void fetchBlock_data();
+    void fetchBlock();
+
+private:
+    void createLargeTable(QSqlDatabase db, const QString &tableName, int rows);
 
 private:
     // returns all database connections
@@ -299,4 +306,154 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     tst_Databases::safeDropTable(db, tableName);
 }
 
+void tst_QSqlQuery::createLargeTable(QSqlDatabase db, const QString &tableName, int rows)
+{
+    QSqlQuery q(db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT NOT NULL, big BIGINT, val DOUBLE PRECISION, "
+                        "stamp TIMESTAMP, data BYTEA)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " SELECT i, i * 1000000007::bigint, i / 7.0, "
+                        "TIMESTAMP '2000-01-01' + i * INTERVAL '1 second', "
+                        "decode(md5(i::text), 'hex') FROM generate_series(1, " + QString::number(rows) + ") AS i"));
+}
+
+// Compares reading a large result buffered by libpq with streaming it
+// in single-row mode (forward-only), each with text and binary results.
+void tst_QSqlQuery::psqlLargeSelect_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<bool>("forwardOnly");
+    QTest::addColumn<bool>("binary");
+
+    int count = 0;
+    foreach (const QString &dbName, dbs.dbNames) {
+        QSqlDatabase db = QSqlDatabase::database(dbName, false);
+        if (!db.isValid() || !db.driverName().startsWith(QLatin1String("QPSQL")))
+            continue;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":buffered:text"))) << dbName << false << false;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":buffered:binary"))) << dbName << false << true;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":forwardOnly:text"))) << dbName << true << false;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":forwardOnly:binary"))) << dbName << true << true;
+        ++count;
+    }
+    if (!count)
+        QSKIP("No database drivers of type QPSQL are available in this Qt configuration");
+}
+
+void tst_QSqlQuery::psqlLargeSelect()
+{
+    QFETCH(QString, dbName);
+    QFETCH(bool, forwardOnly);
+    QFETCH(bool, binary);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const int NUM_ROWS = 200000;
+    const QString tableName(qTableName("largeselect", __FILE__, db));
+    createLargeTable(db, tableName, NUM_ROWS);
+
+    const QString connectionName = dbName + QLatin1String("_largeselect");
+    {
+        QSqlDatabase readDb = QSqlDatabase::cloneDatabase(db, connectionName);
+        if (binary)
+            readDb.setConnectOptions(QLatin1String("QPSQL_BINARY_RESULTS"));
+        QVERIFY_SQL(readDb, open());
+
+        QSqlQuery q(readDb);
+        q.setForwardOnly(forwardOnly);
+        QVERIFY_SQL(q, prepare("SELECT id, big, val, stamp, data FROM " + tableName));
+        QBENCHMARK {
+            QVERIFY_SQL(q, exec());
+            int rows = 0;
+            qint64 sum = 0;
+            while (q.next()) {
+                sum += q.value(0).toInt();
+                q.value(1);
+                q.value(2);
+                q.value(3);
+                q.value(4);
+                ++rows;
+            }
+            QCOMPARE(rows, NUM_ROWS);
+            QCOMPARE(sum, qint64(NUM_ROWS) * (NUM_ROWS + 1) / 2);
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+// Compares reading a forward-only result with next() and value() to
+// reading it in blocks of typed columns.
+void tst_QSqlQuery::fetchBlock_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<bool>("blocks");
+
+    int count = 0;
+    foreach (const QString &dbName, dbs.dbNames) {
+        QSqlDatabase db = QSqlDatabase::database(dbName, false);
+        if (!db.isValid())
+            continue;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":next"))) << dbName << false;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":fetchBlock"))) << dbName << true;
+        ++count;
+    }
+    if (!count)
+        QSKIP("No database drivers are available in this Qt configuration");
+}
+
+void tst_QSqlQuery::fetchBlock()
+{
+    QFETCH(QString, dbName);
+    QFETCH(bool, blocks);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const int NUM_ROWS = 100000;
+    const QString tableName(qTableName("fetchblock", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, val REAL, txt VARCHAR(40))"));
+    QVariantList ids, vals, txts;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        vals << i / 8.0;
+        txts << QString("row number %1").arg(i);
+    }
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, val, txt) VALUES (?, ?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(vals);
+    q.addBindValue(txts);
+    QVERIFY_SQL(q, execBatch());
+
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, prepare("SELECT id, val, txt FROM " + tableName));
+    QSqlColumnBlock block;
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        qint64 sum = 0;
+        int chars = 0;
+        if (blocks) {
+            while (q.fetchBlock(&block, 1024) > 0) {
+                const QVector<qint64> idColumn = block.integerColumn(0);
+                const QVector<double> valColumn = block.realColumn(1);
+                for (int row = 0; row < block.rowCount(); ++row)
+                    sum += idColumn.at(row) + qint64(valColumn.at(row));
+                chars += block.stringData(2).size();
+            }
+        } else {
+            while (q.next()) {
+                sum += q.value(0).toLongLong() + qint64(q.value(1).toDouble());
+                chars += q.value(2).toString().size();
+            }
+        }
+        QVERIFY(sum > 0);
+        QVERIFY(chars > 0);
+    }
+
+    q.clear();
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 #include "main.moc"
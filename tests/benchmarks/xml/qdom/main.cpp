@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QDomDocument>
+#include <qtest.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+
+static size_t heapInUse()
+{
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return size_t(mallinfo().uordblks);
+#endif
+}
+#endif
+
+class tst_QDomDocument : public QObject
+{
+    Q_OBJECT
+private slots:
+    void setContent_data() const;
+    void setContent() const;
+    void destroy_data() const;
+    void destroy() const;
+    void memory_data() const;
+    void memory() const;
+};
+
+// Generates a document of roughly size bytes with records made of text,
+// attributes or markup.
+static QByteArray generateDocument(const QByteArray &kind, int size)
+{
+    QString document = QLatin1String("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                     "<feed xmlns=\"http://www.w3.org/2005/Atom\" xmlns:media=\"http://search.yahoo.com/mrss/\">\n");
+    for (int i = 0; document.size() < size; ++i) {
+        if (kind == "text") {
+            document += QString::fromLatin1("<entry><title>Entry %1</title><summary>The quick brown fox "
+                                            "jumps over the lazy dog.</summary></entry>\n").arg(i);
+        } else if (kind == "attributes") {
+            document += QString::fromLatin1("<entry id=\"%1\" rel=\"alternate\" type=\"text/html\">"
+                                            "<media:thumbnail url=\"http://example.com/%1.png\" width=\"64\" height=\"64\"/>"
+                                            "</entry>\n").arg(i);
+        } else {
+            document += QString::fromLatin1("<entry><a><b>x</b><c/></a><d>%1</d></entry>\n").arg(i);
+        }
+    }
+    document += QLatin1String("</feed>\n");
+    return document.toUtf8();
+}
+
+static void addDocuments()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("namespaceProcessing");
+
+    const int size = 4 * 1024 * 1024;
+    const QByteArray kinds[] = { "text", "attributes", "markup" };
+    for (const QByteArray &kind : kinds) {
+        const QByteArray document = generateDocument(kind, size);
+        QTest::newRow(kind.constData()) << document << false;
+        QTest::newRow((kind + "-ns").constData()) << document << true;
+    }
+}
+
+void tst_QDomDocument::setContent_data() const
+{
+    addDocuments();
+}
+
+void tst_QDomDocument::setContent() const
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    QBENCHMARK {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(document, namespaceProcessing));
+    }
+}
+
+void tst_QDomDocument::destroy_data() const
+{
+    addDocuments();
+}
+
+void tst_QDomDocument::destroy() const
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    QDomDocument doc;
+    QVERIFY(doc.setContent(document, namespaceProcessing));
+
+    QBENCHMARK_ONCE {
+        doc.clear();
+    }
+}
+
+void tst_QDomDocument::memory_data() const
+{
+    addDocuments();
+}
+
+// Reports the heap growth caused by keeping the parsed document alive.
+void tst_QDomDocument::memory() const
+{
+#ifdef __GLIBC__
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    QDomDocument doc;
+    const size_t before = heapInUse();
+    QVERIFY(doc.setContent(document, namespaceProcessing));
+    const size_t after = heapInUse();
+
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+#else
+    QSKIP("Heap statistics are only available with glibc");
+#endif
+}
+
+QTEST_MAIN(tst_QDomDocument)
+
+#include "main.moc"
@@ -0,0 +1,3 @@
+TARGET = tst_bench_qdom
+QT = core xml testlib
+SOURCES += main.cpp